@@ -117,6 +117,22 @@ class this_stoppable_thread {
  public:
   static stop_token get_stop_token();
 
+  // Makes |st| the stop token of the current thread for the lifetime of this
+  // object.  This is useful when work is delegated to a thread pool on behalf
+  // of a stoppable thread, so that the work honours the stop requests made to
+  // that thread.
+  class Scope final {
+   public:
+    explicit Scope(stop_token const& st);
+    ~Scope();
+
+    Scope(Scope const&) = delete;
+    Scope& operator=(Scope const&) = delete;
+
+   private:
+    stop_token const previous_stop_token_;
+  };
+
  private:
   inline static thread_local stop_token stop_token_;
 
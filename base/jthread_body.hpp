@@ -178,6 +178,15 @@ inline stop_token this_stoppable_thread::get_stop_token() {
   return stop_token_;
 }
 
+inline this_stoppable_thread::Scope::Scope(stop_token const& st)
+    : previous_stop_token_(stop_token_) {
+  stop_token_ = st;
+}
+
+inline this_stoppable_thread::Scope::~Scope() {
+  stop_token_ = previous_stop_token_;
+}
+
 }  // namespace internal_jthread
 }  // namespace base
 }  // namespace principia
@@ -140,7 +140,22 @@ TEST(JThreadTest, ThisJThread) {
   EXPECT_TRUE(observed_stop);
 }
 
-
+TEST(JThreadTest, ThisJThreadScope) {
+  auto worker = MakeStoppableThread([]() {});
+  worker.join();
+  worker.request_stop();
+
+  // A thread that is not stoppable temporarily adopts the stop token of
+  // |worker|.
+  std::thread([&worker]() {
+    EXPECT_FALSE(this_stoppable_thread::get_stop_token().stop_requested());
+    {
+      this_stoppable_thread::Scope const scope(worker.get_stop_token());
+      EXPECT_TRUE(this_stoppable_thread::get_stop_token().stop_requested());
+    }
+    EXPECT_FALSE(this_stoppable_thread::get_stop_token().stop_requested());
+  }).join();
+}
 
 }  // namespace base
 }  // namespace principia
@@ -0,0 +1,101 @@
+#include "base/mapped_file.hpp"
+
+#include "base/macros.hpp"
+#include "glog/logging.h"
+#if OS_WIN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace principia {
+namespace base {
+namespace internal_mapped_file {
+
+#if OS_WIN
+
+MappedFile::MappedFile(std::filesystem::path const& path) {
+  HANDLE const file = CreateFileW(path.c_str(),
+                                  GENERIC_READ,
+                                  FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                  /*lpSecurityAttributes=*/nullptr,
+                                  OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL,
+                                  /*hTemplateFile=*/nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return;
+  }
+  LARGE_INTEGER size;
+  if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+    HANDLE const mapping = CreateFileMappingW(file,
+                                              /*lpFileMappingAttributes=*/
+                                              nullptr,
+                                              PAGE_READONLY,
+                                              /*dwMaximumSizeHigh=*/0,
+                                              /*dwMaximumSizeLow=*/0,
+                                              /*lpName=*/nullptr);
+    if (mapping != nullptr) {
+      // The view keeps the mapping and the file open.
+      void const* const view = MapViewOfFile(mapping,
+                                             FILE_MAP_READ,
+                                             /*dwFileOffsetHigh=*/0,
+                                             /*dwFileOffsetLow=*/0,
+                                             /*dwNumberOfBytesToMap=*/0);
+      if (view != nullptr) {
+        data_ = static_cast<std::uint8_t const*>(view);
+        size_ = size.QuadPart;
+      }
+      CloseHandle(mapping);
+    }
+  }
+  CloseHandle(file);
+}
+
+MappedFile::~MappedFile() {
+  if (data_ != nullptr) {
+    CHECK(UnmapViewOfFile(data_)) << GetLastError();
+  }
+}
+
+#else
+
+MappedFile::MappedFile(std::filesystem::path const& path) {
+  int const file = open(path.c_str(), O_RDONLY);
+  if (file < 0) {
+    return;
+  }
+  struct stat status;
+  if (fstat(file, &status) == 0 && status.st_size > 0) {
+    // The mapping keeps the file open.
+    void* const mapping = mmap(/*addr=*/nullptr,
+                               status.st_size,
+                               PROT_READ,
+                               MAP_PRIVATE,
+                               file,
+                               /*offset=*/0);
+    if (mapping != MAP_FAILED) {
+      data_ = static_cast<std::uint8_t const*>(mapping);
+      size_ = status.st_size;
+    }
+  }
+  close(file);
+}
+
+MappedFile::~MappedFile() {
+  if (data_ != nullptr) {
+    CHECK_EQ(0, munmap(const_cast<std::uint8_t*>(data_), size_)) << errno;
+  }
+}
+
+#endif
+
+Array<std::uint8_t const> MappedFile::bytes() const {
+  return Array<std::uint8_t const>(data_, size_);
+}
+
+}  // namespace internal_mapped_file
+}  // namespace base
+}  // namespace principia
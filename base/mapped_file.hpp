@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+
+#include "base/array.hpp"
+
+namespace principia {
+namespace base {
+namespace internal_mapped_file {
+
+// A read-only memory mapping of an entire file.  The pages are only read from
+// the file when they are accessed.  If the file does not exist, is empty, or
+// cannot be mapped, the mapping is empty.  The contents of the mapping are
+// unspecified if the file is modified while it is mapped.
+class MappedFile final {
+ public:
+  explicit MappedFile(std::filesystem::path const& path);
+  ~MappedFile();
+
+  MappedFile(MappedFile const&) = delete;
+  MappedFile(MappedFile&&) = delete;
+  MappedFile& operator=(MappedFile const&) = delete;
+  MappedFile& operator=(MappedFile&&) = delete;
+
+  // The address of the mapping is aligned on a page boundary.
+  Array<std::uint8_t const> bytes() const;
+
+ private:
+  std::uint8_t const* data_ = nullptr;
+  std::int64_t size_ = 0;
+};
+
+}  // namespace internal_mapped_file
+
+using internal_mapped_file::MappedFile;
+
+}  // namespace base
+}  // namespace principia
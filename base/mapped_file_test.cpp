@@ -0,0 +1,58 @@
+#include "base/mapped_file.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace principia {
+namespace base {
+
+using ::testing::Eq;
+
+class MappedFileTest : public ::testing::Test {
+ protected:
+  MappedFileTest()
+      : path_(std::string(::testing::UnitTest::GetInstance()
+                              ->current_test_info()
+                              ->name()) +
+              ".mapped") {
+    std::filesystem::remove(path_);
+  }
+
+  ~MappedFileTest() override {
+    std::filesystem::remove(path_);
+  }
+
+  std::filesystem::path const path_;
+};
+
+TEST_F(MappedFileTest, Missing) {
+  MappedFile const mapped_file(path_);
+  EXPECT_THAT(mapped_file.bytes().size, Eq(0));
+}
+
+TEST_F(MappedFileTest, Empty) {
+  std::ofstream(path_, std::ios::binary).close();
+  MappedFile const mapped_file(path_);
+  EXPECT_THAT(mapped_file.bytes().size, Eq(0));
+}
+
+TEST_F(MappedFileTest, Contents) {
+  {
+    std::ofstream file(path_, std::ios::binary);
+    file << "Mapped";
+  }
+  MappedFile const mapped_file(path_);
+  auto const bytes = mapped_file.bytes();
+  EXPECT_THAT(std::string(reinterpret_cast<char const*>(bytes.data),
+                          bytes.size),
+              Eq("Mapped"));
+  EXPECT_THAT(reinterpret_cast<std::uintptr_t>(bytes.data) % 4096, Eq(0));
+}
+
+}  // namespace base
+}  // namespace principia
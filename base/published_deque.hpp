@@ -0,0 +1,126 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace principia {
+namespace base {
+namespace internal_published_deque {
+
+// A sequence that may be extended at both ends by a single writer while it is
+// being read, without locking, by any number of readers.  Readers obtain a
+// |View|, which is a snapshot of the published elements, and never write to
+// shared memory.
+// Each element has an index which doesn't change once it is published, even if
+// elements are later inserted at the front (so indices may be negative).
+// Published elements are never moved.  Their storage is only reclaimed by
+// |pop_front|, |pop_back|, |clear| and the destructor, which must not be called
+// while readers may access the elements being removed.  The functions that
+// modify the deque must be externally synchronized.
+template<typename T>
+class PublishedDeque final {
+  // Chunks of about 4 KiB, so that small deques of large elements don't waste
+  // memory, but with at least 16 elements.
+  static constexpr std::int64_t chunk_size = std::max<std::int64_t>(
+      16, std::bit_floor(std::size_t{4096} / sizeof(std::optional<T>)));
+  struct Chunk;
+  struct Directory;
+
+ public:
+  // A snapshot of the deque.  Remains valid as long as the deque is only
+  // extended.
+  class View final {
+   public:
+    // The indices of the elements of this view are in [begin(), end()[.
+    std::int64_t begin() const;
+    std::int64_t end() const;
+    bool empty() const;
+    std::int64_t size() const;
+
+    // |index| must be in [begin(), end()[.
+    T const& operator[](std::int64_t index) const;
+    T const& front() const;
+    T const& back() const;
+
+   private:
+    View(Directory const* directory, std::int64_t begin, std::int64_t end);
+
+    Directory const* directory_;
+    std::int64_t begin_;
+    std::int64_t end_;
+
+    friend class PublishedDeque;
+  };
+
+  PublishedDeque();
+
+  PublishedDeque(PublishedDeque const&) = delete;
+  PublishedDeque(PublishedDeque&&) = delete;
+  PublishedDeque& operator=(PublishedDeque const&) = delete;
+  PublishedDeque& operator=(PublishedDeque&&) = delete;
+
+  // Thread-safe.
+  View view() const;
+
+  // Publishes |value| at index |view().end()| (resp. |view().begin() - 1|).
+  void push_back(T value);
+  void push_front(T value);
+
+  // Removes and returns the last (resp. first) element.  Must not be called
+  // while the element may be read.
+  T pop_back();
+  T pop_front();
+
+  // Removes all the elements.  Must not be called while the deque may be read.
+  void clear();
+
+ private:
+  struct Chunk {
+    std::array<std::optional<T>, chunk_size> elements;
+  };
+
+  // The chunks with numbers in [first_chunk, first_chunk + chunks.size()[.
+  // Some of the pointers may be null.  A directory is never modified once
+  // published, except for setting pointers that were null.
+  struct Directory {
+    std::int64_t first_chunk;
+    std::vector<Chunk*> chunks;
+  };
+
+  // The number of the chunk and the position in that chunk of the element with
+  // the given |index|.
+  static std::int64_t ChunkNumber(std::int64_t index);
+  static std::int64_t PositionInChunk(std::int64_t index);
+
+  // Returns the storage for the element with the given |index|, allocating a
+  // chunk and publishing a new directory if needed.
+  std::optional<T>& Slot(std::int64_t index);
+
+  // The chunks are owned here and shared by the directories.  Directories that
+  // have been replaced are kept because readers may still be using them; since
+  // their capacity grows geometrically, they don't use more memory than the
+  // current directory.
+  std::vector<std::unique_ptr<Chunk>> chunks_;
+  std::vector<std::unique_ptr<Directory>> directories_;
+
+  // Published with release semantics after the elements and the directory
+  // that they require.
+  std::atomic<Directory const*> directory_;
+  std::atomic<std::int64_t> begin_ = 0;
+  std::atomic<std::int64_t> end_ = 0;
+};
+
+}  // namespace internal_published_deque
+
+using internal_published_deque::PublishedDeque;
+
+}  // namespace base
+}  // namespace principia
+
+#include "base/published_deque_body.hpp"
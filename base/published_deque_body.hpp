@@ -0,0 +1,176 @@
+#pragma once
+
+#include "base/published_deque.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include "glog/logging.h"
+
+namespace principia {
+namespace base {
+namespace internal_published_deque {
+
+template<typename T>
+std::int64_t PublishedDeque<T>::View::begin() const {
+  return begin_;
+}
+
+template<typename T>
+std::int64_t PublishedDeque<T>::View::end() const {
+  return end_;
+}
+
+template<typename T>
+bool PublishedDeque<T>::View::empty() const {
+  return begin_ == end_;
+}
+
+template<typename T>
+std::int64_t PublishedDeque<T>::View::size() const {
+  return end_ - begin_;
+}
+
+template<typename T>
+T const& PublishedDeque<T>::View::operator[](std::int64_t const index) const {
+  std::int64_t const chunk_number = ChunkNumber(index);
+  Chunk const& chunk =
+      *directory_->chunks[chunk_number - directory_->first_chunk];
+  return *chunk.elements[PositionInChunk(index)];
+}
+
+template<typename T>
+T const& PublishedDeque<T>::View::front() const {
+  return (*this)[begin_];
+}
+
+template<typename T>
+T const& PublishedDeque<T>::View::back() const {
+  return (*this)[end_ - 1];
+}
+
+template<typename T>
+PublishedDeque<T>::View::View(Directory const* const directory,
+                              std::int64_t const begin,
+                              std::int64_t const end)
+    : directory_(directory),
+      begin_(begin),
+      end_(end) {}
+
+template<typename T>
+PublishedDeque<T>::PublishedDeque() {
+  clear();
+}
+
+template<typename T>
+typename PublishedDeque<T>::View PublishedDeque<T>::view() const {
+  // The bounds must be loaded before the directory: the directory published
+  // before them covers them, and any later directory also does.
+  std::int64_t const end = end_.load(std::memory_order_acquire);
+  std::int64_t const begin = begin_.load(std::memory_order_acquire);
+  return View(directory_.load(std::memory_order_acquire), begin, end);
+}
+
+template<typename T>
+void PublishedDeque<T>::push_back(T value) {
+  std::int64_t const end = end_.load(std::memory_order_relaxed);
+  Slot(end).emplace(std::move(value));
+  end_.store(end + 1, std::memory_order_release);
+}
+
+template<typename T>
+void PublishedDeque<T>::push_front(T value) {
+  std::int64_t const begin = begin_.load(std::memory_order_relaxed);
+  Slot(begin - 1).emplace(std::move(value));
+  begin_.store(begin - 1, std::memory_order_release);
+}
+
+template<typename T>
+T PublishedDeque<T>::pop_back() {
+  std::int64_t const end = end_.load(std::memory_order_relaxed);
+  CHECK_LT(begin_.load(std::memory_order_relaxed), end);
+  end_.store(end - 1, std::memory_order_release);
+  std::optional<T>& slot = Slot(end - 1);
+  T value = std::move(*slot);
+  slot.reset();
+  return value;
+}
+
+template<typename T>
+T PublishedDeque<T>::pop_front() {
+  std::int64_t const begin = begin_.load(std::memory_order_relaxed);
+  CHECK_LT(begin, end_.load(std::memory_order_relaxed));
+  begin_.store(begin + 1, std::memory_order_release);
+  std::optional<T>& slot = Slot(begin);
+  T value = std::move(*slot);
+  slot.reset();
+  return value;
+}
+
+template<typename T>
+void PublishedDeque<T>::clear() {
+  begin_.store(0, std::memory_order_release);
+  end_.store(0, std::memory_order_release);
+  chunks_.clear();
+  directories_.clear();
+  // Start with room for one chunk on each side of index 0.
+  directories_.push_back(std::make_unique<Directory>(
+      Directory{/*first_chunk=*/-1, /*chunks=*/{nullptr, nullptr}}));
+  directory_.store(directories_.back().get(), std::memory_order_release);
+}
+
+template<typename T>
+std::int64_t PublishedDeque<T>::ChunkNumber(std::int64_t const index) {
+  // Division rounding towards negative infinity.
+  return index >= 0 ? index / chunk_size : -((-index - 1) / chunk_size) - 1;
+}
+
+template<typename T>
+std::int64_t PublishedDeque<T>::PositionInChunk(std::int64_t const index) {
+  return index - ChunkNumber(index) * chunk_size;
+}
+
+template<typename T>
+std::optional<T>& PublishedDeque<T>::Slot(std::int64_t const index) {
+  std::int64_t const chunk_number = ChunkNumber(index);
+  {
+    Directory const& directory = *directories_.back();
+    std::int64_t const size = directory.chunks.size();
+    std::int64_t const first_chunk = directory.first_chunk;
+    std::int64_t const last_chunk = first_chunk + size - 1;
+    if (chunk_number < first_chunk || chunk_number > last_chunk) {
+      // Publish a larger directory, leaving room on the side where the deque
+      // is growing.
+      std::int64_t const lowest_chunk = std::min(first_chunk, chunk_number);
+      std::int64_t const highest_chunk = std::max(last_chunk, chunk_number);
+      std::int64_t const new_size =
+          std::max(2 * size, highest_chunk - lowest_chunk + 1);
+      auto new_directory = std::make_unique<Directory>();
+      new_directory->first_chunk = chunk_number < first_chunk
+                                       ? highest_chunk - new_size + 1
+                                       : lowest_chunk;
+      new_directory->chunks.resize(new_size, nullptr);
+      std::copy(directory.chunks.begin(),
+                directory.chunks.end(),
+                new_directory->chunks.begin() +
+                    (first_chunk - new_directory->first_chunk));
+      directory_.store(new_directory.get(), std::memory_order_release);
+      directories_.push_back(std::move(new_directory));
+    }
+  }
+
+  // Readers never access the chunk pointer that we may set here, nor the
+  // element that the caller will construct, until it is published by a store
+  // to |begin_| or |end_|.
+  Directory& directory = *directories_.back();
+  Chunk*& chunk = directory.chunks[chunk_number - directory.first_chunk];
+  if (chunk == nullptr) {
+    chunks_.push_back(std::make_unique<Chunk>());
+    chunk = chunks_.back().get();
+  }
+  return chunk->elements[PositionInChunk(index)];
+}
+
+}  // namespace internal_published_deque
+}  // namespace base
+}  // namespace principia
@@ -0,0 +1,88 @@
+#include "base/published_deque.hpp"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace principia {
+namespace base {
+
+using ::testing::Eq;
+
+class PublishedDequeTest : public ::testing::Test {
+ protected:
+  PublishedDeque<std::unique_ptr<int>> deque_;
+};
+
+TEST_F(PublishedDequeTest, PushAndPop) {
+  EXPECT_TRUE(deque_.view().empty());
+  for (int i = 0; i < 1000; ++i) {
+    deque_.push_back(std::make_unique<int>(i));
+  }
+  for (int i = -1; i >= -1000; --i) {
+    deque_.push_front(std::make_unique<int>(i));
+  }
+
+  auto const view = deque_.view();
+  EXPECT_THAT(view.begin(), Eq(-1000));
+  EXPECT_THAT(view.end(), Eq(1000));
+  EXPECT_THAT(view.size(), Eq(2000));
+  EXPECT_THAT(*view.front(), Eq(-1000));
+  EXPECT_THAT(*view.back(), Eq(999));
+  for (int i = -1000; i < 1000; ++i) {
+    EXPECT_THAT(*view[i], Eq(i));
+  }
+
+  EXPECT_THAT(*deque_.pop_back(), Eq(999));
+  EXPECT_THAT(*deque_.pop_front(), Eq(-1000));
+  EXPECT_THAT(deque_.view().begin(), Eq(-999));
+  EXPECT_THAT(deque_.view().end(), Eq(999));
+
+  deque_.clear();
+  EXPECT_TRUE(deque_.view().empty());
+  deque_.push_front(std::make_unique<int>(42));
+  EXPECT_THAT(*deque_.view()[-1], Eq(42));
+}
+
+// A view remains valid while the deque is extended, and readers never see
+// elements that are not fully constructed.
+TEST_F(PublishedDequeTest, ConcurrentReaders) {
+  constexpr int size = 100'000;
+  auto const old_view = [this]() {
+    deque_.push_back(std::make_unique<int>(0));
+    return deque_.view();
+  }();
+
+  std::atomic<bool> done = false;
+  std::vector<std::thread> readers;
+  for (int r = 0; r < 4; ++r) {
+    readers.emplace_back([this, &done]() {
+      while (!done) {
+        auto const view = deque_.view();
+        if (!view.empty()) {
+          EXPECT_THAT(*view.front(), Eq(view.begin()));
+          EXPECT_THAT(*view.back(), Eq(view.end() - 1));
+        }
+      }
+    });
+  }
+  for (int i = 1; i < size; ++i) {
+    deque_.push_back(std::make_unique<int>(i));
+    deque_.push_front(std::make_unique<int>(-i));
+  }
+  done = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+
+  EXPECT_THAT(old_view.size(), Eq(1));
+  EXPECT_THAT(*old_view[0], Eq(0));
+  EXPECT_THAT(deque_.view().size(), Eq(2 * size - 1));
+}
+
+}  // namespace base
+}  // namespace principia
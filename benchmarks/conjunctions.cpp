@@ -0,0 +1,112 @@
+// .\Release\x64\benchmarks.exe --benchmark_filter=Conjunctions --benchmark_repetitions=5  // NOLINT(whitespace/line_length)
+
+#include "physics/conjunctions.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/status_utilities.hpp"
+#include "base/thread_pool.hpp"
+#include "benchmark/benchmark.h"
+#include "geometry/frame.hpp"
+#include "geometry/grassmann.hpp"
+#include "geometry/named_quantities.hpp"
+#include "ksp_plugin/frames.hpp"
+#include "physics/degrees_of_freedom.hpp"
+#include "physics/discrete_trajectory.hpp"
+#include "quantities/elementary_functions.hpp"
+#include "quantities/numbers.hpp"
+#include "quantities/quantities.hpp"
+#include "quantities/si.hpp"
+
+namespace principia {
+namespace physics {
+
+using base::ThreadPool;
+using geometry::Displacement;
+using geometry::Instant;
+using geometry::Velocity;
+using ksp_plugin::Barycentric;
+using quantities::Angle;
+using quantities::AngularFrequency;
+using quantities::Cos;
+using quantities::Length;
+using quantities::Sin;
+using quantities::Time;
+using quantities::si::Kilo;
+using quantities::si::Metre;
+using quantities::si::Minute;
+using quantities::si::Radian;
+using quantities::si::Second;
+
+namespace {
+
+// Vessels on circular orbits of slightly different radii in planes of
+// different inclinations, sampled every 10 s over one period.
+std::vector<DiscreteTrajectory<Barycentric>> MakeVessels(
+    int const number_of_vessels) {
+  Instant const t0;
+  Time const period = 90 * Minute;
+  Time const step = 10 * Second;
+  AngularFrequency const ω = 2 * π * Radian / period;
+  std::vector<DiscreteTrajectory<Barycentric>> vessels(number_of_vessels);
+  for (int k = 0; k < number_of_vessels; ++k) {
+    Length const r = 7000 * Kilo(Metre) + k * 10 * Metre;
+    Angle const inclination = k * π * Radian / number_of_vessels;
+    Angle const phase = k * 0.1 * Radian;
+    for (Instant t = t0; t <= t0 + period; t += step) {
+      Angle const θ = ω * (t - t0) + phase;
+      CHECK_OK(vessels[k].Append(
+          t,
+          DegreesOfFreedom<Barycentric>(
+              Barycentric::origin +
+                  Displacement<Barycentric>({r * Cos(θ),
+                                             r * Sin(θ) * Cos(inclination),
+                                             r * Sin(θ) * Sin(inclination)}),
+              Velocity<Barycentric>(
+                  {-r * ω * Sin(θ) / Radian,
+                   r * ω * Cos(θ) * Cos(inclination) / Radian,
+                   r * ω * Cos(θ) * Sin(inclination) / Radian}))));
+    }
+  }
+  return vessels;
+}
+
+}  // namespace
+
+// The arguments are the number of vessels and the number of threads, 0 for a
+// serial computation.
+void BM_ScreenConjunctions(benchmark::State& state) {
+  auto const vessels = MakeVessels(state.range(0));
+  std::vector<TrajectorySection<Barycentric>> trajectories;
+  for (auto const& vessel : vessels) {
+    trajectories.emplace_back(vessel.begin(), vessel.end());
+  }
+  std::unique_ptr<ThreadPool<void>> pool;
+  if (state.range(1) > 0) {
+    pool = std::make_unique<ThreadPool<void>>(state.range(1));
+  }
+
+  std::int64_t conjunctions = 0;
+  for (auto _ : state) {
+    conjunctions += ScreenConjunctions(trajectories,
+                                       /*threshold=*/1 * Kilo(Metre),
+                                       /*bucket_duration=*/1 * Minute,
+                                       pool.get()).size();
+  }
+  state.SetLabel(std::to_string(conjunctions / state.iterations()) +
+                 " conjunctions");
+}
+
+BENCHMARK(BM_ScreenConjunctions)
+    ->Args({500, 0})
+    ->Args({500, 4})
+    ->Args({500, 8})
+    ->Args({1000, 0})
+    ->Args({1000, 8})
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace physics
+}  // namespace principia
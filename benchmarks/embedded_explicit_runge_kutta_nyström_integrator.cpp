@@ -8,6 +8,7 @@
 #include <type_traits>
 #include <vector>
 
+#include "absl/status/status.h"
 #include "base/not_null.hpp"
 #include "base/status_utilities.hpp"
 #include "benchmark/benchmark.h"
@@ -139,12 +140,15 @@ void SolveHarmonicOscillatorAndComputeError1D(benchmark::State& state,
   state.ResumeTiming();
 }
 
+// If |single| is true, uses the fast path for a single degree of freedom
+// instead of an instance.
 template<typename Integrator>
 void SolveHarmonicOscillatorAndComputeError3D(
     benchmark::State& state,
     Length& q_error,
     Speed& v_error,
-    Integrator const& integrator) {
+    Integrator const& integrator,
+    bool const single) {
   using ODE = SpecialSecondOrderDifferentialEquation<Position<World>>;
 
   Displacement<World> const q_initial({1 * Metre, 0 * Metre, 0 * Metre});
@@ -173,11 +177,26 @@ void SolveHarmonicOscillatorAndComputeError3D(
       std::bind(HarmonicOscillatorToleranceRatio3D<ODE>,
                 _1, _2, length_tolerance, speed_tolerance);
 
-  auto const instance = integrator.NewInstance(problem,
-                                               append_state,
-                                               tolerance_to_error_ratio,
-                                               parameters);
-  CHECK_OK(instance->Solve(t_final));
+  if (single) {
+    CHECK_OK(integrator.SolveSingle(
+        {.initial_state = problem.initial_state,
+         .t_final = t_final,
+         .append_state = append_state,
+         .tolerance_to_error_ratio = tolerance_to_error_ratio,
+         .parameters = parameters},
+        [](Instant const& t,
+           Position<World> const& position,
+           Vector<Acceleration, World>& acceleration) {
+          acceleration = (World::origin - position) / (Second * Second);
+          return absl::OkStatus();
+        }));
+  } else {
+    auto const instance = integrator.NewInstance(problem,
+                                                 append_state,
+                                                 tolerance_to_error_ratio,
+                                                 parameters);
+    CHECK_OK(instance->Solve(t_final));
+  }
 
   state.PauseTiming();
   q_error = Length();
@@ -224,7 +243,26 @@ void BM_EmbeddedExplicitRungeKuttaNyströmIntegratorSolveHarmonicOscillator3D(
         state,
         q_error,
         v_error,
-        EmbeddedExplicitRungeKuttaNyströmIntegrator<Method, Position>());
+        EmbeddedExplicitRungeKuttaNyströmIntegrator<Method, Position>(),
+        /*single=*/false);
+  }
+  std::stringstream ss;
+  ss << q_error << ", " << v_error;
+  state.SetLabel(ss.str());
+}
+
+template<typename Method, typename Position>
+void BM_EmbeddedExplicitRungeKuttaNyströmIntegratorSolveHarmonicOscillator3DSingle(  // NOLINT(whitespace/line_length)
+    benchmark::State& state) {
+  Length q_error;
+  Speed v_error;
+  for (auto _ : state) {
+    SolveHarmonicOscillatorAndComputeError3D(
+        state,
+        q_error,
+        v_error,
+        EmbeddedExplicitRungeKuttaNyströmIntegrator<Method, Position>(),
+        /*single=*/true);
   }
   std::stringstream ss;
   ss << q_error << ", " << v_error;
@@ -243,5 +281,10 @@ BENCHMARK_TEMPLATE2(
     methods::DormandالمكاوىPrince1986RKN434FM, Position<World>)
     ->Unit(benchmark::kMillisecond);
 
+BENCHMARK_TEMPLATE2(
+    BM_EmbeddedExplicitRungeKuttaNyströmIntegratorSolveHarmonicOscillator3DSingle,  // NOLINT(whitespace/line_length)
+    methods::DormandالمكاوىPrince1986RKN434FM, Position<World>)
+    ->Unit(benchmark::kMillisecond);
+
 }  // namespace integrators
 }  // namespace principia
@@ -28,6 +28,7 @@
 #include "physics/discrete_trajectory.hpp"
 #include "physics/ephemeris.hpp"
 #include "physics/massless_body.hpp"
+#include "physics/massless_body_accelerations.hpp"
 #include "quantities/astronomy.hpp"
 #include "quantities/bipm.hpp"
 #include "quantities/elementary_functions.hpp"
@@ -47,10 +48,12 @@ using geometry::DefinesFrame;
 using geometry::Displacement;
 using geometry::Frame;
 using geometry::Identity;
+using geometry::InfiniteFuture;
 using geometry::Instant;
 using geometry::Position;
 using geometry::Quaternion;
 using geometry::Rotation;
+using geometry::Vector;
 using geometry::Velocity;
 using integrators::Integrator;
 using integrators::EmbeddedExplicitRungeKuttaNyströmIntegrator;
@@ -63,10 +66,14 @@ using integrators::methods::Quinlan1999Order8A;
 using integrators::methods::QuinlanTremaine1990Order12;
 using ksp_plugin::Barycentric;
 using quantities::DebugString;
+using quantities::Acceleration;
+using quantities::Exponentiation;
 using quantities::Frequency;
+using quantities::GravitationalParameter;
 using quantities::Length;
 using quantities::Speed;
 using quantities::Sqrt;
+using quantities::Square;
 using quantities::Time;
 using quantities::astronomy::AstronomicalUnit;
 using quantities::astronomy::JulianYear;
@@ -164,6 +171,9 @@ void BM_EphemerisSolarSystem(benchmark::State& state) {
                 FittingTolerance(state.range(0)),
                 accuracy),
             EphemerisParameters());
+    ephemeris->SetMassiveBodiesParallelism(
+        /*number_of_threads=*/state.range(1),
+        /*identical_to_serial=*/false);
 
     state.ResumeTiming();
     CHECK_OK(ephemeris->Prolong(final_time));
@@ -179,7 +189,8 @@ void BM_EphemerisSolarSystem(benchmark::State& state) {
                  Norm();
     state.ResumeTiming();
   }
-  state.SetLabel(quantities::DebugString(error / AstronomicalUnit) + " ua");
+  state.SetLabel(quantities::DebugString(error / AstronomicalUnit) + " ua, " +
+                 std::to_string(state.range(1)) + " threads");
 }
 
 template<SolarSystemFactory::Accuracy accuracy, Flow* flow>
@@ -397,6 +408,97 @@ void BM_EphemerisMultithreadingBenchmark(benchmark::State& state) {
     ss << earth_distance << " ";
   }
   state.SetLabel(ss.str());
+  state.counters["cache_hits"] =
+      ephemeris->massive_bodies_positions_cache_hits();
+  state.counters["cache_misses"] =
+      ephemeris->massive_bodies_positions_cache_misses();
+}
+
+// Reanimates |state.range(0)| years of history of the solar system on
+// |state.range(1)| threads.
+void BM_EphemerisReanimation(benchmark::State& state) {
+  auto const at_спутник_1_launch =
+      SolarSystemAtСпутник1Launch(SolarSystemFactory::Accuracy::MajorBodiesOnly);
+  Instant const epoch = at_спутник_1_launch->epoch();
+  auto const ephemeris =
+      at_спутник_1_launch->MakeEphemeris(
+          /*accuracy_parameters=*/{/*fitting_tolerance=*/1 * Milli(Metre),
+                                   /*geopotential_tolerance=*/0x1p-24},
+          EphemerisParameters());
+  CHECK_OK(ephemeris->Prolong(epoch + state.range(0) * JulianYear));
+  serialization::Ephemeris message;
+  ephemeris->WriteToMessage(&message);
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto const reanimated_ephemeris = Ephemeris<Barycentric>::ReadFromMessage(
+        /*desired_t_min=*/InfiniteFuture,
+        message);
+    reanimated_ephemeris->SetReanimationParallelism(state.range(1));
+    state.ResumeTiming();
+    reanimated_ephemeris->RequestReanimation(epoch);
+    reanimated_ephemeris->WaitForReanimation(epoch);
+  }
+}
+
+// Compares the scalar computation of the accelerations exerted by the massive
+// bodies on massless bodies with the vectorized one.  The massless bodies are
+// in orbit around the Earth.
+template<bool vectorized>
+void BM_EphemerisMasslessBodiesAccelerations(benchmark::State& state) {
+  auto const at_спутник_1_launch =
+      SolarSystemAtСпутник1Launch(SolarSystemFactory::Accuracy::MajorBodiesOnly);
+  std::vector<Position<Barycentric>> massive_positions;
+  std::vector<GravitationalParameter> μs;
+  for (std::string const& name : at_спутник_1_launch->names()) {
+    massive_positions.push_back(
+        at_спутник_1_launch->degrees_of_freedom(name).position());
+    μs.push_back(at_спутник_1_launch->gravitational_parameter(name));
+  }
+
+  Position<Barycentric> const earth_position =
+      at_спутник_1_launch
+          ->degrees_of_freedom(
+              SolarSystemFactory::name(SolarSystemFactory::Earth))
+          .position();
+  std::vector<Position<Barycentric>> positions;
+  for (int i = 0; i < state.range(0); ++i) {
+    positions.push_back(
+        earth_position +
+        Displacement<Barycentric>({(i + 1) * 10'000 * Kilo(Metre),
+                                   i * 1'000 * Kilo(Metre),
+                                   0 * Metre}));
+  }
+
+  std::vector<Vector<Acceleration, Barycentric>> accelerations(
+      positions.size());
+  MasslessBodiesAccelerations<Barycentric> soa_accelerations;
+  for (auto _ : state) {
+    if constexpr (vectorized) {
+      soa_accelerations.Gather(positions);
+      for (int b1 = 0; b1 < massive_positions.size(); ++b1) {
+        benchmark::DoNotOptimize(soa_accelerations.AddPointMassAccelerations(
+            massive_positions[b1], μs[b1], /*collision_radius=*/1 * Metre));
+      }
+      soa_accelerations.Scatter(accelerations);
+    } else {
+      accelerations.assign(accelerations.size(),
+                           Vector<Acceleration, Barycentric>());
+      for (int b1 = 0; b1 < massive_positions.size(); ++b1) {
+        for (int b2 = 0; b2 < positions.size(); ++b2) {
+          Displacement<Barycentric> const Δq =
+              massive_positions[b1] - positions[b2];
+          Square<Length> const Δq² = Δq.Norm²();
+          Length const Δq_norm = Sqrt(Δq²);
+          benchmark::DoNotOptimize(Δq_norm > 1 * Metre);
+          Exponentiation<Length, -3> const one_over_Δq³ =
+              Δq_norm / (Δq² * Δq²);
+          accelerations[b2] += Δq * (μs[b1] * one_over_Δq³);
+        }
+      }
+    }
+    benchmark::DoNotOptimize(accelerations);
+  }
 }
 
 template<SolarSystemFactory::Accuracy accuracy, Flow* flow>
@@ -553,6 +655,29 @@ void FlowEphemerisWithAdaptiveStep(
       Ephemeris<Barycentric>::unlimited_max_ephemeris_steps));
 }
 
+// Same as above, but with Encke's method: the integrator only sees the
+// deviation from a Keplerian orbit around the Earth, which is rectified when it
+// grows beyond a thousandth of the distance to the Earth.
+void FlowEphemerisWithAdaptiveStepEncke(
+    not_null<DiscreteTrajectory<Barycentric>*> const trajectory,
+    Instant const& t,
+    Ephemeris<Barycentric>& ephemeris) {
+  Ephemeris<Barycentric>::AdaptiveStepParameters parameters(
+      EmbeddedExplicitRungeKuttaNyströmIntegrator<
+          DormandالمكاوىPrince1986RKN434FM,
+          Position<Barycentric>>(),
+      /*max_steps=*/std::numeric_limits<std::int64_t>::max(),
+      /*length_integration_tolerance=*/1 * Metre,
+      /*speed_integration_tolerance=*/1 * Metre / Second);
+  parameters.set_encke_rectification_tolerance(1e-3);
+  CHECK_OK(ephemeris.FlowWithAdaptiveStep(
+      trajectory,
+      Ephemeris<Barycentric>::NoIntrinsicAcceleration,
+      t,
+      parameters,
+      Ephemeris<Barycentric>::unlimited_max_ephemeris_steps));
+}
+
 void FlowEphemerisWithFixedStepSLMS(
     not_null<DiscreteTrajectory<Barycentric>*> const trajectory,
     Instant const& t,
@@ -588,18 +713,47 @@ BENCHMARK(BM_EphemerisMultithreadingBenchmark)
     ->ArgPair(3, 4)
     ->ArgPair(3, 5)
     ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_EphemerisReanimation)
+    ->ArgPair(5, 1)
+    ->ArgPair(5, 2)
+    ->ArgPair(5, 4)
+    ->ArgPair(5, 8)
+    ->Unit(benchmark::kSecond);
+BENCHMARK_TEMPLATE(BM_EphemerisMasslessBodiesAccelerations,
+                   /*vectorized=*/false)
+    ->Arg(1)
+    ->Arg(8)
+    ->Arg(64)
+    ->Arg(512)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_EphemerisMasslessBodiesAccelerations,
+                   /*vectorized=*/true)
+    ->Arg(1)
+    ->Arg(8)
+    ->Arg(64)
+    ->Arg(512)
+    ->Unit(benchmark::kMicrosecond);
 BENCHMARK(BM_EphemerisKSPSystem)->Arg(-3)->Unit(benchmark::kSecond);
 BENCHMARK_TEMPLATE(BM_EphemerisSolarSystem,
                    SolarSystemFactory::Accuracy::MajorBodiesOnly)
-    ->Arg(-3)
+    ->ArgPair(-3, 1)
+    ->ArgPair(-3, 2)
+    ->ArgPair(-3, 4)
+    ->ArgPair(-3, 8)
     ->Unit(benchmark::kSecond);
 BENCHMARK_TEMPLATE(BM_EphemerisSolarSystem,
                    SolarSystemFactory::Accuracy::MinorAndMajorBodies)
-    ->Arg(-3)
+    ->ArgPair(-3, 1)
+    ->ArgPair(-3, 2)
+    ->ArgPair(-3, 4)
+    ->ArgPair(-3, 8)
     ->Unit(benchmark::kSecond);
 BENCHMARK_TEMPLATE(BM_EphemerisSolarSystem,
                    SolarSystemFactory::Accuracy::AllBodiesAndDampedOblateness)
-    ->Arg(-3)
+    ->ArgPair(-3, 1)
+    ->ArgPair(-3, 2)
+    ->ArgPair(-3, 4)
+    ->ArgPair(-3, 8)
     ->Unit(benchmark::kSecond);
 BENCHMARK_TEMPLATE(BM_EphemerisL4Probe,
                    SolarSystemFactory::Accuracy::MajorBodiesOnly,
@@ -621,6 +775,11 @@ BENCHMARK_TEMPLATE(BM_EphemerisLEOProbe,
                    &FlowEphemerisWithAdaptiveStep)
     ->Arg(-3)
     ->Unit(benchmark::kSecond);
+BENCHMARK_TEMPLATE(BM_EphemerisLEOProbe,
+                   SolarSystemFactory::Accuracy::MajorBodiesOnly,
+                   &FlowEphemerisWithAdaptiveStepEncke)
+    ->Arg(-3)
+    ->Unit(benchmark::kSecond);
 BENCHMARK_TEMPLATE(BM_EphemerisLEOProbe,
                    SolarSystemFactory::Accuracy::MajorBodiesOnly,
                    &FlowEphemerisWithFixedStepSLMS)
@@ -651,6 +810,11 @@ BENCHMARK_TEMPLATE(BM_EphemerisLEOProbe,
                    &FlowEphemerisWithAdaptiveStep)
     ->Arg(-3)
     ->Unit(benchmark::kSecond);
+BENCHMARK_TEMPLATE(BM_EphemerisLEOProbe,
+                   SolarSystemFactory::Accuracy::AllBodiesAndDampedOblateness,
+                   &FlowEphemerisWithAdaptiveStepEncke)
+    ->Arg(-3)
+    ->Unit(benchmark::kSecond);
 BENCHMARK_TEMPLATE(BM_EphemerisLEOProbe,
                    SolarSystemFactory::Accuracy::AllBodiesAndDampedOblateness,
                    &FlowEphemerisWithFixedStepSLMS)
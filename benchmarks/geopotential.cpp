@@ -3,6 +3,7 @@
 
 #include "physics/geopotential_body.hpp"
 
+#include <algorithm>
 #include <random>
 #include <vector>
 
@@ -138,13 +139,35 @@ void BM_ComputeGeopotentialCpp(benchmark::State& state) {
                             distribution(random) * Metre})));
   }
 
-  for (auto _ : state) {
-    Vector<Exponentiation<Length, -2>, ICRS> acceleration;
-    for (auto const& displacement : displacements) {
-      acceleration = GeneralSphericalHarmonicsAccelerationCpp(
-                         geopotential, Instant(), displacement);
+  // A batch size of 1 uses the scalar function, larger sizes use the batch
+  // function on consecutive chunks of |displacements|.
+  int const batch_size = state.range(1);
+  std::vector<std::vector<Displacement<ICRS>>> batches;
+  for (int i = 0; i < displacements.size(); i += batch_size) {
+    batches.emplace_back(
+        displacements.begin() + i,
+        displacements.begin() +
+            std::min<std::size_t>(i + batch_size, displacements.size()));
+  }
+
+  if (batch_size == 1) {
+    for (auto _ : state) {
+      Vector<Exponentiation<Length, -2>, ICRS> acceleration;
+      for (auto const& displacement : displacements) {
+        acceleration = GeneralSphericalHarmonicsAccelerationCpp(
+                           geopotential, Instant(), displacement);
+      }
+      benchmark::DoNotOptimize(acceleration);
+    }
+  } else {
+    std::vector<Vector<Exponentiation<Length, -2>, ICRS>> accelerations;
+    for (auto _ : state) {
+      for (auto const& batch : batches) {
+        geopotential.GeneralSphericalHarmonicsAccelerations(
+            Instant(), batch, accelerations);
+      }
+      benchmark::DoNotOptimize(accelerations);
     }
-    benchmark::DoNotOptimize(acceleration);
   }
 }
 
@@ -249,10 +272,22 @@ void BM_ComputeGeopotentialF90(benchmark::State& state) {
 #undef PRINCIPIA_CASE_COMPUTE_GEOPOTENTIAL_F90
 
 BENCHMARK(BM_ComputeGeopotentialCpp)
-    ->Arg(2)
-    ->Arg(3)
-    ->Arg(5)
-    ->Arg(10)
+    ->Args({2, 1})
+    ->Args({2, 4})
+    ->Args({2, 16})
+    ->Args({2, 1000})
+    ->Args({3, 1})
+    ->Args({3, 4})
+    ->Args({3, 16})
+    ->Args({3, 1000})
+    ->Args({5, 1})
+    ->Args({5, 4})
+    ->Args({5, 16})
+    ->Args({5, 1000})
+    ->Args({10, 1})
+    ->Args({10, 4})
+    ->Args({10, 16})
+    ->Args({10, 1000})
     ->Unit(benchmark::kMicrosecond);
 BENCHMARK(BM_ComputeGeopotentialF90)
     ->Arg(2)
@@ -0,0 +1,208 @@
+// .\Release\x64\benchmarks.exe --benchmark_filter=Allocations
+
+// This file replaces the global |operator new| and |operator delete| of the
+// benchmarks to count the heap allocations.  Only the allocations of a thread
+// that is within |SolveRepeatedly| are counted, in thread-local variables, so
+// that the other benchmarks, in particular the multithreaded ones, only pay for
+// a test of a thread-local flag.
+
+#define GLOG_NO_ABBREVIATED_SEVERITIES
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <new>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "base/status_utilities.hpp"
+#include "benchmark/benchmark.h"
+#include "geometry/named_quantities.hpp"
+#include "glog/logging.h"
+#include "integrators/embedded_explicit_generalized_runge_kutta_nyström_integrator.hpp"  // NOLINT(whitespace/line_length)
+#include "integrators/embedded_explicit_runge_kutta_nyström_integrator.hpp"
+#include "integrators/methods.hpp"
+#include "integrators/ordinary_differential_equations.hpp"
+#include "integrators/symmetric_linear_multistep_integrator.hpp"
+#include "integrators/symplectic_runge_kutta_nyström_integrator.hpp"
+#include "quantities/named_quantities.hpp"
+#include "quantities/quantities.hpp"
+#include "quantities/si.hpp"
+#include "testing_utilities/integration.hpp"
+
+namespace {
+
+thread_local bool count_heap_allocations = false;
+thread_local std::int64_t heap_allocations = 0;
+
+}  // namespace
+
+void* operator new(std::size_t const size) {
+  if (count_heap_allocations) {
+    ++heap_allocations;
+  }
+  if (void* const pointer = std::malloc(size == 0 ? 1 : size)) {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* const pointer) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void* const pointer, std::size_t) noexcept {
+  std::free(pointer);
+}
+
+namespace principia {
+namespace integrators {
+
+using geometry::Instant;
+using quantities::Abs;
+using quantities::Acceleration;
+using quantities::Length;
+using quantities::Speed;
+using quantities::Time;
+using quantities::si::Metre;
+using quantities::si::Milli;
+using quantities::si::Second;
+using testing_utilities::ComputeHarmonicOscillatorAcceleration1D;
+using ::std::placeholders::_1;
+using ::std::placeholders::_2;
+using ::std::placeholders::_3;
+
+namespace {
+
+using SpecialODE = SpecialSecondOrderDifferentialEquation<Length>;
+using GeneralODE = ExplicitSecondOrderOrdinaryDifferentialEquation<Length>;
+
+// The interval over which the instances are solved at each iteration, which
+// corresponds to a few steps.
+Time const interval = 1 * Second;
+
+IntegrationProblem<SpecialODE> SpecialHarmonicOscillator() {
+  IntegrationProblem<SpecialODE> problem;
+  problem.equation.compute_acceleration =
+      std::bind(ComputeHarmonicOscillatorAcceleration1D,
+                _1, _2, _3, /*evaluations=*/nullptr);
+  problem.initial_state = {{1 * Metre}, {0 * Metre / Second}, Instant()};
+  return problem;
+}
+
+IntegrationProblem<GeneralODE> GeneralHarmonicOscillator() {
+  IntegrationProblem<GeneralODE> problem;
+  problem.equation.compute_acceleration =
+      [](Instant const& t,
+         std::vector<Length> const& q,
+         std::vector<Speed> const& v,
+         std::vector<Acceleration>& result) {
+        result[0] = -q[0] / (Second * Second);
+        return absl::OkStatus();
+      };
+  problem.initial_state = {{1 * Metre}, {0 * Metre / Second}, Instant()};
+  return problem;
+}
+
+template<typename ODE>
+double ToleranceToErrorRatio(Time const& h,
+                             typename ODE::SystemStateError const& error) {
+  return std::min(1 * Milli(Metre) / Abs(error.position_error[0]),
+                  1 * Milli(Metre) / Second / Abs(error.velocity_error[0]));
+}
+
+template<typename ODE>
+typename AdaptiveStepSizeIntegrator<ODE>::Parameters AdaptiveParameters() {
+  // The last step must not be exact for the instance to be reusable.
+  return typename AdaptiveStepSizeIntegrator<ODE>::Parameters(
+      /*first_step=*/interval,
+      /*safety_factor=*/0.9,
+      /*max_steps=*/std::numeric_limits<std::int64_t>::max(),
+      /*last_step_is_exact=*/false);
+}
+
+// Solves |instance| repeatedly over |interval| and reports the number of heap
+// allocations per step.  The first solve is not counted, as it takes care of
+// the startup of the multistep integrators.
+template<typename ODE>
+void SolveRepeatedly(benchmark::State& state,
+                     typename Integrator<ODE>::Instance& instance,
+                     std::int64_t const& steps) {
+  Instant t = instance.time().value + 10 * interval;
+  CHECK_OK(instance.Solve(t));
+  std::int64_t const initial_steps = steps;
+  std::int64_t allocations = 0;
+  for (auto _ : state) {
+    t += interval;
+    heap_allocations = 0;
+    count_heap_allocations = true;
+    absl::Status const status = instance.Solve(t);
+    count_heap_allocations = false;
+    allocations += heap_allocations;
+    CHECK_OK(status);
+  }
+  state.counters["allocations_per_step"] =
+      static_cast<double>(allocations) / (steps - initial_steps);
+}
+
+}  // namespace
+
+void BM_SymplecticRungeKuttaNyströmIntegratorAllocations(
+    benchmark::State& state) {
+  std::int64_t steps = 0;
+  auto const instance =
+      SymplecticRungeKuttaNyströmIntegrator<methods::BlanesMoan2002SRKN14A,
+                                            Length>()
+          .NewInstance(SpecialHarmonicOscillator(),
+                       [&steps](SpecialODE::SystemState const&) { ++steps; },
+                       /*step=*/0.1 * Second);
+  SolveRepeatedly<SpecialODE>(state, *instance, steps);
+}
+
+void BM_SymmetricLinearMultistepIntegratorAllocations(benchmark::State& state) {
+  std::int64_t steps = 0;
+  auto const instance =
+      SymmetricLinearMultistepIntegrator<methods::Quinlan1999Order8A, Length>()
+          .NewInstance(SpecialHarmonicOscillator(),
+                       [&steps](SpecialODE::SystemState const&) { ++steps; },
+                       /*step=*/0.1 * Second);
+  SolveRepeatedly<SpecialODE>(state, *instance, steps);
+}
+
+void BM_EmbeddedExplicitRungeKuttaNyströmIntegratorAllocations(
+    benchmark::State& state) {
+  std::int64_t steps = 0;
+  auto const instance =
+      EmbeddedExplicitRungeKuttaNyströmIntegrator<
+          methods::DormandالمكاوىPrince1986RKN434FM,
+          Length>()
+          .NewInstance(SpecialHarmonicOscillator(),
+                       [&steps](SpecialODE::SystemState const&) { ++steps; },
+                       &ToleranceToErrorRatio<SpecialODE>,
+                       AdaptiveParameters<SpecialODE>());
+  SolveRepeatedly<SpecialODE>(state, *instance, steps);
+}
+
+void BM_EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegratorAllocations(
+    benchmark::State& state) {
+  std::int64_t steps = 0;
+  auto const instance =
+      EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegrator<
+          methods::Fine1987RKNG34,
+          Length>()
+          .NewInstance(GeneralHarmonicOscillator(),
+                       [&steps](GeneralODE::SystemState const&) { ++steps; },
+                       &ToleranceToErrorRatio<GeneralODE>,
+                       AdaptiveParameters<GeneralODE>());
+  SolveRepeatedly<GeneralODE>(state, *instance, steps);
+}
+
+BENCHMARK(BM_SymplecticRungeKuttaNyströmIntegratorAllocations);
+BENCHMARK(BM_SymmetricLinearMultistepIntegratorAllocations);
+BENCHMARK(BM_EmbeddedExplicitRungeKuttaNyströmIntegratorAllocations);
+BENCHMARK(BM_EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegratorAllocations);
+
+}  // namespace integrators
+}  // namespace principia
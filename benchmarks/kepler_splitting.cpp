@@ -0,0 +1,231 @@
+// .\Release\x64\benchmarks.exe --benchmark_filter=KeplerSplitting
+
+// Compares the Keplerian splitting of the motion of the Sol and KSP systems
+// with the integration of the full Newtonian equation.  The counters give the
+// number of steps per simulated year and the largest position error after a
+// year, so that the steps at equal error may be read off for each method.
+
+#include <algorithm>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "astronomy/stabilize_ksp.hpp"
+#include "base/not_null.hpp"
+#include "base/status_utilities.hpp"
+#include "benchmark/benchmark.h"
+#include "geometry/grassmann.hpp"
+#include "geometry/named_quantities.hpp"
+#include "integrators/methods.hpp"
+#include "integrators/ordinary_differential_equations.hpp"
+#include "integrators/symplectic_partitioned_runge_kutta_integrator.hpp"
+#include "integrators/symplectic_runge_kutta_nyström_integrator.hpp"
+#include "ksp_plugin/frames.hpp"
+#include "physics/kepler_splitting.hpp"
+#include "physics/massive_body.hpp"
+#include "physics/solar_system.hpp"
+#include "quantities/astronomy.hpp"
+#include "quantities/elementary_functions.hpp"
+#include "quantities/quantities.hpp"
+#include "quantities/si.hpp"
+
+namespace principia {
+namespace physics {
+
+using base::make_not_null_unique;
+using base::not_null;
+using geometry::Displacement;
+using geometry::Instant;
+using geometry::Position;
+using geometry::Vector;
+using geometry::Velocity;
+using integrators::IntegrationProblem;
+using integrators::SymplecticPartitionedRungeKuttaIntegrator;
+using integrators::SymplecticRungeKuttaNyströmIntegrator;
+using integrators::methods::BlanesMoan2002S6;
+using integrators::methods::BlanesMoan2002SRKN14A;
+using integrators::methods::NewtonDelambreStørmerVerletLeapfrog;
+using ksp_plugin::Barycentric;
+using quantities::Acceleration;
+using quantities::Length;
+using quantities::Pow;
+using quantities::Time;
+using quantities::astronomy::JulianYear;
+using quantities::si::Metre;
+using quantities::si::Minute;
+
+namespace {
+
+using NewtonianMotionEquation =
+    KeplerSplitting<Barycentric>::NewtonianMotionEquation;
+using DecomposableEquation = KeplerSplitting<Barycentric>::DecomposableEquation;
+
+// The bodies of a solar system, without their geopotentials, and their
+// positions after a year computed with a small step.
+struct NBodySystem {
+  std::vector<not_null<std::unique_ptr<MassiveBody const>>> owned_bodies;
+  std::vector<not_null<MassiveBody const*>> bodies;
+  Instant t_initial;
+  std::vector<Position<Barycentric>> initial_positions;
+  std::vector<Velocity<Barycentric>> initial_velocities;
+  std::vector<Position<Barycentric>> final_positions;
+};
+
+using Solver = std::vector<Position<Barycentric>>(NBodySystem const& system,
+                                                  Time const& step);
+
+NewtonianMotionEquation::RightHandSideComputation Gravitation(
+    std::vector<not_null<MassiveBody const*>> const& bodies) {
+  return [bodies](Instant const& t,
+                  std::vector<Position<Barycentric>> const& positions,
+                  std::vector<Vector<Acceleration, Barycentric>>&
+                      accelerations) {
+    std::fill(accelerations.begin(),
+              accelerations.end(),
+              Vector<Acceleration, Barycentric>());
+    for (int i = 0; i < bodies.size(); ++i) {
+      for (int j = i + 1; j < bodies.size(); ++j) {
+        Displacement<Barycentric> const r = positions[j] - positions[i];
+        auto const r_over_r³ = r / Pow<3>(r.Norm());
+        accelerations[i] += bodies[j]->gravitational_parameter() * r_over_r³;
+        accelerations[j] -= bodies[i]->gravitational_parameter() * r_over_r³;
+      }
+    }
+    return absl::OkStatus();
+  };
+}
+
+// Solves the full Newtonian equation of |system| over a year.
+template<typename Method>
+std::vector<Position<Barycentric>> SolveNewtonian(NBodySystem const& system,
+                                                  Time const& step) {
+  IntegrationProblem<NewtonianMotionEquation> problem;
+  problem.equation.compute_acceleration = Gravitation(system.bodies);
+  problem.initial_state = NewtonianMotionEquation::SystemState(
+      system.initial_positions, system.initial_velocities, system.t_initial);
+  std::vector<Position<Barycentric>> final_positions;
+  auto const append_state =
+      [&final_positions](NewtonianMotionEquation::SystemState const& state) {
+        final_positions.clear();
+        for (auto const& position : state.positions) {
+          final_positions.push_back(position.value);
+        }
+      };
+  auto const instance =
+      SymplecticRungeKuttaNyströmIntegrator<Method, Position<Barycentric>>()
+          .NewInstance(problem, append_state, step);
+  CHECK_OK(instance->Solve(system.t_initial + 1 * JulianYear));
+  return final_positions;
+}
+
+// Solves the Keplerian splitting of |system| over a year.
+template<typename Method>
+std::vector<Position<Barycentric>> SolveSplitting(NBodySystem const& system,
+                                                  Time const& step) {
+  KeplerSplitting<Barycentric> splitting(system.bodies,
+                                         system.initial_positions,
+                                         Gravitation(system.bodies));
+  IntegrationProblem<DecomposableEquation> problem;
+  problem.equation = splitting.equation();
+  problem.initial_state = DecomposableEquation::SystemState(
+      {system.initial_positions, system.initial_velocities}, system.t_initial);
+  std::vector<Position<Barycentric>> final_positions;
+  auto const append_state =
+      [&final_positions](DecomposableEquation::SystemState const& state) {
+        final_positions.clear();
+        for (auto const& position : std::get<0>(state.y)) {
+          final_positions.push_back(position.value);
+        }
+      };
+  auto const instance =
+      SymplecticPartitionedRungeKuttaIntegrator<Method,
+                                                Position<Barycentric>>()
+          .NewInstance(problem, append_state, step);
+  CHECK_OK(instance->Solve(system.t_initial + 1 * JulianYear));
+  return final_positions;
+}
+
+not_null<std::unique_ptr<NBodySystem>> MakeNBodySystem(
+    SolarSystem<Barycentric> const& solar_system) {
+  auto system = make_not_null_unique<NBodySystem>();
+  for (auto& body : solar_system.MakeAllMassiveBodies()) {
+    system->bodies.push_back(body.get());
+    system->owned_bodies.push_back(std::move(body));
+  }
+  system->t_initial = solar_system.epoch();
+  for (auto const& name : solar_system.names()) {
+    auto const degrees_of_freedom = solar_system.degrees_of_freedom(name);
+    system->initial_positions.push_back(degrees_of_freedom.position());
+    system->initial_velocities.push_back(degrees_of_freedom.velocity());
+  }
+  system->final_positions = SolveNewtonian<BlanesMoan2002SRKN14A>(
+      *system, /*step=*/5 * Minute);
+  return system;
+}
+
+NBodySystem const& Sol() {
+  static auto const system = MakeNBodySystem(SolarSystem<Barycentric>(
+      SOLUTION_DIR / "astronomy" / "sol_gravity_model.proto.txt",
+      SOLUTION_DIR / "astronomy" /
+          "sol_initial_state_jd_2436145_604166667.proto.txt",
+      /*ignore_frame=*/true));
+  return *system;
+}
+
+NBodySystem const& KSP() {
+  static auto const system = [] {
+    SolarSystem<Barycentric> solar_system(
+        SOLUTION_DIR / "astronomy" / "kerbol_gravity_model.proto.txt",
+        SOLUTION_DIR / "astronomy" / "kerbol_initial_state_0_0.proto.txt",
+        /*ignore_frame=*/true);
+    astronomy::StabilizeKSP(solar_system);
+    return MakeNBodySystem(solar_system);
+  }();
+  return *system;
+}
+
+}  // namespace
+
+// The argument is the step in minutes.  It must divide a Julian year (525960
+// minutes), lest the integration stop short of the reference positions.
+template<NBodySystem const& (*system)(), Solver* solve>
+void BM_KeplerSplitting(benchmark::State& state) {
+  NBodySystem const& n_body_system = system();
+  Time const step = state.range(0) * Minute;
+  std::vector<Position<Barycentric>> final_positions;
+  for (auto _ : state) {
+    final_positions = solve(n_body_system, step);
+  }
+  Length error;
+  for (int i = 0; i < final_positions.size(); ++i) {
+    error = std::max(
+        error,
+        (final_positions[i] - n_body_system.final_positions[i]).Norm());
+  }
+  state.counters["steps_per_year"] = 1 * JulianYear / step;
+  state.counters["max_error_m"] = error / Metre;
+}
+
+#define PRINCIPIA_KEPLER_SPLITTING_BENCHMARKS(system)                      \
+  BENCHMARK_TEMPLATE(BM_KeplerSplitting,                                   \
+                     system,                                               \
+                     &SolveSplitting<NewtonDelambreStørmerVerletLeapfrog>) \
+      ->Arg(60)->Arg(360)->Arg(1080)->Unit(benchmark::kMillisecond);       \
+  BENCHMARK_TEMPLATE(BM_KeplerSplitting,                                   \
+                     system,                                               \
+                     &SolveSplitting<BlanesMoan2002S6>)                    \
+      ->Arg(60)->Arg(360)->Arg(1080)->Unit(benchmark::kMillisecond);       \
+  BENCHMARK_TEMPLATE(BM_KeplerSplitting,                                   \
+                     system,                                               \
+                     &SolveNewtonian<BlanesMoan2002SRKN14A>)               \
+      ->Arg(10)->Arg(20)->Arg(40)->Unit(benchmark::kMillisecond)
+
+PRINCIPIA_KEPLER_SPLITTING_BENCHMARKS(Sol);
+PRINCIPIA_KEPLER_SPLITTING_BENCHMARKS(KSP);
+
+#undef PRINCIPIA_KEPLER_SPLITTING_BENCHMARKS
+
+}  // namespace physics
+}  // namespace principia
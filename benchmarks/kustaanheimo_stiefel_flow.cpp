@@ -0,0 +1,219 @@
+// .\Release\x64\benchmarks.exe --benchmark_filter=EccentricOrbit
+
+// Compares the number of steps taken by the adaptive integration of eccentric
+// orbits around the Earth, in the full solar system, with the Newtonian
+// equation and with the regularization of Kustaanheimo and Stiefel.  The
+// argument is the decimal logarithm of the integration tolerance in metres
+// (and metres per second).  The counters give the number of steps and the
+// error at the end of the integration, so that the steps at equal error may be
+// read off for each formulation.
+
+#include <cmath>
+#include <limits>
+#include <memory>
+
+#include "absl/status/status.h"
+#include "astronomy/epoch.hpp"
+#include "astronomy/frames.hpp"
+#include "base/not_null.hpp"
+#include "base/status_utilities.hpp"
+#include "benchmark/benchmark.h"
+#include "geometry/named_quantities.hpp"
+#include "integrators/embedded_explicit_runge_kutta_integrator.hpp"
+#include "integrators/embedded_explicit_runge_kutta_nyström_integrator.hpp"
+#include "integrators/methods.hpp"
+#include "integrators/symmetric_linear_multistep_integrator.hpp"
+#include "physics/degrees_of_freedom.hpp"
+#include "physics/discrete_trajectory.hpp"
+#include "physics/ephemeris.hpp"
+#include "physics/kepler_orbit.hpp"
+#include "physics/kustaanheimo_stiefel_flow.hpp"
+#include "physics/massless_body.hpp"
+#include "physics/solar_system.hpp"
+#include "quantities/elementary_functions.hpp"
+#include "quantities/numbers.hpp"
+#include "quantities/quantities.hpp"
+#include "quantities/si.hpp"
+
+namespace principia {
+namespace physics {
+
+using astronomy::ICRS;
+using astronomy::J2000;
+using base::not_null;
+using geometry::Instant;
+using geometry::Position;
+using integrators::EmbeddedExplicitRungeKuttaIntegrator;
+using integrators::EmbeddedExplicitRungeKuttaNyströmIntegrator;
+using integrators::SymmetricLinearMultistepIntegrator;
+using integrators::methods::DormandPrince1986RK547FC;
+using integrators::methods::DormandالمكاوىPrince1986RKN434FM;
+using integrators::methods::QuinlanTremaine1990Order12;
+using quantities::ArcSin;
+using quantities::Length;
+using quantities::Sqrt;
+using quantities::Time;
+using quantities::si::Day;
+using quantities::si::Kilo;
+using quantities::si::Metre;
+using quantities::si::Milli;
+using quantities::si::Minute;
+using quantities::si::Radian;
+using quantities::si::Second;
+
+namespace {
+
+Time const integration_duration = 10 * Day;
+
+using Flow = absl::Status(not_null<DiscreteTrajectory<ICRS>*> trajectory,
+                          Length const& tolerance);
+
+SolarSystem<ICRS> const& Sol() {
+  static SolarSystem<ICRS> const solar_system(
+      SOLUTION_DIR / "astronomy" / "sol_gravity_model.proto.txt",
+      SOLUTION_DIR / "astronomy" /
+          "sol_initial_state_jd_2451545_000000000.proto.txt");
+  return solar_system;
+}
+
+Ephemeris<ICRS>& SolEphemeris() {
+  static not_null<std::unique_ptr<Ephemeris<ICRS>>> const ephemeris = [] {
+    auto ephemeris = Sol().MakeEphemeris(
+        /*accuracy_parameters=*/{/*fitting_tolerance=*/5 * Milli(Metre),
+                                 /*geopotential_tolerance=*/0x1p-24},
+        Ephemeris<ICRS>::FixedStepParameters(
+            SymmetricLinearMultistepIntegrator<QuinlanTremaine1990Order12,
+                                               Position<ICRS>>(),
+            /*step=*/10 * Minute));
+    CHECK_OK(ephemeris->Prolong(J2000 + integration_duration));
+    return ephemeris;
+  }();
+  return *ephemeris;
+}
+
+not_null<MassiveBody const*> Earth() {
+  return Sol().massive_body(SolEphemeris(), "Earth");
+}
+
+// From https://en.wikipedia.org/wiki/Molniya_orbit, as in the Молния test.
+KeplerianElements<ICRS> Молния() {
+  Time const sidereal_day = Day * 365.2425 / 366.2425;
+  KeplerianElements<ICRS> elements;
+  elements.eccentricity = 0.74105;
+  elements.mean_motion = 2.0 * π * Radian / (sidereal_day / 2.0);
+  elements.inclination = ArcSin(2.0 / Sqrt(5.0));
+  elements.argument_of_periapsis = -π / 2.0 * Radian;
+  elements.longitude_of_ascending_node = 1 * Radian;
+  elements.mean_anomaly = 2 * Radian;
+  return elements;
+}
+
+// A highly eccentric orbit with a periapsis 300 km above the surface of the
+// Earth and a period of about 2 days.
+KeplerianElements<ICRS> HighlyEccentric() {
+  KeplerianElements<ICRS> elements;
+  elements.eccentricity = 0.9;
+  elements.periapsis_distance = 6678 * Kilo(Metre);
+  elements.inclination = 0.5 * Radian;
+  elements.argument_of_periapsis = 1 * Radian;
+  elements.longitude_of_ascending_node = 2 * Radian;
+  elements.mean_anomaly = 0 * Radian;
+  return elements;
+}
+
+absl::Status FlowNewtonian(not_null<DiscreteTrajectory<ICRS>*> const trajectory,
+                           Length const& tolerance) {
+  return SolEphemeris().FlowWithAdaptiveStep(
+      trajectory,
+      Ephemeris<ICRS>::NoIntrinsicAcceleration,
+      J2000 + integration_duration,
+      Ephemeris<ICRS>::AdaptiveStepParameters(
+          EmbeddedExplicitRungeKuttaNyströmIntegrator<
+              DormandالمكاوىPrince1986RKN434FM,
+              Position<ICRS>>(),
+          /*max_steps=*/std::numeric_limits<std::int64_t>::max(),
+          /*length_integration_tolerance=*/tolerance,
+          /*speed_integration_tolerance=*/tolerance / Second),
+      Ephemeris<ICRS>::unlimited_max_ephemeris_steps);
+}
+
+absl::Status FlowKustaanheimoStiefel(
+    not_null<DiscreteTrajectory<ICRS>*> const trajectory,
+    Length const& tolerance) {
+  KustaanheimoStiefelFlow<ICRS> flow(
+      KustaanheimoStiefelFlow<ICRS>::AdaptiveParameters(
+          EmbeddedExplicitRungeKuttaIntegrator<
+              DormandPrince1986RK547FC,
+              KustaanheimoStiefelFlow<ICRS>::IndependentVariable,
+              double,
+              double,
+              double,
+              Instant>(),
+          /*max_steps=*/std::numeric_limits<std::int64_t>::max(),
+          /*length_integration_tolerance=*/tolerance,
+          /*speed_integration_tolerance=*/tolerance / Second),
+      &SolEphemeris(),
+      Earth());
+  return flow.FlowWithAdaptiveStep(trajectory, J2000 + integration_duration);
+}
+
+DegreesOfFreedom<ICRS> InitialDegreesOfFreedom(
+    KeplerianElements<ICRS> const& elements) {
+  KeplerOrbit<ICRS> const orbit(*Earth(), MasslessBody{}, elements, J2000);
+  return Sol().degrees_of_freedom("Earth") + orbit.StateVectors(J2000);
+}
+
+// The final position computed with a Newtonian integration with a very small
+// tolerance.
+template<KeplerianElements<ICRS> (*elements)()>
+Position<ICRS> const& ReferenceFinalPosition() {
+  static Position<ICRS> const position = [] {
+    DiscreteTrajectory<ICRS> trajectory;
+    CHECK_OK(trajectory.Append(J2000, InitialDegreesOfFreedom(elements())));
+    CHECK_OK(FlowNewtonian(&trajectory, /*tolerance=*/1e-6 * Metre));
+    return trajectory.back().degrees_of_freedom.position();
+  }();
+  return position;
+}
+
+}  // namespace
+
+template<KeplerianElements<ICRS> (*elements)(), Flow* flow>
+void BM_EccentricOrbit(benchmark::State& state) {
+  Length const tolerance = std::pow(10.0, state.range(0)) * Metre;
+  DegreesOfFreedom<ICRS> const initial_degrees_of_freedom =
+      InitialDegreesOfFreedom(elements());
+  Position<ICRS> const& reference_final_position =
+      ReferenceFinalPosition<elements>();
+
+  std::int64_t steps;
+  Length error;
+  for (auto _ : state) {
+    state.PauseTiming();
+    DiscreteTrajectory<ICRS> trajectory;
+    CHECK_OK(trajectory.Append(J2000, initial_degrees_of_freedom));
+    state.ResumeTiming();
+    CHECK_OK(flow(&trajectory, tolerance));
+    state.PauseTiming();
+    steps = trajectory.size() - 1;
+    error = (trajectory.back().degrees_of_freedom.position() -
+             reference_final_position).Norm();
+    state.ResumeTiming();
+  }
+  state.counters["steps"] = steps;
+  state.counters["error_m"] = error / Metre;
+}
+
+#define PRINCIPIA_ECCENTRIC_ORBIT_BENCHMARKS(elements)                        \
+  BENCHMARK_TEMPLATE(BM_EccentricOrbit, &elements, &FlowNewtonian)            \
+      ->Arg(-3)->Arg(0)->Unit(benchmark::kMillisecond);                       \
+  BENCHMARK_TEMPLATE(BM_EccentricOrbit, &elements, &FlowKustaanheimoStiefel)  \
+      ->Arg(-3)->Arg(0)->Unit(benchmark::kMillisecond)
+
+PRINCIPIA_ECCENTRIC_ORBIT_BENCHMARKS(Молния);
+PRINCIPIA_ECCENTRIC_ORBIT_BENCHMARKS(HighlyEccentric);
+
+#undef PRINCIPIA_ECCENTRIC_ORBIT_BENCHMARKS
+
+}  // namespace physics
+}  // namespace principia
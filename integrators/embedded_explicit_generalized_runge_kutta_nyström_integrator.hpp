@@ -15,6 +15,7 @@
 #include "absl/status/status.h"
 #include "base/not_null.hpp"
 #include "numerics/fixed_arrays.hpp"
+#include "numerics/hermite5.hpp"
 #include "integrators/methods.hpp"
 #include "integrators/ordinary_differential_equations.hpp"
 #include "quantities/named_quantities.hpp"
@@ -28,6 +29,7 @@ using base::not_null;
 using geometry::Instant;
 using numerics::FixedStrictlyLowerTriangularMatrix;
 using numerics::FixedVector;
+using numerics::Hermite5;
 using quantities::Time;
 using quantities::Variation;
 
@@ -76,6 +78,12 @@ class EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegrator
   static constexpr auto lower_order = Method::lower_order;
   static constexpr auto first_same_as_last = Method::first_same_as_last;
 
+  // Called after each accepted step with the continuous extensions of the
+  // positions over that step, one for each dimension of the system, see
+  // |NewInstance|.
+  using DenseOutput = std::function<void(
+      std::vector<Hermite5<Instant, Position>> const& interpolants)>;
+
   EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegrator();
 
   EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegrator(
@@ -115,6 +123,7 @@ class EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegrator
    private:
     Instance(IntegrationProblem<ODE> const& problem,
              AppendState const& append_state,
+             DenseOutput const& dense_output,
              ToleranceToErrorRatio const& tolerance_to_error_ratio,
              Parameters const& parameters,
              Time const& time_step,
@@ -122,6 +131,21 @@ class EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegrator
              EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegrator const&
                  integrator);
 
+    DenseOutput const dense_output_;
+
+    // Buffers used by |Solve|.  They are sized at construction so that solving
+    // the instance repeatedly does not allocate.
+    typename ODE::SystemState final_state_;
+    std::vector<typename ODE::Displacement> Δq̂_;
+    std::vector<typename ODE::Velocity> Δv̂_;
+    typename ODE::SystemStateError error_estimate_;
+    std::vector<Position> q_stage_;
+    std::vector<typename ODE::Velocity> v_stage_;
+    std::vector<std::vector<typename ODE::Acceleration>> g_;
+    std::vector<Position> q_start_;
+    std::vector<typename ODE::Velocity> v_start_;
+    std::vector<Hermite5<Instant, Position>> interpolants_;
+
     EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegrator const& integrator_;
     friend class EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegrator;
   };
@@ -132,6 +156,20 @@ class EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegrator
       ToleranceToErrorRatio const& tolerance_to_error_ratio,
       Parameters const& parameters) const override;
 
+  // Same as above, but |dense_output| is called after each accepted step,
+  // before |append_state|.  The continuous extensions are quintic Hermite
+  // interpolants of the positions, velocities and accelerations at the ends of
+  // the step, so their error is of the same order as that of the method.  With
+  // a method that is not FSAL, the acceleration at the end of a step is reused
+  // for the first stage of the next one, so this costs at most one more
+  // evaluation of the right-hand side for each call to |Solve|.
+  not_null<std::unique_ptr<typename Integrator<ODE>::Instance>> NewInstance(
+      IntegrationProblem<ODE> const& problem,
+      AppendState const& append_state,
+      DenseOutput const& dense_output,
+      ToleranceToErrorRatio const& tolerance_to_error_ratio,
+      Parameters const& parameters) const;
+
   void WriteToMessage(
       not_null<serialization::AdaptiveStepSizeIntegrator*> message)
       const override;
@@ -7,6 +7,7 @@
 #include <cmath>
 #include <ctime>
 #include <optional>
+#include <utility>
 #include <vector>
 
 #include "base/jthread.hpp"
@@ -67,7 +68,8 @@ absl::Status EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegrator<
   // restartability.
 
   // State before the last, truncated step.
-  std::optional<typename ODE::SystemState> final_state;
+  typename ODE::SystemState& final_state = final_state_;
+  bool has_final_state = false;
 
   // Argument checks.
   int const dimension = current_state.positions.size();
@@ -90,9 +92,9 @@ absl::Status EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegrator<
   DoublePrecision<Instant>& t = current_state.time;
 
   // Position increment (high-order).
-  std::vector<Displacement> Δq̂(dimension);
+  std::vector<Displacement>& Δq̂ = Δq̂_;
   // Velocity increment (high-order).
-  std::vector<Velocity> Δv̂(dimension);
+  std::vector<Velocity>& Δv̂ = Δv̂_;
   // Current position.  This is a non-const reference whose purpose is to make
   // the equations more readable.
   std::vector<DoublePrecision<Position>>& q̂ = current_state.positions;
@@ -101,19 +103,20 @@ absl::Status EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegrator<
   std::vector<DoublePrecision<Velocity>>& v̂ = current_state.velocities;
 
   // Difference between the low- and high-order approximations.
-  typename ODE::SystemStateError error_estimate;
-  error_estimate.position_error.resize(dimension);
-  error_estimate.velocity_error.resize(dimension);
+  typename ODE::SystemStateError& error_estimate = error_estimate_;
 
   // Current Runge-Kutta-Nyström stage.
-  std::vector<Position> q_stage(dimension);
-  std::vector<Velocity> v_stage(dimension);
+  std::vector<Position>& q_stage = q_stage_;
+  std::vector<Velocity>& v_stage = v_stage_;
   // Accelerations at each stage.
   // TODO(egg): this is a rectangular container, use something more appropriate.
-  std::vector<std::vector<Acceleration>> g(stages_);
-  for (auto& g_stage : g) {
-    g_stage.resize(dimension);
-  }
+  std::vector<std::vector<Acceleration>>& g = g_;
+
+  // The state at the beginning of the current step and the continuous
+  // extensions over that step, only used if there is a |dense_output_|.
+  std::vector<Position>& q_start = q_start_;
+  std::vector<Velocity>& v_start = v_start_;
+  std::vector<Hermite5<Instant, Position>>& interpolants = interpolants_;
 
   bool at_end = false;
   double tolerance_to_error_ratio;
@@ -172,6 +175,7 @@ absl::Status EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegrator<
           // last stage below.
           h = time_to_end;
           final_state = current_state;
+          has_final_state = true;
         }
       }
 
@@ -230,6 +234,7 @@ absl::Status EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegrator<
     if (!parameters.last_step_is_exact && t.value + (t.error + h) > t_final) {
       // We did overshoot.  Drop the point that we just computed and exit.
       final_state = current_state;
+      has_final_state = true;
       break;
     }
 
@@ -239,6 +244,14 @@ absl::Status EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegrator<
       first_stage = 1;
     }
 
+    Instant const t_start = t.value;
+    if (dense_output_ != nullptr) {
+      for (int k = 0; k < dimension; ++k) {
+        q_start[k] = q̂[k].value;
+        v_start[k] = v̂[k].value;
+      }
+    }
+
     // Increment the solution with the high-order approximation.
     t.Increment(h);
     for (int k = 0; k < dimension; ++k) {
@@ -246,6 +259,33 @@ absl::Status EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegrator<
       v̂[k].Increment(Δv̂[k]);
     }
     RETURN_IF_STOPPED;
+    if (dense_output_ != nullptr) {
+      if (!first_same_as_last) {
+        // Compute the acceleration at the end of the step.  This is exactly the
+        // first stage of the next step, so we don't compute it again.
+        for (int k = 0; k < dimension; ++k) {
+          q_stage[k] = q̂[k].value;
+          v_stage[k] = v̂[k].value;
+        }
+        termination_condition::UpdateWithAbort(
+            equation.compute_acceleration(
+                t.value + t.error, q_stage, v_stage, g.back()),
+            status);
+        using std::swap;
+        swap(g.front(), g.back());
+        first_stage = 1;
+      }
+      // At this point |g.back()| holds the accelerations at the beginning of
+      // the step and |g.front()| those at the end.
+      interpolants.clear();
+      for (int k = 0; k < dimension; ++k) {
+        interpolants.emplace_back(std::pair{t_start, t.value},
+                                  std::pair{q_start[k], q̂[k].value},
+                                  std::pair{v_start[k], v̂[k].value},
+                                  std::pair{g.back()[k], g.front()[k]});
+      }
+      dense_output_(interpolants);
+    }
     append_state(current_state);
     ++step_count;
     if (absl::IsAborted(step_status)) {
@@ -260,8 +300,8 @@ absl::Status EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegrator<
     }
   }
   // The resolution is restartable from the last non-truncated state.
-  CHECK(final_state);
-  current_state = *final_state;
+  CHECK(has_final_state);
+  current_state = final_state;
   return status;
 }
 
@@ -316,6 +356,7 @@ Instance::ReadFromMessage(
   // private.
   return std::unique_ptr<Instance>(new Instance(problem,
                                                 append_state,
+                                                /*dense_output=*/nullptr,
                                                 tolerance_to_error_ratio,
                                                 parameters,
                                                 time_step,
@@ -328,6 +369,7 @@ EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegrator<Method, Position>::
 Instance::Instance(
     IntegrationProblem<ODE> const& problem,
     AppendState const& append_state,
+    DenseOutput const& dense_output,
     ToleranceToErrorRatio const& tolerance_to_error_ratio,
     Parameters const& parameters,
     Time const& time_step,
@@ -339,7 +381,46 @@ Instance::Instance(
                                                 parameters,
                                                 time_step,
                                                 first_use),
-      integrator_(integrator) {}
+      dense_output_(dense_output),
+      final_state_(problem.initial_state),
+      Δq̂_(problem.initial_state.positions.size()),
+      Δv̂_(problem.initial_state.positions.size()),
+      q_stage_(problem.initial_state.positions.size()),
+      v_stage_(problem.initial_state.positions.size()),
+      g_(stages_,
+         std::vector<typename ODE::Acceleration>(
+             problem.initial_state.positions.size())),
+      integrator_(integrator) {
+  int const dimension = problem.initial_state.positions.size();
+  error_estimate_.position_error.resize(dimension);
+  error_estimate_.velocity_error.resize(dimension);
+  if (dense_output_ != nullptr) {
+    q_start_.resize(dimension);
+    v_start_.resize(dimension);
+    interpolants_.reserve(dimension);
+  }
+}
+
+template<typename Method, typename Position>
+not_null<std::unique_ptr<typename Integrator<
+    ExplicitSecondOrderOrdinaryDifferentialEquation<Position>>::Instance>>
+EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegrator<Method, Position>::
+NewInstance(IntegrationProblem<ODE> const& problem,
+            AppendState const& append_state,
+            ToleranceToErrorRatio const& tolerance_to_error_ratio,
+            Parameters const& parameters) const {
+  // Cannot use |make_not_null_unique| because the constructor of |Instance| is
+  // private.
+  return std::unique_ptr<Instance>(
+      new Instance(problem,
+                   append_state,
+                   /*dense_output=*/nullptr,
+                   tolerance_to_error_ratio,
+                   parameters,
+                   /*time_step=*/parameters.first_step,
+                   /*first_use=*/true,
+                   *this));
+}
 
 template<typename Method, typename Position>
 not_null<std::unique_ptr<typename Integrator<
@@ -347,6 +428,7 @@ not_null<std::unique_ptr<typename Integrator<
 EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegrator<Method, Position>::
 NewInstance(IntegrationProblem<ODE> const& problem,
             AppendState const& append_state,
+            DenseOutput const& dense_output,
             ToleranceToErrorRatio const& tolerance_to_error_ratio,
             Parameters const& parameters) const {
   // Cannot use |make_not_null_unique| because the constructor of |Instance| is
@@ -354,6 +436,7 @@ NewInstance(IntegrationProblem<ODE> const& problem,
   return std::unique_ptr<Instance>(
       new Instance(problem,
                    append_state,
+                   dense_output,
                    tolerance_to_error_ratio,
                    parameters,
                    /*time_step=*/parameters.first_step,
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <limits>
+#include <utility>
 #include <vector>
 
 #include "base/macros.hpp"
@@ -148,6 +149,111 @@ TEST_F(EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegratorTest, Legendre) {
   EXPECT_THAT(max_derivative_error, IsNear(4.54e-3_(1) / Second));
 }
 
+TEST_F(EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegratorTest,
+       DenseOutput) {
+  auto const& integrator =
+      EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegrator<
+          methods::Fine1987RKNG34,
+          double>();
+  constexpr int degree = 3;
+  double const x_initial = 0;
+  Variation<double> const v_initial = -3 / (2 * Second);
+  Instant const t_initial;
+  Instant const t_final = t_initial + 0.99 * Second;
+  double const tolerance = 1e-6;
+  Variation<double> const derivative_tolerance = 1e-6 / Second;
+
+  int evaluations = 0;
+  std::vector<ODE::SystemState> solution;
+  ODE legendre_equation;
+  legendre_equation.compute_acceleration =
+      std::bind(ComputeLegendrePolynomialSecondDerivative<degree>,
+                _1, _2, _3, _4, &evaluations);
+  IntegrationProblem<ODE> problem;
+  problem.equation = legendre_equation;
+  problem.initial_state = {{x_initial}, {v_initial}, t_initial};
+  auto const append_state = [&solution](ODE::SystemState const& state) {
+    solution.push_back(state);
+  };
+  AdaptiveStepSizeIntegrator<ODE>::Parameters const parameters(
+      /*first_step=*/t_final - t_initial,
+      /*safety_factor=*/0.9);
+  auto const tolerance_to_error_ratio = std::bind(ToleranceToErrorRatio,
+                                                  _1,
+                                                  _2,
+                                                  tolerance,
+                                                  derivative_tolerance,
+                                                  [](bool tolerable) {});
+
+  // Without dense output.
+  {
+    auto instance = integrator.NewInstance(
+        problem, append_state, tolerance_to_error_ratio, parameters);
+    EXPECT_THAT(instance->Solve(t_final),
+                StatusIs(termination_condition::Done));
+  }
+  std::vector<ODE::SystemState> const expected_solution = std::move(solution);
+  int const expected_evaluations = evaluations;
+
+  // With dense output.
+  solution.clear();
+  evaluations = 0;
+  std::vector<Hermite5<Instant, double>> interpolants;
+  auto const dense_output =
+      [&interpolants](
+          std::vector<Hermite5<Instant, double>> const& step_interpolants) {
+        interpolants.push_back(step_interpolants[0]);
+      };
+  {
+    auto instance = integrator.NewInstance(problem,
+                                           append_state,
+                                           dense_output,
+                                           tolerance_to_error_ratio,
+                                           parameters);
+    EXPECT_THAT(instance->Solve(t_final),
+                StatusIs(termination_condition::Done));
+  }
+
+  // The method is not FSAL, but the acceleration at the end of a step is reused
+  // for the next one, so the solution is unchanged and the dense output costs
+  // at most one evaluation.
+  ASSERT_EQ(expected_solution.size(), solution.size());
+  for (int i = 0; i < solution.size(); ++i) {
+    EXPECT_EQ(expected_solution[i].time.value, solution[i].time.value);
+    EXPECT_EQ(expected_solution[i].positions[0].value,
+              solution[i].positions[0].value);
+    EXPECT_EQ(expected_solution[i].velocities[0].value,
+              solution[i].velocities[0].value);
+  }
+  EXPECT_LE(evaluations, expected_evaluations + 1);
+
+  // The interpolants are about as accurate as the solution at the ends of the
+  // steps.
+  ASSERT_EQ(solution.size(), interpolants.size());
+  double max_error{};
+  double max_interpolation_error{};
+  for (int i = 0; i < interpolants.size(); ++i) {
+    auto const& interpolant = interpolants[i];
+    Instant const& t0 = interpolant.lower_bound();
+    Instant const& t1 = interpolant.upper_bound();
+    EXPECT_EQ(solution[i].time.value, t1);
+    double const x1 = (t1 - t_initial) / (1 * Second);
+    max_error = std::max(
+        max_error,
+        AbsoluteError(LegendrePolynomial<degree, EstrinEvaluator>()(x1),
+                      solution[i].positions[0].value));
+    for (int j = 1; j < 8; ++j) {
+      Instant const t = t0 + j * (t1 - t0) / 8;
+      double const x = (t - t_initial) / (1 * Second);
+      max_interpolation_error = std::max(
+          max_interpolation_error,
+          AbsoluteError(LegendrePolynomial<degree, EstrinEvaluator>()(x),
+                        interpolant.Evaluate(t)));
+    }
+  }
+  EXPECT_THAT(max_interpolation_error, Lt(2 * max_error));
+}
+
 }  // namespace internal_embedded_explicit_generalized_runge_kutta_nyström_integrator  // NOLINT
 }  // namespace integrators
 }  // namespace principia
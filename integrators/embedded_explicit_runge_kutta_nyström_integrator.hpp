@@ -15,6 +15,7 @@
 #include "absl/status/status.h"
 #include "base/not_null.hpp"
 #include "numerics/fixed_arrays.hpp"
+#include "numerics/hermite5.hpp"
 #include "integrators/methods.hpp"
 #include "integrators/ordinary_differential_equations.hpp"
 #include "quantities/named_quantities.hpp"
@@ -28,6 +29,7 @@ using base::not_null;
 using geometry::Instant;
 using numerics::FixedStrictlyLowerTriangularMatrix;
 using numerics::FixedVector;
+using numerics::Hermite5;
 using quantities::Time;
 using quantities::Variation;
 
@@ -71,6 +73,12 @@ class EmbeddedExplicitRungeKuttaNyströmIntegrator
   static constexpr auto lower_order = Method::lower_order;
   static constexpr auto first_same_as_last = Method::first_same_as_last;
 
+  // Called after each accepted step with the continuous extensions of the
+  // positions over that step, one for each dimension of the system, see
+  // |NewInstance|.
+  using DenseOutput = std::function<void(
+      std::vector<Hermite5<Instant, Position>> const& interpolants)>;
+
   EmbeddedExplicitRungeKuttaNyströmIntegrator();
 
   EmbeddedExplicitRungeKuttaNyströmIntegrator(
@@ -109,12 +117,27 @@ class EmbeddedExplicitRungeKuttaNyströmIntegrator
    private:
     Instance(IntegrationProblem<ODE> const& problem,
              AppendState const& append_state,
+             DenseOutput const& dense_output,
              ToleranceToErrorRatio const& tolerance_to_error_ratio,
              Parameters const& parameters,
              Time const& time_step,
              bool first_use,
              EmbeddedExplicitRungeKuttaNyströmIntegrator const& integrator);
 
+    DenseOutput const dense_output_;
+
+    // Buffers used by |Solve|.  They are sized at construction so that solving
+    // the instance repeatedly does not allocate.
+    typename ODE::SystemState final_state_;
+    std::vector<typename ODE::Displacement> Δq̂_;
+    std::vector<typename ODE::Velocity> Δv̂_;
+    typename ODE::SystemStateError error_estimate_;
+    std::vector<Position> q_stage_;
+    std::vector<std::vector<typename ODE::Acceleration>> g_;
+    std::vector<Position> q_start_;
+    std::vector<typename ODE::Velocity> v_start_;
+    std::vector<Hermite5<Instant, Position>> interpolants_;
+
     EmbeddedExplicitRungeKuttaNyströmIntegrator const& integrator_;
     friend class EmbeddedExplicitRungeKuttaNyströmIntegrator;
   };
@@ -125,6 +148,70 @@ class EmbeddedExplicitRungeKuttaNyströmIntegrator
       ToleranceToErrorRatio const& tolerance_to_error_ratio,
       Parameters const& parameters) const override;
 
+  // Same as above, but |dense_output| is called after each accepted step,
+  // before |append_state|.  The continuous extensions are quintic Hermite
+  // interpolants of the positions, velocities and accelerations at the ends of
+  // the step, so their error is of the same order as that of the method.  With
+  // a method that is not FSAL, the acceleration at the end of a step is reused
+  // for the first stage of the next one, so this costs at most one more
+  // evaluation of the right-hand side for each call to |Solve|.
+  not_null<std::unique_ptr<typename Integrator<ODE>::Instance>> NewInstance(
+      IntegrationProblem<ODE> const& problem,
+      AppendState const& append_state,
+      DenseOutput const& dense_output,
+      ToleranceToErrorRatio const& tolerance_to_error_ratio,
+      Parameters const& parameters) const;
+
+  // The right-hand side of a batch of independent problems, see |SolveBatch|.
+  // Entry k of |accelerations| and |statuses| must be computed from entry k of
+  // |times| and |positions|, which pertain to the problem at index
+  // |problems[k]| in the batch.  The |accelerations| and |statuses| have the
+  // right size, and the |statuses| are OK, on entry.
+  using BatchedRightHandSideComputation = std::function<void(
+      std::vector<int> const& problems,
+      std::vector<Instant> const& times,
+      std::vector<Position> const& positions,
+      std::vector<typename ODE::Acceleration>& accelerations,
+      std::vector<absl::Status>& statuses)>;
+
+  // A problem of one degree of freedom, solved as part of a batch, see
+  // |SolveBatch|, or by itself, see |SolveSingle|.
+  struct BatchedProblem {
+    typename ODE::SystemState initial_state;
+    Instant t_final;
+    AppendState append_state;
+    ToleranceToErrorRatio tolerance_to_error_ratio;
+    Parameters parameters;
+  };
+
+  // Solves the |problems| in lockstep.  Each problem has its own step size
+  // control, exactly as if it were solved by its own instance, but the
+  // right-hand side is computed in a single call of |compute_accelerations|
+  // for each stage of the steps attempted by all the problems.  A problem
+  // retires from the batch when it reaches its |t_final|, its |max_steps|, or
+  // a vanishing step size.  Returns the status of each problem.  The
+  // integration is not restartable.
+  std::vector<absl::Status> SolveBatch(
+      std::vector<BatchedProblem> const& problems,
+      BatchedRightHandSideComputation const& compute_accelerations) const;
+
+  // The right-hand side of a problem of one degree of freedom, see
+  // |SolveSingle|.
+  using SingleRightHandSideComputation = std::function<absl::Status(
+      Instant const& t,
+      Position const& position,
+      typename ODE::Acceleration& acceleration)>;
+
+  // Solves a |problem| of one degree of freedom.  This yields exactly the same
+  // states as an instance would, but the accelerations at the stages are held
+  // in an array and the increments in scalars, so the loops on the stages have
+  // compile-time bounds and there is no indirection through vectors of
+  // dimension 1, which dominates the cost of a step of a single massless body.
+  // The integration is not restartable.
+  absl::Status SolveSingle(
+      BatchedProblem const& problem,
+      SingleRightHandSideComputation const& compute_acceleration) const;
+
   void WriteToMessage(
       not_null<serialization::AdaptiveStepSizeIntegrator*> message)
       const override;
@@ -4,9 +4,11 @@
 #include "integrators/embedded_explicit_runge_kutta_nyström_integrator.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <ctime>
 #include <optional>
+#include <utility>
 #include <vector>
 
 #include "base/jthread.hpp"
@@ -65,7 +67,8 @@ Instance::Solve(Instant const& t_final) {
   // restartability.
 
   // State before the last, truncated step.
-  std::optional<typename ODE::SystemState> final_state;
+  typename ODE::SystemState& final_state = final_state_;
+  bool has_final_state = false;
 
   // Argument checks.
   int const dimension = current_state.positions.size();
@@ -88,9 +91,9 @@ Instance::Solve(Instant const& t_final) {
   DoublePrecision<Instant>& t = current_state.time;
 
   // Position increment (high-order).
-  std::vector<Displacement> Δq̂(dimension);
+  std::vector<Displacement>& Δq̂ = Δq̂_;
   // Velocity increment (high-order).
-  std::vector<Velocity> Δv̂(dimension);
+  std::vector<Velocity>& Δv̂ = Δv̂_;
   // Current position.  This is a non-const reference whose purpose is to make
   // the equations more readable.
   std::vector<DoublePrecision<Position>>& q̂ = current_state.positions;
@@ -99,18 +102,19 @@ Instance::Solve(Instant const& t_final) {
   std::vector<DoublePrecision<Velocity>>& v̂ = current_state.velocities;
 
   // Difference between the low- and high-order approximations.
-  typename ODE::SystemStateError error_estimate;
-  error_estimate.position_error.resize(dimension);
-  error_estimate.velocity_error.resize(dimension);
+  typename ODE::SystemStateError& error_estimate = error_estimate_;
 
   // Current Runge-Kutta-Nyström stage.
-  std::vector<Position> q_stage(dimension);
+  std::vector<Position>& q_stage = q_stage_;
   // Accelerations at each stage.
   // TODO(egg): this is a rectangular container, use something more appropriate.
-  std::vector<std::vector<Acceleration>> g(stages_);
-  for (auto& g_stage : g) {
-    g_stage.resize(dimension);
-  }
+  std::vector<std::vector<Acceleration>>& g = g_;
+
+  // The state at the beginning of the current step and the continuous
+  // extensions over that step, only used if there is a |dense_output_|.
+  std::vector<Position>& q_start = q_start_;
+  std::vector<Velocity>& v_start = v_start_;
+  std::vector<Hermite5<Instant, Position>>& interpolants = interpolants_;
 
   bool at_end = false;
   double tolerance_to_error_ratio;
@@ -169,6 +173,7 @@ Instance::Solve(Instant const& t_final) {
           // last stage below.
           h = time_to_end;
           final_state = current_state;
+          has_final_state = true;
         }
       }
 
@@ -223,6 +228,7 @@ Instance::Solve(Instant const& t_final) {
     if (!parameters.last_step_is_exact && t.value + (t.error + h) > t_final) {
       // We did overshoot.  Drop the point that we just computed and exit.
       final_state = current_state;
+      has_final_state = true;
       break;
     }
 
@@ -232,6 +238,14 @@ Instance::Solve(Instant const& t_final) {
       first_stage = 1;
     }
 
+    Instant const t_start = t.value;
+    if (dense_output_ != nullptr) {
+      for (int k = 0; k < dimension; ++k) {
+        q_start[k] = q̂[k].value;
+        v_start[k] = v̂[k].value;
+      }
+    }
+
     // Increment the solution with the high-order approximation.
     t.Increment(h);
     for (int k = 0; k < dimension; ++k) {
@@ -239,6 +253,31 @@ Instance::Solve(Instant const& t_final) {
       v̂[k].Increment(Δv̂[k]);
     }
     RETURN_IF_STOPPED;
+    if (dense_output_ != nullptr) {
+      if (!first_same_as_last) {
+        // Compute the acceleration at the end of the step.  This is exactly the
+        // first stage of the next step, so we don't compute it again.
+        for (int k = 0; k < dimension; ++k) {
+          q_stage[k] = q̂[k].value;
+        }
+        termination_condition::UpdateWithAbort(
+            equation.compute_acceleration(t.value + t.error, q_stage, g.back()),
+            status);
+        using std::swap;
+        swap(g.front(), g.back());
+        first_stage = 1;
+      }
+      // At this point |g.back()| holds the accelerations at the beginning of
+      // the step and |g.front()| those at the end.
+      interpolants.clear();
+      for (int k = 0; k < dimension; ++k) {
+        interpolants.emplace_back(std::pair{t_start, t.value},
+                                  std::pair{q_start[k], q̂[k].value},
+                                  std::pair{v_start[k], v̂[k].value},
+                                  std::pair{g.back()[k], g.front()[k]});
+      }
+      dense_output_(interpolants);
+    }
     append_state(current_state);
     ++step_count;
     if (step_count == parameters.max_steps && !at_end) {
@@ -251,8 +290,8 @@ Instance::Solve(Instant const& t_final) {
     }
   }
   // The resolution is restartable from the last non-truncated state.
-  CHECK(final_state);
-  current_state = *final_state;
+  CHECK(has_final_state);
+  current_state = final_state;
   return status;
 }
 
@@ -307,6 +346,7 @@ ReadFromMessage(
   // private.
   return std::unique_ptr<Instance>(new Instance(problem,
                                                 append_state,
+                                                /*dense_output=*/nullptr,
                                                 tolerance_to_error_ratio,
                                                 parameters,
                                                 time_step,
@@ -319,6 +359,7 @@ EmbeddedExplicitRungeKuttaNyströmIntegrator<Method, Position>::
 Instance::Instance(
     IntegrationProblem<ODE> const& problem,
     AppendState const& append_state,
+    DenseOutput const& dense_output,
     ToleranceToErrorRatio const& tolerance_to_error_ratio,
     Parameters const& parameters,
     Time const& time_step,
@@ -330,7 +371,45 @@ Instance::Instance(
                                                 parameters,
                                                 time_step,
                                                 first_use),
-      integrator_(integrator) {}
+      dense_output_(dense_output),
+      final_state_(problem.initial_state),
+      Δq̂_(problem.initial_state.positions.size()),
+      Δv̂_(problem.initial_state.positions.size()),
+      q_stage_(problem.initial_state.positions.size()),
+      g_(stages_,
+         std::vector<typename ODE::Acceleration>(
+             problem.initial_state.positions.size())),
+      integrator_(integrator) {
+  int const dimension = problem.initial_state.positions.size();
+  error_estimate_.position_error.resize(dimension);
+  error_estimate_.velocity_error.resize(dimension);
+  if (dense_output_ != nullptr) {
+    q_start_.resize(dimension);
+    v_start_.resize(dimension);
+    interpolants_.reserve(dimension);
+  }
+}
+
+template<typename Method, typename Position>
+not_null<std::unique_ptr<typename Integrator<
+    SpecialSecondOrderDifferentialEquation<Position>>::Instance>>
+EmbeddedExplicitRungeKuttaNyströmIntegrator<Method, Position>::
+NewInstance(IntegrationProblem<ODE> const& problem,
+            AppendState const& append_state,
+            ToleranceToErrorRatio const& tolerance_to_error_ratio,
+            Parameters const& parameters) const {
+  // Cannot use |make_not_null_unique| because the constructor of |Instance| is
+  // private.
+  return std::unique_ptr<Instance>(
+      new Instance(problem,
+                   append_state,
+                   /*dense_output=*/nullptr,
+                   tolerance_to_error_ratio,
+                   parameters,
+                   /*step=*/parameters.first_step,
+                   /*first_use=*/true,
+                   *this));
+}
 
 template<typename Method, typename Position>
 not_null<std::unique_ptr<typename Integrator<
@@ -338,6 +417,7 @@ not_null<std::unique_ptr<typename Integrator<
 EmbeddedExplicitRungeKuttaNyströmIntegrator<Method, Position>::
 NewInstance(IntegrationProblem<ODE> const& problem,
             AppendState const& append_state,
+            DenseOutput const& dense_output,
             ToleranceToErrorRatio const& tolerance_to_error_ratio,
             Parameters const& parameters) const {
   // Cannot use |make_not_null_unique| because the constructor of |Instance| is
@@ -345,6 +425,7 @@ NewInstance(IntegrationProblem<ODE> const& problem,
   return std::unique_ptr<Instance>(
       new Instance(problem,
                    append_state,
+                   dense_output,
                    tolerance_to_error_ratio,
                    parameters,
                    /*step=*/parameters.first_step,
@@ -352,6 +433,370 @@ NewInstance(IntegrationProblem<ODE> const& problem,
                    *this));
 }
 
+template<typename Method, typename Position>
+std::vector<absl::Status>
+EmbeddedExplicitRungeKuttaNyströmIntegrator<Method, Position>::SolveBatch(
+    std::vector<BatchedProblem> const& problems,
+    BatchedRightHandSideComputation const& compute_accelerations) const {
+  using Displacement = typename ODE::Displacement;
+  using Velocity = typename ODE::Velocity;
+  using Acceleration = typename ODE::Acceleration;
+
+  // The state of the integration of one problem.  See |Instance::Solve| for
+  // the meaning of the fields.
+  struct Lane {
+    typename ODE::SystemState current_state;
+    Time h;
+    std::array<Acceleration, stages_> g;
+    Displacement Δq̂;
+    Velocity Δv̂;
+    bool at_end = false;
+    // True until the first step has been attempted; it has no step size
+    // control.
+    bool first_attempt = true;
+    double tolerance_to_error_ratio;
+    int first_stage = 0;
+    std::int64_t step_count = 0;
+    absl::Status status;
+    absl::Status step_status;
+  };
+
+  int const size = problems.size();
+  std::vector<absl::Status> statuses(size);
+  std::vector<Lane> lanes(size);
+  // The indices of the problems that have not retired from the batch.
+  std::vector<int> active;
+  active.reserve(size);
+  for (int l = 0; l < size; ++l) {
+    auto const& problem = problems[l];
+    auto& lane = lanes[l];
+    CHECK_EQ(1, problem.initial_state.positions.size());
+    if (Sign(problem.parameters.first_step).is_positive()) {
+      CHECK_LT(problem.initial_state.time.value, problem.t_final);
+    } else {
+      CHECK_GT(problem.initial_state.time.value, problem.t_final);
+    }
+    lane.current_state = problem.initial_state;
+    lane.h = problem.parameters.first_step;
+    active.push_back(l);
+  }
+
+  // The arguments of |compute_accelerations|, and the lanes they come from.
+  std::vector<int> stage_lanes;
+  std::vector<Instant> t_stage;
+  std::vector<Position> q_stage;
+  std::vector<Acceleration> g_stage;
+  std::vector<absl::Status> stage_statuses;
+  stage_lanes.reserve(size);
+  t_stage.reserve(size);
+  q_stage.reserve(size);
+
+  typename ODE::SystemStateError error_estimate;
+  error_estimate.position_error.resize(1);
+  error_estimate.velocity_error.resize(1);
+
+  while (!active.empty()) {
+    // Choose the size of the step attempted by each problem.
+    std::erase_if(active, [&lanes, &problems, &statuses](int const l) {
+      auto const& parameters = problems[l].parameters;
+      auto& lane = lanes[l];
+      auto const& t = lane.current_state.time;
+      if (lane.first_attempt) {
+        lane.first_attempt = false;
+      } else {
+        lane.step_status = absl::OkStatus();
+        lane.h *= parameters.safety_factor *
+                  std::pow(lane.tolerance_to_error_ratio,
+                           1.0 / (lower_order + 1));
+        if (t.value + (t.error + lane.h) == t.value) {
+          statuses[l] = absl::Status(
+              termination_condition::VanishingStepSize,
+              "At time " + DebugString(t.value) +
+                  ", step size is effectively zero.  "
+                  "Singularity or stiff system suspected.");
+          return true;
+        }
+      }
+      if (parameters.last_step_is_exact) {
+        Sign const integration_direction = Sign(parameters.first_step);
+        Time const time_to_end = (problems[l].t_final - t.value) - t.error;
+        lane.at_end = integration_direction * lane.h >=
+                      integration_direction * time_to_end;
+        if (lane.at_end) {
+          lane.h = time_to_end;
+        }
+      }
+      return false;
+    });
+
+    // Runge-Kutta-Nyström iteration; fills the |g| of each lane with one call
+    // of |compute_accelerations| per stage.
+    for (int i = 0; i < stages_; ++i) {
+      stage_lanes.clear();
+      t_stage.clear();
+      q_stage.clear();
+      for (int const l : active) {
+        auto const& lane = lanes[l];
+        if (i < lane.first_stage) {
+          continue;
+        }
+        auto const& parameters = problems[l].parameters;
+        auto const& t = lane.current_state.time;
+        Time const& h = lane.h;
+        Acceleration Σⱼ_aᵢⱼ_gⱼ{};
+        for (int j = 0; j < i; ++j) {
+          Σⱼ_aᵢⱼ_gⱼ += a_(i, j) * lane.g[j];
+        }
+        stage_lanes.push_back(l);
+        t_stage.push_back(
+            (parameters.last_step_is_exact && lane.at_end && c_[i] == 1.0)
+                ? problems[l].t_final
+                : t.value + (t.error + c_[i] * h));
+        q_stage.push_back(lane.current_state.positions[0].value +
+                          h * c_[i] * lane.current_state.velocities[0].value +
+                          h * h * Σⱼ_aᵢⱼ_gⱼ);
+      }
+      if (stage_lanes.empty()) {
+        continue;
+      }
+      g_stage.resize(stage_lanes.size());
+      stage_statuses.assign(stage_lanes.size(), absl::OkStatus());
+      compute_accelerations(
+          stage_lanes, t_stage, q_stage, g_stage, stage_statuses);
+      for (int k = 0; k < stage_lanes.size(); ++k) {
+        auto& lane = lanes[stage_lanes[k]];
+        lane.g[i] = g_stage[k];
+        termination_condition::UpdateWithAbort(stage_statuses[k],
+                                               lane.step_status);
+      }
+    }
+
+    // Increment computation and step size control.  The problems whose step
+    // is rejected try again in the next iteration.
+    std::erase_if(active, [&error_estimate, &lanes, &problems, &statuses](
+                              int const l) {
+      auto const& problem = problems[l];
+      auto const& parameters = problem.parameters;
+      auto& lane = lanes[l];
+      auto& t = lane.current_state.time;
+      auto& q̂ = lane.current_state.positions[0];
+      auto& v̂ = lane.current_state.velocities[0];
+      Time const& h = lane.h;
+      Acceleration Σᵢ_b̂ᵢ_gᵢ{};
+      Acceleration Σᵢ_bᵢ_gᵢ{};
+      Acceleration Σᵢ_b̂ʹᵢ_gᵢ{};
+      Acceleration Σᵢ_bʹᵢ_gᵢ{};
+      for (int i = 0; i < stages_; ++i) {
+        Σᵢ_b̂ᵢ_gᵢ  += b̂_[i] * lane.g[i];
+        Σᵢ_bᵢ_gᵢ  += b_[i] * lane.g[i];
+        Σᵢ_b̂ʹᵢ_gᵢ += b̂ʹ_[i] * lane.g[i];
+        Σᵢ_bʹᵢ_gᵢ += bʹ_[i] * lane.g[i];
+      }
+      lane.Δq̂                = h * v̂.value + h * h * Σᵢ_b̂ᵢ_gᵢ;
+      Displacement const Δq = h * v̂.value + h * h * Σᵢ_bᵢ_gᵢ;
+      lane.Δv̂                = h * Σᵢ_b̂ʹᵢ_gᵢ;
+      Velocity const Δv     = h * Σᵢ_bʹᵢ_gᵢ;
+      error_estimate.position_error[0] = Δq - lane.Δq̂;
+      error_estimate.velocity_error[0] = Δv - lane.Δv̂;
+      lane.tolerance_to_error_ratio =
+          problem.tolerance_to_error_ratio(h, error_estimate);
+      if (lane.tolerance_to_error_ratio < 1.0) {
+        return false;
+      }
+
+      lane.status.Update(lane.step_status);
+
+      if (!parameters.last_step_is_exact &&
+          t.value + (t.error + h) > problem.t_final) {
+        // We did overshoot.  Drop the point that we just computed.
+        statuses[l] = lane.status;
+        return true;
+      }
+
+      if (first_same_as_last) {
+        using std::swap;
+        swap(lane.g.front(), lane.g.back());
+        lane.first_stage = 1;
+      }
+
+      // Increment the solution with the high-order approximation.
+      t.Increment(h);
+      q̂.Increment(lane.Δq̂);
+      v̂.Increment(lane.Δv̂);
+      problem.append_state(lane.current_state);
+      ++lane.step_count;
+      if (lane.at_end) {
+        statuses[l] = lane.status;
+        return true;
+      }
+      if (lane.step_count == parameters.max_steps) {
+        statuses[l] = absl::Status(
+            termination_condition::ReachedMaximalStepCount,
+            "Reached maximum step count " +
+                std::to_string(parameters.max_steps) + " at time " +
+                DebugString(t.value) + "; requested t_final is " +
+                DebugString(problem.t_final) + ".");
+        return true;
+      }
+      return false;
+    });
+
+    if (base::this_stoppable_thread::get_stop_token().stop_requested()) {
+      for (int const l : active) {
+        statuses[l] = absl::CancelledError("Cancelled by stop token");
+      }
+      break;
+    }
+  }
+  return statuses;
+}
+
+template<typename Method, typename Position>
+absl::Status
+EmbeddedExplicitRungeKuttaNyströmIntegrator<Method, Position>::SolveSingle(
+    BatchedProblem const& problem,
+    SingleRightHandSideComputation const& compute_acceleration) const {
+  using Displacement = typename ODE::Displacement;
+  using Velocity = typename ODE::Velocity;
+  using Acceleration = typename ODE::Acceleration;
+
+  // This is |Instance::Solve| specialized to one degree of freedom; the
+  // arithmetic must be kept identical.  See there for the meaning of the
+  // variables.
+  auto const& parameters = problem.parameters;
+  Instant const& t_final = problem.t_final;
+
+  CHECK_EQ(1, problem.initial_state.positions.size());
+  Sign const integration_direction = Sign(parameters.first_step);
+  if (integration_direction.is_positive()) {
+    CHECK_LT(problem.initial_state.time.value, t_final);
+  } else {
+    CHECK_GT(problem.initial_state.time.value, t_final);
+  }
+
+  // The state is held in a |SystemState| so that it may be given to
+  // |append_state|.
+  typename ODE::SystemState current_state = problem.initial_state;
+  DoublePrecision<Instant>& t = current_state.time;
+  DoublePrecision<Position>& q̂ = current_state.positions[0];
+  DoublePrecision<Velocity>& v̂ = current_state.velocities[0];
+
+  Time h = parameters.first_step;
+  Displacement Δq̂;
+  Velocity Δv̂;
+  typename ODE::SystemStateError error_estimate;
+  error_estimate.position_error.resize(1);
+  error_estimate.velocity_error.resize(1);
+  std::array<Acceleration, stages_> g;
+
+  bool at_end = false;
+  double tolerance_to_error_ratio;
+  int first_stage = 0;
+  std::int64_t step_count = 0;
+
+  absl::Status status;
+  absl::Status step_status;
+
+  // No step size control on the first step.
+  goto runge_kutta_nyström_step;
+
+  while (!at_end) {
+    do {
+      step_status = absl::OkStatus();
+      h *= parameters.safety_factor *
+               std::pow(tolerance_to_error_ratio, 1.0 / (lower_order + 1));
+      if (t.value + (t.error + h) == t.value) {
+        return absl::Status(termination_condition::VanishingStepSize,
+                            "At time " + DebugString(t.value) +
+                                ", step size is effectively zero.  "
+                                "Singularity or stiff system suspected.");
+      }
+
+    runge_kutta_nyström_step:
+      if (parameters.last_step_is_exact) {
+        Time const time_to_end = (t_final - t.value) - t.error;
+        at_end = integration_direction * h >=
+                 integration_direction * time_to_end;
+        if (at_end) {
+          h = time_to_end;
+        }
+      }
+
+      auto const h² = h * h;
+
+      // Runge-Kutta-Nyström iteration; fills |g|.  The bounds of the loops
+      // are known at compile time, so they may be unrolled.
+      for (int i = first_stage; i < stages_; ++i) {
+        Instant const t_stage =
+            (parameters.last_step_is_exact && at_end && c_[i] == 1.0)
+                ? t_final
+                : t.value + (t.error + c_[i] * h);
+        Acceleration Σⱼ_aᵢⱼ_gⱼ{};
+        for (int j = 0; j < i; ++j) {
+          Σⱼ_aᵢⱼ_gⱼ += a_(i, j) * g[j];
+        }
+        termination_condition::UpdateWithAbort(
+            compute_acceleration(
+                t_stage,
+                q̂.value + h * c_[i] * v̂.value + h² * Σⱼ_aᵢⱼ_gⱼ,
+                g[i]),
+            step_status);
+      }
+
+      // Increment computation and step size control.
+      Acceleration Σᵢ_b̂ᵢ_gᵢ{};
+      Acceleration Σᵢ_bᵢ_gᵢ{};
+      Acceleration Σᵢ_b̂ʹᵢ_gᵢ{};
+      Acceleration Σᵢ_bʹᵢ_gᵢ{};
+      for (int i = 0; i < stages_; ++i) {
+        Σᵢ_b̂ᵢ_gᵢ  += b̂_[i] * g[i];
+        Σᵢ_bᵢ_gᵢ  += b_[i] * g[i];
+        Σᵢ_b̂ʹᵢ_gᵢ += b̂ʹ_[i] * g[i];
+        Σᵢ_bʹᵢ_gᵢ += bʹ_[i] * g[i];
+      }
+      Δq̂                    = h * v̂.value + h² * Σᵢ_b̂ᵢ_gᵢ;
+      Displacement const Δq = h * v̂.value + h² * Σᵢ_bᵢ_gᵢ;
+      Δv̂                    = h * Σᵢ_b̂ʹᵢ_gᵢ;
+      Velocity const Δv     = h * Σᵢ_bʹᵢ_gᵢ;
+
+      error_estimate.position_error[0] = Δq - Δq̂;
+      error_estimate.velocity_error[0] = Δv - Δv̂;
+      tolerance_to_error_ratio =
+          problem.tolerance_to_error_ratio(h, error_estimate);
+    } while (tolerance_to_error_ratio < 1.0);
+
+    status.Update(step_status);
+
+    if (!parameters.last_step_is_exact && t.value + (t.error + h) > t_final) {
+      // We did overshoot.  Drop the point that we just computed and exit.
+      break;
+    }
+
+    if (first_same_as_last) {
+      using std::swap;
+      swap(g.front(), g.back());
+      first_stage = 1;
+    }
+
+    // Increment the solution with the high-order approximation.
+    t.Increment(h);
+    q̂.Increment(Δq̂);
+    v̂.Increment(Δv̂);
+    RETURN_IF_STOPPED;
+    problem.append_state(current_state);
+    ++step_count;
+    if (step_count == parameters.max_steps && !at_end) {
+      return absl::Status(termination_condition::ReachedMaximalStepCount,
+                          "Reached maximum step count " +
+                              std::to_string(parameters.max_steps) +
+                              " at time " + DebugString(t.value) +
+                              "; requested t_final is " + DebugString(t_final) +
+                              ".");
+    }
+  }
+  return status;
+}
+
 template<typename Method, typename Position>
 void EmbeddedExplicitRungeKuttaNyströmIntegrator<Method, Position>::
 WriteToMessage(not_null<serialization::AdaptiveStepSizeIntegrator*> message)
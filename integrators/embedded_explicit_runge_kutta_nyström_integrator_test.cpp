@@ -180,6 +180,86 @@ TEST_F(EmbeddedExplicitRungeKuttaNyströmIntegratorTest,
   EXPECT_EQ(11, subsequent_rejections);
 }
 
+TEST_F(EmbeddedExplicitRungeKuttaNyströmIntegratorTest, DenseOutput) {
+  auto const& integrator = EmbeddedExplicitRungeKuttaNyströmIntegrator<
+      methods::DormandالمكاوىPrince1986RKN434FM,
+      Length>();
+  Length const x_initial = 1 * Metre;
+  Speed const v_initial = 0 * Metre / Second;
+  Time const period = 2 * π * Second;
+  Instant const t_initial;
+  Instant const t_final = t_initial + 10 * period;
+  Length const length_tolerance = 1 * Milli(Metre);
+  Speed const speed_tolerance = 1 * Milli(Metre) / Second;
+
+  int evaluations = 0;
+  std::vector<ODE::SystemState> solution;
+  std::vector<Hermite5<Instant, Length>> interpolants;
+  ODE harmonic_oscillator;
+  harmonic_oscillator.compute_acceleration =
+      std::bind(ComputeHarmonicOscillatorAcceleration1D,
+                _1, _2, _3, &evaluations);
+  IntegrationProblem<ODE> problem;
+  problem.equation = harmonic_oscillator;
+  problem.initial_state = {{x_initial}, {v_initial}, t_initial};
+  auto const append_state = [&solution](ODE::SystemState const& state) {
+    solution.push_back(state);
+  };
+  auto const dense_output =
+      [&interpolants](
+          std::vector<Hermite5<Instant, Length>> const& step_interpolants) {
+        interpolants.push_back(step_interpolants[0]);
+      };
+
+  AdaptiveStepSizeIntegrator<ODE>::Parameters const parameters(
+      /*first_time_step=*/t_final - t_initial,
+      /*safety_factor=*/0.9);
+  auto const tolerance_to_error_ratio =
+      std::bind(HarmonicOscillatorToleranceRatio,
+                _1, _2,
+                length_tolerance,
+                speed_tolerance,
+                [](bool tolerable) {});
+  auto instance = integrator.NewInstance(problem,
+                                         append_state,
+                                         dense_output,
+                                         tolerance_to_error_ratio,
+                                         parameters);
+  EXPECT_THAT(instance->Solve(t_final), StatusIs(termination_condition::Done));
+
+  // The method is FSAL, so the dense output is free.  The solution is the same
+  // as in |HarmonicOscillatorBackAndForth|.
+  EXPECT_EQ(132, solution.size());
+  EXPECT_EQ(2 * 4 + (132 - 1 + 3) * 3, evaluations);
+  ASSERT_EQ(solution.size(), interpolants.size());
+  for (int i = 0; i < interpolants.size(); ++i) {
+    auto const& interpolant = interpolants[i];
+    Instant const& t0 = interpolant.lower_bound();
+    Instant const& t1 = interpolant.upper_bound();
+    EXPECT_EQ(solution[i].time.value, t1);
+    EXPECT_THAT(AbsoluteError(solution[i].positions[0].value,
+                              interpolant.Evaluate(t1)),
+                Lt(1e-12 * Metre));
+    EXPECT_THAT(AbsoluteError(solution[i].velocities[0].value,
+                              interpolant.EvaluateDerivative(t1)),
+                Lt(1e-12 * Metre / Second));
+    if (i > 0) {
+      EXPECT_EQ(solution[i - 1].time.value, t0);
+    }
+    // Within the step, the interpolant is as accurate as the method, compared
+    // to the exact solution through the state at the beginning of the step.
+    Length const q0 = interpolant.Evaluate(t0);
+    Speed const v0 = interpolant.EvaluateDerivative(t0);
+    AngularFrequency const ω = 1 * Radian / Second;
+    for (int j = 1; j < 8; ++j) {
+      Time const Δt = j * (t1 - t0) / 8;
+      Length const q = q0 * Cos(ω * Δt) + v0 * Sin(ω * Δt) / ω * Radian;
+      EXPECT_THAT(AbsoluteError(q, interpolant.Evaluate(t0 + Δt)),
+                  Lt(length_tolerance));
+    }
+  }
+}
+
 TEST_F(EmbeddedExplicitRungeKuttaNyströmIntegratorTest, MaxSteps) {
   AdaptiveStepSizeIntegrator<ODE> const& integrator =
       EmbeddedExplicitRungeKuttaNyströmIntegrator<
@@ -436,6 +516,188 @@ TEST_F(EmbeddedExplicitRungeKuttaNyströmIntegratorTest, Restart) {
   EXPECT_THAT(solution2, ElementsAreArray(solution1));
 }
 
+TEST_F(EmbeddedExplicitRungeKuttaNyströmIntegratorTest, Batch) {
+  using RKNIntegrator = EmbeddedExplicitRungeKuttaNyströmIntegrator<
+      methods::DormandالمكاوىPrince1986RKN434FM,
+      Length>;
+  RKNIntegrator const& integrator =
+      EmbeddedExplicitRungeKuttaNyströmIntegrator<
+          methods::DormandالمكاوىPrince1986RKN434FM,
+          Length>();
+  Speed const v_initial = 0 * Metre / Second;
+  Time const period = 2 * π * Second;
+  Instant const t_initial;
+  // The problems have different initial states, tolerances and final times, so
+  // their steps differ.  The last one reaches its maximal step count.
+  std::vector<Length> const x_initials = {1 * Metre, 2 * Metre, 0.5 * Metre};
+  std::vector<Length> const length_tolerances = {
+      1 * Milli(Metre), 1 * Milli(Metre), 1 * Centi(Metre)};
+  std::vector<Instant> const t_finals = {t_initial + 10 * period,
+                                         t_initial + 3 * period,
+                                         t_initial + 10 * period};
+  std::vector<std::int64_t> const max_steps = {
+      std::numeric_limits<std::int64_t>::max(),
+      std::numeric_limits<std::int64_t>::max(),
+      20};
+  int const size = x_initials.size();
+
+  auto const tolerance_to_error_ratio = [](Length const& length_tolerance) {
+    return std::bind(HarmonicOscillatorToleranceRatio,
+                     _1, _2,
+                     length_tolerance,
+                     length_tolerance / Second,
+                     [](bool tolerable) {});
+  };
+  auto const parameters = [&max_steps, &t_finals, t_initial](int const k) {
+    return AdaptiveStepSizeIntegrator<ODE>::Parameters(
+        /*first_time_step=*/t_finals[k] - t_initial,
+        /*safety_factor=*/0.9,
+        max_steps[k],
+        /*last_step_is_exact=*/true);
+  };
+
+  // Solve the problems separately.
+  int evaluations = 0;
+  std::vector<std::vector<ODE::SystemState>> expected_solutions(size);
+  std::vector<absl::Status> expected_statuses;
+  for (int k = 0; k < size; ++k) {
+    IntegrationProblem<ODE> problem;
+    problem.equation.compute_acceleration =
+        std::bind(ComputeHarmonicOscillatorAcceleration1D,
+                  _1, _2, _3, &evaluations);
+    problem.initial_state = {{x_initials[k]}, {v_initial}, t_initial};
+    auto const instance = integrator.NewInstance(
+        problem,
+        [&expected_solution = expected_solutions[k]](
+            ODE::SystemState const& state) {
+          expected_solution.push_back(state);
+        },
+        tolerance_to_error_ratio(length_tolerances[k]),
+        parameters(k));
+    expected_statuses.push_back(instance->Solve(t_finals[k]));
+  }
+
+  // Solve them in a batch.
+  int batched_evaluations = 0;
+  int calls = 0;
+  std::vector<std::vector<ODE::SystemState>> solutions(size);
+  std::vector<RKNIntegrator::BatchedProblem> problems;
+  for (int k = 0; k < size; ++k) {
+    problems.push_back(RKNIntegrator::BatchedProblem{
+        .initial_state = {{x_initials[k]}, {v_initial}, t_initial},
+        .t_final = t_finals[k],
+        .append_state =
+            [&solution = solutions[k]](ODE::SystemState const& state) {
+              solution.push_back(state);
+            },
+        .tolerance_to_error_ratio =
+            tolerance_to_error_ratio(length_tolerances[k]),
+        .parameters = parameters(k)});
+  }
+  auto const statuses = integrator.SolveBatch(
+      problems,
+      [&batched_evaluations, &calls](
+          std::vector<int> const& problems,
+          std::vector<Instant> const& times,
+          std::vector<Length> const& positions,
+          std::vector<Acceleration>& accelerations,
+          std::vector<absl::Status>& statuses) {
+        ++calls;
+        std::vector<Acceleration> acceleration(1);
+        for (int k = 0; k < positions.size(); ++k) {
+          statuses[k] = ComputeHarmonicOscillatorAcceleration1D(
+              times[k], {positions[k]}, acceleration, &batched_evaluations);
+          accelerations[k] = acceleration[0];
+        }
+      });
+
+  // The solutions are identical, but the right-hand side is called much less
+  // often.
+  EXPECT_OK(statuses[0]);
+  EXPECT_OK(statuses[1]);
+  EXPECT_THAT(statuses[2],
+              StatusIs(termination_condition::ReachedMaximalStepCount));
+  for (int k = 0; k < size; ++k) {
+    EXPECT_EQ(expected_statuses[k].code(), statuses[k].code());
+    EXPECT_THAT(solutions[k], ElementsAreArray(expected_solutions[k]));
+  }
+  EXPECT_EQ(evaluations, batched_evaluations);
+  EXPECT_THAT(calls, Lt(evaluations));
+}
+
+TEST_F(EmbeddedExplicitRungeKuttaNyströmIntegratorTest, Single) {
+  using RKNIntegrator = EmbeddedExplicitRungeKuttaNyströmIntegrator<
+      methods::DormandالمكاوىPrince1986RKN434FM,
+      Length>;
+  RKNIntegrator const& integrator =
+      EmbeddedExplicitRungeKuttaNyströmIntegrator<
+          methods::DormandالمكاوىPrince1986RKN434FM,
+          Length>();
+  Length const x_initial = 1 * Metre;
+  Speed const v_initial = 0 * Metre / Second;
+  Time const period = 2 * π * Second;
+  Instant const t_initial;
+  Instant const t_final = t_initial + 10 * period;
+  Length const length_tolerance = 1 * Milli(Metre);
+  Speed const speed_tolerance = 1 * Milli(Metre) / Second;
+  auto const tolerance_to_error_ratio =
+      std::bind(HarmonicOscillatorToleranceRatio,
+                _1, _2,
+                length_tolerance,
+                speed_tolerance,
+                [](bool tolerable) {});
+
+  for (bool const last_step_is_exact : {true, false}) {
+    AdaptiveStepSizeIntegrator<ODE>::Parameters const parameters(
+        /*first_time_step=*/t_final - t_initial,
+        /*safety_factor=*/0.9,
+        /*max_steps=*/std::numeric_limits<std::int64_t>::max(),
+        last_step_is_exact);
+
+    int evaluations = 0;
+    std::vector<ODE::SystemState> expected_solution;
+    IntegrationProblem<ODE> problem;
+    problem.equation.compute_acceleration =
+        std::bind(ComputeHarmonicOscillatorAcceleration1D,
+                  _1, _2, _3, &evaluations);
+    problem.initial_state = {{x_initial}, {v_initial}, t_initial};
+    auto const instance = integrator.NewInstance(
+        problem,
+        [&expected_solution](ODE::SystemState const& state) {
+          expected_solution.push_back(state);
+        },
+        tolerance_to_error_ratio,
+        parameters);
+    EXPECT_OK(instance->Solve(t_final));
+
+    int single_evaluations = 0;
+    std::vector<ODE::SystemState> solution;
+    std::vector<Acceleration> acceleration(1);
+    EXPECT_OK(integrator.SolveSingle(
+        RKNIntegrator::BatchedProblem{
+            .initial_state = {{x_initial}, {v_initial}, t_initial},
+            .t_final = t_final,
+            .append_state =
+                [&solution](ODE::SystemState const& state) {
+                  solution.push_back(state);
+                },
+            .tolerance_to_error_ratio = tolerance_to_error_ratio,
+            .parameters = parameters},
+        [&acceleration, &single_evaluations](Instant const& t,
+                                             Length const& position,
+                                             Acceleration& result) {
+          absl::Status const status = ComputeHarmonicOscillatorAcceleration1D(
+              t, {position}, acceleration, &single_evaluations);
+          result = acceleration[0];
+          return status;
+        }));
+
+    // The fast path computes exactly the same solution.
+    EXPECT_THAT(solution, ElementsAreArray(expected_solution));
+    EXPECT_EQ(evaluations, single_evaluations);
+  }
+}
+
 TEST_F(EmbeddedExplicitRungeKuttaNyströmIntegratorTest, Serialization) {
   AdaptiveStepSizeIntegrator<ODE> const& integrator =
       EmbeddedExplicitRungeKuttaNyströmIntegrator<
@@ -5,6 +5,7 @@
 
 #include <limits>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -16,6 +17,7 @@
 #include "integrators/embedded_explicit_runge_kutta_integrator.hpp"
 #include "integrators/methods.hpp"
 #include "integrators/symmetric_linear_multistep_integrator.hpp"
+#include "integrators/symplectic_partitioned_runge_kutta_integrator.hpp"
 #include "integrators/symplectic_runge_kutta_nyström_integrator.hpp"
 #include "quantities/serialization.hpp"
 
@@ -504,23 +506,47 @@ FixedStepSizeIntegrator<ODE_>::Instance::Instance(
   return SymplecticRungeKuttaNyströmIntegrator<methods::method, \
                                                typename ODE::Position>()
 
+// The decomposable equations are only solved by the symplectic partitioned
+// Runge-Kutta integrators, whose positions are the first state elements.
+#define PRINCIPIA_READ_FSS_INTEGRATOR_DECOMPOSABLE_SPRK(method)  \
+  return SymplecticPartitionedRungeKuttaIntegrator<              \
+      methods::method,                                           \
+      typename std::tuple_element_t<0, typename ODE::State>::value_type>()
+
+#define PRINCIPIA_READ_FSS_INTEGRATOR_NONE(method)
+
 template<typename ODE_>
 FixedStepSizeIntegrator<ODE_> const&
 FixedStepSizeIntegrator<ODE_>::ReadFromMessage(
       serialization::FixedStepSizeIntegrator const& message) {
-  switch (message.kind()) {
-    PRINCIPIA_FSS_INTEGRATOR_CASES(PRINCIPIA_READ_FSS_INTEGRATOR_SLMS,
-                                   PRINCIPIA_READ_FSS_INTEGRATOR_SPRK,
-                                   PRINCIPIA_READ_FSS_INTEGRATOR_SRKN)
-    default:
-      LOG(FATAL) << message.kind();
-      base::noreturn();
+  if constexpr (base::is_instance_of_v<
+                    DecomposableFirstOrderDifferentialEquation, ODE>) {
+    switch (message.kind()) {
+      PRINCIPIA_FSS_INTEGRATOR_CASES(
+          PRINCIPIA_READ_FSS_INTEGRATOR_NONE,
+          PRINCIPIA_READ_FSS_INTEGRATOR_DECOMPOSABLE_SPRK,
+          PRINCIPIA_READ_FSS_INTEGRATOR_NONE)
+      default:
+        break;
+    }
+  } else {
+    switch (message.kind()) {
+      PRINCIPIA_FSS_INTEGRATOR_CASES(PRINCIPIA_READ_FSS_INTEGRATOR_SLMS,
+                                     PRINCIPIA_READ_FSS_INTEGRATOR_SPRK,
+                                     PRINCIPIA_READ_FSS_INTEGRATOR_SRKN)
+      default:
+        break;
+    }
   }
+  LOG(FATAL) << message.kind();
+  base::noreturn();
 }
 
 #undef PRINCIPIA_READ_FSS_INTEGRATOR_SLMS
 #undef PRINCIPIA_READ_FSS_INTEGRATOR_SPRK
 #undef PRINCIPIA_READ_FSS_INTEGRATOR_SRKN
+#undef PRINCIPIA_READ_FSS_INTEGRATOR_DECOMPOSABLE_SPRK
+#undef PRINCIPIA_READ_FSS_INTEGRATOR_NONE
 
 template<typename Equation>
 FixedStepSizeIntegrator<Equation> const&
@@ -89,6 +89,8 @@ struct ExplicitFirstOrderOrdinaryDifferentialEquation final {
 // using splitting methods.
 template<typename... StateElements>
 struct DecomposableFirstOrderDifferentialEquation final {
+  using IndependentVariable = Instant;
+  using IndependentVariableDifference = Time;
   using State = std::tuple<std::vector<StateElements>...>;
 
   using Flow = std::function<absl::Status(Instant const& t_initial,
@@ -106,6 +108,12 @@ struct DecomposableFirstOrderDifferentialEquation final {
     friend bool operator==(SystemState const& lhs, SystemState const& rhs) {
       return lhs.y == rhs.y && lhs.time == rhs.time;
     }
+
+    // Only defined for the equations whose state is made of positions and
+    // velocities, i.e., that have two |StateElements|.
+    void WriteToMessage(not_null<serialization::SystemState*> message) const;
+    static SystemState ReadFromMessage(
+        serialization::SystemState const& message);
   };
 
   // We cannot use |Difference<StateElements>| here for the same reason.  For
@@ -3,6 +3,7 @@
 
 #include "integrators/ordinary_differential_equations.hpp"
 
+#include <tuple>
 #include <vector>
 
 #include "base/for_all_of.hpp"
@@ -55,11 +56,50 @@ SystemState::ReadFromMessage(serialization::SystemState const& message) {
   LOG(FATAL) << "NYI";
 }
 
-template<typename... State>
-DecomposableFirstOrderDifferentialEquation<State...>::SystemState::SystemState(
-    State const& y,
-    Instant const& t)
-    : y(y), time(t) {}
+template<typename... StateElements>
+DecomposableFirstOrderDifferentialEquation<StateElements...>::SystemState::
+SystemState(State const& y, Instant const& t)
+    : time(t) {
+  for_all_of(y, this->y).loop([](auto const& y, auto& this_y) {
+    for (auto const& y_i : y) {
+      this_y.emplace_back(y_i);
+    }
+  });
+}
+
+template<typename... StateElements>
+void DecomposableFirstOrderDifferentialEquation<StateElements...>::SystemState::
+WriteToMessage(not_null<serialization::SystemState*> const message) const {
+  static_assert(sizeof...(StateElements) == 2);
+  for (auto const& position : std::get<0>(y)) {
+    position.WriteToMessage(message->add_position());
+  }
+  for (auto const& velocity : std::get<1>(y)) {
+    velocity.WriteToMessage(message->add_velocity());
+  }
+  time.WriteToMessage(message->mutable_time());
+}
+
+template<typename... StateElements>
+typename DecomposableFirstOrderDifferentialEquation<
+    StateElements...>::SystemState
+DecomposableFirstOrderDifferentialEquation<StateElements...>::SystemState::
+ReadFromMessage(serialization::SystemState const& message) {
+  static_assert(sizeof...(StateElements) == 2);
+  using Position = std::tuple_element_t<0, std::tuple<StateElements...>>;
+  using Velocity = std::tuple_element_t<1, std::tuple<StateElements...>>;
+  SystemState system_state;
+  for (auto const& p : message.position()) {
+    std::get<0>(system_state.y).push_back(
+        DoublePrecision<Position>::ReadFromMessage(p));
+  }
+  for (auto const& v : message.velocity()) {
+    std::get<1>(system_state.y).push_back(
+        DoublePrecision<Velocity>::ReadFromMessage(v));
+  }
+  system_state.time = DoublePrecision<Instant>::ReadFromMessage(message.time());
+  return system_state;
+}
 
 template<typename Position_>
 ExplicitSecondOrderOrdinaryDifferentialEquation<
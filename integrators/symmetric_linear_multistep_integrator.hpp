@@ -105,6 +105,12 @@ class SymmetricLinearMultistepIntegrator
 
     int startup_step_index_ = 0;
     std::list<Step> previous_steps_;  // At most |order_| elements.
+
+    // Buffers used by |Solve|.  They are sized at construction so that solving
+    // the instance repeatedly does not allocate.
+    std::vector<Position> positions_;
+    std::vector<DoublePrecision<typename ODE::Displacement>> Σⱼ_minus_αⱼ_qⱼ_;
+    std::vector<typename ODE::Acceleration> Σⱼ_βⱼ_numerator_aⱼ_;
     SymmetricLinearMultistepIntegrator const& integrator_;
     friend class SymmetricLinearMultistepIntegrator;
   };
@@ -64,10 +64,10 @@ SymmetricLinearMultistepIntegrator<Method, Position>::Instance::Solve(
   int const k = order;
 
   absl::Status status;
-  std::vector<Position> positions(dimension);
+  std::vector<Position>& positions = positions_;
 
-  DoubleDisplacements Σⱼ_minus_αⱼ_qⱼ(dimension);
-  std::vector<Acceleration> Σⱼ_βⱼ_numerator_aⱼ(dimension);
+  DoubleDisplacements& Σⱼ_minus_αⱼ_qⱼ = Σⱼ_minus_αⱼ_qⱼ_;
+  std::vector<Acceleration>& Σⱼ_βⱼ_numerator_aⱼ = Σⱼ_βⱼ_numerator_aⱼ_;
   while (h <= (t_final - t.value) - t.error) {
     // We take advantage of the symmetry to iterate on the list of previous
     // steps from both ends.
@@ -114,13 +114,14 @@ SymmetricLinearMultistepIntegrator<Method, Position>::Instance::Solve(
       }
     }
 
-    // Create a new step in the instance.
+    // Create a new step in the instance.  The oldest step is no longer needed,
+    // so we move it to the end of the list and reuse its storage.
     t.Increment(h);
-    previous_steps_.emplace_back();
+    previous_steps_.splice(previous_steps_.end(),
+                           previous_steps_,
+                           previous_steps_.begin());
     Step& current_step = previous_steps_.back();
     current_step.time = t;
-    current_step.accelerations.resize(dimension);
-    current_step.displacements.reserve(dimension);
 
     // Fill the new step.  We skip the division by αₖ as it is equal to 1.0.
     double const αₖ = α[0];
@@ -129,7 +130,7 @@ SymmetricLinearMultistepIntegrator<Method, Position>::Instance::Solve(
       DoubleDisplacement& current_displacement = Σⱼ_minus_αⱼ_qⱼ[d];
       current_displacement.Increment(h * h *
                                      Σⱼ_βⱼ_numerator_aⱼ[d] / β_denominator);
-      current_step.displacements.push_back(current_displacement);
+      current_step.displacements[d] = current_displacement;
       DoublePosition const current_position =
           DoublePosition() + current_displacement;
       positions[d] = current_position.value;
@@ -140,7 +141,6 @@ SymmetricLinearMultistepIntegrator<Method, Position>::Instance::Solve(
                                       positions,
                                       current_step.accelerations),
         status);
-    previous_steps_.pop_front();
 
     ComputeVelocityUsingCohenHubbardOesterwinter();
 
@@ -261,6 +261,9 @@ SymmetricLinearMultistepIntegrator<Method, Position>::Instance::Instance(
     Time const& step,
     SymmetricLinearMultistepIntegrator const& integrator)
     : FixedStepSizeIntegrator<ODE>::Instance(problem, append_state, step),
+      positions_(problem.initial_state.positions.size()),
+      Σⱼ_minus_αⱼ_qⱼ_(problem.initial_state.positions.size()),
+      Σⱼ_βⱼ_numerator_aⱼ_(problem.initial_state.positions.size()),
       integrator_(integrator) {
   previous_steps_.emplace_back();
   FillStepFromSystemState(this->equation_,
@@ -279,6 +282,9 @@ SymmetricLinearMultistepIntegrator<Method, Position>::Instance::Instance(
     : FixedStepSizeIntegrator<ODE>::Instance(problem, append_state, step),
       startup_step_index_(startup_step_index),
       previous_steps_(std::move(previous_steps)),
+      positions_(problem.initial_state.positions.size()),
+      Σⱼ_minus_αⱼ_qⱼ_(problem.initial_state.positions.size()),
+      Σⱼ_βⱼ_numerator_aⱼ_(problem.initial_state.positions.size()),
       integrator_(integrator) {}
 
 template<typename Method, typename Position>
@@ -1,13 +1,21 @@
 ﻿
-#pragma once
+// The files containing the tree of of child classes of |Integrator| must be
+// included in the order of inheritance to avoid circular dependencies.  This
+// class will end up being reincluded as part of the implementation of its
+//  parent.
+#ifndef PRINCIPIA_INTEGRATORS_INTEGRATORS_HPP_
+#include "integrators/integrators.hpp"
+#else
+#ifndef PRINCIPIA_INTEGRATORS_SYMPLECTIC_PARTITIONED_RUNGE_KUTTA_INTEGRATOR_HPP_
+#define PRINCIPIA_INTEGRATORS_SYMPLECTIC_PARTITIONED_RUNGE_KUTTA_INTEGRATOR_HPP_
 
 #include <type_traits>
 
 #include "absl/status/status.h"
 #include "base/not_null.hpp"
 #include "geometry/named_quantities.hpp"
-#include "integrators/integrators.hpp"
 #include "integrators/ordinary_differential_equations.hpp"
+#include "quantities/named_quantities.hpp"
 #include "quantities/quantities.hpp"
 
 namespace principia {
@@ -17,13 +25,20 @@ namespace internal_symplectic_partitioned_runge_kutta_integrator {
 using base::not_null;
 using geometry::Instant;
 using quantities::Time;
+using quantities::Variation;
 
-// A symplectic partitioned Runge-Kutta integrator.  Does not subclass
-// |Integrator|; used to generate (less general)
-// |SymplecticRungeKuttaNyströmIntegrator|s.
+// A symplectic partitioned Runge-Kutta integrator.  Used to generate (less
+// general) |SymplecticRungeKuttaNyströmIntegrator|s, and to solve equations
+// whose splitting is not into drifts and kicks, e.g., Keplerian drifts and
+// interaction kicks.
 // Represents a single-step method for the solution of
 //   (q, p)′ = X(q, p, t), with X = A(q, p, t) + B(q, p, t).
-// |Position| is the type of |q|, and |Momentum| is that of |p|.
+// |Position| is the type of |q|; the momenta |p| are represented by velocities,
+// whose type is |Variation<Position>|.  The flows of A and B are the
+// |left_flow| and the |right_flow| of the equation, respectively.  The time is
+// advanced by B: the |right_flow| is called with the times at the beginning
+// and at the end of its evolution, while the |left_flow| is called with |t₀|
+// the current time and |t₁ - t₀| the duration of its evolution.
 // The step is the composition of evolutions
 //   exp(aᵣ₋₁ h A) exp(bᵣ₋₁ h B) ... exp(a₀ h A) exp(b₀ h B);
 // A and B are interchangeable.  If aᵣ₋₁ vanishes, this becomes
@@ -50,9 +65,11 @@ using quantities::Time;
 template<typename Method, typename Position>
 class SymplecticPartitionedRungeKuttaIntegrator
     : public FixedStepSizeIntegrator<
-          DecomposableFirstOrderDifferentialEquation<Position>> {
+          DecomposableFirstOrderDifferentialEquation<Position,
+                                                     Variation<Position>>> {
  public:
-  using ODE = DecomposableFirstOrderDifferentialEquation<Position>;
+  using ODE =
+      DecomposableFirstOrderDifferentialEquation<Position, Variation<Position>>;
   using AppendState = typename Integrator<ODE>::AppendState;
 
   static constexpr auto time_reversible = Method::time_reversible;
@@ -75,6 +92,10 @@ class SymplecticPartitionedRungeKuttaIntegrator
              Time const& step,
              SymplecticPartitionedRungeKuttaIntegrator const& integrator);
 
+    // The state at the current stage and the result of the next flow.  They
+    // are sized at construction and swapped as the stages progress.
+    typename ODE::State y_;
+    typename ODE::State y_stage_;
     SymplecticPartitionedRungeKuttaIntegrator const& integrator_;
     friend class SymplecticPartitionedRungeKuttaIntegrator;
   };
@@ -112,3 +133,6 @@ SymplecticPartitionedRungeKuttaIntegrator();
 }  // namespace principia
 
 #include "integrators/symplectic_partitioned_runge_kutta_integrator_body.hpp"
+
+#endif  // PRINCIPIA_INTEGRATORS_SYMPLECTIC_PARTITIONED_RUNGE_KUTTA_INTEGRATOR_HPP_  // NOLINT(whitespace/line_length)
+#endif  // PRINCIPIA_INTEGRATORS_INTEGRATORS_HPP_
@@ -3,18 +3,110 @@
 
 #include "integrators/symplectic_partitioned_runge_kutta_integrator.hpp"
 
+#include <utility>
+
+#include "base/for_all_of.hpp"
+#include "base/jthread.hpp"
 #include "base/mod.hpp"
+#include "geometry/sign.hpp"
+#include "numerics/double_precision.hpp"
 
 namespace principia {
 namespace integrators {
 namespace internal_symplectic_partitioned_runge_kutta_integrator {
 
+using base::for_all_of;
 using base::mod;
+using geometry::Sign;
+using numerics::DoublePrecision;
+using quantities::Abs;
 
 template<typename Method, typename Position>
 absl::Status SymplecticPartitionedRungeKuttaIntegrator<Method, Position>::
 Instance::Solve(Instant const& t_final) {
-  LOG(FATAL) << "I'm sorry Dave.  I'm afraid I can't do that.";
+  auto const& a = integrator_.a_;
+  auto const& b = integrator_.b_;
+
+  auto& current_state = this->current_state_;
+  auto& append_state = this->append_state_;
+  auto const& equation = this->equation_;
+  auto const& step = this->step_;
+
+  // |current_state| is updated as the integration progresses to allow
+  // restartability.
+
+  // Argument checks.
+  CHECK_NE(Time(), step);
+  Sign const integration_direction = Sign(step);
+  if (integration_direction.is_positive()) {
+    // Integrating forward.
+    CHECK_LT(current_state.time.value, t_final);
+  } else {
+    // Integrating backward.
+    CHECK_GT(current_state.time.value, t_final);
+  }
+
+  // Time step.
+  Time const& h = step;
+  Time const abs_h = integration_direction * h;
+  // Current time.  This is a non-const reference whose purpose is to make the
+  // equations more readable.
+  DoublePrecision<Instant>& t = current_state.time;
+
+  // The state after the evolutions computed so far in the current step, and
+  // the result of the next evolution.
+  typename ODE::State& y = y_;
+  typename ODE::State& y_stage = y_stage_;
+
+  absl::Status status;
+
+  while (abs_h <= Abs((t_final - t.value) - t.error)) {
+    for_all_of(current_state.y, y).loop(
+        [](auto const& current_yᵢ, auto& yᵢ) {
+          for (int k = 0; k < current_yᵢ.size(); ++k) {
+            yᵢ[k] = current_yᵢ[k].value;
+          }
+        });
+
+    // The fraction of the step by which B has advanced the time.
+    double c = 0;
+    for (int i = 0; i < stages_; ++i) {
+      if (b[i] != 0) {
+        // exp(bᵢ h B)
+        Instant const t_start = t.value + (t.error + c * h);
+        c += b[i];
+        termination_condition::UpdateWithAbort(
+            equation.right_flow(
+                t_start, t.value + (t.error + c * h), y, y_stage),
+            status);
+        std::swap(y, y_stage);
+      }
+      if (a[i] != 0) {
+        // exp(aᵢ h A)
+        Instant const t_stage = t.value + (t.error + c * h);
+        termination_condition::UpdateWithAbort(
+            equation.left_flow(t_stage, t_stage + a[i] * h, y, y_stage),
+            status);
+        std::swap(y, y_stage);
+      }
+    }
+
+    // Increment the solution.
+    t.Increment(h);
+    for_all_of(current_state.y, y).loop(
+        [](auto& current_yᵢ, auto const& yᵢ) {
+          for (int k = 0; k < current_yᵢ.size(); ++k) {
+            current_yᵢ[k].Increment(yᵢ[k] - current_yᵢ[k].value);
+          }
+        });
+    RETURN_IF_STOPPED;
+    append_state(current_state);
+    if (absl::IsAborted(status)) {
+      return status;
+    }
+  }
+
+  return status;
 }
 
 template<typename Method, typename Position>
@@ -26,7 +118,8 @@ Instance::integrator() const {
 
 template<typename Method, typename Position>
 not_null<std::unique_ptr<typename Integrator<
-    DecomposableFirstOrderDifferentialEquation<Position>>::Instance>>
+    DecomposableFirstOrderDifferentialEquation<Position,
+                                               Variation<Position>>>::Instance>>
 SymplecticPartitionedRungeKuttaIntegrator<Method, Position>::
 Instance::Clone() const {
   return std::unique_ptr<Instance>(new Instance(*this));
@@ -36,7 +129,26 @@ template<typename Method, typename Position>
 void SymplecticPartitionedRungeKuttaIntegrator<Method, Position>::
 Instance::WriteToMessage(
     not_null<serialization::IntegratorInstance*> message) const {
-  LOG(FATAL) << "WriteToMessage NYI";
+  // The instance has no state beyond that of its base class, so it may be
+  // deserialized by creating a new instance from the state and the step.
+  FixedStepSizeIntegrator<ODE>::Instance::WriteToMessage(message);
+}
+
+template<typename Method, typename Position>
+SymplecticPartitionedRungeKuttaIntegrator<Method, Position>::
+Instance::Instance(IntegrationProblem<ODE> const& problem,
+                   AppendState const& append_state,
+                   Time const& step,
+                   SymplecticPartitionedRungeKuttaIntegrator const& integrator)
+    : FixedStepSizeIntegrator<ODE>::Instance(problem, append_state, step),
+      integrator_(integrator) {
+  for_all_of(problem.initial_state.y, y_, y_stage_).loop(
+      [](auto const& initial_yᵢ, auto& yᵢ, auto& y_stageᵢ) {
+        for (auto const& initial_yᵢₖ : initial_yᵢ) {
+          yᵢ.push_back(initial_yᵢₖ.value);
+        }
+        y_stageᵢ = yᵢ;
+      });
 }
 
 template<typename Method, typename Position>
@@ -59,7 +171,8 @@ SymplecticPartitionedRungeKuttaIntegrator() {
 
 template<typename Method, typename Position>
 not_null<std::unique_ptr<typename Integrator<
-    DecomposableFirstOrderDifferentialEquation<Position>>::Instance>>
+    DecomposableFirstOrderDifferentialEquation<Position,
+                                               Variation<Position>>>::Instance>>
 SymplecticPartitionedRungeKuttaIntegrator<Method, Position>::
 NewInstance(IntegrationProblem<ODE> const& problem,
             AppendState const& append_state,
@@ -77,7 +190,8 @@ void SymplecticPartitionedRungeKuttaIntegrator<Method, Position>::
 
 template<typename Method, typename Position>
 not_null<std::unique_ptr<typename Integrator<
-    DecomposableFirstOrderDifferentialEquation<Position>>::Instance>>
+    DecomposableFirstOrderDifferentialEquation<Position,
+                                               Variation<Position>>>::Instance>>
 SymplecticPartitionedRungeKuttaIntegrator<Method, Position>::
 ReadFromMessage(serialization::FixedStepSizeIntegratorInstance const& message,
                 IntegrationProblem<ODE> const& problem,
@@ -0,0 +1,165 @@
+#include "integrators/symplectic_partitioned_runge_kutta_integrator.hpp"
+
+#include <cmath>
+#include <vector>
+
+#include "geometry/named_quantities.hpp"
+#include "glog/logging.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "integrators/methods.hpp"
+#include "quantities/elementary_functions.hpp"
+#include "quantities/named_quantities.hpp"
+#include "quantities/quantities.hpp"
+#include "quantities/si.hpp"
+#include "testing_utilities/matchers.hpp"
+#include "testing_utilities/numerics.hpp"
+#include "testing_utilities/statistics.hpp"
+
+namespace principia {
+namespace integrators {
+
+using geometry::Instant;
+using quantities::AngularFrequency;
+using quantities::Cos;
+using quantities::Length;
+using quantities::Speed;
+using quantities::Time;
+using quantities::si::Metre;
+using quantities::si::Radian;
+using quantities::si::Second;
+using testing_utilities::AbsoluteError;
+using testing_utilities::Slope;
+using ::testing::Eq;
+using ::testing::Lt;
+
+namespace {
+
+using ODE = DecomposableFirstOrderDifferentialEquation<Length, Speed>;
+
+// The harmonic oscillator q″ = -q, split into the kicks A and the drifts B.
+ODE HarmonicOscillator(int* const kicks) {
+  ODE harmonic_oscillator;
+  harmonic_oscillator.left_flow = [kicks](Instant const& t_initial,
+                                          Instant const& t_final,
+                                          ODE::State const& initial_state,
+                                          ODE::State& final_state) {
+    Time const τ = t_final - t_initial;
+    auto const& [q₀, v₀] = initial_state;
+    auto& [q₁, v₁] = final_state;
+    q₁[0] = q₀[0];
+    v₁[0] = v₀[0] - q₀[0] * τ / (Second * Second);
+    ++*kicks;
+    return absl::OkStatus();
+  };
+  harmonic_oscillator.right_flow = [](Instant const& t_initial,
+                                      Instant const& t_final,
+                                      ODE::State const& initial_state,
+                                      ODE::State& final_state) {
+    Time const τ = t_final - t_initial;
+    auto const& [q₀, v₀] = initial_state;
+    auto& [q₁, v₁] = final_state;
+    q₁[0] = q₀[0] + v₀[0] * τ;
+    v₁[0] = v₀[0];
+    return absl::OkStatus();
+  };
+  return harmonic_oscillator;
+}
+
+// Returns the order of convergence of the position for the given |Method| on
+// the harmonic oscillator.
+template<typename Method>
+double PositionConvergenceOrder(Time const& beginning_of_convergence) {
+  Length const q_initial = 1 * Metre;
+  Speed const v_initial = 0 * Metre / Second;
+  AngularFrequency const ω = 1 * Radian / Second;
+  Instant const t_initial;
+  Instant const t_final = t_initial + 100 * Second;
+
+  int kicks = 0;
+  IntegrationProblem<ODE> problem;
+  problem.equation = HarmonicOscillator(&kicks);
+  problem.initial_state = ODE::SystemState({{q_initial}, {v_initial}},
+                                           t_initial);
+  ODE::SystemState final_state;
+  auto const append_state = [&final_state](ODE::SystemState const& state) {
+    final_state = state;
+  };
+
+  std::vector<double> log_step_sizes;
+  std::vector<double> log_q_errors;
+  Time step = beginning_of_convergence;
+  for (int i = 0; i < 50; ++i, step /= 1.1) {
+    auto const instance =
+        SymplecticPartitionedRungeKuttaIntegrator<Method, Length>()
+            .NewInstance(problem, append_state, step);
+    EXPECT_OK(instance->Solve(t_final));
+    Time const t = final_state.time.value - t_initial;
+    Length const& q = std::get<0>(final_state.y)[0].value;
+    double const log_q_error =
+        std::log10(AbsoluteError(q / q_initial, Cos(ω * t)));
+    if (log_q_error <= -13) {
+      // If we keep going the effects of finite precision will drown out
+      // convergence.
+      break;
+    }
+    log_step_sizes.push_back(std::log10(step / Second));
+    log_q_errors.push_back(log_q_error);
+  }
+  return Slope(log_step_sizes, log_q_errors);
+}
+
+}  // namespace
+
+TEST(SymplecticPartitionedRungeKuttaIntegratorTest, Convergence) {
+  double const leapfrog_order =
+      PositionConvergenceOrder<methods::NewtonDelambreStørmerVerletLeapfrog>(
+          /*beginning_of_convergence=*/0.2 * Second);
+  EXPECT_THAT(AbsoluteError(2.0, leapfrog_order), Lt(0.1));
+  double const candy_rozmus_forest_ruth_order =
+      PositionConvergenceOrder<methods::CandyRozmus1991ForestRuth1990>(
+          /*beginning_of_convergence=*/0.2 * Second);
+  EXPECT_THAT(AbsoluteError(4.0, candy_rozmus_forest_ruth_order), Lt(0.1));
+}
+
+TEST(SymplecticPartitionedRungeKuttaIntegratorTest, Evaluations) {
+  Instant const t_initial;
+  Instant const t_final = t_initial + 10 * Second;
+  Time const step = 0.125 * Second;
+
+  int kicks = 0;
+  IntegrationProblem<ODE> problem;
+  problem.equation = HarmonicOscillator(&kicks);
+  problem.initial_state = ODE::SystemState({{1 * Metre}, {0 * Metre / Second}},
+                                           t_initial);
+  std::vector<ODE::SystemState> solution;
+  auto const append_state = [&solution](ODE::SystemState const& state) {
+    solution.push_back(state);
+  };
+  auto const instance =
+      SymplecticPartitionedRungeKuttaIntegrator<
+          methods::CandyRozmus1991ForestRuth1990, Length>()
+          .NewInstance(problem, append_state, step);
+  EXPECT_OK(instance->Solve(t_final));
+
+  // The evolutions with a vanishing coefficient are skipped, so each step only
+  // has as many kicks as the method has evaluations.
+  EXPECT_THAT(solution.size(), Eq(80));
+  EXPECT_THAT(kicks,
+              Eq(80 * methods::CandyRozmus1991ForestRuth1990::evaluations));
+  EXPECT_EQ(t_final, solution.back().time.value);
+}
+
+TEST(SymplecticPartitionedRungeKuttaIntegratorTest, SystemStateSerialization) {
+  ODE::SystemState const system_state(
+      {{1 * Metre, 2 * Metre}, {3 * Metre / Second, 4 * Metre / Second}},
+      Instant() + 5 * Second);
+  serialization::SystemState message;
+  system_state.WriteToMessage(&message);
+  EXPECT_EQ(2, message.position_size());
+  EXPECT_EQ(2, message.velocity_size());
+  EXPECT_EQ(system_state, ODE::SystemState::ReadFromMessage(message));
+}
+
+}  // namespace integrators
+}  // namespace principia
@@ -9,6 +9,8 @@
 #ifndef PRINCIPIA_INTEGRATORS_SYMPLECTIC_RUNGE_KUTTA_NYSTRÖM_INTEGRATOR_HPP_
 #define PRINCIPIA_INTEGRATORS_SYMPLECTIC_RUNGE_KUTTA_NYSTRÖM_INTEGRATOR_HPP_
 
+#include <vector>
+
 #include "absl/status/status.h"
 #include "integrators/methods.hpp"
 #include "integrators/ordinary_differential_equations.hpp"
@@ -98,6 +100,13 @@ class SymplecticRungeKuttaNyströmIntegrator
              Time const& step,
              SymplecticRungeKuttaNyströmIntegrator const& integrator);
 
+    // Buffers used by |Solve|.  They are sized at construction so that solving
+    // the instance repeatedly does not allocate.
+    std::vector<typename ODE::Displacement> Δq_;
+    std::vector<typename ODE::Velocity> Δv_;
+    std::vector<Position> q_stage_;
+    std::vector<typename ODE::Acceleration> g_;
+
     SymplecticRungeKuttaNyströmIntegrator const& integrator_;
     friend class SymplecticRungeKuttaNyströmIntegrator;
   };
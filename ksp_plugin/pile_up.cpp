@@ -73,6 +73,10 @@ const auto part_x = Vector<double, RigidPart>({1, 0, 0});
 const auto part_y = Vector<double, RigidPart>({0, 1, 0});
 const auto part_z = Vector<double, RigidPart>({0, 0, 1});
 
+// Below this number of pile-ups, sharing an instance is not worth the cost of
+// aligning the histories.
+constexpr int min_pile_ups_per_batch = 2;
+
 PileUp::PileUp(
     std::list<not_null<Part*>> parts,
     Instant const& t,
@@ -600,7 +604,11 @@ void PileUp::DeformPileUpIfNeeded(Instant const& t) {
 
 absl::Status PileUp::AdvanceTime(Instant const& t) {
   absl::Status status;
-  Instant const history_last = history_->back().time;
+  // If this pile-up was in a |PileUpBatch|, its parts may lack the end of the
+  // |history_|.
+  Instant const history_last =
+      batched_history_last_.value_or(history_->back().time);
+  batched_history_last_.reset();
   if (intrinsic_force_ == Vector<Force, Barycentric>{}) {
     // Remove the fork.
     trajectory_.DeleteSegments(psychohistory_);
@@ -613,17 +621,9 @@ absl::Status PileUp::AdvanceTime(Instant const& t) {
     CHECK_LT(history_->back().time, t);
     status = ephemeris_->FlowWithFixedStep(t, *fixed_instance_);
     psychohistory_ = trajectory_.NewSegment();
-    if (history_->back().time < t) {
-      // Do not clear the |fixed_instance_| here, we will use it for the next
-      // fixed-step integration.
-      status.Update(
-          ephemeris_->FlowWithAdaptiveStep(
-              &trajectory_,
-              Ephemeris<Barycentric>::NoIntrinsicAcceleration,
-              t,
-              adaptive_step_parameters_,
-              Ephemeris<Barycentric>::unlimited_max_ephemeris_steps));
-    }
+    // Do not clear the |fixed_instance_| here, we will use it for the next
+    // fixed-step integration.
+    status.Update(FlowPsychohistory(t));
   } else {
     // Destroy the fixed instance, it wouldn't be correct to use it the next
     // time we go through this function.  It will be re-created as needed.
@@ -652,6 +652,23 @@ absl::Status PileUp::AdvanceTime(Instant const& t) {
     psychohistory_ = trajectory_.NewSegment();
   }
 
+  AppendToParts(history_last);
+  return status;
+}
+
+absl::Status PileUp::FlowPsychohistory(Instant const& t) {
+  if (history_->back().time < t) {
+    return ephemeris_->FlowWithAdaptiveStep(
+        &trajectory_,
+        Ephemeris<Barycentric>::NoIntrinsicAcceleration,
+        t,
+        adaptive_step_parameters_,
+        Ephemeris<Barycentric>::unlimited_max_ephemeris_steps);
+  }
+  return absl::OkStatus();
+}
+
+void PileUp::AppendToParts(Instant const& history_last) {
   // Append the |history_| to the parts' history and the |psychohistory_| to the
   // parts' psychohistory.  Drop the history of the pile-up, we won't need it
   // anymore.
@@ -666,8 +683,6 @@ absl::Status PileUp::AdvanceTime(Instant const& t) {
     AppendToPart<&Part::AppendToPsychohistory>(it);
   }
   trajectory_.ForgetBefore(psychohistory_->front().time);
-
-  return status;
 }
 
 void PileUp::NudgeParts() const {
@@ -709,6 +724,163 @@ void PileUp::AppendToPart(DiscreteTrajectory<Barycentric>::iterator it) const {
   }
 }
 
+std::atomic<std::uint64_t> PileUp::next_serial_number_ = 0;
+
+void PileUpBatch::Reset(std::list<PileUp*> const& pile_ups) {
+  absl::MutexLock l(&lock_);
+  std::vector<not_null<PileUp*>> batched_pile_ups;
+  std::vector<std::uint64_t> batched_serial_numbers;
+  for (PileUp* const pile_up : pile_ups) {
+    if (pile_up->intrinsic_force_ == Vector<Force, Barycentric>{} &&
+        pile_up->apparent_part_rigid_motion_.empty() &&
+        (batched_pile_ups.empty() ||
+         pile_up->fixed_step_parameters_.step() ==
+             batched_pile_ups.front()->fixed_step_parameters_.step())) {
+      batched_pile_ups.push_back(check_not_null(pile_up));
+      batched_serial_numbers.push_back(pile_up->serial_number_);
+    }
+  }
+  if (batched_pile_ups.size() < min_pile_ups_per_batch) {
+    batched_pile_ups.clear();
+    batched_serial_numbers.clear();
+  }
+
+  // If the batch didn't change and its histories were not advanced otherwise,
+  // keep the instance, it knows the previous steps of the integration.
+  if (instance_ != nullptr &&
+      batched_pile_ups == pile_ups_ &&
+      batched_serial_numbers == serial_numbers_ &&
+      std::all_of(pile_ups_.begin(),
+                  pile_ups_.end(),
+                  [time = instance_->time().value](PileUp const* pile_up) {
+                    return pile_up->history_->back().time == time;
+                  })) {
+    return;
+  }
+
+  instance_ = nullptr;
+  last_flow_time_.reset();
+  pile_ups_.clear();
+  serial_numbers_.clear();
+  indices_.clear();
+  if (batched_pile_ups.empty()) {
+    return;
+  }
+
+  // Align the histories on the last point of the most recent one.  A pile-up
+  // whose history cannot be aligned is left out of the batch.
+  Instant t_align = batched_pile_ups.front()->history_->back().time;
+  for (PileUp const* const pile_up : batched_pile_ups) {
+    t_align = std::max(t_align, pile_up->history_->back().time);
+  }
+  std::vector<not_null<DiscreteTrajectory<Barycentric>*>> trajectories;
+  for (not_null<PileUp*> const pile_up : batched_pile_ups) {
+    absl::MutexLock l(pile_up->lock_.get());
+    pile_up->fixed_instance_ = nullptr;
+    Instant const history_last = pile_up->batched_history_last_.value_or(
+        pile_up->history_->back().time);
+    pile_up->batched_history_last_.reset();
+    if (pile_up->history_->back().time < t_align) {
+      pile_up->trajectory_.DeleteSegments(pile_up->psychohistory_);
+      pile_up->ephemeris_->FlowWithAdaptiveStep(
+          &pile_up->trajectory_,
+          Ephemeris<Barycentric>::NoIntrinsicAcceleration,
+          t_align,
+          pile_up->adaptive_step_parameters_,
+          Ephemeris<Barycentric>::unlimited_max_ephemeris_steps)
+          .IgnoreError();
+      pile_up->psychohistory_ = pile_up->trajectory_.NewSegment();
+    }
+    if (history_last < pile_up->history_->back().time) {
+      pile_up->AppendToParts(history_last);
+    }
+    if (pile_up->history_->back().time == t_align) {
+      indices_.emplace(pile_up, pile_ups_.size());
+      pile_ups_.push_back(pile_up);
+      serial_numbers_.push_back(pile_up->serial_number_);
+      trajectories.push_back(&pile_up->trajectory_);
+    }
+  }
+  if (pile_ups_.size() < min_pile_ups_per_batch) {
+    pile_ups_.clear();
+    serial_numbers_.clear();
+    indices_.clear();
+    return;
+  }
+
+  PileUp const& front = *pile_ups_.front();
+  instance_ = front.ephemeris_->NewBatchedInstance(
+      trajectories, front.fixed_step_parameters_, &collided_);
+}
+
+bool PileUpBatch::Contains(not_null<PileUp const*> const pile_up) const {
+  absl::ReaderMutexLock l(&lock_);
+  return IndexOf(*pile_up).has_value();
+}
+
+absl::Status PileUpBatch::DeformAndAdvanceTime(PileUp& pile_up,
+                                               Instant const& t) {
+  std::optional<int> index;
+  {
+    absl::ReaderMutexLock l(&lock_);
+    index = IndexOf(pile_up);
+  }
+  if (!index.has_value()) {
+    return pile_up.DeformAndAdvanceTime(t);
+  }
+
+  absl::Status status;
+  {
+    absl::MutexLock l(&lock_);
+    if (!last_flow_time_.has_value() || *last_flow_time_ < t) {
+      FlowHistories(t);
+    }
+    status = last_flow_status_;
+    if (collided_[*index]) {
+      status.Update(absl::OutOfRangeError("Collision detected"));
+    }
+  }
+
+  absl::MutexLock l(pile_up.lock_.get());
+  if (pile_up.batched_history_last_.has_value()) {
+    pile_up.DeformPileUpIfNeeded(t);
+    status.Update(pile_up.FlowPsychohistory(t));
+    pile_up.AppendToParts(*pile_up.batched_history_last_);
+    pile_up.batched_history_last_.reset();
+    pile_up.NudgeParts();
+  }
+  return status;
+}
+
+void PileUpBatch::FlowHistories(Instant const& t) {
+  // The parts of a pile-up may not have been updated after the previous
+  // integration if this method is called for a later |t|.
+  Instant const history_last = instance_->time().value;
+  for (not_null<PileUp*> const pile_up : pile_ups_) {
+    absl::MutexLock l(pile_up->lock_.get());
+    pile_up->trajectory_.DeleteSegments(pile_up->psychohistory_);
+    if (!pile_up->batched_history_last_.has_value()) {
+      pile_up->batched_history_last_ = history_last;
+    }
+  }
+  last_flow_status_ =
+      pile_ups_.front()->ephemeris_->FlowWithFixedStep(t, *instance_);
+  for (not_null<PileUp*> const pile_up : pile_ups_) {
+    absl::MutexLock l(pile_up->lock_.get());
+    pile_up->psychohistory_ = pile_up->trajectory_.NewSegment();
+  }
+  last_flow_time_ = t;
+}
+
+std::optional<int> PileUpBatch::IndexOf(PileUp const& pile_up) const {
+  if (auto const it = indices_.find(&pile_up);
+      it != indices_.end() &&
+      serial_numbers_[it->second] == pile_up.serial_number_) {
+    return it->second;
+  }
+  return std::nullopt;
+}
+
 PileUpFuture::PileUpFuture(not_null<PileUp const*> const pile_up,
                            std::future<absl::Status> future)
     : pile_up(pile_up),
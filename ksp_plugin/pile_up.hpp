@@ -1,6 +1,8 @@
 ﻿
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <future>
 #include <list>
@@ -8,6 +10,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/synchronization/mutex.h"
@@ -185,12 +188,27 @@ class PileUp {
   // |DeformPileUpIfNeeded|.
   void NudgeParts() const;
 
+  // Flows the |psychohistory_|, which must consist of the last point of the
+  // |history_|, with an adaptive step until |t|.
+  absl::Status FlowPsychohistory(Instant const& t);
+
+  // Appends the points of the |history_| after |history_last| to the parts'
+  // histories and the |psychohistory_| to the parts' psychohistories, and
+  // forgets the |trajectory_| before the |psychohistory_|.
+  void AppendToParts(Instant const& history_last);
+
   template<AppendToPartTrajectory append_to_part_trajectory>
   void AppendToPart(DiscreteTrajectory<Barycentric>::iterator it) const;
 
   // Wrapped in a |unique_ptr| to be moveable.
   not_null<std::unique_ptr<absl::Mutex>> lock_;
 
+  // Distinguishes this pile-up from all the other pile-ups constructed in this
+  // process, including those that were allocated at the same address after it
+  // was destroyed.  Not serialized.
+  std::uint64_t serial_number_ = next_serial_number_++;
+  static std::atomic<std::uint64_t> next_serial_number_;
+
   std::list<not_null<Part*>> parts_;
   not_null<Ephemeris<Barycentric>*> ephemeris_;
   Ephemeris<Barycentric>::AdaptiveStepParameters adaptive_step_parameters_;
@@ -237,6 +255,11 @@ class PileUp {
       Ephemeris<Barycentric>::NewtonianMotionEquation>::Instance>
       fixed_instance_;
 
+  // Set when the |history_| was integrated by the instance of a |PileUpBatch|
+  // but the parts were not updated yet, in which case this is the last time of
+  // the |history_| before that integration.  Not serialized.
+  std::optional<Instant> batched_history_last_;
+
   PartTo<RigidMotion<RigidPart, NonRotatingPileUp>> actual_part_rigid_motion_;
   PartTo<RigidMotion<RigidPart, Apparent>> apparent_part_rigid_motion_;
 
@@ -247,9 +270,57 @@ class PileUp {
   // Called in the destructor.
   std::function<void()> deletion_callback_;
 
+  friend class PileUpBatch;
   friend class TestablePileUp;
 };
 
+// The pile-ups that are not subject to an intrinsic force and whose parts have
+// no apparent motion, i.e., the unloaded, unaccelerated ones, may share a
+// single fixed-step instance for integrating their histories, so that the
+// evaluation of the ephemeris is amortized over all of them.  The histories
+// are aligned on the last point of the most recent one when a batch is
+// created.  This class is thread-safe.
+class PileUpBatch {
+ public:
+  // Makes the batch consist of those of the |pile_ups| whose histories may be
+  // integrated together.  The instance is reused if the batch didn't change,
+  // otherwise the histories are aligned and a new instance is created.  Must
+  // not be called concurrently with any method of the |pile_ups|.
+  void Reset(std::list<PileUp*> const& pile_ups);
+
+  bool Contains(not_null<PileUp const*> pile_up) const;
+
+  // Same as |pile_up.DeformAndAdvanceTime(t)|, but if the |pile_up| is in the
+  // batch its history is integrated together with those of the other pile-ups
+  // of the batch, the first time this method is called for |t|.
+  absl::Status DeformAndAdvanceTime(PileUp& pile_up, Instant const& t);
+
+ private:
+  // Integrates the histories of all the pile-ups of the batch until |t| with
+  // the |instance_|.
+  void FlowHistories(Instant const& t) EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Returns the index of |pile_up| in |pile_ups_|, if it is in the batch.
+  std::optional<int> IndexOf(PileUp const& pile_up) const
+      SHARED_LOCKS_REQUIRED(lock_);
+
+  mutable absl::Mutex lock_;
+  // The pile-ups are identified by their address and their serial number,
+  // since a pile-up may be destroyed and another one allocated at the same
+  // address between two calls to |Reset|.
+  std::vector<not_null<PileUp*>> pile_ups_ GUARDED_BY(lock_);
+  std::vector<std::uint64_t> serial_numbers_ GUARDED_BY(lock_);
+  std::map<PileUp const*, int> indices_ GUARDED_BY(lock_);
+  // Indexed like |pile_ups_|.  Must outlive the |instance_|.
+  std::vector<bool> collided_ GUARDED_BY(lock_);
+  std::unique_ptr<typename Integrator<
+      Ephemeris<Barycentric>::NewtonianMotionEquation>::Instance>
+      instance_ GUARDED_BY(lock_);
+  // The time of the last call to |FlowHistories| and its status.
+  std::optional<Instant> last_flow_time_ GUARDED_BY(lock_);
+  absl::Status last_flow_status_ GUARDED_BY(lock_);
+};
+
 // A convenient data object to track a pile-up and the result of integrating it.
 struct PileUpFuture {
   PileUpFuture(not_null<PileUp const*> pile_up,
@@ -261,6 +332,7 @@ struct PileUpFuture {
 }  // namespace internal_pile_up
 
 using internal_pile_up::PileUp;
+using internal_pile_up::PileUpBatch;
 using internal_pile_up::PileUpFuture;
 
 }  // namespace ksp_plugin
@@ -19,7 +19,6 @@ using geometry::R3Element;
 using geometry::RP2Line;
 using geometry::Sign;
 using geometry::Velocity;
-using physics::MassiveBody;
 using quantities::Infinity;
 using quantities::Pow;
 using quantities::Sin;
@@ -391,11 +390,11 @@ std::vector<Sphere<Navigation>> Planetarium::ComputePlottableSpheres(
   std::vector<Sphere<Navigation>> plottable_spheres;
 
   auto const& bodies = ephemeris_->bodies();
-  for (not_null<MassiveBody const*> const body : bodies) {
-    auto const trajectory = ephemeris_->trajectory(body);
-    Length const mean_radius = body->mean_radius();
-    Position<Barycentric> const centre_in_barycentric =
-        trajectory->EvaluatePosition(now);
+  auto const centres_in_barycentric = ephemeris_->EvaluateAllPositions(now);
+  for (int i = 0; i < bodies.size(); ++i) {
+    Length const mean_radius = bodies[i]->mean_radius();
+    Position<Barycentric> const& centre_in_barycentric =
+        centres_in_barycentric[i];
     Sphere<Navigation> plottable_sphere(
         rigid_motion_at_now.rigid_transformation()(centre_in_barycentric),
         parameters_.sphere_radius_multiplier_ * mean_radius);
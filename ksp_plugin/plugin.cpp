@@ -22,6 +22,7 @@
 #include "astronomy/stabilize_ksp.hpp"
 #include "astronomy/time_scales.hpp"
 #include "base/file.hpp"
+#include "base/flags.hpp"
 #include "base/hexadecimal.hpp"
 #include "base/map_util.hpp"
 #include "base/not_null.hpp"
@@ -48,10 +49,12 @@
 #include "physics/body_centred_non_rotating_dynamic_frame.hpp"
 #include "physics/body_surface_dynamic_frame.hpp"
 #include "physics/body_surface_frame_field.hpp"
+#include "physics/conjunctions.hpp"
 #include "physics/dynamic_frame.hpp"
 #include "physics/frame_field.hpp"
 #include "physics/massive_body.hpp"
 #include "physics/solar_system.hpp"
+#include "quantities/parser.hpp"
 #include "quantities/quantities.hpp"
 #include "quantities/si.hpp"
 
@@ -69,6 +72,7 @@ using base::check_not_null;
 using base::dynamic_cast_not_null;
 using base::FindOrDie;
 using base::Fingerprint2011;
+using base::Flags;
 using base::HexadecimalEncoder;
 using base::make_not_null_unique;
 using base::not_null;
@@ -96,17 +100,21 @@ using physics::BodySurfaceDynamicFrame;
 using physics::BodySurfaceFrameField;
 using physics::ComputeApsides;
 using physics::ComputeNodes;
+using physics::Conjunction;
 using physics::CoordinateFrameField;
 using physics::DynamicFrame;
 using physics::Frenet;
 using physics::KeplerianElements;
 using physics::MassiveBody;
 using physics::RigidMotion;
+using physics::ScreenConjunctions;
 using physics::SolarSystem;
+using physics::TrajectorySection;
 using quantities::Force;
 using quantities::Infinity;
 using quantities::Length;
 using quantities::MomentOfInertia;
+using quantities::ParseQuantity;
 using quantities::si::Milli;
 using quantities::si::Minute;
 using quantities::si::Radian;
@@ -240,6 +248,8 @@ void Plugin::EndInitialization() {
                                      DefaultEphemerisAccuracyParameters()),
                                  ephemeris_fixed_step_parameters_.value_or(
                                      DefaultEphemerisFixedStepParameters()));
+  SetEphemerisParallelism();
+  StartEphemerisLookAheadProlongationIfRequested();
 
   // Construct the celestials using the bodies from the ephemeris.
   for (std::string const& name : solar_system.names()) {
@@ -778,7 +788,12 @@ void Plugin::AdvanceTime(Instant const& t, Angle const& planetarium_rotation) {
 void Plugin::CatchUpLaggingVessels(VesselSet& collided_vessels) {
   CHECK(!initializing_);
 
-  // Start all the integrations in parallel.
+  // The pile-ups may have changed since the last call, so the batch must be
+  // updated before any integration starts.
+  pile_up_batch_.Reset(pile_ups_);
+
+  // Start all the integrations in parallel.  The tasks of the pile-ups of the
+  // batch wait for the first one to integrate all their histories.
   std::vector<PileUpFuture> pile_up_futures;
   for (auto* const pile_up : pile_ups_) {
     pile_up_futures.emplace_back(
@@ -786,7 +801,7 @@ void Plugin::CatchUpLaggingVessels(VesselSet& collided_vessels) {
         vessel_thread_pool_.Add([this, pile_up]() {
           // Note that there cannot be contention in the following method as
           // no two pile-ups are advanced at the same time.
-          return pile_up->DeformAndAdvanceTime(current_time_);
+          return pile_up_batch_.DeformAndAdvanceTime(*pile_up, current_time_);
         }));
   }
 
@@ -825,7 +840,7 @@ not_null<std::unique_ptr<PileUpFuture>> Plugin::CatchUpVessel(
         // caller is catching-up two vessels belonging to the same pile-up in
         // parallel.
         absl::Status const status =
-            pile_up->DeformAndAdvanceTime(current_time_);
+            pile_up_batch_.DeformAndAdvanceTime(*pile_up, current_time_);
         if (!status.ok()) {
           vessel.DisableDownsampling();
         }
@@ -1005,6 +1020,37 @@ void Plugin::ComputeAndRenderClosestApproaches(
           PlanetariumRotation());
 }
 
+std::vector<Plugin::VesselConjunction> Plugin::ComputeConjunctions(
+    Length const& threshold) const {
+  std::vector<GUID> guids;
+  std::vector<TrajectorySection<Barycentric>> predictions;
+  for (auto const& [guid, vessel] : vessels_) {
+    auto const prediction = vessel->prediction();
+    guids.push_back(guid);
+    predictions.emplace_back(prediction->begin(), prediction->end());
+  }
+
+  if (conjunctions_thread_pool_ == nullptr) {
+    conjunctions_thread_pool_ = std::make_unique<ThreadPool<void>>(
+        /*pool_size=*/std::thread::hardware_concurrency());
+  }
+
+  std::vector<VesselConjunction> vessel_conjunctions;
+  // The steps of the predictions are adaptive; the duration of the buckets is
+  // a compromise between the size of the bounding boxes and their number.
+  for (Conjunction<Barycentric> const& conjunction :
+       ScreenConjunctions(predictions,
+                          threshold,
+                          /*bucket_duration=*/10 * Minute,
+                          conjunctions_thread_pool_.get())) {
+    vessel_conjunctions.push_back({.vessel1 = guids[conjunction.index1],
+                                   .vessel2 = guids[conjunction.index2],
+                                   .time = conjunction.time,
+                                   .distance = conjunction.distance});
+  }
+  return vessel_conjunctions;
+}
+
 void Plugin::ComputeAndRenderNodes(
     DiscreteTrajectory<Barycentric>::iterator const& begin,
     DiscreteTrajectory<Barycentric>::iterator const& end,
@@ -1443,9 +1489,11 @@ not_null<std::unique_ptr<Plugin>> Plugin::ReadFromMessage(
       Ephemeris<Barycentric>::ReadFromMessage(/*using_checkpoint_at_or_before=*/
                                               plugin->current_time_,
                                               message.ephemeris());
+  plugin->SetEphemerisParallelism();
   plugin->ephemeris_->Prolong(plugin->game_epoch_).IgnoreError();
   plugin->ephemeris_->Prolong(plugin->current_time_).IgnoreError();
   CHECK_LE(plugin->ephemeris_->t_min(), plugin->current_time_);
+  plugin->StartEphemerisLookAheadProlongationIfRequested();
 
   ReadCelestialsFromMessages(*plugin->ephemeris_,
                              message.celestial(),
@@ -1597,6 +1645,23 @@ void Plugin::UpdatePlanetariumRotation() {
       DefinesFrame<CameraCompensatedReference>{});
 }
 
+void Plugin::SetEphemerisParallelism() {
+  ephemeris_->SetMassiveBodiesParallelism(
+      /*number_of_threads=*/std::max(1u, std::thread::hardware_concurrency()),
+      /*identical_to_serial=*/true);
+}
+
+void Plugin::StartEphemerisLookAheadProlongationIfRequested() {
+  auto const values = Flags::Values("ephemeris_look_ahead");
+  if (values.empty()) {
+    return;
+  }
+  CHECK_EQ(1, values.size()) << "Multiple values for ephemeris_look_ahead";
+  Time const horizon = ParseQuantity<Time>(*values.begin());
+  LOG(INFO) << "Prolonging the ephemeris " << horizon << " ahead";
+  ephemeris_->StartLookAheadProlongation(horizon);
+}
+
 Velocity<World> Plugin::VesselVelocity(
     Instant const& time,
     DegreesOfFreedom<Barycentric> const& degrees_of_freedom) const {
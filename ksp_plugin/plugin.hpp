@@ -300,7 +300,8 @@ class Plugin {
   // there, filling the tails of all their parts up to that instant; then
   // advances time on all vessels that are not yet at |current_time_|.  Inserts
   // the set of vessels that have collided with a celestial into
-  // |collided_vessels|.
+  // |collided_vessels|.  The histories of the unloaded, unaccelerated pile ups
+  // are integrated together, here and in |CatchUpVessel|.
   virtual void CatchUpLaggingVessels(VesselSet& collided_vessels);
 
   // Advances time to |current_time_| on the pile up containing the given
@@ -370,6 +371,22 @@ class Plugin {
       int max_points,
       DiscreteTrajectory<World>& closest_approaches) const;
 
+  // A closest approach between the predictions of two vessels.
+  struct VesselConjunction {
+    GUID vessel1;
+    GUID vessel2;
+    Instant time;
+    Length distance;
+  };
+
+  // Screens the predictions of all the vessels against each other and returns
+  // their closest approaches within |threshold|, in increasing time order.  The
+  // screening runs on |conjunctions_thread_pool_|, created by the first call.
+  // This function is not exposed through the interface, it is for use by C++
+  // clients of the plugin.
+  virtual std::vector<VesselConjunction> ComputeConjunctions(
+      Length const& threshold) const;
+
   // Computes the nodes of the trajectory defined by |begin| and |end| with
   // respect to plane of the trajectory of the targetted vessel.
   virtual void ComputeAndRenderNodes(
@@ -477,6 +494,19 @@ class Plugin {
   // whenever |main_body_| or |planetarium_rotation_| changes.
   void UpdatePlanetariumRotation();
 
+  // Makes the ephemeris compute the accelerations on all the hardware threads,
+  // with the same results as the serial computation.  This parallelizes the
+  // computation of the histories of the |pile_up_batch_| by ranges of
+  // pile-ups.  Must be called once |ephemeris_| has been constructed, before
+  // it is prolonged.
+  void SetEphemerisParallelism();
+
+  // If the flag |ephemeris_look_ahead| is set to a duration (e.g., "6 h"),
+  // starts prolonging the ephemeris asynchronously that far beyond the times
+  // passed to |Prolong|.  Must be called once |ephemeris_| has been
+  // constructed.
+  void StartEphemerisLookAheadProlongationIfRequested();
+
   Velocity<World> VesselVelocity(
       Instant const& time,
       DegreesOfFreedom<Barycentric> const& degrees_of_freedom) const;
@@ -535,6 +565,10 @@ class Plugin {
 
   // The thread pool for advancing vessels.
   ThreadPool<absl::Status> vessel_thread_pool_;
+  // The thread pool for screening conjunctions, null until the first call to
+  // |ComputeConjunctions|.  Mutable because the screening doesn't change the
+  // state of the plugin.
+  mutable std::unique_ptr<ThreadPool<void>> conjunctions_thread_pool_;
 
   Angle planetarium_rotation_;
   std::optional<Rotation<Barycentric, AliceSun>> cached_planetarium_rotation_;
@@ -557,6 +591,9 @@ class Plugin {
   // and the pile-up will remove itself once no part owns it.  The elements are
   // not |not_null<>| because we temporarily need to insert null pointers.
   std::list<PileUp*> pile_ups_;
+  // The unloaded, unaccelerated pile-ups whose histories are integrated
+  // together.  Updated by |CatchUpLaggingVessels|.
+  PileUpBatch pile_up_batch_;
 
   // The vessels that are currently loaded, i.e. in the physics bubble.
   VesselSet loaded_vessels_;
@@ -2,7 +2,10 @@
 #include "ksp_plugin/pile_up.hpp"
 
 #include <limits>
+#include <list>
 #include <map>
+#include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -27,6 +30,7 @@
 #include "testing_utilities/almost_equals.hpp"
 #include "testing_utilities/componentwise.hpp"
 #include "testing_utilities/matchers.hpp"
+#include "testing_utilities/numerics_matchers.hpp"
 #include "testing_utilities/vanishes_before.hpp"
 
 namespace principia {
@@ -65,6 +69,7 @@ using quantities::si::Micro;
 using quantities::si::Newton;
 using quantities::si::Radian;
 using quantities::si::Second;
+using testing_utilities::AbsoluteErrorFrom;
 using testing_utilities::AlmostEquals;
 using testing_utilities::Componentwise;
 using testing_utilities::EqualsProto;
@@ -73,7 +78,9 @@ using ::testing::ByMove;
 using ::testing::DoAll;
 using ::testing::ElementsAre;
 using ::testing::Eq;
+using ::testing::Gt;
 using ::testing::IsEmpty;
+using ::testing::Lt;
 using ::testing::Matcher;
 using ::testing::MockFunction;
 using ::testing::Return;
@@ -255,6 +262,45 @@ class PileUpTest : public testing::Test {
     EXPECT_THAT(pile_up.apparent_part_rigid_motion(), IsEmpty());
   }
 
+  // An ephemeris with a tiny body very far, so that the motions of the
+  // pile-ups are uniform.
+  static not_null<std::unique_ptr<Ephemeris<Barycentric>>>
+  MakeUniformMotionEphemeris() {
+    std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+    bodies.emplace_back(make_not_null_unique<MassiveBody>(1 * Kilogram));
+    std::vector<DegreesOfFreedom<Barycentric>> const initial_state{
+        DegreesOfFreedom<Barycentric>{
+            Barycentric::origin +
+                Displacement<Barycentric>(
+                    {std::pow(2, 100) * Metre, 0 * Metre, 0 * Metre}),
+            Barycentric::unmoving}};
+    return make_not_null_unique<Ephemeris<Barycentric>>(
+        std::move(bodies),
+        initial_state,
+        /*initial_time=*/astronomy::J2000,
+        /*accuracy_parameters=*/Ephemeris<Barycentric>::AccuracyParameters(
+            /*fitting_tolerance=*/1 * Metre,
+            /*geopotential_tolerance=*/0x1p-24),
+        Ephemeris<Barycentric>::FixedStepParameters(
+            SymplecticRungeKuttaNyströmIntegrator<BlanesMoan2002SRKN6B,
+                                                  Position<Barycentric>>(),
+            1 * Second));
+  }
+
+  // Constructs in |pile_up| a pile-up made of |part| at time |t|, which may be
+  // part of a |PileUpBatch|.
+  void EmplaceBatchablePileUp(std::optional<TestablePileUp>& pile_up,
+                              Part& part,
+                              Instant const& t,
+                              Ephemeris<Barycentric>& ephemeris) {
+    pile_up.emplace(std::list<not_null<Part*>>{&part},
+                    t,
+                    DefaultPsychohistoryParameters(),
+                    DefaultHistoryParameters(),
+                    &ephemeris,
+                    deletion_callback_.AsStdFunction());
+  }
+
   MockFunction<void()> deletion_callback_;
 
   PartId const part_id1_ = 111;
@@ -645,6 +691,169 @@ TEST_F(PileUpTest, MidStepIntrinsicForce) {
       AlmostEquals(old_velocity + 0.5 * fixed_step * a, 1));
 }
 
+// Checks that the pile-ups of a batch move as they would on their own.
+TEST_F(PileUpTest, Batch) {
+  auto const ephemeris = MakeUniformMotionEphemeris();
+
+  // The pile-ups are created at different times, so their histories must be
+  // aligned.
+  Instant const t1 = astronomy::J2000;
+  Instant const t2 = astronomy::J2000 + 3 * Second;
+  EXPECT_CALL(deletion_callback_, Call()).Times(2);
+  std::optional<TestablePileUp> pile_up1;
+  std::optional<TestablePileUp> pile_up2;
+  EmplaceBatchablePileUp(pile_up1, p1_, t1, *ephemeris);
+  EmplaceBatchablePileUp(pile_up2, p2_, t2, *ephemeris);
+  std::list<PileUp*> const pile_ups{&*pile_up1, &*pile_up2};
+
+  PileUpBatch batch;
+  batch.Reset(pile_ups);
+  EXPECT_TRUE(batch.Contains(&*pile_up1));
+  EXPECT_TRUE(batch.Contains(&*pile_up2));
+
+  Instant t = t2;
+  for (int i = 0; i < 10; ++i) {
+    t += 7 * Second;
+    EXPECT_OK(batch.DeformAndAdvanceTime(*pile_up1, t));
+    EXPECT_OK(batch.DeformAndAdvanceTime(*pile_up2, t));
+    // Nothing changed, the instance is reused.
+    batch.Reset(pile_ups);
+  }
+
+  EXPECT_THAT(
+      p1_.rigid_motion()({RigidPart::origin, RigidPart::unmoving}),
+      Componentwise(
+          AbsoluteErrorFrom(
+              p1_dof_.position() + p1_dof_.velocity() * (t - t1),
+              Lt(1 * Micro(Metre))),
+          AbsoluteErrorFrom(p1_dof_.velocity(),
+                            Lt(1 * Micro(Metre) / Second))));
+  EXPECT_THAT(
+      p2_.rigid_motion()({RigidPart::origin, RigidPart::unmoving}),
+      Componentwise(
+          AbsoluteErrorFrom(
+              p2_dof_.position() + p2_dof_.velocity() * (t - t2),
+              Lt(1 * Micro(Metre))),
+          AbsoluteErrorFrom(p2_dof_.velocity(),
+                            Lt(1 * Micro(Metre) / Second))));
+  EXPECT_EQ(t, pile_up1->psychohistory()->back().time);
+  EXPECT_EQ(t, pile_up2->psychohistory()->back().time);
+
+  // A pile-up subject to an intrinsic force leaves the batch, which is then too
+  // small to exist.
+  p1_.apply_intrinsic_force(p1_.mass() * Vector<Acceleration, Barycentric>(
+                                             {1 * Metre / Pow<2>(Second),
+                                              0 * Metre / Pow<2>(Second),
+                                              0 * Metre / Pow<2>(Second)}));
+  pile_up1->RecomputeFromParts();
+  batch.Reset(pile_ups);
+  EXPECT_FALSE(batch.Contains(&*pile_up1));
+  EXPECT_FALSE(batch.Contains(&*pile_up2));
+  EXPECT_OK(batch.DeformAndAdvanceTime(*pile_up1, t + 7 * Second));
+  EXPECT_OK(batch.DeformAndAdvanceTime(*pile_up2, t + 7 * Second));
+}
+
+// Checks that a pile-up allocated at the address of a destroyed pile-up of the
+// batch doesn't inherit its motion.
+TEST_F(PileUpTest, BatchWithReusedAddress) {
+  auto const ephemeris = MakeUniformMotionEphemeris();
+
+  Instant const t1 = astronomy::J2000;
+  EXPECT_CALL(deletion_callback_, Call()).Times(3);
+  std::optional<TestablePileUp> pile_up1;
+  std::optional<TestablePileUp> pile_up2;
+  EmplaceBatchablePileUp(pile_up1, p1_, t1, *ephemeris);
+  EmplaceBatchablePileUp(pile_up2, p2_, t1, *ephemeris);
+  std::list<PileUp*> const pile_ups{&*pile_up1, &*pile_up2};
+
+  PileUpBatch batch;
+  batch.Reset(pile_ups);
+  Instant const t2 = t1 + 7 * Second;
+  EXPECT_OK(batch.DeformAndAdvanceTime(*pile_up1, t2));
+  EXPECT_OK(batch.DeformAndAdvanceTime(*pile_up2, t2));
+
+  // Replace the second pile-up with one that moves in the opposite direction,
+  // at the same address.
+  pile_up2.reset();
+  DegreesOfFreedom<Barycentric> const p2_dof(
+      p2_dof_.position() + p2_dof_.velocity() * (t2 - t1),
+      -p2_dof_.velocity());
+  p2_.set_rigid_motion(
+      RigidMotion<RigidPart, Barycentric>::MakeNonRotatingMotion(p2_dof));
+  EmplaceBatchablePileUp(pile_up2, p2_, t2, *ephemeris);
+  EXPECT_EQ(pile_ups.back(), &*pile_up2);
+
+  batch.Reset(pile_ups);
+  EXPECT_TRUE(batch.Contains(&*pile_up1));
+  EXPECT_TRUE(batch.Contains(&*pile_up2));
+  Instant t = t2;
+  for (int i = 0; i < 10; ++i) {
+    t += 7 * Second;
+    EXPECT_OK(batch.DeformAndAdvanceTime(*pile_up1, t));
+    EXPECT_OK(batch.DeformAndAdvanceTime(*pile_up2, t));
+    batch.Reset(pile_ups);
+  }
+
+  EXPECT_THAT(
+      p2_.rigid_motion()({RigidPart::origin, RigidPart::unmoving}),
+      Componentwise(
+          AbsoluteErrorFrom(p2_dof.position() + p2_dof.velocity() * (t - t2),
+                            Lt(1 * Micro(Metre))),
+          AbsoluteErrorFrom(p2_dof.velocity(),
+                            Lt(1 * Micro(Metre) / Second))));
+}
+
+// Checks that the histories of a large batch are computed by ranges of
+// pile-ups on the threads of the ephemeris.
+TEST_F(PileUpTest, BatchOnSeveralThreads) {
+  auto const ephemeris = MakeUniformMotionEphemeris();
+  ephemeris->SetMassiveBodiesParallelism(/*number_of_threads=*/4,
+                                         /*identical_to_serial=*/true);
+
+  // Enough pile-ups for several ranges.  They have different velocities.
+  constexpr int size = 256;
+  auto const velocity = [this](int const i) {
+    return (i + 1.0) * p1_dof_.velocity();
+  };
+  Instant const t1 = astronomy::J2000;
+  EXPECT_CALL(deletion_callback_, Call()).Times(size);
+  std::vector<std::unique_ptr<Part>> parts;
+  std::vector<std::optional<TestablePileUp>> pile_ups(size);
+  std::list<PileUp*> batched_pile_ups;
+  for (int i = 0; i < size; ++i) {
+    DegreesOfFreedom<Barycentric> const dof(p1_dof_.position(),
+                                            velocity(i));
+    parts.push_back(std::make_unique<Part>(
+        part_id2_ + 1 + i,
+        "p" + std::to_string(i),
+        mass1_,
+        EccentricPart::origin,
+        inertia_tensor1_,
+        RigidMotion<EccentricPart, Barycentric>::MakeNonRotatingMotion(dof),
+        /*deletion_callback=*/nullptr));
+    EmplaceBatchablePileUp(pile_ups[i], *parts.back(), t1, *ephemeris);
+    batched_pile_ups.push_back(&*pile_ups[i]);
+  }
+
+  PileUpBatch batch;
+  batch.Reset(batched_pile_ups);
+  Instant const t2 = t1 + 100 * Second;
+  for (auto& pile_up : pile_ups) {
+    EXPECT_OK(batch.DeformAndAdvanceTime(*pile_up, t2));
+  }
+
+  EXPECT_THAT(ephemeris->massless_bodies_ranges_computed_concurrently(),
+              Gt(0));
+  for (int i = 0; i < size; ++i) {
+    EXPECT_THAT(
+        parts[i]->rigid_motion()({RigidPart::origin, RigidPart::unmoving}),
+        Componentwise(
+            AbsoluteErrorFrom(p1_dof_.position() + velocity(i) * (t2 - t1),
+                              Lt(1 * Micro(Metre))),
+            AbsoluteErrorFrom(velocity(i), Lt(1 * Micro(Metre) / Second))));
+  }
+}
+
 TEST_F(PileUpTest, Serialization) {
   MockEphemeris<Barycentric> ephemeris;
   p1_.apply_intrinsic_force(
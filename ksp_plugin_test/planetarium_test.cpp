@@ -17,7 +17,6 @@
 #include "physics/discrete_trajectory.hpp"
 #include "physics/ephemeris.hpp"
 #include "physics/massive_body.hpp"
-#include "physics/mock_continuous_trajectory.hpp"
 #include "physics/mock_dynamic_frame.hpp"
 #include "physics/mock_ephemeris.hpp"
 #include "physics/rigid_motion.hpp"
@@ -59,7 +58,6 @@ using geometry::Velocity;
 using physics::DiscreteTrajectory;
 using physics::Ephemeris;
 using physics::MassiveBody;
-using physics::MockContinuousTrajectory;
 using physics::MockDynamicFrame;
 using physics::MockEphemeris;
 using physics::RigidMotion;
@@ -133,10 +131,9 @@ class PlanetariumTest : public ::testing::Test {
             Barycentric::nonrotating,
             Barycentric::unmoving)));
     EXPECT_CALL(ephemeris_, bodies()).WillRepeatedly(ReturnRef(bodies_));
-    EXPECT_CALL(ephemeris_, trajectory(_))
-        .WillRepeatedly(Return(&continuous_trajectory_));
-    EXPECT_CALL(continuous_trajectory_, EvaluatePosition(_))
-        .WillRepeatedly(Return(Barycentric::origin));
+    EXPECT_CALL(ephemeris_, EvaluateAllPositions(_))
+        .WillRepeatedly(Return(
+            std::vector<Position<Barycentric>>{Barycentric::origin}));
   }
 
   Instant const t0_;
@@ -146,7 +143,6 @@ class PlanetariumTest : public ::testing::Test {
       plotting_to_scaled_space_;
   RotatingBody<Barycentric> const body_;
   std::vector<not_null<MassiveBody const*>> const bodies_;
-  MockContinuousTrajectory<Barycentric> continuous_trajectory_;
   MockEphemeris<Barycentric> ephemeris_;
 };
 
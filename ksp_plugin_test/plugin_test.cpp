@@ -2,12 +2,14 @@
 #include "ksp_plugin/plugin.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <limits>
 #include <map>
 #include <memory>
 #include <optional>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -36,6 +38,7 @@
 #include "physics/mock_dynamic_frame.hpp"
 #include "physics/mock_ephemeris.hpp"
 #include "quantities/astronomy.hpp"
+#include "quantities/numbers.hpp"
 #include "quantities/quantities.hpp"
 #include "quantities/si.hpp"
 #include "testing_utilities/almost_equals.hpp"
@@ -92,6 +95,7 @@ using quantities::Cos;
 using quantities::DebugString;
 using quantities::GravitationalParameter;
 using quantities::Length;
+using quantities::Pow;
 using quantities::Sin;
 using quantities::Sqrt;
 using quantities::Time;
@@ -126,9 +130,11 @@ using ::testing::Eq;
 using ::testing::Ge;
 using ::testing::Gt;
 using ::testing::InSequence;
+using ::testing::IsEmpty;
 using ::testing::Le;
 using ::testing::Lt;
 using ::testing::Ne;
+using ::testing::Not;
 using ::testing::Ref;
 using ::testing::Return;
 using ::testing::ReturnRef;
@@ -990,5 +996,68 @@ TEST_F(PluginTest, Frenet) {
       AlmostEquals(alice_sun_to_world(satellite_initial_velocity_), 7, 83));
 }
 
+// Two vessels on the same circular orbit, in opposite directions.  They meet
+// every half revolution.
+TEST_F(PluginTest, ComputeConjunctions) {
+  Plugin plugin(initial_time_, initial_time_, 0 * Radian);
+  std::string const earth_name =
+      SolarSystemFactory::name(SolarSystemFactory::Earth);
+  plugin.InsertCelestialAbsoluteCartesian(
+      SolarSystemFactory::Earth,
+      /*parent_index=*/std::nullopt,
+      solar_system_->gravity_model_message(earth_name),
+      solar_system_->cartesian_initial_state_message(earth_name));
+  plugin.EndInitialization();
+  GUID const prograde = "prograde";
+  GUID const retrograde = "retrograde";
+  PartId part_id = 42;
+  for (auto const& [guid, velocity] :
+       {std::pair{prograde, satellite_initial_velocity_},
+        std::pair{retrograde, -satellite_initial_velocity_}}) {
+    bool inserted;
+    plugin.InsertOrKeepVessel(guid,
+                              "v" + guid,
+                              SolarSystemFactory::Earth,
+                              /*loaded=*/false,
+                              inserted);
+    plugin.InsertUnloadedPart(
+        part_id++,
+        "part",
+        guid,
+        RelativeDegreesOfFreedom<AliceSun>(satellite_initial_displacement_,
+                                           velocity));
+  }
+  plugin.PrepareToReportCollisions();
+  plugin.FreeVesselsAndPartsAndCollectPileUps(20 * Milli(Second));
+
+  Instant const t0 = ParseTT(initial_time_);
+  Time const period =
+      2 * π * Sqrt(Pow<3>(satellite_initial_displacement_.Norm()) /
+                   solar_system_->gravitational_parameter(earth_name));
+  // Polling for the predictions to cover a revolution.
+  auto const covers_a_revolution = [&plugin, period, t0](GUID const& guid) {
+    return plugin.GetVessel(guid)->prediction()->back().time > t0 + period;
+  };
+  while (!covers_a_revolution(prograde) || !covers_a_revolution(retrograde)) {
+    plugin.UpdatePrediction({prograde, retrograde});
+    using namespace std::chrono_literals;
+    std::this_thread::sleep_for(100ms);
+  }
+
+  Length const threshold = 10 * Kilo(Metre);
+  auto const conjunctions = plugin.ComputeConjunctions(threshold);
+  EXPECT_THAT(conjunctions, Not(IsEmpty()));
+  bool found_half_revolution = false;
+  for (auto const& conjunction : conjunctions) {
+    EXPECT_THAT(conjunction.vessel1, Ne(conjunction.vessel2));
+    EXPECT_THAT(conjunction.distance, Le(threshold));
+    if (AbsoluteError(t0 + period / 2, conjunction.time) < 1 * Minute) {
+      found_half_revolution = true;
+      EXPECT_THAT(conjunction.distance, Lt(1 * Kilo(Metre)));
+    }
+  }
+  EXPECT_TRUE(found_half_revolution);
+}
+
 }  // namespace ksp_plugin
 }  // namespace principia
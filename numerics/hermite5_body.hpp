@@ -0,0 +1,83 @@
+#pragma once
+
+#include "numerics/hermite5.hpp"
+
+#include <utility>
+
+namespace principia {
+namespace numerics {
+namespace internal_hermite5 {
+
+using quantities::Difference;
+
+template<typename Argument, typename Value>
+Hermite5<Argument, Value>::Hermite5(
+    std::pair<Argument, Argument> arguments,
+    std::pair<Value, Value> const& values,
+    std::pair<Derivative1, Derivative1> const& derivatives,
+    std::pair<Derivative2, Derivative2> const& second_derivatives)
+    : arguments_(std::move(arguments)) {
+  a0_ = values.first;
+  a1_ = derivatives.first;
+  a2_ = 0.5 * second_derivatives.first;
+  Difference<Argument> const h = arguments_.second - arguments_.first;
+  // If we were given the same point twice, there is a removable singularity.
+  // See |Hermite3|.
+  if (h == Difference<Argument>{} &&
+      values.first == values.second &&
+      derivatives.first == derivatives.second &&
+      second_derivatives.first == second_derivatives.second) {
+    a3_ = {};
+    a4_ = {};
+    a5_ = {};
+    return;
+  }
+  auto const one_over_h = 1.0 / h;
+  auto const one_over_h² = one_over_h * one_over_h;
+  auto const one_over_h³ = one_over_h * one_over_h²;
+  // The differences between the values and derivatives at the upper bound and
+  // those of the Taylor expansion of degree 2 at the lower bound.  The
+  // remaining coefficients are the solution of a 3 × 3 linear system in these
+  // differences.
+  Difference<Value> const δvalue =
+      (values.second - values.first) - (a1_ + a2_ * h) * h;
+  Difference<Value> const δderivative_h =
+      (derivatives.second - derivatives.first - 2.0 * a2_ * h) * h;
+  Difference<Value> const δsecond_derivative_h² =
+      (second_derivatives.second - second_derivatives.first) * h * h;
+  a3_ = (10.0 * δvalue - 4.0 * δderivative_h + 0.5 * δsecond_derivative_h²) *
+        one_over_h³;
+  a4_ = (-15.0 * δvalue + 7.0 * δderivative_h - δsecond_derivative_h²) *
+        one_over_h³ * one_over_h;
+  a5_ = (6.0 * δvalue - 3.0 * δderivative_h + 0.5 * δsecond_derivative_h²) *
+        one_over_h³ * one_over_h²;
+}
+
+template<typename Argument, typename Value>
+Value Hermite5<Argument, Value>::Evaluate(Argument const& argument) const {
+  Difference<Argument> const Δargument = argument - arguments_.first;
+  return (((((a5_ * Δargument + a4_) * Δargument + a3_) * Δargument + a2_) *
+               Δargument + a1_) * Δargument) + a0_;
+}
+
+template<typename Argument, typename Value>
+typename Hermite5<Argument, Value>::Derivative1
+Hermite5<Argument, Value>::EvaluateDerivative(Argument const& argument) const {
+  Difference<Argument> const Δargument = argument - arguments_.first;
+  return ((((5.0 * a5_ * Δargument + 4.0 * a4_) * Δargument + 3.0 * a3_) *
+               Δargument + 2.0 * a2_) * Δargument) + a1_;
+}
+
+template<typename Argument, typename Value>
+Argument const& Hermite5<Argument, Value>::lower_bound() const {
+  return arguments_.first;
+}
+
+template<typename Argument, typename Value>
+Argument const& Hermite5<Argument, Value>::upper_bound() const {
+  return arguments_.second;
+}
+
+}  // namespace internal_hermite5
+}  // namespace numerics
+}  // namespace principia
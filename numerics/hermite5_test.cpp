@@ -0,0 +1,116 @@
+#include "numerics/hermite5.hpp"
+
+#include <algorithm>
+
+#include "geometry/frame.hpp"
+#include "geometry/grassmann.hpp"
+#include "geometry/named_quantities.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "quantities/elementary_functions.hpp"
+#include "quantities/quantities.hpp"
+#include "quantities/si.hpp"
+#include "testing_utilities/numerics.hpp"
+
+namespace principia {
+
+using geometry::Displacement;
+using geometry::Frame;
+using geometry::Inertial;
+using geometry::Instant;
+using geometry::Position;
+using geometry::Velocity;
+using quantities::Acceleration;
+using quantities::AngularFrequency;
+using quantities::Cos;
+using quantities::Length;
+using quantities::Pow;
+using quantities::Sin;
+using quantities::Speed;
+using quantities::Time;
+using quantities::si::Metre;
+using quantities::si::Radian;
+using quantities::si::Second;
+using testing_utilities::AbsoluteError;
+using ::testing::Lt;
+
+namespace numerics {
+
+class Hermite5Test : public ::testing::Test {
+ protected:
+  using World = Frame<enum class WorldTag, Inertial>;
+
+  Instant const t0_;
+};
+
+TEST_F(Hermite5Test, Quintic) {
+  // The polynomial t⁵ - 2 t³ + t is reproduced exactly.
+  Hermite5<Instant, Length> h({t0_ + 1 * Second, t0_ + 2 * Second},
+                              {0 * Metre, 18 * Metre},
+                              {0 * Metre / Second, 57 * Metre / Second},
+                              {8 * Metre / Pow<2>(Second),
+                               136 * Metre / Pow<2>(Second)});
+
+  EXPECT_THAT(AbsoluteError(0 * Metre, h.Evaluate(t0_ + 1 * Second)),
+              Lt(1e-12 * Metre));
+  EXPECT_THAT(AbsoluteError(2.34375 * Metre, h.Evaluate(t0_ + 1.5 * Second)),
+              Lt(1e-12 * Metre));
+  EXPECT_THAT(AbsoluteError(18 * Metre, h.Evaluate(t0_ + 2 * Second)),
+              Lt(1e-12 * Metre));
+  EXPECT_THAT(AbsoluteError(12.8125 * Metre / Second,
+                            h.EvaluateDerivative(t0_ + 1.5 * Second)),
+              Lt(1e-12 * Metre / Second));
+  EXPECT_THAT(AbsoluteError(57 * Metre / Second,
+                            h.EvaluateDerivative(t0_ + 2 * Second)),
+              Lt(1e-12 * Metre / Second));
+  EXPECT_EQ(t0_ + 1 * Second, h.lower_bound());
+  EXPECT_EQ(t0_ + 2 * Second, h.upper_bound());
+}
+
+TEST_F(Hermite5Test, Typed) {
+  // Just here to check that the types work in the presence of affine spaces.
+  Hermite5<Instant, Position<World>> h({t0_ + 1 * Second, t0_ + 2 * Second},
+                                       {World::origin, World::origin},
+                                       {World::unmoving, World::unmoving},
+                                       {{}, {}});
+
+  EXPECT_EQ(World::origin, h.Evaluate(t0_ + 1.3 * Second));
+  EXPECT_EQ(Velocity<World>(), h.EvaluateDerivative(t0_ + 1.7 * Second));
+}
+
+TEST_F(Hermite5Test, Circle) {
+  AngularFrequency const ω = 1 * Radian / Second;
+  auto const position = [this, ω](Instant const& t) {
+    return World::origin + Displacement<World>({Cos(ω * (t - t0_)) * Metre,
+                                                Sin(ω * (t - t0_)) * Metre,
+                                                0 * Metre});
+  };
+  auto const velocity = [this, ω](Instant const& t) {
+    return Velocity<World>({-Sin(ω * (t - t0_)) * Metre / Second,
+                            Cos(ω * (t - t0_)) * Metre / Second,
+                            0 * Metre / Second});
+  };
+  auto const acceleration = [&position](Instant const& t) {
+    return (World::origin - position(t)) / Pow<2>(Second);
+  };
+
+  // The error of the interpolation is bounded by (h / 2)⁶ / 6! times the
+  // maximum of the 6th derivative, here 1 m s⁻⁶.
+  for (Time const step : {1 * Second, 0.1 * Second}) {
+    Instant const t1 = t0_ + step;
+    Hermite5<Instant, Position<World>> const h(
+        {t0_, t1},
+        {position(t0_), position(t1)},
+        {velocity(t0_), velocity(t1)},
+        {acceleration(t0_), acceleration(t1)});
+    Length error;
+    for (int i = 0; i <= 16; ++i) {
+      Instant const t = t0_ + i * step / 16;
+      error = std::max(error, AbsoluteError(position(t), h.Evaluate(t)));
+    }
+    EXPECT_THAT(error, Lt(Pow<6>(step / (2 * Second)) / 720 * Metre));
+  }
+}
+
+}  // namespace numerics
+}  // namespace principia
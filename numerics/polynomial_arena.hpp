@@ -0,0 +1,153 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+
+#include "base/published_deque.hpp"
+#include "numerics/polynomial.hpp"
+#include "numerics/polynomial_evaluators.hpp"
+#include "quantities/named_quantities.hpp"
+
+namespace principia {
+namespace numerics {
+namespace internal_polynomial_arena {
+
+using base::PublishedDeque;
+using quantities::Derivative;
+
+// Storage for polynomials in the monomial basis of degree in
+// [1, max_degree], evaluated with the |EstrinEvaluator|, without a heap
+// allocation per polynomial.  The polynomials of each degree are stored
+// contiguously and never move, and they are evaluated without virtual calls
+// through a table indexed by degree.
+// Like |PublishedDeque|, the arena may be extended at both ends by a single
+// writer while it is read, without locking, through |Handle|s.  The elements of
+// each degree are kept in the order in which they were inserted, so that
+// |pop_back| (resp. |pop_front|) removes the polynomial of the given degree
+// most recently inserted with |push_back| (resp. |push_front|).
+// The polynomials also have a flat representation, suitable for storage in
+// files: a sequence of |double|s consisting of the origin followed by the
+// coefficients, each expressed by its coordinates in SI units.
+template<typename Value, typename Argument, int max_degree>
+class PolynomialArena final {
+  static_assert(max_degree >= 1);
+
+  template<int degree>
+  using PolynomialOfDegree =
+      PolynomialInMonomialBasis<Value, Argument, degree, EstrinEvaluator>;
+
+ public:
+  // A reference to a polynomial of the arena.  Trivially copyable and small, so
+  // that it can be stored in the header of each interval of a piecewise
+  // function.  Valid until the polynomial is removed from the arena.
+  class Handle final {
+   public:
+    int degree() const;
+
+    Value Evaluate(Argument const& argument) const;
+    Derivative<Value, Argument> EvaluateDerivative(
+        Argument const& argument) const;
+
+    // Suitable for serialization; the evaluation functions above are faster.
+    Polynomial<Value, Argument> const& polynomial() const;
+
+    // Writes the flat representation of the polynomial to |flat|, which must
+    // have room for |FlatSize(degree())| values.
+    void WriteFlat(double* flat) const;
+
+   private:
+    Handle(int degree, Polynomial<Value, Argument> const* polynomial);
+
+    int degree_;
+    Polynomial<Value, Argument> const* polynomial_;
+
+    friend class PolynomialArena;
+  };
+
+  PolynomialArena() = default;
+
+  PolynomialArena(PolynomialArena const&) = delete;
+  PolynomialArena(PolynomialArena&&) = delete;
+  PolynomialArena& operator=(PolynomialArena const&) = delete;
+  PolynomialArena& operator=(PolynomialArena&&) = delete;
+
+  // Copies |polynomial| into the arena.  |polynomial| must be a
+  // |PolynomialInMonomialBasis| with the |EstrinEvaluator| or the
+  // |HornerEvaluator|; in the latter case it is converted to the former.
+  Handle push_back(Polynomial<Value, Argument> const& polynomial);
+  Handle push_front(Polynomial<Value, Argument> const& polynomial);
+
+  // Appends the polynomial of the given |degree| whose flat representation
+  // starts at |flat|.
+  Handle push_back(int degree, double const* flat);
+
+  // The number of |double|s in the flat representation of a polynomial of the
+  // given |degree|.
+  static std::int64_t FlatSize(int degree);
+
+  // Removes the last (resp. first) polynomial of the given |degree|.  Must not
+  // be called while the polynomial may be read.
+  void pop_back(int degree);
+  void pop_front(int degree);
+
+  // Removes all the polynomials.  Must not be called while the arena may be
+  // read.
+  void clear();
+
+ private:
+  // The functions that depend on the degree of the polynomial, for the table
+  // indexed by degree.
+  struct DegreeOperations {
+    Value (*evaluate)(Polynomial<Value, Argument> const* polynomial,
+                      Argument const& argument);
+    Derivative<Value, Argument> (*evaluate_derivative)(
+        Polynomial<Value, Argument> const* polynomial,
+        Argument const& argument);
+    Handle (*push_back)(PolynomialArena& arena,
+                        Polynomial<Value, Argument> const& polynomial);
+    Handle (*push_front)(PolynomialArena& arena,
+                         Polynomial<Value, Argument> const& polynomial);
+    Handle (*push_back_flat)(PolynomialArena& arena, double const* flat);
+    void (*write_flat)(Polynomial<Value, Argument> const* polynomial,
+                       double* flat);
+    std::int64_t flat_size;
+    void (*pop_back)(PolynomialArena& arena);
+    void (*pop_front)(PolynomialArena& arena);
+    void (*clear)(PolynomialArena& arena);
+  };
+
+  template<int degree>
+  static PolynomialOfDegree<degree> Convert(
+      Polynomial<Value, Argument> const& polynomial);
+
+  template<int degree>
+  static constexpr DegreeOperations MakeDegreeOperations();
+
+  // The element at index |degree - 1| of the table is for polynomials of that
+  // degree.
+  template<int... indices>
+  static constexpr std::array<DegreeOperations, max_degree>
+  MakeDegreeOperationsTable(std::integer_sequence<int, indices...>);
+
+  static DegreeOperations const& Operations(int degree);
+
+  template<int... indices>
+  static std::tuple<PublishedDeque<PolynomialOfDegree<indices + 1>>...>
+  MakePolynomials(std::integer_sequence<int, indices...>);
+
+  // The element at index |degree - 1| is the storage for the polynomials of
+  // that degree.
+  decltype(MakePolynomials(std::make_integer_sequence<int, max_degree>()))
+      polynomials_;
+};
+
+}  // namespace internal_polynomial_arena
+
+using internal_polynomial_arena::PolynomialArena;
+
+}  // namespace numerics
+}  // namespace principia
+
+#include "numerics/polynomial_arena_body.hpp"
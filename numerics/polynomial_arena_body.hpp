@@ -0,0 +1,281 @@
+#pragma once
+
+#include "numerics/polynomial_arena.hpp"
+
+#include <tuple>
+#include <utility>
+
+#include "base/for_all_of.hpp"
+#include "geometry/grassmann.hpp"
+#include "geometry/point.hpp"
+#include "geometry/r3_element.hpp"
+#include "glog/logging.h"
+#include "quantities/quantities.hpp"
+#include "quantities/si.hpp"
+
+namespace principia {
+namespace numerics {
+namespace internal_polynomial_arena {
+
+using base::for_all_of;
+using geometry::Multivector;
+using geometry::Point;
+using geometry::R3Element;
+using quantities::Quantity;
+
+// The flat representation of the values that appear in polynomials.  |Write|
+// and |Read| advance |flat| past the value.
+template<typename T>
+struct FlatValue;
+
+template<>
+struct FlatValue<double> {
+  static constexpr std::int64_t size = 1;
+  static void Write(double const value, double*& flat) {
+    *flat++ = value;
+  }
+  static double Read(double const*& flat) {
+    return *flat++;
+  }
+};
+
+template<typename Dimensions>
+struct FlatValue<Quantity<Dimensions>> {
+  static constexpr std::int64_t size = 1;
+  static void Write(Quantity<Dimensions> const& value, double*& flat) {
+    *flat++ = value / quantities::si::Unit<Quantity<Dimensions>>;
+  }
+  static Quantity<Dimensions> Read(double const*& flat) {
+    return *flat++ * quantities::si::Unit<Quantity<Dimensions>>;
+  }
+};
+
+template<typename Scalar, typename Frame, int rank>
+struct FlatValue<Multivector<Scalar, Frame, rank>> {
+  static constexpr std::int64_t size = 3 * FlatValue<Scalar>::size;
+  static void Write(Multivector<Scalar, Frame, rank> const& value,
+                    double*& flat) {
+    R3Element<Scalar> const& coordinates = value.coordinates();
+    FlatValue<Scalar>::Write(coordinates.x, flat);
+    FlatValue<Scalar>::Write(coordinates.y, flat);
+    FlatValue<Scalar>::Write(coordinates.z, flat);
+  }
+  static Multivector<Scalar, Frame, rank> Read(double const*& flat) {
+    // The order of evaluation of function arguments is unspecified.
+    Scalar const x = FlatValue<Scalar>::Read(flat);
+    Scalar const y = FlatValue<Scalar>::Read(flat);
+    Scalar const z = FlatValue<Scalar>::Read(flat);
+    return Multivector<Scalar, Frame, rank>(R3Element<Scalar>(x, y, z));
+  }
+};
+
+template<typename Vector>
+struct FlatValue<Point<Vector>> {
+  static constexpr std::int64_t size = FlatValue<Vector>::size;
+  static void Write(Point<Vector> const& value, double*& flat) {
+    FlatValue<Vector>::Write(value - Point<Vector>(), flat);
+  }
+  static Point<Vector> Read(double const*& flat) {
+    return Point<Vector>() + FlatValue<Vector>::Read(flat);
+  }
+};
+
+template<typename Tuple, std::size_t... indices>
+constexpr std::int64_t FlatTupleSize(std::index_sequence<indices...>) {
+  return (FlatValue<std::tuple_element_t<indices, Tuple>>::size + ...);
+}
+
+template<typename Value, typename Argument, int max_degree>
+int PolynomialArena<Value, Argument, max_degree>::Handle::degree() const {
+  return degree_;
+}
+
+template<typename Value, typename Argument, int max_degree>
+Value PolynomialArena<Value, Argument, max_degree>::Handle::Evaluate(
+    Argument const& argument) const {
+  return Operations(degree_).evaluate(polynomial_, argument);
+}
+
+template<typename Value, typename Argument, int max_degree>
+Derivative<Value, Argument>
+PolynomialArena<Value, Argument, max_degree>::Handle::EvaluateDerivative(
+    Argument const& argument) const {
+  return Operations(degree_).evaluate_derivative(polynomial_, argument);
+}
+
+template<typename Value, typename Argument, int max_degree>
+Polynomial<Value, Argument> const&
+PolynomialArena<Value, Argument, max_degree>::Handle::polynomial() const {
+  return *polynomial_;
+}
+
+template<typename Value, typename Argument, int max_degree>
+void PolynomialArena<Value, Argument, max_degree>::Handle::WriteFlat(
+    double* const flat) const {
+  Operations(degree_).write_flat(polynomial_, flat);
+}
+
+template<typename Value, typename Argument, int max_degree>
+PolynomialArena<Value, Argument, max_degree>::Handle::Handle(
+    int const degree,
+    Polynomial<Value, Argument> const* const polynomial)
+    : degree_(degree),
+      polynomial_(polynomial) {}
+
+template<typename Value, typename Argument, int max_degree>
+typename PolynomialArena<Value, Argument, max_degree>::Handle
+PolynomialArena<Value, Argument, max_degree>::push_back(
+    Polynomial<Value, Argument> const& polynomial) {
+  return Operations(polynomial.degree()).push_back(*this, polynomial);
+}
+
+template<typename Value, typename Argument, int max_degree>
+typename PolynomialArena<Value, Argument, max_degree>::Handle
+PolynomialArena<Value, Argument, max_degree>::push_front(
+    Polynomial<Value, Argument> const& polynomial) {
+  return Operations(polynomial.degree()).push_front(*this, polynomial);
+}
+
+template<typename Value, typename Argument, int max_degree>
+typename PolynomialArena<Value, Argument, max_degree>::Handle
+PolynomialArena<Value, Argument, max_degree>::push_back(
+    int const degree,
+    double const* const flat) {
+  return Operations(degree).push_back_flat(*this, flat);
+}
+
+template<typename Value, typename Argument, int max_degree>
+std::int64_t PolynomialArena<Value, Argument, max_degree>::FlatSize(
+    int const degree) {
+  return Operations(degree).flat_size;
+}
+
+template<typename Value, typename Argument, int max_degree>
+void PolynomialArena<Value, Argument, max_degree>::pop_back(int const degree) {
+  Operations(degree).pop_back(*this);
+}
+
+template<typename Value, typename Argument, int max_degree>
+void PolynomialArena<Value, Argument, max_degree>::pop_front(int const degree) {
+  Operations(degree).pop_front(*this);
+}
+
+template<typename Value, typename Argument, int max_degree>
+void PolynomialArena<Value, Argument, max_degree>::clear() {
+  for (int degree = 1; degree <= max_degree; ++degree) {
+    Operations(degree).clear(*this);
+  }
+}
+
+template<typename Value, typename Argument, int max_degree>
+template<int degree>
+auto PolynomialArena<Value, Argument, max_degree>::Convert(
+    Polynomial<Value, Argument> const& polynomial)
+    -> PolynomialOfDegree<degree> {
+  using Estrin = PolynomialOfDegree<degree>;
+  using Horner =
+      PolynomialInMonomialBasis<Value, Argument, degree, HornerEvaluator>;
+  if (auto const* const estrin = dynamic_cast<Estrin const*>(&polynomial);
+      estrin != nullptr) {
+    return *estrin;
+  }
+  auto const* const horner = dynamic_cast<Horner const*>(&polynomial);
+  CHECK(horner != nullptr) << "Unexpected polynomial of degree " << degree;
+  return Estrin(*horner);
+}
+
+template<typename Value, typename Argument, int max_degree>
+template<int degree>
+constexpr auto
+PolynomialArena<Value, Argument, max_degree>::MakeDegreeOperations()
+    -> DegreeOperations {
+  using P = PolynomialOfDegree<degree>;
+  using Coefficients = typename P::Coefficients;
+  return DegreeOperations{
+      /*evaluate=*/
+      [](Polynomial<Value, Argument> const* const polynomial,
+         Argument const& argument) {
+        // The qualified call is not virtual.
+        return static_cast<P const*>(polynomial)->P::operator()(argument);
+      },
+      /*evaluate_derivative=*/
+      [](Polynomial<Value, Argument> const* const polynomial,
+         Argument const& argument) {
+        return static_cast<P const*>(polynomial)->P::EvaluateDerivative(
+            argument);
+      },
+      /*push_back=*/
+      [](PolynomialArena& arena,
+         Polynomial<Value, Argument> const& polynomial) {
+        auto& polynomials = std::get<degree - 1>(arena.polynomials_);
+        polynomials.push_back(Convert<degree>(polynomial));
+        return Handle(degree, &polynomials.view().back());
+      },
+      /*push_front=*/
+      [](PolynomialArena& arena,
+         Polynomial<Value, Argument> const& polynomial) {
+        auto& polynomials = std::get<degree - 1>(arena.polynomials_);
+        polynomials.push_front(Convert<degree>(polynomial));
+        return Handle(degree, &polynomials.view().front());
+      },
+      /*push_back_flat=*/
+      [](PolynomialArena& arena, double const* flat) {
+        Argument const origin = FlatValue<Argument>::Read(flat);
+        Coefficients coefficients;
+        for_all_of(coefficients).loop([&flat](auto& coefficient) {
+          coefficient =
+              FlatValue<std::remove_reference_t<decltype(coefficient)>>::Read(
+                  flat);
+        });
+        auto& polynomials = std::get<degree - 1>(arena.polynomials_);
+        polynomials.push_back(P(coefficients, origin));
+        return Handle(degree, &polynomials.view().back());
+      },
+      /*write_flat=*/
+      [](Polynomial<Value, Argument> const* const polynomial, double* flat) {
+        auto const& p = *static_cast<P const*>(polynomial);
+        FlatValue<Argument>::Write(p.origin(), flat);
+        for_all_of(p.coefficients()).loop([&flat](auto const& coefficient) {
+          FlatValue<std::remove_cvref_t<decltype(coefficient)>>::Write(
+              coefficient, flat);
+        });
+      },
+      /*flat_size=*/FlatValue<Argument>::size +
+          FlatTupleSize<Coefficients>(
+              std::make_index_sequence<std::tuple_size_v<Coefficients>>()),
+      /*pop_back=*/
+      [](PolynomialArena& arena) {
+        std::get<degree - 1>(arena.polynomials_).pop_back();
+      },
+      /*pop_front=*/
+      [](PolynomialArena& arena) {
+        std::get<degree - 1>(arena.polynomials_).pop_front();
+      },
+      /*clear=*/
+      [](PolynomialArena& arena) {
+        std::get<degree - 1>(arena.polynomials_).clear();
+      }};
+}
+
+template<typename Value, typename Argument, int max_degree>
+template<int... indices>
+constexpr auto
+PolynomialArena<Value, Argument, max_degree>::MakeDegreeOperationsTable(
+    std::integer_sequence<int, indices...>)
+    -> std::array<DegreeOperations, max_degree> {
+  return {MakeDegreeOperations<indices + 1>()...};
+}
+
+template<typename Value, typename Argument, int max_degree>
+auto PolynomialArena<Value, Argument, max_degree>::Operations(int const degree)
+    -> DegreeOperations const& {
+  static constexpr std::array<DegreeOperations, max_degree> operations =
+      MakeDegreeOperationsTable(std::make_integer_sequence<int, max_degree>());
+  DCHECK_LE(1, degree);
+  DCHECK_LE(degree, max_degree);
+  return operations[degree - 1];
+}
+
+}  // namespace internal_polynomial_arena
+}  // namespace numerics
+}  // namespace principia
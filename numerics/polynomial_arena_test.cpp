@@ -0,0 +1,151 @@
+#include "numerics/polynomial_arena.hpp"
+
+#include <memory>
+#include <vector>
+
+#include "geometry/frame.hpp"
+#include "geometry/grassmann.hpp"
+#include "geometry/named_quantities.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "numerics/polynomial.hpp"
+#include "numerics/polynomial_evaluators.hpp"
+#include "quantities/quantities.hpp"
+#include "quantities/si.hpp"
+#include "serialization/geometry.pb.h"
+
+namespace principia {
+
+using geometry::Displacement;
+using geometry::Frame;
+using geometry::Handedness;
+using geometry::Inertial;
+using geometry::Instant;
+using geometry::Position;
+using geometry::Vector;
+using geometry::Velocity;
+using quantities::Acceleration;
+using quantities::si::Metre;
+using quantities::si::Second;
+using ::testing::Eq;
+
+namespace numerics {
+
+class PolynomialArenaTest : public ::testing::Test {
+ protected:
+  using World = Frame<serialization::Frame::TestTag,
+                      Inertial,
+                      Handedness::Right,
+                      serialization::Frame::TEST>;
+
+  using Arena = PolynomialArena<Position<World>, Instant, 17>;
+  using P1H = PolynomialInMonomialBasis<Position<World>, Instant, 1,
+                                        HornerEvaluator>;
+  using P2E = PolynomialInMonomialBasis<Position<World>, Instant, 2,
+                                        EstrinEvaluator>;
+
+  // A polynomial of degree 2 whose value at |t0_ + i * Second| is different
+  // for each |i|.
+  P2E MakeP2E(double const i) const {
+    return P2E({World::origin + Displacement<World>({i * Metre,
+                                                     0 * Metre,
+                                                     0 * Metre}),
+                Velocity<World>({0 * Metre / Second,
+                                 i * Metre / Second,
+                                 0 * Metre / Second}),
+                Vector<Acceleration, World>({0 * Metre / Second / Second,
+                                             0 * Metre / Second / Second,
+                                             2 * Metre / Second / Second})},
+               t0_ + i * Second);
+  }
+
+  P1H MakeP1H(double const i) const {
+    return P1H({World::origin + Displacement<World>({0 * Metre,
+                                                     0 * Metre,
+                                                     i * Metre}),
+                Velocity<World>({i * Metre / Second,
+                                 0 * Metre / Second,
+                                 0 * Metre / Second})},
+               t0_ + i * Second);
+  }
+
+  Instant const t0_;
+  Arena arena_;
+};
+
+// Check that the handles evaluate like the polynomials that were inserted,
+// including those that were converted from the |HornerEvaluator|.
+TEST_F(PolynomialArenaTest, Evaluate) {
+  std::vector<Arena::Handle> handles;
+  for (int i = 0; i < 10; ++i) {
+    handles.push_back(arena_.push_back(MakeP2E(i)));
+    handles.push_back(arena_.push_back(MakeP1H(i)));
+  }
+  for (int i = 0; i < 10; ++i) {
+    Instant const t = t0_ + (i + 0.5) * Second;
+    auto const& p2 = handles[2 * i];
+    auto const& p1 = handles[2 * i + 1];
+    EXPECT_THAT(p2.degree(), Eq(2));
+    EXPECT_THAT(p1.degree(), Eq(1));
+    EXPECT_THAT(p2.Evaluate(t), Eq(MakeP2E(i)(t)));
+    EXPECT_THAT(p2.EvaluateDerivative(t),
+                Eq(MakeP2E(i).EvaluateDerivative(t)));
+    EXPECT_THAT(p1.Evaluate(t), Eq(MakeP1H(i)(t)));
+    EXPECT_THAT(p1.EvaluateDerivative(t),
+                Eq(MakeP1H(i).EvaluateDerivative(t)));
+    EXPECT_THAT(p2.polynomial()(t), Eq(MakeP2E(i)(t)));
+    EXPECT_THAT(p1.polynomial().degree(), Eq(1));
+  }
+}
+
+// Check that polynomials are removed in the right order, and that the handles
+// to the remaining ones are not invalidated.
+TEST_F(PolynomialArenaTest, PushAndPop) {
+  Instant const t = t0_ + 100 * Second;
+  auto const middle = arena_.push_back(MakeP2E(0));
+  for (int i = 1; i < 1000; ++i) {
+    arena_.push_back(MakeP2E(i));
+    arena_.push_front(MakeP2E(-i));
+  }
+  arena_.push_back(MakeP1H(1));
+  for (int i = 1; i < 1000; ++i) {
+    arena_.pop_back(/*degree=*/2);
+    arena_.pop_front(/*degree=*/2);
+  }
+  EXPECT_THAT(middle.Evaluate(t), Eq(MakeP2E(0)(t)));
+  auto const front = arena_.push_front(MakeP2E(-1));
+  auto const back = arena_.push_back(MakeP2E(1));
+  EXPECT_THAT(front.Evaluate(t), Eq(MakeP2E(-1)(t)));
+  EXPECT_THAT(back.Evaluate(t), Eq(MakeP2E(1)(t)));
+  EXPECT_THAT(middle.Evaluate(t), Eq(MakeP2E(0)(t)));
+
+  arena_.pop_back(/*degree=*/1);
+  arena_.clear();
+  auto const handle = arena_.push_back(MakeP1H(3));
+  EXPECT_THAT(handle.Evaluate(t), Eq(MakeP1H(3)(t)));
+}
+
+// Check that the flat representation of a polynomial is exact.
+TEST_F(PolynomialArenaTest, Flat) {
+  Instant const t = t0_ + 3.7 * Second;
+  auto const p2 = arena_.push_back(MakeP2E(7));
+  auto const p1 = arena_.push_back(MakeP1H(-2));
+  EXPECT_THAT(Arena::FlatSize(2), Eq(1 + 3 * 3));
+  EXPECT_THAT(Arena::FlatSize(1), Eq(1 + 2 * 3));
+
+  std::vector<double> flat(Arena::FlatSize(2) + Arena::FlatSize(1));
+  p2.WriteFlat(&flat[0]);
+  p1.WriteFlat(&flat[Arena::FlatSize(2)]);
+  EXPECT_THAT(flat[0], Eq(7));
+  EXPECT_THAT(flat[1], Eq(7));
+
+  auto const q2 = arena_.push_back(/*degree=*/2, &flat[0]);
+  auto const q1 = arena_.push_back(/*degree=*/1, &flat[Arena::FlatSize(2)]);
+  EXPECT_THAT(q2.Evaluate(t), Eq(p2.Evaluate(t)));
+  EXPECT_THAT(q2.EvaluateDerivative(t), Eq(p2.EvaluateDerivative(t)));
+  EXPECT_THAT(q1.Evaluate(t), Eq(p1.Evaluate(t)));
+  EXPECT_THAT(q1.EvaluateDerivative(t), Eq(p1.EvaluateDerivative(t)));
+}
+
+}  // namespace numerics
+}  // namespace principia
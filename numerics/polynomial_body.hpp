@@ -450,6 +450,15 @@ is_zero() const {
   return coefficients_ == Coefficients{};
 }
 
+template<typename Value_, typename Argument_, int degree_,
+         template<typename, typename, int> typename Evaluator>
+typename PolynomialInMonomialBasis<Value_, Argument_, degree_, Evaluator>::
+    Coefficients const&
+PolynomialInMonomialBasis<Value_, Argument_, degree_, Evaluator>::
+coefficients() const {
+  return coefficients_;
+}
+
 template<typename Value_, typename Argument_, int degree_,
          template<typename, typename, int> typename Evaluator>
 Argument_ const&
@@ -73,11 +73,25 @@ BoundedArray<Argument, 2> SolveQuadraticEquation(
     Derivative<Value, Argument> const& a1,
     Derivative<Derivative<Value, Argument>, Argument> const& a2);
 
+// Returns the real roots in [lower_bound, upper_bound] of the polynomial:
+//   coefficients[0] + coefficients[1] * x + ... + coefficients[n] * x^n
+// The result is sorted.  The polynomial is monotonic between consecutive roots
+// of its derivative, which are computed recursively, so each of these intervals
+// contains at most one root, which is found by Brent's method.  A root of even
+// multiplicity is only found if the polynomial is exactly zero at a root of its
+// derivative.  For good conditioning, the interval should be small, e.g.,
+// [0, 1].
+inline std::vector<double> SolvePolynomialEquation(
+    std::vector<double> const& coefficients,
+    double lower_bound,
+    double upper_bound);
+
 }  // namespace internal_root_finders
 
 using internal_root_finders::Bisect;
 using internal_root_finders::Brent;
 using internal_root_finders::GoldenSectionSearch;
+using internal_root_finders::SolvePolynomialEquation;
 using internal_root_finders::SolveQuadraticEquation;
 
 }  // namespace numerics
@@ -4,6 +4,7 @@
 #include "numerics/root_finders.hpp"
 
 #include <algorithm>
+#include <cmath>
 #include <functional>
 #include <limits>
 #include <vector>
@@ -392,6 +393,67 @@ BoundedArray<Argument, 2> SolveQuadraticEquation(
   }
 }
 
+inline std::vector<double> SolvePolynomialEquation(
+    std::vector<double> const& coefficients,
+    double const lower_bound,
+    double const upper_bound) {
+  std::vector<double> roots;
+  int degree = static_cast<int>(coefficients.size()) - 1;
+  while (degree > 0 && coefficients[degree] == 0) {
+    --degree;
+  }
+  if (degree <= 0) {
+    return roots;
+  }
+
+  // If the constant term dominates the other terms on the interval, there is
+  // no root.  This test is cheap and eliminates most intervals in practice.
+  double const x_max = std::max(std::abs(lower_bound), std::abs(upper_bound));
+  double x_max_to_the_i = 1;
+  double bound = 0;
+  for (int i = 1; i <= degree; ++i) {
+    x_max_to_the_i *= x_max;
+    bound += std::abs(coefficients[i]) * x_max_to_the_i;
+  }
+  if (std::abs(coefficients[0]) > bound) {
+    return roots;
+  }
+
+  auto const evaluate = [&coefficients, degree](double const x) {
+    double result = coefficients[degree];
+    for (int i = degree - 1; i >= 0; --i) {
+      result = result * x + coefficients[i];
+    }
+    return result;
+  };
+
+  std::vector<double> derivative(degree);
+  for (int i = 1; i <= degree; ++i) {
+    derivative[i - 1] = i * coefficients[i];
+  }
+  std::vector<double> points =
+      SolvePolynomialEquation(derivative, lower_bound, upper_bound);
+  points.insert(points.begin(), lower_bound);
+  points.push_back(upper_bound);
+
+  double f_lower = evaluate(points.front());
+  if (f_lower == 0) {
+    roots.push_back(points.front());
+  }
+  for (std::size_t i = 1; i < points.size(); ++i) {
+    double const f_upper = evaluate(points[i]);
+    if (f_upper == 0) {
+      if (roots.empty() || roots.back() != points[i]) {
+        roots.push_back(points[i]);
+      }
+    } else if (f_lower != 0 && (f_lower < 0) != (f_upper < 0)) {
+      roots.push_back(Brent(evaluate, points[i - 1], points[i]));
+    }
+    f_lower = f_upper;
+  }
+  return roots;
+}
+
 }  // namespace internal_root_finders
 }  // namespace numerics
 }  // namespace principia
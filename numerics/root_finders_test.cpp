@@ -490,5 +490,26 @@ TEST_F(RootFindersTest, QuadraticEquations) {
   EXPECT_THAT(s5, ElementsAre(t0 - 1.0 * Second));
 }
 
+TEST_F(RootFindersTest, PolynomialEquations) {
+  // (x - 0.1) (x - 0.5) (x - 0.9) (x + 3).
+  std::vector<double> const p1 = {-0.135, 1.725, -3.91, 1.5, 1};
+  EXPECT_THAT(SolvePolynomialEquation(p1, 0, 1),
+              ElementsAre(AlmostEquals(0.1, 0, 2),
+                          AlmostEquals(0.5, 0, 2),
+                          AlmostEquals(0.9, 0, 2)));
+  EXPECT_THAT(SolvePolynomialEquation(p1, -4, 0),
+              ElementsAre(AlmostEquals(-3.0, 0, 2)));
+
+  // A double root which is exactly a root of the derivative.
+  EXPECT_THAT(SolvePolynomialEquation({0.25, -1, 1}, 0, 1), ElementsAre(0.5));
+
+  // No real roots.
+  EXPECT_THAT(SolvePolynomialEquation({1, 0, 1}, -1, 1), IsEmpty());
+  EXPECT_THAT(SolvePolynomialEquation({3}, -1, 1), IsEmpty());
+
+  // A triple root at a bound.
+  EXPECT_THAT(SolvePolynomialEquation({0, 0, 0, 1}, 0, 1), ElementsAre(0));
+}
+
 }  // namespace numerics
 }  // namespace principia
@@ -1,7 +1,9 @@
 ﻿
 #pragma once
 
+#include <cstdint>
 #include <functional>
+#include <string>
 
 #include "absl/container/btree_map.h"
 #include "absl/container/btree_set.h"
@@ -9,6 +11,7 @@
 #include "absl/synchronization/mutex.h"
 #include "base/not_null.hpp"
 #include "geometry/named_quantities.hpp"
+#include "gipfeli/compression.h"
 #include "google/protobuf/repeated_field.h"
 #include "quantities/quantities.hpp"
 
@@ -35,6 +38,8 @@ using quantities::Time;
 // The |Message| must declare a nested message named |Checkpoint|, which must
 // have a field named |time| of type |Point|.  There must be a repeated field of
 // |Checkpoint|s in |Message|.
+// Over a long timeline the checkpoints use a lot of memory, so they are kept
+// serialized and compressed, and are only decoded when they are read.
 // This class is thread-safe.  The callbacks are not run under a lock.
 template<typename Message>
 class Checkpointer {
@@ -114,6 +119,9 @@ class Checkpointer {
   // Same as above, but uses the reader passed at construction.
   absl::Status ReadFromCheckpointAt(Instant const& t) const EXCLUDES(lock_);
 
+  // The number of bytes used by the compressed checkpoints.
+  std::int64_t checkpoints_size_in_bytes() const EXCLUDES(lock_);
+
   void WriteToMessage(not_null<google::protobuf::RepeatedPtrField<
                           typename Message::Checkpoint>*> message) const
       EXCLUDES(lock_);
@@ -124,19 +132,26 @@ class Checkpointer {
           message);
 
  private:
-  using CheckpointsByTime =
-      absl::btree_map<Instant, typename Message::Checkpoint>;
+  // The checkpoints serialized and compressed with gipfeli.
+  using CheckpointsByTime = absl::btree_map<Instant, std::string>;
 
   void WriteToCheckpointLocked(Instant const& t)
       EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
+  static std::string Encode(typename Message::Checkpoint const& checkpoint);
+  static typename Message::Checkpoint Decode(std::string const& bytes);
+
+  // A compressor for the current thread, since they are not thread-safe.
+  static google::compression::Compressor& compressor();
+
   mutable absl::Mutex lock_;
   Writer const writer_;
   Reader const reader_;
 
   // The time field of the Checkpoint message may or may not be set.  The map
   // key is the source of truth.
-  CheckpointsByTime checkpoints_;
+  CheckpointsByTime checkpoints_ GUARDED_BY(lock_);
+  std::int64_t checkpoints_size_in_bytes_ GUARDED_BY(lock_) = 0;
 };
 
 }  // namespace internal_checkpointer
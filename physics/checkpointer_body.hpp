@@ -4,12 +4,16 @@
 #include "physics/checkpointer.hpp"
 
 #include <map>
+#include <memory>
+#include <string>
 #include <vector>
 #include <utility>
 
 #include "absl/container/btree_set.h"
 #include "base/status_utilities.hpp"
 #include "geometry/named_quantities.hpp"
+#include "gipfeli/gipfeli.h"
+#include "glog/logging.h"
 
 namespace principia {
 namespace physics {
@@ -139,34 +143,34 @@ bool Checkpointer<Message>::WriteToCheckpointIfNeeded(
 
 template<typename Message>
 absl::Status Checkpointer<Message>::ReadFromOldestCheckpoint() const {
-  typename Message::Checkpoint const* checkpoint = nullptr;
+  std::string bytes;
   {
     absl::ReaderMutexLock l(&lock_);
     if (checkpoints_.empty()) {
       return absl::NotFoundError("No checkpoint");
     }
-    checkpoint = &checkpoints_.cbegin()->second;
+    bytes = checkpoints_.cbegin()->second;
   }
-  return reader_(*checkpoint);
+  return reader_(Decode(bytes));
 }
 
 template<typename Message>
 absl::Status Checkpointer<Message>::ReadFromNewestCheckpoint() const {
-  typename Message::Checkpoint const* checkpoint = nullptr;
+  std::string bytes;
   {
     absl::ReaderMutexLock l(&lock_);
     if (checkpoints_.empty()) {
       return absl::NotFoundError("No checkpoint");
     }
-    checkpoint = &checkpoints_.crbegin()->second;
+    bytes = checkpoints_.crbegin()->second;
   }
-  return reader_(*checkpoint);
+  return reader_(Decode(bytes));
 }
 
 template<typename Message>
 absl::Status Checkpointer<Message>::ReadFromCheckpointAtOrBefore(
     Instant const& t) const {
-  typename Message::Checkpoint const* checkpoint = nullptr;
+  std::string bytes;
   {
     absl::ReaderMutexLock l(&lock_);
     // |it| denotes an entry strictly greater than |t| (or end).
@@ -174,24 +178,25 @@ absl::Status Checkpointer<Message>::ReadFromCheckpointAtOrBefore(
     if (it == checkpoints_.cbegin()) {
       return absl::NotFoundError("No checkpoint");
     }
-    checkpoint = &std::prev(it)->second;
+    bytes = std::prev(it)->second;
   }
-  return reader_(*checkpoint);
+  return reader_(Decode(bytes));
 }
 
 template<typename Message>
 absl::Status Checkpointer<Message>::ReadFromCheckpointAt(
     Instant const& t,
     Reader const& reader) const {
-  typename CheckpointsByTime::const_iterator it;
+  std::string bytes;
   {
     absl::ReaderMutexLock l(&lock_);
-    it = checkpoints_.find(t);
+    auto const it = checkpoints_.find(t);
     if (it == checkpoints_.end()) {
       return absl::NotFoundError("No checkpoint found");
     }
+    bytes = it->second;
   }
-  return reader(it->second);
+  return reader(Decode(bytes));
 }
 
 template<typename Message>
@@ -200,14 +205,20 @@ absl::Status Checkpointer<Message>::ReadFromCheckpointAt(
   return ReadFromCheckpointAt(t, reader_);
 }
 
+template<typename Message>
+std::int64_t Checkpointer<Message>::checkpoints_size_in_bytes() const {
+  absl::ReaderMutexLock l(&lock_);
+  return checkpoints_size_in_bytes_;
+}
+
 template<typename Message>
 void Checkpointer<Message>::WriteToMessage(
     not_null<google::protobuf::RepeatedPtrField<typename Message::Checkpoint>*>
         message) const {
   absl::ReaderMutexLock l(&lock_);
-  for (const auto [time, checkpoint] : checkpoints_) {
+  for (auto const& [time, bytes] : checkpoints_) {
     typename Message::Checkpoint* const message_checkpoint = message->Add();
-    *message_checkpoint = checkpoint;
+    *message_checkpoint = Decode(bytes);
     time.WriteToMessage(message_checkpoint->mutable_time());
   }
 }
@@ -223,7 +234,9 @@ Checkpointer<Message>::ReadFromMessage(
       std::make_unique<Checkpointer>(std::move(writer), std::move(reader));
   for (const auto& checkpoint : message) {
     Instant const time = Instant::ReadFromMessage(checkpoint.time());
-    checkpointer->checkpoints_.emplace(time, checkpoint);
+    auto const [it, _] =
+        checkpointer->checkpoints_.emplace(time, Encode(checkpoint));
+    checkpointer->checkpoints_size_in_bytes_ += it->second.size();
   }
   return std::move(checkpointer);
 }
@@ -232,11 +245,47 @@ template<typename Message>
 void Checkpointer<Message>::WriteToCheckpointLocked(Instant const& t) {
   lock_.AssertHeld();
   CHECK(!checkpoints_.contains(t)) << t;
-  auto const it = checkpoints_.emplace_hint(
-      checkpoints_.end(), t, typename Message::Checkpoint());
+  // The placeholder prevents another checkpoint from being created at |t|
+  // while the lock is released.
+  auto const it = checkpoints_.emplace_hint(checkpoints_.end(), t, "");
   lock_.Unlock();
-  writer_(&it->second);
+  typename Message::Checkpoint checkpoint;
+  writer_(&checkpoint);
+  std::string bytes = Encode(checkpoint);
   lock_.Lock();
+  checkpoints_size_in_bytes_ += bytes.size();
+  it->second = std::move(bytes);
+}
+
+template<typename Message>
+std::string Checkpointer<Message>::Encode(
+    typename Message::Checkpoint const& checkpoint) {
+  std::string serialized;
+  CHECK(checkpoint.SerializeToString(&serialized));
+  std::string compressed;
+  compressor().Compress(serialized, &compressed);
+  return compressed;
+}
+
+template<typename Message>
+typename Message::Checkpoint Checkpointer<Message>::Decode(
+    std::string const& bytes) {
+  typename Message::Checkpoint checkpoint;
+  // A placeholder for a checkpoint that is being written.
+  if (bytes.empty()) {
+    return checkpoint;
+  }
+  std::string serialized;
+  CHECK(compressor().Uncompress(bytes, &serialized));
+  CHECK(checkpoint.ParseFromString(serialized));
+  return checkpoint;
+}
+
+template<typename Message>
+google::compression::Compressor& Checkpointer<Message>::compressor() {
+  thread_local std::unique_ptr<google::compression::Compressor> const
+      compressor(google::compression::NewGipfeliCompressor());
+  return *compressor;
 }
 
 }  // namespace internal_checkpointer
@@ -1,5 +1,7 @@
 #include "physics/checkpointer.hpp"
 
+#include <string>
+
 #include "base/status_utilities.hpp"
 #include "geometry/named_quantities.hpp"
 #include "gmock/gmock.h"
@@ -38,6 +40,15 @@ struct Message {
       return time_;
     }
 
+    bool SerializeToString(std::string* const output) const {
+      *output = std::to_string(payload);
+      return true;
+    }
+    bool ParseFromString(std::string const& data) {
+      payload = std::stoi(data);
+      return true;
+    }
+
     int payload = 0;
 
    private:
@@ -237,5 +248,34 @@ TEST_F(CheckpointerTest, Serialization) {
   EXPECT_EQ(Instant() + 10 * Second, checkpointer->oldest_checkpoint());
 }
 
+TEST_F(CheckpointerTest, Compression) {
+  EXPECT_EQ(0, checkpointer_.checkpoints_size_in_bytes());
+
+  Instant const t1 = Instant() + 10 * Second;
+  EXPECT_CALL(writer_, Call(_)).WillOnce(SetPayload(1729));
+  checkpointer_.WriteToCheckpoint(t1);
+  std::int64_t const size1 = checkpointer_.checkpoints_size_in_bytes();
+  EXPECT_LT(0, size1);
+
+  Instant const t2 = t1 + 11 * Second;
+  EXPECT_CALL(writer_, Call(_)).WillOnce(SetPayload(-42));
+  checkpointer_.WriteToCheckpoint(t2);
+  EXPECT_LT(size1, checkpointer_.checkpoints_size_in_bytes());
+
+  Message m;
+  checkpointer_.WriteToMessage(&m.checkpoint);
+  EXPECT_EQ(1729, m.checkpoint[0].payload);
+  EXPECT_EQ(-42, m.checkpoint[1].payload);
+
+  auto const checkpointer =
+      Checkpointer<Message>::ReadFromMessage(writer_.AsStdFunction(),
+                                             reader_.AsStdFunction(),
+                                             m.checkpoint);
+  EXPECT_EQ(checkpointer_.checkpoints_size_in_bytes(),
+            checkpointer->checkpoints_size_in_bytes());
+  EXPECT_CALL(reader_, Call(Field(&Message::Checkpoint::payload, -42)));
+  EXPECT_OK(checkpointer->ReadFromNewestCheckpoint());
+}
+
 }  // namespace physics
 }  // namespace principia
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "base/thread_pool.hpp"
+#include "geometry/named_quantities.hpp"
+#include "physics/degrees_of_freedom.hpp"
+#include "physics/discrete_trajectory.hpp"
+#include "physics/discrete_trajectory_iterator.hpp"
+#include "quantities/quantities.hpp"
+
+namespace principia {
+namespace physics {
+namespace internal_conjunctions {
+
+using base::ThreadPool;
+using geometry::Instant;
+using quantities::Length;
+using quantities::Time;
+
+// A local minimum of the distance between two trajectories.
+template<typename Frame>
+struct Conjunction {
+  // The indices of the trajectories in the input of |ScreenConjunctions|, with
+  // |index1 < index2|.
+  int index1;
+  int index2;
+  Instant time;
+  Length distance;
+  DegreesOfFreedom<Frame> degrees_of_freedom1;
+  DegreesOfFreedom<Frame> degrees_of_freedom2;
+};
+
+// The section [first, second[ of a discrete trajectory.
+template<typename Frame>
+using TrajectorySection = std::pair<DiscreteTrajectoryIterator<Frame>,
+                                    DiscreteTrajectoryIterator<Frame>>;
+
+// Returns the local minima of the distance between any two of the
+// |trajectories| where that distance is at most |threshold|, in increasing
+// time order.  The trajectories are interpolated using Hermite polynomials, as
+// in |DiscreteTrajectory::EvaluateDegreesOfFreedom|.
+// The time span of the trajectories is divided in buckets of |bucket_duration|.
+// In each bucket, the pairs of trajectories whose bounding boxes are within
+// |threshold| of each other are found by sweep and prune, and only these pairs
+// are refined.  The bounding boxes are those of the control points of the
+// Hermite polynomials, so no conjunction is missed.  The duration of the
+// buckets should be a few times the step of the trajectories.
+// The buckets are processed on the |pool| if it is not null.
+template<typename Frame>
+std::vector<Conjunction<Frame>> ScreenConjunctions(
+    std::vector<TrajectorySection<Frame>> const& trajectories,
+    Length const& threshold,
+    Time const& bucket_duration,
+    ThreadPool<void>* pool = nullptr);
+
+}  // namespace internal_conjunctions
+
+using internal_conjunctions::Conjunction;
+using internal_conjunctions::ScreenConjunctions;
+using internal_conjunctions::TrajectorySection;
+
+}  // namespace physics
+}  // namespace principia
+
+#include "physics/conjunctions_body.hpp"
@@ -0,0 +1,369 @@
+#pragma once
+
+#include "physics/conjunctions.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <future>
+#include <iterator>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+#include "geometry/barycentre_calculator.hpp"
+#include "geometry/r3_element.hpp"
+#include "geometry/sign.hpp"
+#include "numerics/hermite3.hpp"
+#include "quantities/named_quantities.hpp"
+
+namespace principia {
+namespace physics {
+namespace internal_conjunctions {
+
+using geometry::Barycentre;
+using geometry::InnerProduct;
+using geometry::Position;
+using geometry::R3Element;
+using geometry::Sign;
+using numerics::Hermite3;
+using quantities::IsFinite;
+using quantities::Square;
+using quantities::Variation;
+
+// An axis-aligned box, in the coordinates of the frame.
+struct BoundingBox {
+  explicit BoundingBox(R3Element<Length> const& point);
+
+  void Extend(R3Element<Length> const& point);
+  void Extend(BoundingBox const& box);
+
+  // Returns false if the distance between this box and |box| is certainly
+  // greater than |threshold|.
+  bool IsWithin(BoundingBox const& box, Length const& threshold) const;
+
+  R3Element<Length> min;
+  R3Element<Length> max;
+};
+
+// The bounding boxes of a trajectory in the buckets that it spans.
+template<typename Frame>
+struct TrajectoryBuckets {
+  std::int64_t first_bucket = 0;
+  // Indexed by bucket number minus |first_bucket|.
+  std::vector<BoundingBox> boxes;
+  // The first point of the first Hermite polynomial that overlaps each bucket.
+  std::vector<DiscreteTrajectoryIterator<Frame>> firsts;
+  Instant t_min;
+  Instant t_max;
+
+  bool spans(std::int64_t const bucket) const {
+    return bucket >= first_bucket &&
+           bucket < first_bucket + static_cast<std::int64_t>(boxes.size());
+  }
+};
+
+inline BoundingBox::BoundingBox(R3Element<Length> const& point)
+    : min(point), max(point) {}
+
+inline void BoundingBox::Extend(R3Element<Length> const& point) {
+  min = R3Element<Length>(std::min(min.x, point.x),
+                          std::min(min.y, point.y),
+                          std::min(min.z, point.z));
+  max = R3Element<Length>(std::max(max.x, point.x),
+                          std::max(max.y, point.y),
+                          std::max(max.z, point.z));
+}
+
+inline void BoundingBox::Extend(BoundingBox const& box) {
+  Extend(box.min);
+  Extend(box.max);
+}
+
+inline bool BoundingBox::IsWithin(BoundingBox const& box,
+                                  Length const& threshold) const {
+  return min.x <= box.max.x + threshold && box.min.x <= max.x + threshold &&
+         min.y <= box.max.y + threshold && box.min.y <= max.y + threshold &&
+         min.z <= box.max.z + threshold && box.min.z <= max.z + threshold;
+}
+
+// Returns the degrees of freedom at |t| of the trajectory ending at |end|.
+// |it| must be a point at or before |t|, and is advanced to the last point at
+// or before |t|.
+template<typename Frame>
+DegreesOfFreedom<Frame> Interpolate(DiscreteTrajectoryIterator<Frame>& it,
+                                    DiscreteTrajectoryIterator<Frame> const end,
+                                    Instant const& t) {
+  for (auto next = std::next(it); next != end && next->time <= t; ++next) {
+    it = next;
+  }
+  auto const next = std::next(it);
+  if (it->time == t || next == end) {
+    return it->degrees_of_freedom;
+  }
+  Hermite3<Instant, Position<Frame>> const hermite(
+      {it->time, next->time},
+      {it->degrees_of_freedom.position(), next->degrees_of_freedom.position()},
+      {it->degrees_of_freedom.velocity(), next->degrees_of_freedom.velocity()});
+  return DegreesOfFreedom<Frame>(hermite.Evaluate(t),
+                                 hermite.EvaluateDerivative(t));
+}
+
+// Appends to |conjunctions| the local minima in [t_lower, t_upper] of the
+// distance between the trajectories |index1| and |index2|, starting the search
+// at |it1| and |it2|.
+template<typename Frame>
+void Refine(std::int64_t const index1,
+            std::int64_t const index2,
+            DiscreteTrajectoryIterator<Frame> it1,
+            DiscreteTrajectoryIterator<Frame> const end1,
+            DiscreteTrajectoryIterator<Frame> it2,
+            DiscreteTrajectoryIterator<Frame> const end2,
+            Instant const& t_lower,
+            Instant const& t_upper,
+            Length const& threshold,
+            std::vector<Conjunction<Frame>>& conjunctions) {
+  std::optional<Instant> previous_time;
+  std::optional<Square<Length>> previous_squared_distance;
+  std::optional<Variation<Square<Length>>>
+      previous_squared_distance_derivative;
+  auto previous_it1 = it1;
+  auto previous_it2 = it2;
+
+  // The samples are the points of both trajectories, so that the relative
+  // motion is a cubic between consecutive samples.
+  for (Instant t = t_lower;;) {
+    RelativeDegreesOfFreedom<Frame> const relative =
+        Interpolate(it1, end1, t) - Interpolate(it2, end2, t);
+    Square<Length> const squared_distance = relative.displacement().Norm²();
+    Variation<Square<Length>> const squared_distance_derivative =
+        2.0 * InnerProduct(relative.displacement(), relative.velocity());
+
+    if (previous_squared_distance_derivative &&
+        Sign(*previous_squared_distance_derivative).is_negative() &&
+        !Sign(squared_distance_derivative).is_negative()) {
+      // The distance has a minimum.  Find it as in |ComputeApsides|.
+      Hermite3<Instant, Square<Length>> const
+          squared_distance_approximation(
+              {*previous_time, t},
+              {*previous_squared_distance, squared_distance},
+              {*previous_squared_distance_derivative,
+               squared_distance_derivative});
+      Instant minimum_time;
+      int valid_extrema = 0;
+      for (auto const& extremum :
+           squared_distance_approximation.FindExtrema()) {
+        if (extremum >= *previous_time && extremum <= t) {
+          minimum_time = extremum;
+          ++valid_extrema;
+        }
+      }
+      if (valid_extrema != 1) {
+        minimum_time = Barycentre<Instant, Variation<Square<Length>>>(
+            {t, *previous_time},
+            {*previous_squared_distance_derivative,
+             -squared_distance_derivative});
+      }
+      if (IsFinite(minimum_time - Instant{})) {
+        auto const degrees_of_freedom1 =
+            Interpolate(previous_it1, end1, minimum_time);
+        auto const degrees_of_freedom2 =
+            Interpolate(previous_it2, end2, minimum_time);
+        Length const distance = (degrees_of_freedom1.position() -
+                                 degrees_of_freedom2.position()).Norm();
+        if (distance <= threshold) {
+          conjunctions.push_back({.index1 = static_cast<int>(index1),
+                                  .index2 = static_cast<int>(index2),
+                                  .time = minimum_time,
+                                  .distance = distance,
+                                  .degrees_of_freedom1 = degrees_of_freedom1,
+                                  .degrees_of_freedom2 = degrees_of_freedom2});
+        }
+      }
+    }
+
+    if (t >= t_upper) {
+      break;
+    }
+    previous_time = t;
+    previous_squared_distance = squared_distance;
+    previous_squared_distance_derivative = squared_distance_derivative;
+    previous_it1 = it1;
+    previous_it2 = it2;
+
+    Instant next_t = t_upper;
+    if (auto const next1 = std::next(it1); next1 != end1) {
+      next_t = std::min(next_t, next1->time);
+    }
+    if (auto const next2 = std::next(it2); next2 != end2) {
+      next_t = std::min(next_t, next2->time);
+    }
+    t = next_t;
+  }
+}
+
+template<typename Frame>
+std::vector<Conjunction<Frame>> ScreenConjunctions(
+    std::vector<TrajectorySection<Frame>> const& trajectories,
+    Length const& threshold,
+    Time const& bucket_duration,
+    ThreadPool<void>* const pool) {
+  std::int64_t const number_of_trajectories = trajectories.size();
+
+  // Runs |task(i)| for all i in [0, size[, on the |pool| if there is one.
+  auto const run = [pool](std::int64_t const size, auto const& task) {
+    if (pool == nullptr) {
+      for (std::int64_t i = 0; i < size; ++i) {
+        task(i);
+      }
+    } else {
+      std::vector<std::future<void>> futures;
+      for (std::int64_t i = 0; i < size; ++i) {
+        futures.push_back(pool->Add([i, &task]() { task(i); }));
+      }
+      for (auto& future : futures) {
+        future.wait();
+      }
+    }
+  };
+
+  std::optional<Instant> t_start;
+  std::optional<Instant> t_end;
+  for (auto const& [begin, end] : trajectories) {
+    if (begin != end) {
+      t_start = t_start.has_value() ? std::min(*t_start, begin->time)
+                                    : begin->time;
+      t_end = t_end.has_value() ? std::max(*t_end, std::prev(end)->time)
+                                : std::prev(end)->time;
+    }
+  }
+  if (!t_start.has_value()) {
+    return {};
+  }
+  std::int64_t const number_of_buckets = std::max<std::int64_t>(
+      1, std::ceil((*t_end - *t_start) / bucket_duration));
+  auto const bucket = [number_of_buckets, &bucket_duration, &t_start](
+                          Instant const& t) {
+    return std::clamp<std::int64_t>(
+        std::floor((t - *t_start) / bucket_duration), 0, number_of_buckets - 1);
+  };
+
+  // Compute the bounding boxes of each trajectory in each bucket.  The
+  // Hermite polynomial between two points is in the convex hull of its Bézier
+  // control points.
+  std::vector<TrajectoryBuckets<Frame>> buckets(number_of_trajectories);
+  run(number_of_trajectories, [&bucket, &buckets, &trajectories](
+                                  std::int64_t const i) {
+    auto const& [begin, end] = trajectories[i];
+    auto& trajectory_buckets = buckets[i];
+    if (begin == end) {
+      return;
+    }
+    trajectory_buckets.first_bucket = bucket(begin->time);
+    trajectory_buckets.t_min = begin->time;
+    trajectory_buckets.t_max = std::prev(end)->time;
+    for (auto it = begin; it != end; ++it) {
+      auto const& [t0, degrees_of_freedom0] = *it;
+      auto const q0 = degrees_of_freedom0.position() - Frame::origin;
+      BoundingBox box(q0.coordinates());
+      std::int64_t last_bucket = bucket(t0);
+      if (auto const next = std::next(it); next != end) {
+        auto const& [t1, degrees_of_freedom1] = *next;
+        auto const q1 = degrees_of_freedom1.position() - Frame::origin;
+        Time const h = t1 - t0;
+        box.Extend(q1.coordinates());
+        box.Extend((q0 + degrees_of_freedom0.velocity() * h / 3).coordinates());
+        box.Extend((q1 - degrees_of_freedom1.velocity() * h / 3).coordinates());
+        last_bucket = bucket(t1);
+      }
+      for (std::int64_t b = bucket(t0); b <= last_bucket; ++b) {
+        std::size_t const k = b - trajectory_buckets.first_bucket;
+        if (k == trajectory_buckets.boxes.size()) {
+          trajectory_buckets.boxes.push_back(box);
+          trajectory_buckets.firsts.push_back(it);
+        } else {
+          trajectory_buckets.boxes[k].Extend(box);
+        }
+      }
+    }
+  });
+
+  // In each bucket, sweep along the x axis and refine the pairs whose boxes
+  // are close enough.
+  std::vector<std::vector<Conjunction<Frame>>> bucket_conjunctions(
+      number_of_buckets);
+  run(number_of_buckets, [&bucket_conjunctions,
+                          &bucket_duration,
+                          &buckets,
+                          number_of_trajectories,
+                          &t_start,
+                          &threshold,
+                          &trajectories](std::int64_t const b) {
+    std::vector<std::int64_t> entries;
+    for (std::int64_t i = 0; i < number_of_trajectories; ++i) {
+      if (buckets[i].spans(b)) {
+        entries.push_back(i);
+      }
+    }
+    auto const box = [b, &buckets](std::int64_t const i) -> auto const& {
+      return buckets[i].boxes[b - buckets[i].first_bucket];
+    };
+    std::stable_sort(entries.begin(),
+                     entries.end(),
+                     [&box](std::int64_t const left, std::int64_t const right) {
+                       return box(left).min.x < box(right).min.x;
+                     });
+
+    Instant const bucket_start = *t_start + b * bucket_duration;
+    Instant const bucket_end = bucket_start + bucket_duration;
+    std::vector<std::int64_t> active;
+    for (std::int64_t const j : entries) {
+      std::erase_if(active, [&box, j, &threshold](std::int64_t const i) {
+        return box(i).max.x + threshold < box(j).min.x;
+      });
+      for (std::int64_t const i : active) {
+        if (!box(i).IsWithin(box(j), threshold)) {
+          continue;
+        }
+        std::int64_t const index1 = std::min(i, j);
+        std::int64_t const index2 = std::max(i, j);
+        auto const& buckets1 = buckets[index1];
+        auto const& buckets2 = buckets[index2];
+        Instant const t_lower =
+            std::max({bucket_start, buckets1.t_min, buckets2.t_min});
+        Instant const t_upper =
+            std::min({bucket_end, buckets1.t_max, buckets2.t_max});
+        if (t_lower <= t_upper) {
+          Refine(index1,
+                 index2,
+                 buckets1.firsts[b - buckets1.first_bucket],
+                 trajectories[index1].second,
+                 buckets2.firsts[b - buckets2.first_bucket],
+                 trajectories[index2].second,
+                 t_lower,
+                 t_upper,
+                 threshold,
+                 bucket_conjunctions[b]);
+        }
+      }
+      active.push_back(j);
+    }
+  });
+
+  std::vector<Conjunction<Frame>> conjunctions;
+  for (auto const& c : bucket_conjunctions) {
+    conjunctions.insert(conjunctions.end(), c.begin(), c.end());
+  }
+  std::stable_sort(conjunctions.begin(),
+                   conjunctions.end(),
+                   [](Conjunction<Frame> const& left,
+                      Conjunction<Frame> const& right) {
+                     return std::tie(left.time, left.index1, left.index2) <
+                            std::tie(right.time, right.index1, right.index2);
+                   });
+  return conjunctions;
+}
+
+}  // namespace internal_conjunctions
+}  // namespace physics
+}  // namespace principia
@@ -0,0 +1,117 @@
+#include "physics/conjunctions.hpp"
+
+#include <vector>
+
+#include "base/thread_pool.hpp"
+#include "geometry/frame.hpp"
+#include "geometry/grassmann.hpp"
+#include "geometry/named_quantities.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "physics/degrees_of_freedom.hpp"
+#include "physics/discrete_trajectory.hpp"
+#include "quantities/quantities.hpp"
+#include "quantities/si.hpp"
+#include "serialization/geometry.pb.h"
+#include "testing_utilities/matchers.hpp"
+#include "testing_utilities/numerics.hpp"
+
+namespace principia {
+namespace physics {
+
+using base::ThreadPool;
+using geometry::Displacement;
+using geometry::Frame;
+using geometry::Handedness;
+using geometry::Inertial;
+using geometry::Instant;
+using geometry::Velocity;
+using quantities::Length;
+using quantities::Speed;
+using quantities::Time;
+using quantities::si::Kilo;
+using quantities::si::Metre;
+using quantities::si::Micro;
+using quantities::si::Second;
+using testing_utilities::AbsoluteError;
+using ::testing::Eq;
+using ::testing::IsEmpty;
+using ::testing::Lt;
+using ::testing::SizeIs;
+
+class ConjunctionsTest : public ::testing::Test {
+ protected:
+  using World = Frame<serialization::Frame::TestTag,
+                      Inertial,
+                      Handedness::Right,
+                      serialization::Frame::TEST>;
+
+  // Fills |trajectory| with a uniform motion that goes through |q0| at |t0_|.
+  void FillTrajectory(Displacement<World> const& q0,
+                      Velocity<World> const& v,
+                      DiscreteTrajectory<World>& trajectory) const {
+    for (int i = 0; i <= number_of_steps_; ++i) {
+      Instant const t = t0_ + i * step_;
+      EXPECT_OK(trajectory.Append(
+          t,
+          DegreesOfFreedom<World>(World::origin + q0 + v * (t - t0_), v)));
+    }
+  }
+
+  Instant const t0_;
+  Time const step_ = 7 * Second;
+  int const number_of_steps_ = 30;
+};
+
+TEST_F(ConjunctionsTest, UniformMotions) {
+  Speed const v = 10 * Metre / Second;
+  Length const l = 1 * Kilo(Metre);
+
+  // The first two trajectories pass within 1 m of each other at |t0_ + l / v|.
+  // The third one is far away.
+  DiscreteTrajectory<World> trajectory1;
+  DiscreteTrajectory<World> trajectory2;
+  DiscreteTrajectory<World> trajectory3;
+  FillTrajectory(Displacement<World>({-l, 0 * Metre, 0 * Metre}),
+                 Velocity<World>({v, 0 * v, 0 * v}),
+                 trajectory1);
+  FillTrajectory(Displacement<World>({0 * Metre, -l, 1 * Metre}),
+                 Velocity<World>({0 * v, v, 0 * v}),
+                 trajectory2);
+  FillTrajectory(Displacement<World>({-l, 0 * Metre, 10 * Kilo(Metre)}),
+                 Velocity<World>({v, 0 * v, 0 * v}),
+                 trajectory3);
+  std::vector<TrajectorySection<World>> const trajectories = {
+      {trajectory1.begin(), trajectory1.end()},
+      {trajectory2.begin(), trajectory2.end()},
+      {trajectory3.begin(), trajectory3.end()}};
+
+  auto const conjunctions = ScreenConjunctions(trajectories,
+                                               /*threshold=*/10 * Metre,
+                                               /*bucket_duration=*/20 * Second);
+  ASSERT_THAT(conjunctions, SizeIs(1));
+  EXPECT_THAT(conjunctions[0].index1, Eq(0));
+  EXPECT_THAT(conjunctions[0].index2, Eq(1));
+  EXPECT_THAT(AbsoluteError(t0_ + l / v, conjunctions[0].time),
+              Lt(1 * Micro(Second)));
+  EXPECT_THAT(AbsoluteError(1 * Metre, conjunctions[0].distance),
+              Lt(1 * Micro(Metre)));
+
+  // The parallel screening gives the same result.
+  ThreadPool<void> pool(/*pool_size=*/2);
+  auto const parallel_conjunctions =
+      ScreenConjunctions(trajectories,
+                         /*threshold=*/10 * Metre,
+                         /*bucket_duration=*/20 * Second,
+                         &pool);
+  ASSERT_THAT(parallel_conjunctions, SizeIs(1));
+  EXPECT_THAT(parallel_conjunctions[0].time, Eq(conjunctions[0].time));
+
+  EXPECT_THAT(ScreenConjunctions(trajectories,
+                                 /*threshold=*/0.5 * Metre,
+                                 /*bucket_duration=*/20 * Second),
+              IsEmpty());
+}
+
+}  // namespace physics
+}  // namespace principia
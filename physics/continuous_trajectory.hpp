@@ -2,16 +2,23 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
 #include <optional>
 #include <utility>
 #include <vector>
 
 #include "absl/status/status.h"
 #include "absl/synchronization/mutex.h"
+#include "base/macros.hpp"
 #include "base/not_null.hpp"
+#include "base/published_deque.hpp"
+#include "base/thread_pool.hpp"
+#include "geometry/grassmann.hpp"
 #include "geometry/named_quantities.hpp"
+#include "geometry/r3_element.hpp"
 #include "numerics/piecewise_poisson_series.hpp"
 #include "numerics/polynomial.hpp"
+#include "numerics/polynomial_arena.hpp"
 #include "numerics/polynomial_evaluators.hpp"
 #include "physics/checkpointer.hpp"
 #include "physics/degrees_of_freedom.hpp"
@@ -21,25 +28,41 @@
 
 namespace principia {
 namespace physics {
+
+FORWARD_DECLARE_FROM(ephemeris_cache,
+                     TEMPLATE(typename Frame) class,
+                     EphemerisCache);
+
 namespace internal_continuous_trajectory {
 
 using base::not_null;
+using base::PublishedDeque;
+using base::ThreadPool;
 using geometry::Displacement;
 using geometry::Instant;
 using geometry::Position;
+using geometry::R3Element;
+using geometry::Vector;
 using geometry::Velocity;
 using quantities::Length;
 using quantities::Time;
 using numerics::EstrinEvaluator;
 using numerics::PiecewisePoissonSeries;
 using numerics::Polynomial;
+using numerics::PolynomialArena;
+
+// The range of degrees of the polynomials of a |ContinuousTrajectory|.
+constexpr int max_degree = 17;
+constexpr int min_degree = 3;
 
 template<typename Frame>
 class TestableContinuousTrajectory;
 
 // This class is thread-safe, but the client must be aware that if, for
 // instance, the trajectory is appended to asynchronously, successive calls to
-// |t_max()| may return different values.
+// |t_max()| may return different values.  The functions that evaluate the
+// trajectory or return its bounds don't lock and don't write to memory shared
+// with other threads, so they scale with the number of threads.
 template<typename Frame>
 class ContinuousTrajectory : public Trajectory<Frame> {
  public:
@@ -58,11 +81,11 @@ class ContinuousTrajectory : public Trajectory<Frame> {
   ContinuousTrajectory& operator=(ContinuousTrajectory&&) = delete;
 
   // Returns true iff this trajectory cannot be evaluated for any time.
-  bool empty() const EXCLUDES(lock_);
+  bool empty() const;
 
   // The average degree of the polynomials for the trajectory.  Only useful for
   // benchmarking or analyzing performance.  Do not use in real code.
-  double average_degree() const EXCLUDES(lock_);
+  double average_degree() const;
 
   // Appends one point to the trajectory.  |time| must be after the last time
   // passed to |Append| if the trajectory is not empty.  The |time|s passed to
@@ -73,7 +96,8 @@ class ContinuousTrajectory : public Trajectory<Frame> {
       EXCLUDES(lock_);
 
   // Prepends the given |trajectory| to this one.  Ideally the last point of
-  // |trajectory| should match the first point of this object.
+  // |trajectory| should match the first point of this object.  This object may
+  // be evaluated concurrently, but |trajectory| must not.
   // Note the rvalue reference: |ContinuousTrajectory| is not moveable and not
   // copyable, but the |InstantPolynomialPairs| are moveable and we really want
   // to move them.  We could pass by non-const lvalue reference, but we would
@@ -87,18 +111,54 @@ class ContinuousTrajectory : public Trajectory<Frame> {
   // trajectory cannot be evaluated for the last points, for which no polynomial
   // was constructed.  For an empty trajectory, an infinity with the proper
   // sign is returned.
-  Instant t_min() const override EXCLUDES(lock_);
-  Instant t_max() const override EXCLUDES(lock_);
+  Instant t_min() const override;
+  Instant t_max() const override;
 
-  Position<Frame> EvaluatePosition(Instant const& time) const override
-      EXCLUDES(lock_);
-  Velocity<Frame> EvaluateVelocity(Instant const& time) const override
-      EXCLUDES(lock_);
+  Position<Frame> EvaluatePosition(Instant const& time) const override;
+  Velocity<Frame> EvaluateVelocity(Instant const& time) const override;
   DegreesOfFreedom<Frame> EvaluateDegreesOfFreedom(
-      Instant const& time) const override EXCLUDES(lock_);
+      Instant const& time) const override;
 
   // End of the implementation of the interface.
 
+  // Same as above, but the polynomial at index |hint| is tried first.  On
+  // return, |hint| is the index of the polynomial that was evaluated.  The
+  // trajectories of an |Ephemeris| have aligned polynomial boundaries, so
+  // passing the same |hint| to all of them shares the lookup.  Any value is
+  // correct for |hint|.
+  Position<Frame> EvaluatePosition(Instant const& time,
+                                   std::int64_t& hint) const;
+  DegreesOfFreedom<Frame> EvaluateDegreesOfFreedom(Instant const& time,
+                                                   std::int64_t& hint) const;
+
+  // A zero of a function of the motion of this trajectory relative to another
+  // one, and whether that function is increasing there.
+  struct Zero {
+    Instant time;
+    bool increasing;
+  };
+
+  // Returns the apsides in [t_min, t_max] of this trajectory relative to
+  // |other|, i.e., the zeros of ⟨q - q_other, v - v_other⟩, in increasing
+  // order.  A zero where that function is increasing is a periapsis.
+  // The zeros are found on the polynomials themselves, independently on each
+  // interval where both trajectories are polynomials.  If |pool| is not null,
+  // the intervals are processed in parallel on it.
+  std::vector<Zero> ComputeApsides(ContinuousTrajectory const& other,
+                                   Instant const& t_min,
+                                   Instant const& t_max,
+                                   ThreadPool<void>* pool = nullptr) const;
+
+  // Same as above, but returns the nodes of this trajectory relative to |other|
+  // on the plane orthogonal to |normal|, i.e., the zeros of
+  // ⟨q - q_other, normal⟩.  A zero where that function is increasing is an
+  // ascending node.
+  std::vector<Zero> ComputeNodes(ContinuousTrajectory const& other,
+                                 Vector<double, Frame> const& normal,
+                                 Instant const& t_min,
+                                 Instant const& t_max,
+                                 ThreadPool<void>* pool = nullptr) const;
+
 #if PRINCIPIA_CONTINUOUS_TRAJECTORY_SUPPORTS_PIECEWISE_POISSON_SERIES
   // Returns the degree for a piecewise Poisson series covering the given time
   // interval.
@@ -133,49 +193,43 @@ class ContinuousTrajectory : public Trajectory<Frame> {
       Instant const& t,
       Checkpointer<serialization::ContinuousTrajectory>::Reader const& reader)
       const;
+  std::int64_t checkpoints_size_in_bytes() const;
 
   // Return functions that can be passed to a |Checkpointer| to write this
-  // trajectory to a checkpoint or read it back.
+  // trajectory to a checkpoint or read it back.  The reader truncates the
+  // polynomials, so it must only be used on a trajectory that is not being
+  // evaluated concurrently.
   Checkpointer<serialization::ContinuousTrajectory>::Writer
   MakeCheckpointerWriter();
   Checkpointer<serialization::ContinuousTrajectory>::Reader
   MakeCheckpointerReader();
 
- public:
-  // Beware! This part of the API is thread-unsafe.  The caller (which may be a
-  // function of this class) is responsible for synchronization, i.e., for
-  // making sure that no mutators execute in parallel with any of the functions
-  // having "locked" in their name.  The purpose of this API is to improve the
-  // performance of the |Ephemeris|.
-
-  Instant t_min_locked() const;
-  Instant t_max_locked() const;
-
-  Position<Frame> EvaluatePositionLocked(Instant const& time) const;
-  Velocity<Frame> EvaluateVelocityLocked(Instant const& time) const;
-  DegreesOfFreedom<Frame> EvaluateDegreesOfFreedomLocked(
-      Instant const& time) const;
-
  protected:
   // For mocking.
   ContinuousTrajectory();
 
  private:
+  // The polynomials are stored by value, contiguously for each degree, and
+  // evaluated without virtual calls.
+  using Polynomials = PolynomialArena<Position<Frame>, Instant, max_degree>;
+
   // Each polynomial is valid over an interval [t_min, t_max].  Polynomials are
-  // stored in this vector sorted by their |t_max|, as it turns out that we
-  // never need to extract their |t_min|.  Logically, the |t_min| for a
-  // polynomial is the |t_max| of the previous one.  The first polynomial has a
-  // |t_min| which is |*first_time_|.
+  // stored sorted by their |t_max|.  Logically, the |t_min| for a polynomial is
+  // the |t_max| of the previous one, and the first polynomial has a |t_min|
+  // which is |*first_time_|.  The |t_min| is nonetheless stored so that readers
+  // can determine the bounds of the trajectory from the polynomials alone.
+  // This header is small, so that the binary search over the intervals touches
+  // little memory; the degree and the origin of the polynomial are accessed
+  // through the |polynomial| handle.
   struct InstantPolynomialPair {
-    InstantPolynomialPair(
-        Instant t_max,
-        not_null<std::unique_ptr<Polynomial<Position<Frame>, Instant>>>
-            polynomial);
+    InstantPolynomialPair(Instant t_min,
+                          Instant t_max,
+                          typename Polynomials::Handle polynomial);
+    Instant t_min;
     Instant t_max;
-    not_null<std::unique_ptr<Polynomial<Position<Frame>, Instant>>>
-        polynomial;
+    typename Polynomials::Handle polynomial;
   };
-  using InstantPolynomialPairs = std::vector<InstantPolynomialPair>;
+  using InstantPolynomialPairs = PublishedDeque<InstantPolynomialPair>;
 
   // Really a static method, but may be overridden for testing.
   virtual not_null<std::unique_ptr<Polynomial<Position<Frame>, Instant>>>
@@ -196,13 +250,51 @@ class ContinuousTrajectory : public Trajectory<Frame> {
       std::vector<Position<Frame>> const& q,
       std::vector<Velocity<Frame>> const& v) REQUIRES(lock_);
 
-  // Returns an iterator to the polynomial applicable for the given |time|, or
-  // |begin| if |time| is before the first polynomial or |end| if |time| is
-  // after the last polynomial.  If |time| is the |t_max| of some polynomial,
-  // that polynomial is returned.  Time complexity is O(N Log N).
-  typename InstantPolynomialPairs::const_iterator
-  FindPolynomialForInstantLocked(Instant const& time) const
-      REQUIRES_SHARED(lock_);
+  // Returns the zeros in [t_min, t_max] of the polynomials computed by
+  // |make_polynomial| from the coefficients of |q - q_other| on each interval
+  // where both trajectories are polynomials.  |make_polynomial| is called with
+  // the coefficients of |q - q_other|, in metres, as a polynomial in
+  // u = (t - t_lower) / (t_upper - t_lower), where [t_lower, t_upper] is the
+  // interval, and must fill the coefficients of a polynomial in u.
+  template<typename MakePolynomial>
+  std::vector<Zero> ComputeRelativeZeros(ContinuousTrajectory const& other,
+                                         Instant const& t_min,
+                                         Instant const& t_max,
+                                         ThreadPool<void>* pool,
+                                         MakePolynomial make_polynomial) const;
+
+  // Writes to |coefficients| the coefficients of |polynomial|, in metres, as a
+  // polynomial in u = (t - t_lower) / (t_upper - t_lower).
+  static void ShiftAndScale(typename Polynomials::Handle const& polynomial,
+                            Instant const& t_lower,
+                            Instant const& t_upper,
+                            std::vector<R3Element<double>>& coefficients);
+
+  // Returns the index in |polynomials| of the polynomial applicable for the
+  // given |time|, or |polynomials.begin()| if |time| is before the first
+  // polynomial or |polynomials.end()| if |time| is after the last polynomial.
+  // If |time| is the |t_max| of some polynomial, that polynomial is returned.
+  // The polynomial at index |hint| is tried first, then the one last accessed
+  // by this thread, and |hint| is set to the result.  Time complexity is
+  // O(Log N) in the worst case, O(1) most of the time.
+  std::int64_t FindPolynomialForInstant(
+      typename InstantPolynomialPairs::View const& polynomials,
+      Instant const& time,
+      std::int64_t& hint) const;
+
+  // Lookups into |polynomials_| are expensive because they entail a binary
+  // search into a sequence that grows over time.  In benchmarks, this can be as
+  // costly as the polynomial evaluation itself.  The accesses are not random,
+  // though, they are clustered in time and (slowly) increasing.  To take
+  // advantage of this, we keep track of the index of the last accessed
+  // polynomial and first try to see if the new lookup is for the same
+  // polynomial.  This makes us O(1) instead of O(Log N) most of the time and it
+  // speeds up the lookup by a factor of 7.  The index is thread-local, so that
+  // concurrent evaluations don't write to shared memory, and so that threads
+  // that evaluate at different times don't evict each other's index.  The
+  // returned reference is only valid on the calling thread.  Any value is
+  // correct.
+  std::int64_t& last_accessed_polynomial() const;
 
   // Construction parameters;
   Time const step_;
@@ -223,23 +315,12 @@ class ContinuousTrajectory : public Trajectory<Frame> {
   int degree_ GUARDED_BY(lock_);
   int degree_age_ GUARDED_BY(lock_);
 
-  // The polynomials are in increasing time order.
-  InstantPolynomialPairs polynomials_ GUARDED_BY(lock_);
-
-  // Lookups into |polynomials_| are expensive because they entail a binary
-  // search into a vector that grows over time.  In benchmarks, this can be as
-  // costly as the polynomial evaluation itself.  The accesses are not random,
-  // though, they are clustered in time and (slowly) increasing.  To take
-  // advantage of this, we keep track of the index of the last accessed
-  // polynomial and first try to see if the new lookup is for the same
-  // polynomial.  This makes us O(1) instead of O(Log N) most of the time and it
-  // speeds up the lookup by a factor of 7.  This member is mutable to maintain
-  // the fiction that evaluation has no side effects.  In the presence of
-  // multithreading it may be that different threads would want to access
-  // polynomials at different indices, but by and large the threads progress in
-  // parallel, and benchmarks show that there is no adverse performance effects.
-  // Any value in the range of |polynomials_| or 0 is correct.
-  mutable std::int64_t last_accessed_polynomial_ GUARDED_BY(lock_) = 0;
+  // The polynomials are in increasing time order.  They are modified with
+  // |lock_| held, and published to the readers, which don't lock.  For each
+  // degree, the order of the polynomials in |polynomial_arena_| is the order of
+  // their headers in |polynomials_|.
+  Polynomials polynomial_arena_;
+  InstantPolynomialPairs polynomials_;
 
   // The time at which this trajectory starts.  Set for a nonempty trajectory.
   std::optional<Instant> first_time_ GUARDED_BY(lock_);
@@ -250,6 +331,7 @@ class ContinuousTrajectory : public Trajectory<Frame> {
   std::vector<std::pair<Instant, DegreesOfFreedom<Frame>>> last_points_
       GUARDED_BY(lock_);
 
+  friend class physics::EphemerisCache<Frame>;
   friend class TestableContinuousTrajectory<Frame>;
 };
 
@@ -4,6 +4,9 @@
 #include "physics/continuous_trajectory.hpp"
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <future>
 #include <limits>
 #include <optional>
 #include <sstream>
@@ -15,6 +18,7 @@
 #include "geometry/named_quantities.hpp"
 #include "glog/stl_logging.h"
 #include "numerics/newhall.hpp"
+#include "numerics/root_finders.hpp"
 #include "numerics/ulp_distance.hpp"
 #include "numerics/чебышёв_series.hpp"
 #include "quantities/si.hpp"
@@ -25,12 +29,14 @@ namespace internal_continuous_trajectory {
 
 using base::dynamic_cast_not_null;
 using base::make_not_null_unique;
+using geometry::Dot;
 using geometry::InfiniteFuture;
 using geometry::InfinitePast;
 using geometry::Interval;
 using numerics::EstrinEvaluator;
 using numerics::PoissonSeries;
 using numerics::PolynomialInMonomialBasis;
+using numerics::SolvePolynomialEquation;
 using numerics::ULPDistance;
 using numerics::ЧебышёвSeries;
 using quantities::DebugString;
@@ -38,9 +44,10 @@ using quantities::si::Metre;
 using quantities::si::Second;
 namespace si = quantities::si;
 
-constexpr int max_degree = 17;
-constexpr int min_degree = 3;
 int const max_degree_age = 100;
+// The number of pieces processed by each task when computing the zeros of a
+// function of the relative motion of two trajectories in parallel.
+constexpr std::int64_t pieces_per_task = 256;
 
 // Only supports 8 divisions for now.
 int const divisions = 8;
@@ -64,21 +71,20 @@ ContinuousTrajectory<Frame>::ContinuousTrajectory(Time const& step,
 
 template<typename Frame>
 bool ContinuousTrajectory<Frame>::empty() const {
-  absl::ReaderMutexLock l(&lock_);
-  return polynomials_.empty();
+  return polynomials_.view().empty();
 }
 
 template<typename Frame>
 double ContinuousTrajectory<Frame>::average_degree() const {
-  absl::ReaderMutexLock l(&lock_);
-  if (polynomials_.empty()) {
+  auto const polynomials = polynomials_.view();
+  if (polynomials.empty()) {
     return 0;
   } else {
     double total = 0;
-    for (auto const& pair : polynomials_) {
-      total += pair.polynomial->degree();
+    for (std::int64_t i = polynomials.begin(); i < polynomials.end(); ++i) {
+      total += polynomials[i].polynomial.degree();
     }
-    return total / polynomials_.size();
+    return total / polynomials.size();
   }
 }
 
@@ -140,17 +146,25 @@ void ContinuousTrajectory<Frame>::Prepend(ContinuousTrajectory&& prefix) {
   CHECK_EQ(step_, prefix.step_);
   CHECK_EQ(tolerance_, prefix.tolerance_);
 
-  if (prefix.polynomials_.empty()) {
+  if (prefix.polynomials_.view().empty()) {
     // Nothing to do.
-  } else if (polynomials_.empty()) {
+  } else if (polynomials_.view().empty()) {
     // All the data comes from |prefix|.  This must set all the fields of
     // this object that are not set at construction.
     adjusted_tolerance_ = prefix.adjusted_tolerance_;
     is_unstable_ = prefix.is_unstable_;
     degree_ = prefix.degree_;
     degree_age_ = prefix.degree_age_;
-    polynomials_ = std::move(prefix.polynomials_);
-    last_accessed_polynomial_ = prefix.last_accessed_polynomial_;
+    // The polynomials are published one at a time, so the readers always see
+    // a contiguous sequence.  This operation is in O(prefix.size()).
+    while (!prefix.polynomials_.view().empty()) {
+      InstantPolynomialPair const pair = prefix.polynomials_.pop_front();
+      polynomials_.push_back(InstantPolynomialPair(
+          pair.t_min,
+          pair.t_max,
+          polynomial_arena_.push_back(pair.polynomial.polynomial())));
+    }
+    prefix.polynomial_arena_.clear();
     first_time_ = prefix.first_time_;
     last_points_ = prefix.last_points_;
   } else {
@@ -159,12 +173,17 @@ void ContinuousTrajectory<Frame>::Prepend(ContinuousTrajectory&& prefix) {
     // on the other may depend on characteristics of the hardware and/or math
     // library, so we cannot check that the trajectories are "continuous" at the
     // junction.
-    CHECK_EQ(*first_time_, prefix.polynomials_.back().t_max);
-    // This operation is in O(prefix.size()).
-    std::move(polynomials_.begin(),
-              polynomials_.end(),
-              std::back_inserter(prefix.polynomials_));
-    polynomials_.swap(prefix.polynomials_);
+    CHECK_EQ(*first_time_, prefix.polynomials_.view().back().t_max);
+    // The polynomials of this object are not moved, so the readers may keep
+    // evaluating them.  This operation is in O(prefix.size()).
+    while (!prefix.polynomials_.view().empty()) {
+      InstantPolynomialPair const pair = prefix.polynomials_.pop_back();
+      polynomials_.push_front(InstantPolynomialPair(
+          pair.t_min,
+          pair.t_max,
+          polynomial_arena_.push_front(pair.polynomial.polynomial())));
+    }
+    prefix.polynomial_arena_.clear();
     first_time_ = prefix.first_time_;
     // Note that any |last_points_| in |prefix| are irrelevant because they
     // correspond to a time interval covered by the first polynomial of this
@@ -174,35 +193,115 @@ void ContinuousTrajectory<Frame>::Prepend(ContinuousTrajectory&& prefix) {
 
 template<typename Frame>
 Instant ContinuousTrajectory<Frame>::t_min() const {
-  absl::ReaderMutexLock l(&lock_);
-  return t_min_locked();
+  auto const polynomials = polynomials_.view();
+  if (polynomials.empty()) {
+    return InfiniteFuture;
+  }
+  return polynomials.front().t_min;
 }
 
 template<typename Frame>
 Instant ContinuousTrajectory<Frame>::t_max() const {
-  absl::ReaderMutexLock l(&lock_);
-  return t_max_locked();
+  auto const polynomials = polynomials_.view();
+  if (polynomials.empty()) {
+    return InfinitePast;
+  }
+  return polynomials.back().t_max;
 }
 
 template<typename Frame>
 Position<Frame> ContinuousTrajectory<Frame>::EvaluatePosition(
     Instant const& time) const {
-  absl::ReaderMutexLock l(&lock_);
-  return EvaluatePositionLocked(time);
+  std::int64_t hint = last_accessed_polynomial();
+  return EvaluatePosition(time, hint);
 }
 
 template<typename Frame>
 Velocity<Frame> ContinuousTrajectory<Frame>::EvaluateVelocity(
     Instant const& time) const {
-  absl::ReaderMutexLock l(&lock_);
-  return EvaluateVelocityLocked(time);
+  auto const polynomials = polynomials_.view();
+  CHECK(!polynomials.empty()) << time;
+  CHECK_LE(polynomials.front().t_min, time);
+  CHECK_GE(polynomials.back().t_max, time);
+  std::int64_t hint = last_accessed_polynomial();
+  auto const& polynomial =
+      polynomials[FindPolynomialForInstant(polynomials, time, hint)].polynomial;
+  return polynomial.EvaluateDerivative(time);
 }
 
 template<typename Frame>
 DegreesOfFreedom<Frame> ContinuousTrajectory<Frame>::EvaluateDegreesOfFreedom(
     Instant const& time) const {
-  absl::ReaderMutexLock l(&lock_);
-  return EvaluateDegreesOfFreedomLocked(time);
+  std::int64_t hint = last_accessed_polynomial();
+  return EvaluateDegreesOfFreedom(time, hint);
+}
+
+template<typename Frame>
+Position<Frame> ContinuousTrajectory<Frame>::EvaluatePosition(
+    Instant const& time,
+    std::int64_t& hint) const {
+  auto const polynomials = polynomials_.view();
+  CHECK(!polynomials.empty()) << time;
+  CHECK_LE(polynomials.front().t_min, time);
+  CHECK_GE(polynomials.back().t_max, time);
+  auto const& polynomial =
+      polynomials[FindPolynomialForInstant(polynomials, time, hint)].polynomial;
+  return polynomial.Evaluate(time);
+}
+
+template<typename Frame>
+DegreesOfFreedom<Frame> ContinuousTrajectory<Frame>::EvaluateDegreesOfFreedom(
+    Instant const& time,
+    std::int64_t& hint) const {
+  auto const polynomials = polynomials_.view();
+  CHECK(!polynomials.empty()) << time;
+  CHECK_LE(polynomials.front().t_min, time);
+  CHECK_GE(polynomials.back().t_max, time);
+  auto const& polynomial =
+      polynomials[FindPolynomialForInstant(polynomials, time, hint)].polynomial;
+  return DegreesOfFreedom<Frame>(polynomial.Evaluate(time),
+                                 polynomial.EvaluateDerivative(time));
+}
+
+template<typename Frame>
+std::vector<typename ContinuousTrajectory<Frame>::Zero>
+ContinuousTrajectory<Frame>::ComputeApsides(
+    ContinuousTrajectory const& other,
+    Instant const& t_min,
+    Instant const& t_max,
+    ThreadPool<void>* const pool) const {
+  // If Δq(u) = Σ Δq_i u^i, then ⟨Δq, Δq′⟩ = Σ j ⟨Δq_i, Δq_j⟩ u^(i + j - 1).
+  auto const make_polynomial =
+      [](std::vector<R3Element<double>> const& Δq,
+         std::vector<double>& polynomial) {
+        int const degree = static_cast<int>(Δq.size()) - 1;
+        polynomial.assign(std::max(2 * degree, 1), 0);
+        for (int i = 0; i <= degree; ++i) {
+          for (int j = 1; j <= degree; ++j) {
+            polynomial[i + j - 1] += j * Dot(Δq[i], Δq[j]);
+          }
+        }
+      };
+  return ComputeRelativeZeros(other, t_min, t_max, pool, make_polynomial);
+}
+
+template<typename Frame>
+std::vector<typename ContinuousTrajectory<Frame>::Zero>
+ContinuousTrajectory<Frame>::ComputeNodes(
+    ContinuousTrajectory const& other,
+    Vector<double, Frame> const& normal,
+    Instant const& t_min,
+    Instant const& t_max,
+    ThreadPool<void>* const pool) const {
+  auto const make_polynomial =
+      [&normal](std::vector<R3Element<double>> const& Δq,
+                std::vector<double>& polynomial) {
+        polynomial.resize(Δq.size());
+        for (std::size_t i = 0; i < Δq.size(); ++i) {
+          polynomial[i] = Dot(Δq[i], normal.coordinates());
+        }
+      };
+  return ComputeRelativeZeros(other, t_min, t_max, pool, make_polynomial);
 }
 
 #if PRINCIPIA_CONTINUOUS_TRAJECTORY_SUPPORTS_PIECEWISE_POISSON_SERIES
@@ -211,17 +310,16 @@ template<typename Frame>
 int ContinuousTrajectory<Frame>::PiecewisePoissonSeriesDegree(
     Instant const& t_min,
     Instant const& t_max) const {
-  absl::ReaderMutexLock l(&lock_);
-  CHECK_LE(t_min_locked(), t_min);
-  CHECK_GE(t_max_locked(), t_max);
-  auto const it_min = FindPolynomialForInstantLocked(t_min);
-  auto const it_max = FindPolynomialForInstantLocked(t_max);
+  auto const polynomials = polynomials_.view();
+  CHECK(!polynomials.empty());
+  CHECK_LE(polynomials.front().t_min, t_min);
+  CHECK_GE(polynomials.back().t_max, t_max);
+  std::int64_t hint = last_accessed_polynomial();
+  std::int64_t const i_min = FindPolynomialForInstant(polynomials, t_min, hint);
+  std::int64_t const i_max = FindPolynomialForInstant(polynomials, t_max, hint);
   int degree = min_degree;
-  for (auto it = it_min;; ++it) {
-    degree = std::max(degree, it->polynomial->degree());
-    if (it == it_max) {
-      break;
-    }
+  for (std::int64_t i = i_min; i <= i_max; ++i) {
+    degree = std::max(degree, polynomials[i].polynomial.degree());
   }
   return degree;
 }
@@ -254,7 +352,8 @@ ContinuousTrajectory<Frame>::ToPiecewisePoissonSeries(
   static_assert(aperiodic_degree >= min_degree &&
                 aperiodic_degree <= max_degree);
   // No check on the periodic degree, it plays no role here.
-  CHECK(!polynomials_.empty());
+  auto const polynomials = polynomials_.view();
+  CHECK(!polynomials.empty());
   using PiecewisePoisson =
       PiecewisePoissonSeries<Displacement<Frame>,
                              aperiodic_degree, periodic_degree,
@@ -306,16 +405,18 @@ ContinuousTrajectory<Frame>::ToPiecewisePoissonSeries(
 
   std::unique_ptr<PiecewisePoisson> result;
 
-  absl::ReaderMutexLock l(&lock_);
-  auto const it_min = FindPolynomialForInstantLocked(t_min);
-  auto const it_max = FindPolynomialForInstantLocked(t_max);
+  std::int64_t hint = last_accessed_polynomial();
+  std::int64_t const i_min = FindPolynomialForInstant(polynomials, t_min, hint);
+  std::int64_t const i_max = FindPolynomialForInstant(polynomials, t_max, hint);
   Instant current_t_min = t_min;
-  for (auto it = it_min;; ++it) {
-    Instant const current_t_max = std::min(t_max, it->t_max);
+  for (std::int64_t i = i_min; i <= i_max; ++i) {
+    auto const& pair = polynomials[i];
+    Instant const current_t_max = std::min(t_max, pair.t_max);
     Interval<Instant> interval;
     interval.Include(current_t_min);
     interval.Include(current_t_max);
-    auto const polynomial_cast_to_degree = cast_to_degree(it->polynomial.get());
+    auto const polynomial_cast_to_degree =
+        cast_to_degree(&pair.polynomial.polynomial());
     if (result == nullptr) {
       result = std::make_unique<PiecewisePoisson>(
           interval, Poisson(polynomial_cast_to_degree, {{}}));
@@ -323,9 +424,6 @@ ContinuousTrajectory<Frame>::ToPiecewisePoissonSeries(
       result->Append(interval, Poisson(polynomial_cast_to_degree, {{}}));
     }
     current_t_min = current_t_max;
-    if (it == it_max) {
-      break;
-    }
   }
   return *result;
 }
@@ -347,13 +445,14 @@ void ContinuousTrajectory<Frame>::WriteToMessage(
   // true since Fatou (#2149), but we maintain compatibility with older saves,
   // see #3039.  When such an old save is rewritten, we end up with polynomials
   // before the oldest checkpoint.
-  for (auto const& pair : polynomials_) {
-    Instant const& t_max = pair.t_max;
-    auto const& polynomial = pair.polynomial;
+  auto const polynomials = polynomials_.view();
+  for (std::int64_t i = polynomials.begin(); i < polynomials.end(); ++i) {
+    Instant const& t_max = polynomials[i].t_max;
+    auto const& polynomial = polynomials[i].polynomial;
     if (t_max <= checkpointer_->oldest_checkpoint()) {
       auto* const pair = message->add_instant_polynomial_pair();
       t_max.WriteToMessage(pair->mutable_t_max());
-      polynomial->WriteToMessage(pair->mutable_polynomial());
+      polynomial.polynomial().WriteToMessage(pair->mutable_polynomial());
     } else {
       break;
     }
@@ -392,6 +491,9 @@ ContinuousTrajectory<Frame>::ReadFromMessage(
       std::make_unique<ContinuousTrajectory<Frame>>(
           Time::ReadFromMessage(message.step()),
           Length::ReadFromMessage(message.tolerance()));
+  // The trajectory is not published yet, so we don't need to lock it.
+  auto& polynomial_arena = continuous_trajectory->polynomial_arena_;
+  auto& polynomials = continuous_trajectory->polynomials_;
   if (is_pre_cohen) {
     for (auto const& s : message.series()) {
       // Read the series, evaluate it and use the resulting values to build a
@@ -407,16 +509,25 @@ ContinuousTrajectory<Frame>::ReadFromMessage(
         v.push_back(series.EvaluateDerivative(t));
       }
       Displacement<Frame> error_estimate;  // Should we do something with this?
-      continuous_trajectory->polynomials_.emplace_back(
+      polynomials.push_back(InstantPolynomialPair(
+          series.t_min(),
           series.t_max(),
-          continuous_trajectory->NewhallApproximationInMonomialBasis(
-              series.degree(),
-              q, v,
-              series.t_min(), series.t_max(),
-              error_estimate));
+          polynomial_arena.push_back(
+              *continuous_trajectory->NewhallApproximationInMonomialBasis(
+                  series.degree(),
+                  q, v,
+                  series.t_min(), series.t_max(),
+                  error_estimate))));
     }
   } else {
+    // The |t_min| of a polynomial is the |t_max| of the previous one.
+    std::optional<Instant> t_min;
+    if (message.has_first_time()) {
+      t_min = Instant::ReadFromMessage(message.first_time());
+    }
     for (auto const& pair : message.instant_polynomial_pair()) {
+      CHECK(t_min.has_value()) << message.DebugString();
+      Instant const t_max = Instant::ReadFromMessage(pair.t_max());
       if (is_pre_gröbner) {
         // The easiest way to implement compatibility is to patch the serialized
         // form.
@@ -429,16 +540,21 @@ ContinuousTrajectory<Frame>::ReadFromMessage(
             mutable_coefficient(0)->mutable_point();
         *coefficient0_point->mutable_multivector() = coefficient0_multivector;
 
-        continuous_trajectory->polynomials_.emplace_back(
-            Instant::ReadFromMessage(pair.t_max()),
-            Polynomial<Position<Frame>, Instant>::template ReadFromMessage<
-                EstrinEvaluator>(polynomial));
+        polynomials.push_back(InstantPolynomialPair(
+            *t_min,
+            t_max,
+            polynomial_arena.push_back(
+                *Polynomial<Position<Frame>, Instant>::template ReadFromMessage<
+                    EstrinEvaluator>(polynomial))));
       } else {
-        continuous_trajectory->polynomials_.emplace_back(
-            Instant::ReadFromMessage(pair.t_max()),
-            Polynomial<Position<Frame>, Instant>::template ReadFromMessage<
-                EstrinEvaluator>(pair.polynomial()));
+        polynomials.push_back(InstantPolynomialPair(
+            *t_min,
+            t_max,
+            polynomial_arena.push_back(
+                *Polynomial<Position<Frame>, Instant>::template ReadFromMessage<
+                    EstrinEvaluator>(pair.polynomial()))));
       }
+      t_min = t_max;
     }
   }
   if (message.has_first_time()) {
@@ -504,6 +620,11 @@ absl::Status ContinuousTrajectory<Frame>::ReadFromCheckpointAt(
   return checkpointer_->ReadFromCheckpointAt(t, reader);
 }
 
+template<typename Frame>
+std::int64_t ContinuousTrajectory<Frame>::checkpoints_size_in_bytes() const {
+  return checkpointer_->checkpoints_size_in_bytes();
+}
+
 template<typename Frame>
 Checkpointer<serialization::ContinuousTrajectory>::Writer
 ContinuousTrajectory<Frame>::MakeCheckpointerWriter() {
@@ -553,30 +674,25 @@ ContinuousTrajectory<Frame>::MakeCheckpointerReader() {
       }
 
       // Restore the other members to their state at the time of the checkpoint.
+      // This removes polynomials, which is only correct because this function
+      // is not called while the trajectory is being evaluated.
       if (last_points_.empty()) {
         polynomials_.clear();
+        polynomial_arena_.clear();
         first_time_ = std::nullopt;
       } else {
-        // Locate the polynomial that ends at the first last_point_.  Note that
-        // we cannot use FindPolynomialForInstantLocked because it calls
-        // lower_bound and we don't want to change its behaviour.
+        // Remove the polynomials that end after the first last_point_.  If
+        // oldest_time is the t_max of some polynomial, that polynomial is kept.
         Instant const& oldest_time = last_points_.front().first;
-        // If oldest_time is the t_max of some polynomial, then the returned
-        // iterator points to the next polynomial.
-        auto const it =
-            std::upper_bound(polynomials_.begin(),
-                             polynomials_.end(),
-                             oldest_time,
-                             [](Instant const& left,
-                                InstantPolynomialPair const& right) {
-                               return left < right.t_max;
-                             });
-        polynomials_.erase(it, polynomials_.end());
-        if (polynomials_.empty()) {
+        while (!polynomials_.view().empty() &&
+               oldest_time < polynomials_.view().back().t_max) {
+          InstantPolynomialPair const pair = polynomials_.pop_back();
+          polynomial_arena_.pop_back(pair.polynomial.degree());
+        }
+        if (polynomials_.view().empty()) {
           first_time_ = oldest_time;
         }
       }
-      last_accessed_polynomial_ = 0;  // Always a valid value.
 
       return absl::OkStatus();
     };
@@ -585,57 +701,6 @@ ContinuousTrajectory<Frame>::MakeCheckpointerReader() {
   }
 }
 
-template<typename Frame>
-Instant ContinuousTrajectory<Frame>::t_min_locked() const {
-  if (polynomials_.empty()) {
-    return InfiniteFuture;
-  }
-  return *first_time_;
-}
-
-template<typename Frame>
-Instant ContinuousTrajectory<Frame>::t_max_locked() const {
-  if (polynomials_.empty()) {
-    return InfinitePast;
-  }
-  return polynomials_.crbegin()->t_max;
-}
-
-template<typename Frame>
-Position<Frame> ContinuousTrajectory<Frame>::EvaluatePositionLocked(
-    Instant const& time) const {
-  CHECK_LE(t_min_locked(), time);
-  CHECK_GE(t_max_locked(), time);
-  auto const it = FindPolynomialForInstantLocked(time);
-  CHECK(it != polynomials_.end());
-  auto const& polynomial = *it->polynomial;
-  return polynomial(time);
-}
-
-template<typename Frame>
-Velocity<Frame> ContinuousTrajectory<Frame>::EvaluateVelocityLocked(
-    Instant const& time) const {
-  CHECK_LE(t_min_locked(), time);
-  CHECK_GE(t_max_locked(), time);
-  auto const it = FindPolynomialForInstantLocked(time);
-  CHECK(it != polynomials_.end());
-  auto const& polynomial = *it->polynomial;
-  return polynomial.EvaluateDerivative(time);
-}
-
-template<typename Frame>
-DegreesOfFreedom<Frame>
-ContinuousTrajectory<Frame>::EvaluateDegreesOfFreedomLocked(
-    Instant const& time) const {
-  CHECK_LE(t_min_locked(), time);
-  CHECK_GE(t_max_locked(), time);
-  auto const it = FindPolynomialForInstantLocked(time);
-  CHECK(it != polynomials_.end());
-  auto const& polynomial = *it->polynomial;
-  return DegreesOfFreedom<Frame>(polynomial(time),
-                                 polynomial.EvaluateDerivative(time));
-}
-
 template<typename Frame>
 ContinuousTrajectory<Frame>::ContinuousTrajectory()
     : checkpointer_(
@@ -646,11 +711,12 @@ ContinuousTrajectory<Frame>::ContinuousTrajectory()
 
 template<typename Frame>
 ContinuousTrajectory<Frame>::InstantPolynomialPair::InstantPolynomialPair(
+    Instant const t_min,
     Instant const t_max,
-    not_null<std::unique_ptr<Polynomial<Position<Frame>, Instant>>>
-        polynomial)
-    : t_max(t_max),
-      polynomial(std::move(polynomial)) {}
+    typename Polynomials::Handle const polynomial)
+    : t_min(t_min),
+      t_max(t_max),
+      polynomial(polynomial) {}
 
 template<typename Frame>
 not_null<std::unique_ptr<Polynomial<Position<Frame>, Instant>>>
@@ -687,14 +753,15 @@ absl::Status ContinuousTrajectory<Frame>::ComputeBestNewhallApproximation(
     degree_age_ = 0;
   }
 
-  // Compute the approximation with the current degree.
+  // Compute the approximation with the current degree.  It is only published
+  // once the best degree has been found.
+  Instant const& t_min = last_points_.cbegin()->first;
   Displacement<Frame> displacement_error_estimate;
-  polynomials_.emplace_back(time,
-                            NewhallApproximationInMonomialBasis(
-                                degree_,
-                                q, v,
-                                last_points_.cbegin()->first, time,
-                                displacement_error_estimate));
+  not_null<std::unique_ptr<Polynomial<Position<Frame>, Instant>>> polynomial =
+      NewhallApproximationInMonomialBasis(degree_,
+                                          q, v,
+                                          t_min, time,
+                                          displacement_error_estimate);
 
   // Estimate the error.  For initializing |previous_error_estimate|, any value
   // greater than |error_estimate| will do.
@@ -726,11 +793,11 @@ absl::Status ContinuousTrajectory<Frame>::ComputeBestNewhallApproximation(
     ++degree_;
     VLOG(1) << "Increasing degree for " << this << " to " <<degree_
             << " because error estimate was " << error_estimate;
-    polynomials_.back().polynomial = NewhallApproximationInMonomialBasis(
-                                         degree_,
-                                         q, v,
-                                         last_points_.cbegin()->first, time,
-                                         displacement_error_estimate);
+    polynomial = NewhallApproximationInMonomialBasis(
+                     degree_,
+                     q, v,
+                     t_min, time,
+                     displacement_error_estimate);
     previous_error_estimate = error_estimate;
     error_estimate = displacement_error_estimate.Norm();
   }
@@ -754,6 +821,8 @@ absl::Status ContinuousTrajectory<Frame>::ComputeBestNewhallApproximation(
   }
 
   ++degree_age_;
+  polynomials_.push_back(InstantPolynomialPair(
+      t_min, time, polynomial_arena_.push_back(*polynomial)));
 
   // Check that the tolerance did not explode.
   if (adjusted_tolerance_ < 1e6 * previous_adjusted_tolerance) {
@@ -772,30 +841,227 @@ absl::Status ContinuousTrajectory<Frame>::ComputeBestNewhallApproximation(
 }
 
 template<typename Frame>
-typename ContinuousTrajectory<Frame>::InstantPolynomialPairs::const_iterator
-ContinuousTrajectory<Frame>::FindPolynomialForInstantLocked(
-    Instant const& time) const {
+template<typename MakePolynomial>
+std::vector<typename ContinuousTrajectory<Frame>::Zero>
+ContinuousTrajectory<Frame>::ComputeRelativeZeros(
+    ContinuousTrajectory const& other,
+    Instant const& t_min,
+    Instant const& t_max,
+    ThreadPool<void>* const pool,
+    MakePolynomial make_polynomial) const {
+  auto const polynomials1 = polynomials_.view();
+  auto const polynomials2 = other.polynomials_.view();
+
+  // The intervals where both trajectories are polynomials, and the result of
+  // their processing.
+  struct Piece {
+    Instant t_lower;
+    Instant t_upper;
+    typename Polynomials::Handle polynomial1;
+    typename Polynomials::Handle polynomial2;
+    std::vector<Zero> zeros;
+    // The values of the polynomial at |t_lower| and |t_upper|.
+    double lower_value = 0;
+    double upper_value = 0;
+  };
+  std::vector<Piece> pieces;
+  if (!polynomials1.empty() && !polynomials2.empty()) {
+    std::int64_t hint1 = polynomials1.begin();
+    std::int64_t hint2 = polynomials2.begin();
+    std::int64_t i1 = FindPolynomialForInstant(polynomials1, t_min, hint1);
+    std::int64_t i2 =
+        other.FindPolynomialForInstant(polynomials2, t_min, hint2);
+    while (i1 < polynomials1.end() && i2 < polynomials2.end()) {
+      auto const& pair1 = polynomials1[i1];
+      auto const& pair2 = polynomials2[i2];
+      Instant const t_lower = std::max({pair1.t_min, pair2.t_min, t_min});
+      Instant const t_upper = std::min({pair1.t_max, pair2.t_max, t_max});
+      if (t_lower < t_upper) {
+        pieces.push_back({.t_lower = t_lower,
+                          .t_upper = t_upper,
+                          .polynomial1 = pair1.polynomial,
+                          .polynomial2 = pair2.polynomial});
+      }
+      // Move past the polynomials that end first.
+      Instant const t = std::min(pair1.t_max, pair2.t_max);
+      if (t >= t_max) {
+        break;
+      }
+      if (pair1.t_max == t) {
+        ++i1;
+      }
+      if (pair2.t_max == t) {
+        ++i2;
+      }
+    }
+  }
+
+  auto const process = [&make_polynomial](Piece& piece) {
+    // The buffers are reused across calls on the same thread.
+    thread_local std::vector<R3Element<double>> Δq;
+    thread_local std::vector<R3Element<double>> q2;
+    thread_local std::vector<double> polynomial;
+    ShiftAndScale(piece.polynomial1, piece.t_lower, piece.t_upper, Δq);
+    ShiftAndScale(piece.polynomial2, piece.t_lower, piece.t_upper, q2);
+    if (q2.size() > Δq.size()) {
+      Δq.resize(q2.size());
+    }
+    for (std::size_t i = 0; i < q2.size(); ++i) {
+      Δq[i] -= q2[i];
+    }
+    make_polynomial(Δq, polynomial);
+
+    piece.lower_value = polynomial.front();
+    piece.upper_value = 0;
+    for (double const coefficient : polynomial) {
+      piece.upper_value += coefficient;
+    }
+    Time const Δt = piece.t_upper - piece.t_lower;
+    for (double const u : SolvePolynomialEquation(polynomial, 0, 1)) {
+      double derivative = 0;
+      for (int i = static_cast<int>(polynomial.size()) - 1; i >= 1; --i) {
+        derivative = derivative * u + i * polynomial[i];
+      }
+      piece.zeros.push_back({piece.t_lower + u * Δt, derivative > 0});
+    }
+  };
+
+  if (pool == nullptr) {
+    for (auto& piece : pieces) {
+      process(piece);
+    }
+  } else {
+    std::vector<std::future<void>> futures;
+    for (std::int64_t begin = 0;
+         begin < static_cast<std::int64_t>(pieces.size());
+         begin += pieces_per_task) {
+      std::int64_t const end =
+          std::min<std::int64_t>(begin + pieces_per_task, pieces.size());
+      futures.push_back(pool->Add([begin, end, &pieces, &process]() {
+        for (std::int64_t i = begin; i < end; ++i) {
+          process(pieces[i]);
+        }
+      }));
+    }
+    for (auto& future : futures) {
+      future.wait();
+    }
+  }
+
+  std::vector<Zero> zeros;
+  for (std::size_t i = 0; i < pieces.size(); ++i) {
+    auto const& piece = pieces[i];
+    // The polynomials are not exactly continuous, so the function may change
+    // sign at the boundary between two pieces without vanishing in either.
+    if (i > 0 && pieces[i - 1].t_upper == piece.t_lower) {
+      double const left_value = pieces[i - 1].upper_value;
+      double const right_value = piece.lower_value;
+      if ((left_value < 0 && right_value > 0) ||
+          (left_value > 0 && right_value < 0)) {
+        zeros.push_back({piece.t_lower, right_value > 0});
+      }
+    }
+    for (auto const& zero : piece.zeros) {
+      // A zero at the boundary between two pieces may be found by both.
+      if (zeros.empty() || zeros.back().time != zero.time) {
+        zeros.push_back(zero);
+      }
+    }
+  }
+  return zeros;
+}
+
+template<typename Frame>
+void ContinuousTrajectory<Frame>::ShiftAndScale(
+    typename Polynomials::Handle const& polynomial,
+    Instant const& t_lower,
+    Instant const& t_upper,
+    std::vector<R3Element<double>>& coefficients) {
+  int const degree = polynomial.degree();
+  // The buffer is reused across calls on the same thread.
+  thread_local std::vector<double> flat;
+  flat.resize(Polynomials::FlatSize(degree));
+  polynomial.WriteFlat(flat.data());
+
+  // The flat representation is the origin followed by the coefficients, see
+  // |PolynomialArena|.
+  Instant const origin = Instant() + flat[0] * Second;
+  coefficients.resize(degree + 1);
+  for (int i = 0; i <= degree; ++i) {
+    coefficients[i] = R3Element<double>(
+        flat[1 + 3 * i], flat[2 + 3 * i], flat[3 + 3 * i]);
+  }
+
+  // Taylor shift to |t_lower| by repeated synthetic division.
+  double const shift = (t_lower - origin) / Second;
+  for (int i = 0; i < degree; ++i) {
+    for (int j = degree - 1; j >= i; --j) {
+      coefficients[j] += shift * coefficients[j + 1];
+    }
+  }
+
+  double const scale = (t_upper - t_lower) / Second;
+  double scale_to_the_i = 1;
+  for (int i = 1; i <= degree; ++i) {
+    scale_to_the_i *= scale;
+    coefficients[i] *= scale_to_the_i;
+  }
+}
+
+template<typename Frame>
+std::int64_t ContinuousTrajectory<Frame>::FindPolynomialForInstant(
+    typename InstantPolynomialPairs::View const& polynomials,
+    Instant const& time,
+    std::int64_t& hint) const {
   // This returns the first polynomial |p| such that |time <= p.t_max|.
-  {
-    auto const begin = polynomials_.begin();
-    auto const it = begin + last_accessed_polynomial_;
-    if (it != polynomials_.end() && time <= it->t_max &&
-        (it == begin || std::prev(it)->t_max < time)) {
-      return it;
+  auto const is_applicable = [&polynomials, &time](std::int64_t const i) {
+    return i >= polynomials.begin() && i < polynomials.end() &&
+           time <= polynomials[i].t_max &&
+           (i == polynomials.begin() || polynomials[i - 1].t_max < time);
+  };
+  std::int64_t& last_accessed = last_accessed_polynomial();
+  if (is_applicable(hint)) {
+    last_accessed = hint;
+    return hint;
+  }
+  if (is_applicable(last_accessed)) {
+    hint = last_accessed;
+    return hint;
+  }
+  std::int64_t low = polynomials.begin();
+  std::int64_t high = polynomials.end();
+  while (low < high) {
+    std::int64_t const middle = low + (high - low) / 2;
+    if (polynomials[middle].t_max < time) {
+      low = middle + 1;
+    } else {
+      high = middle;
     }
   }
-  {
-    auto const it =
-        std::lower_bound(polynomials_.begin(),
-                         polynomials_.end(),
-                         time,
-                         [](InstantPolynomialPair const& left,
-                            Instant const& right) {
-                           return left.t_max < right;
-                         });
-    last_accessed_polynomial_ = it - polynomials_.begin();
-    return it;
+  hint = low;
+  last_accessed = low;
+  return low;
+}
+
+template<typename Frame>
+std::int64_t& ContinuousTrajectory<Frame>::last_accessed_polynomial() const {
+  // A small direct-mapped table, so that a thread that alternates between a
+  // few trajectories (e.g., the bodies of an |Ephemeris|) keeps one index for
+  // each of them.  A collision only costs a binary search.
+  struct Entry {
+    ContinuousTrajectory const* trajectory = nullptr;
+    std::int64_t polynomial = 0;
+  };
+  static constexpr int entries = 64;
+  thread_local std::array<Entry, entries> last_accessed_polynomials;
+  Entry& entry = last_accessed_polynomials[
+      reinterpret_cast<std::uintptr_t>(this) / sizeof(ContinuousTrajectory) %
+      entries];
+  if (entry.trajectory != this) {
+    entry.trajectory = this;
+    entry.polynomial = 0;
   }
+  return entry.polynomial;
 }
 
 }  // namespace internal_continuous_trajectory
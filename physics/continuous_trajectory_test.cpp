@@ -2,9 +2,11 @@
 #include "physics/continuous_trajectory.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <deque>
 #include <functional>
 #include <limits>
+#include <thread>
 #include <vector>
 
 #include "geometry/frame.hpp"
@@ -34,6 +36,7 @@ using geometry::Displacement;
 using geometry::Frame;
 using geometry::Handedness;
 using geometry::Inertial;
+using geometry::Vector;
 using geometry::Velocity;
 using numerics::Polynomial;
 using numerics::PolynomialInMonomialBasis;
@@ -56,8 +59,10 @@ using testing_utilities::AlmostEquals;
 using testing_utilities::EqualsProto;
 using testing_utilities::IsNear;
 using testing_utilities::operator""_;
+using ::testing::Lt;
 using ::testing::Sequence;
 using ::testing::SetArgReferee;
+using ::testing::SizeIs;
 using ::testing::_;
 
 template<typename Frame>
@@ -714,6 +719,139 @@ TEST_F(ContinuousTrajectoryTest, Prepend) {
   }
 }
 
+// Readers evaluate the trajectory without locking while it is being appended
+// to.  This is mostly useful with a thread sanitizer.
+TEST_F(ContinuousTrajectoryTest, ConcurrentEvaluation) {
+  int const number_of_steps = 10'000;
+  Time const step = 0.01 * Second;
+  Length const tolerance = 0.1 * Metre;
+  auto position_function =
+      [this](Instant const t) {
+        return World::origin +
+            Displacement<World>({(t - t0_) * 3 * Metre / Second,
+                                 (t - t0_) * 5 * Metre / Second,
+                                 (t - t0_) * (-2) * Metre / Second});
+      };
+  auto velocity_function =
+      [](Instant const t) {
+        return Velocity<World>({3 * Metre / Second,
+                                5 * Metre / Second,
+                                -2 * Metre / Second});
+      };
+  ContinuousTrajectory<World> trajectory(step, tolerance);
+  FillTrajectory(/*number_of_steps=*/9,
+                 step,
+                 position_function,
+                 velocity_function,
+                 t0_,
+                 trajectory);
+
+  std::atomic<bool> done = false;
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; ++i) {
+    readers.emplace_back([&done, &position_function, &trajectory]() {
+      while (!done) {
+        Instant const t_min = trajectory.t_min();
+        Instant const t_max = trajectory.t_max();
+        EXPECT_LE(t_min, t_max);
+        for (Instant const& time :
+             {t_min, t_min + (t_max - t_min) / 2, t_max}) {
+          EXPECT_THAT(trajectory.EvaluatePosition(time),
+                      AlmostEquals(position_function(time), 0, 10)) << time;
+        }
+      }
+    });
+  }
+  FillTrajectory(number_of_steps,
+                 step,
+                 position_function,
+                 velocity_function,
+                 t0_ + 9 * step,
+                 trajectory);
+  done = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+}
+
+// The trajectory is on an ellipse centred on the other one, so its apsides are
+// at the ends of the axes and its nodes with respect to the x-z plane at the
+// ends of the major axis.
+TEST_F(ContinuousTrajectoryTest, ApsidesAndNodes) {
+  int const number_of_steps = 2000;
+  Time const step = 0.01 * Second;
+  Length const tolerance = 1 * Milli(Metre);
+  Length const a = 2 * Kilo(Metre);
+  Length const b = 1 * Kilo(Metre);
+  Time const period = 10 * Second;
+  AngularFrequency const ω = 2 * π * Radian / period;
+
+  auto position_function = [this, a, b, ω](Instant const t) {
+    Angle const angle = ω * (t - t0_);
+    return World::origin +
+        Displacement<World>({a * Cos(angle), b * Sin(angle), 0 * Metre});
+  };
+  auto velocity_function = [this, a, b, ω](Instant const t) {
+    Angle const angle = ω * (t - t0_);
+    return Velocity<World>({-ω * a * Sin(angle) / Radian,
+                            ω * b * Cos(angle) / Radian,
+                            0 * Metre / Second});
+  };
+  auto origin_position_function = [](Instant const) {
+    return World::origin;
+  };
+  auto origin_velocity_function = [](Instant const) {
+    return World::unmoving;
+  };
+
+  ContinuousTrajectory<World> trajectory(step, tolerance);
+  ContinuousTrajectory<World> origin(step, tolerance);
+  FillTrajectory(number_of_steps,
+                 step,
+                 position_function,
+                 velocity_function,
+                 t0_,
+                 trajectory);
+  FillTrajectory(number_of_steps,
+                 step,
+                 origin_position_function,
+                 origin_velocity_function,
+                 t0_,
+                 origin);
+
+  // The periapsides are at the ends of the minor axis.
+  auto const apsides =
+      trajectory.ComputeApsides(origin, trajectory.t_min(), trajectory.t_max());
+  ASSERT_THAT(apsides, SizeIs(7));
+  for (int i = 0; i < apsides.size(); ++i) {
+    EXPECT_THAT(AbsoluteError(t0_ + (i + 1) * period / 4, apsides[i].time),
+                Lt(1 * Milli(Second)));
+    EXPECT_EQ(i % 2 == 0, apsides[i].increasing);
+  }
+
+  // The ascending node is at the beginning of each period.
+  auto const nodes = trajectory.ComputeNodes(origin,
+                                             Vector<double, World>({0, 1, 0}),
+                                             trajectory.t_min(),
+                                             trajectory.t_max());
+  ASSERT_THAT(nodes, SizeIs(3));
+  for (int i = 0; i < nodes.size(); ++i) {
+    EXPECT_THAT(AbsoluteError(t0_ + (i + 1) * period / 2, nodes[i].time),
+                Lt(1 * Milli(Second)));
+    EXPECT_EQ(i % 2 == 1, nodes[i].increasing);
+  }
+
+  // The parallel computation gives the same results.
+  ThreadPool<void> pool(/*pool_size=*/2);
+  auto const parallel_apsides = trajectory.ComputeApsides(
+      origin, trajectory.t_min(), trajectory.t_max(), &pool);
+  ASSERT_THAT(parallel_apsides, SizeIs(apsides.size()));
+  for (int i = 0; i < apsides.size(); ++i) {
+    EXPECT_EQ(apsides[i].time, parallel_apsides[i].time);
+    EXPECT_EQ(apsides[i].increasing, parallel_apsides[i].increasing);
+  }
+}
+
 TEST_F(ContinuousTrajectoryTest, Serialization) {
   int const number_of_steps = 20;
   int const number_of_substeps = 50;
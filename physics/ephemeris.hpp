@@ -1,17 +1,24 @@
 ﻿
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
 #include <functional>
 #include <limits>
 #include <map>
 #include <memory>
+#include <optional>
 #include <vector>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/synchronization/mutex.h"
+#include "base/macros.hpp"
 #include "base/recurring_thread.hpp"
 #include "base/not_null.hpp"
+#include "base/thread_pool.hpp"
 #include "geometry/grassmann.hpp"
 #include "geometry/named_quantities.hpp"
 #include "google/protobuf/repeated_field.h"
@@ -21,8 +28,12 @@
 #include "physics/continuous_trajectory.hpp"
 #include "physics/degrees_of_freedom.hpp"
 #include "physics/discrete_trajectory.hpp"
+#include "physics/ephemeris_cache.hpp"
+#include "physics/event_detector.hpp"
 #include "physics/geopotential.hpp"
+#include "physics/kepler_splitting.hpp"
 #include "physics/massive_body.hpp"
+#include "physics/massless_body_accelerations.hpp"
 #include "physics/oblate_body.hpp"
 #include "physics/protector.hpp"
 #include "serialization/ksp_plugin.pb.h"
@@ -31,10 +42,17 @@
 
 namespace principia {
 namespace physics {
+
+FORWARD_DECLARE_FROM(kustaanheimo_stiefel_flow,
+                     TEMPLATE(typename Frame) class,
+                     KustaanheimoStiefelFlow);
+
 namespace internal_ephemeris {
 
 using base::not_null;
 using base::RecurringThread;
+using base::ThreadPool;
+using geometry::Displacement;
 using geometry::InfinitePast;
 using geometry::Instant;
 using geometry::Position;
@@ -46,7 +64,9 @@ using integrators::IntegrationProblem;
 using integrators::Integrator;
 using integrators::SpecialSecondOrderDifferentialEquation;
 using quantities::Acceleration;
+using quantities::GravitationalParameter;
 using quantities::Length;
+using quantities::Quotient;
 using quantities::SpecificEnergy;
 using quantities::Speed;
 using quantities::Time;
@@ -81,6 +101,17 @@ class Ephemeris {
     void set_speed_integration_tolerance(
         Speed const& speed_integration_tolerance);
 
+    // If positive, the flows of the |NewtonianMotionEquation| use Encke's
+    // method: they integrate the deviation of the massless body from a
+    // reference conic around the body that exerts the largest acceleration on
+    // it.  Once per revolution of the reference conic, the conic is rectified
+    // to osculate the trajectory if the deviation exceeds this fraction of the
+    // distance to the primary.  The default of 0 integrates the full motion.
+    // Ignored by the flows of the |GeneralizedNewtonianMotionEquation|.
+    double encke_rectification_tolerance() const;
+    void set_encke_rectification_tolerance(
+        double encke_rectification_tolerance);
+
     void WriteToMessage(
         not_null<serialization::Ephemeris::AdaptiveStepParameters*> message)
         const;
@@ -93,6 +124,7 @@ class Ephemeris {
     std::int64_t max_steps_;
     Length length_integration_tolerance_;
     Speed speed_integration_tolerance_;
+    double encke_rectification_tolerance_ = 0;
     friend class Ephemeris<Frame>;
   };
 
@@ -114,12 +146,37 @@ class Ephemeris {
       SpecialSecondOrderDifferentialEquation<Position<Frame>>;
   using GeneralizedNewtonianMotionEquation =
       ExplicitSecondOrderOrdinaryDifferentialEquation<Position<Frame>>;
+  // The equation describing the motion of the |bodies_| split into Keplerian
+  // drifts and interaction kicks, see |KeplerSplitting|.
+  using KeplerSplittingEquation =
+      typename KeplerSplitting<Frame>::DecomposableEquation;
 
   using AdaptiveStepParameters =
       ODEAdaptiveStepParameters<NewtonianMotionEquation>;
   using GeneralizedAdaptiveStepParameters =
       ODEAdaptiveStepParameters<GeneralizedNewtonianMotionEquation>;
 
+  // The parameters of |FlowWithAdaptiveStepParareal|.
+  struct PararealParameters {
+    // The number of time slices, which are integrated concurrently.
+    int slices;
+    // The parameters of the coarse propagator, which predicts the states at
+    // the beginning of the slices.  Its tolerances should be much larger than
+    // those of the fine propagator, so that it is cheap compared to the
+    // integration of a slice.
+    AdaptiveStepParameters coarse_parameters;
+    // The algorithm always converges after |slices| iterations.
+    int max_iterations;
+  };
+
+  // The largest discontinuities of a trajectory computed by
+  // |FlowWithAdaptiveStepParareal| at the boundaries of its slices.
+  struct PararealDefect {
+    Length position;
+    Speed velocity;
+    int iterations = 0;
+  };
+
   class AccuracyParameters final {
    public:
     AccuracyParameters(Length const& fitting_tolerance,
@@ -141,6 +198,15 @@ class Ephemeris {
     FixedStepParameters(
         FixedStepSizeIntegrator<NewtonianMotionEquation> const& integrator,
         Time const& step);
+    // When these parameters are those of an |Ephemeris|, its massive bodies
+    // are integrated by the |kepler_splitting_integrator|, using a
+    // |KeplerSplitting| whose hierarchy is built from their initial state.
+    // The massless bodies are always integrated by the |integrator|.
+    FixedStepParameters(
+        FixedStepSizeIntegrator<NewtonianMotionEquation> const& integrator,
+        FixedStepSizeIntegrator<KeplerSplittingEquation> const&
+            kepler_splitting_integrator,
+        Time const& step);
 
     Time const& step() const;
 
@@ -153,6 +219,9 @@ class Ephemeris {
     // This will refer to a static object returned by a factory.
     not_null<FixedStepSizeIntegrator<NewtonianMotionEquation> const*>
         integrator_;
+    // Null if the massive bodies are integrated by the |integrator_|.
+    FixedStepSizeIntegrator<KeplerSplittingEquation> const*
+        kepler_splitting_integrator_ = nullptr;
     Time step_;
     friend class Ephemeris<Frame>;
   };
@@ -174,6 +243,15 @@ class Ephemeris {
   virtual not_null<ContinuousTrajectory<Frame> const*> trajectory(
       not_null<MassiveBody const*> body) const;
 
+  // Returns the positions (resp. degrees of freedom) of all the |bodies()| at
+  // time |t|, in the order of |bodies()|.  |t| must be in
+  // [t_min(), t_max()].  This is cheaper than evaluating the |trajectory()| of
+  // each body, as the polynomial lookup is shared between the trajectories.
+  virtual std::vector<Position<Frame>> EvaluateAllPositions(
+      Instant const& t) const;
+  virtual std::vector<DegreesOfFreedom<Frame>> EvaluateAllDegreesOfFreedom(
+      Instant const& t) const;
+
   // Returns true if at least one of the trajectories is empty.
   virtual bool empty() const;
 
@@ -187,10 +265,66 @@ class Ephemeris {
 
   virtual absl::Status last_severe_integration_status() const;
 
+  // The number of bytes used by the compressed checkpoints of the ephemeris and
+  // of its trajectories.
+  std::int64_t checkpoints_size_in_bytes() const;
+
+  // Requests that the accelerations between the massive bodies be computed on
+  // |number_of_threads| threads (including the thread that integrates the
+  // ephemeris).  If |identical_to_serial| is true, each thread computes the
+  // accelerations on a subset of the bodies, summing the contributions in the
+  // same order as the serial computation: the result is bitwise identical to
+  // it, but each pair of bodies is evaluated twice.  Otherwise, the pairs of
+  // bodies are split into balanced tiles, each with its own accumulators, and
+  // the accumulators are reduced in a fixed order: the result is independent of
+  // |number_of_threads| and of the scheduling, but may differ from the serial
+  // computation in the last bits.  The polynomials of the trajectories of the
+  // massive bodies are also fitted on these threads, which doesn't affect the
+  // result.  A |number_of_threads| of 1 restores the serial computation.  Must
+  // not be called while the ephemeris is being prolonged or reanimated.
+  void SetMassiveBodiesParallelism(int number_of_threads,
+                                   bool identical_to_serial);
+
+  // The number of times that the positions of the massive bodies were found
+  // (resp. not found) in the cache shared by the fixed-step flows of massless
+  // bodies.  Only useful for benchmarking or analyzing performance.
+  std::int64_t massive_bodies_positions_cache_hits() const;
+  std::int64_t massive_bodies_positions_cache_misses() const;
+
+  // The number of ranges of massless bodies whose accelerations were computed
+  // by a batched instance on a thread other than the one running the instance
+  // (see |NewBatchedInstance|).  Only useful for testing or benchmarking.
+  std::int64_t massless_bodies_ranges_computed_concurrently() const;
+
+  // Requests that the flows with an adaptive step approximate the effect of the
+  // perturbers that are far from the massless body.  For each trajectory, the
+  // body that exerts the largest acceleration (which approximates the smallest
+  // sphere of influence containing the massless body) is the primary, and the
+  // perturbers whose tidal effect is negligible are replaced by the
+  // acceleration that they exert on the primary, frozen over a time window.
+  // The perturbers are selected again when a bound on the error of this
+  // approximation, relative to the acceleration by the primary, exceeds
+  // |relative_tolerance|, which should be well below the tolerances of the
+  // integration.  The bound is rigorous for spherical perturbers, but only
+  // first-order for their harmonics and for the time window.  A
+  // |relative_tolerance| of 0 restores the exact computation.  Must not be
+  // called while the ephemeris is being flowed.
+  void SetPerturberCulling(double relative_tolerance);
+
+  // The largest bound on the relative error introduced by the culling of the
+  // perturbers in the flows completed so far.
+  double perturber_culling_error_bound() const EXCLUDES(lock_);
+
   // Prolongs the ephemeris up to at least |t|.  Returns an error iff the thread
   // is stopped.  After a successful call, |t_max() >= t|.
   virtual absl::Status Prolong(Instant const& t) EXCLUDES(lock_);
 
+  // Starts a thread that asynchronously prolongs the ephemeris so that, after a
+  // call to |Prolong(t)|, |t_max()| eventually reaches |t + horizon|.
+  // Subsequent calls to |Prolong| return immediately unless the look-ahead has
+  // been overrun.  Must not be called concurrently with |Prolong|.
+  void StartLookAheadProlongation(Time const& horizon);
+
   // Asks the reanimator thread to asynchronously reconstruct the past so that
   // the |t_min()| of the ephemeris ultimately ends up at or before
   // |desired_t_min|.
@@ -200,6 +334,28 @@ class Ephemeris {
   // |desired_t_min|.
   void WaitForReanimation(Instant const& desired_t_min);
 
+  // Requests that the segments between checkpoints be reanimated concurrently
+  // on |number_of_threads| threads (in addition to the reanimator thread, which
+  // stitches them in order).  The segments are independent, so the result
+  // doesn't depend on |number_of_threads|.  A |number_of_threads| of 1 restores
+  // the serial reanimation.  Must be called before |RequestReanimation|.
+  void SetReanimationParallelism(int number_of_threads);
+
+  // The fraction of the segments of the current reanimation that have been
+  // stitched to the trajectories, in [0, 1].  Returns 1 if no reanimation was
+  // ever started.
+  double reanimation_progress() const EXCLUDES(lock_);
+
+  // Uses the file at |path| as a persistent cache for reanimation: the segments
+  // between checkpoints that are found in the cache are read from it instead of
+  // being integrated and fitted, and the segments that are integrated are
+  // added to it.  The cache is specific to the bodies and to the accuracy and
+  // fixed-step parameters of this ephemeris; a file written for other ones is
+  // overwritten.  Must be called before |RequestReanimation|.
+  template<typename F = Frame,
+           typename = std::enable_if_t<base::is_serializable_v<F>>>
+  void SetReanimationCache(std::filesystem::path const& path);
+
   // Creates an instance suitable for integrating the given |trajectories| with
   // their |intrinsic_accelerations| using a fixed-step integrator parameterized
   // by |parameters|.
@@ -218,6 +374,32 @@ class Ephemeris {
       IntrinsicAccelerations const& intrinsic_accelerations,
       FixedStepParameters const& parameters);
 
+  // Same as above, but the states of |trajectories[i]| are given to
+  // |event_detectors[i]| as they are computed, starting with the last state of
+  // the trajectory.  |event_detectors| must be empty or have the same size as
+  // |trajectories|, and its elements may be null.
+  virtual absl::StatusOr<not_null<
+      std::unique_ptr<typename Integrator<NewtonianMotionEquation>::Instance>>>
+  StoppableNewInstance(
+      std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
+      IntrinsicAccelerations const& intrinsic_accelerations,
+      std::vector<EventDetector<Frame>*> const& event_detectors,
+      FixedStepParameters const& parameters);
+
+  // Same as |NewInstance| without intrinsic accelerations, but suitable for a
+  // large number of |trajectories|: the accelerations are computed by ranges
+  // of massless bodies on the threads of the ephemeris (see
+  // |SetMassiveBodiesParallelism|).  A collision with a celestial doesn't
+  // cause the integration to fail; instead, |(*collided)[i]| is set to true if
+  // the massless body following |trajectories[i]| collided.  |collided| must
+  // outlive the instance.
+  virtual not_null<
+      std::unique_ptr<typename Integrator<NewtonianMotionEquation>::Instance>>
+  NewBatchedInstance(
+      std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
+      FixedStepParameters const& parameters,
+      not_null<std::vector<bool>*> collided);
+
   // Integrates, until exactly |t| (except for timeouts or singularities), the
   // |trajectory| followed by a massless body in the gravitational potential
   // described by |*this|.  If |t > t_max()|, calls |Prolong(t)| beforehand.
@@ -238,6 +420,54 @@ class Ephemeris {
       GeneralizedAdaptiveStepParameters const& parameters,
       std::int64_t max_ephemeris_steps) EXCLUDES(lock_);
 
+  // Same as the above two, but the states of the |trajectory| are given to the
+  // |event_detector|, if it is not null, as they are computed, starting with
+  // the last state of the |trajectory|.  The events are thus found during the
+  // integration, without walking the trajectory again.
+  virtual absl::Status FlowWithAdaptiveStep(
+      not_null<DiscreteTrajectory<Frame>*> trajectory,
+      IntrinsicAcceleration intrinsic_acceleration,
+      Instant const& t,
+      AdaptiveStepParameters const& parameters,
+      std::int64_t max_ephemeris_steps,
+      EventDetector<Frame>* event_detector) EXCLUDES(lock_);
+  virtual absl::Status FlowWithAdaptiveStep(
+      not_null<DiscreteTrajectory<Frame>*> trajectory,
+      GeneralizedIntrinsicAcceleration intrinsic_acceleration,
+      Instant const& t,
+      GeneralizedAdaptiveStepParameters const& parameters,
+      std::int64_t max_ephemeris_steps,
+      EventDetector<Frame>* event_detector) EXCLUDES(lock_);
+
+  // Same as the first one, without intrinsic acceleration, for each of the
+  // |trajectories|.  If the integrator of the |parameters| is an embedded
+  // explicit Runge-Kutta-Nyström integrator, the trajectories are integrated
+  // in lockstep, each with its own step size control, and the accelerations of
+  // the massless bodies that are at the same time are computed together.  This
+  // amortizes the evaluation of the massive bodies over the |trajectories|.
+  // Returns a status for each of the |trajectories|.
+  virtual std::vector<absl::Status> FlowWithAdaptiveStep(
+      std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
+      Instant const& t,
+      AdaptiveStepParameters const& parameters,
+      std::int64_t max_ephemeris_steps) EXCLUDES(lock_);
+
+  // Same as the first |FlowWithAdaptiveStep|, without intrinsic acceleration,
+  // but parallel in time using the parareal algorithm: the interval is split in
+  // slices whose initial states are predicted by a coarse propagator, and the
+  // slices are integrated concurrently on the |pool|, if any, with the given
+  // |parameters|.  The predictions are then corrected and the slices that
+  // changed are integrated again, until the discontinuities at the boundaries
+  // of the slices are within the tolerances of the |parameters| or the maximal
+  // number of iterations is reached.  Returns the remaining discontinuities.
+  virtual absl::StatusOr<PararealDefect> FlowWithAdaptiveStepParareal(
+      not_null<DiscreteTrajectory<Frame>*> trajectory,
+      Instant const& t,
+      AdaptiveStepParameters const& parameters,
+      PararealParameters const& parareal_parameters,
+      std::int64_t max_ephemeris_steps,
+      ThreadPool<void>* pool) EXCLUDES(lock_);
+
   // Integrates, until at most |t|, the trajectories followed by massless
   // bodies in the gravitational potential described by |*this|.  If
   // |t > t_max()|, calls |Prolong(t)| beforehand.  The trajectories and
@@ -318,42 +548,129 @@ class Ephemeris {
   Checkpointer<serialization::Ephemeris>::Writer MakeCheckpointerWriter();
   Checkpointer<serialization::Ephemeris>::Reader MakeCheckpointerReader();
 
+  // Called on a stoppable thread to prolong the ephemeris up to at least |t|.
+  // Contrary to |Prolong|, |lock_| is released after each step, so that the
+  // flows, which need to evaluate the trajectories of the bodies, are not
+  // blocked for the entire prolongation.
+  absl::Status ProlongAhead(Instant const& t) EXCLUDES(lock_);
+
   // Called on a stoppable thread to reconstruct the past state of the ephemeris
   // and its trajectories starting in such a way that |t_min()| is at or before
   // |desired_t_min|.  The member variable |oldest_reanimated_checkpoint_| tells
   // the reanimator where to stop.
   absl::Status Reanimate(Instant const desired_t_min) EXCLUDES(lock_);
 
+  // The trajectories of the massive bodies between two checkpoints, which have
+  // been reanimated but not yet stitched to those of this ephemeris.
+  struct ReanimatedSegment {
+    Instant t_initial;
+    std::vector<not_null<std::unique_ptr<ContinuousTrajectory<Frame>>>>
+        trajectories;
+    // Set if the |trajectories| must be added to the |reanimation_cache_|.
+    std::optional<std::uint64_t> cache_fingerprint;
+  };
+
   // Reconstructs the past state of the ephemeris between |t_initial| and
-  // |t_final| using the given checkpoint |message|.
-  absl::Status ReanimateOneCheckpoint(
+  // |t_final| using the given checkpoint |message|.  May be called
+  // concurrently for different segments.
+  absl::StatusOr<ReanimatedSegment> ReanimateSegment(
       serialization::Ephemeris::Checkpoint const& message,
       Instant const& t_initial,
       Instant const& t_final) EXCLUDES(lock_);
 
+  // Prepends the trajectories of the |segment| to those of this ephemeris and
+  // records that we will not reanimate it again.  Must be called on the
+  // |reanimator_| thread, for segments going backwards in time.
+  void StitchReanimatedSegment(ReanimatedSegment segment) EXCLUDES(lock_);
+
+  // Identifies the segment between |t_initial| and |t_final| in the
+  // |reanimation_cache_|, based on the checkpoints of the ephemeris (given by
+  // |message|) and of its trajectories at |t_initial|.
+  std::uint64_t ReanimationCacheFingerprint(
+      serialization::Ephemeris::Checkpoint const& message,
+      Instant const& t_initial,
+      Instant const& t_final) const;
+
   // Callbacks for the integrators.
   void AppendMassiveBodiesState(
       typename NewtonianMotionEquation::SystemState const& state)
       REQUIRES(lock_);
+  // The fitting of the trajectories is distributed over the threads of the
+  // |massive_bodies_pool_|, if any.  The statuses are in the order of the
+  // |trajectories|.
   template<typename ContinuousTrajectoryPtr>
-  static std::vector<absl::Status> AppendMassiveBodiesStateToTrajectories(
+  std::vector<absl::Status> AppendMassiveBodiesStateToTrajectories(
       typename NewtonianMotionEquation::SystemState const& state,
-      std::vector<not_null<ContinuousTrajectoryPtr>> const& trajectories);
+      std::vector<not_null<ContinuousTrajectoryPtr>> const& trajectories)
+      const;
   static void AppendMasslessBodiesStateToTrajectories(
       typename NewtonianMotionEquation::SystemState const& state,
       std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories);
+  // Gives the state of the i-th massless body to |event_detectors[i]|, if any.
+  static void AppendMasslessBodiesStateToEventDetectors(
+      typename NewtonianMotionEquation::SystemState const& state,
+      std::vector<EventDetector<Frame>*> const& event_detectors);
 
   // Returns an equation suitable for the massive bodies contained in this
   // ephemeris.
   NewtonianMotionEquation MakeMassiveBodiesNewtonianMotionEquation();
 
+  // Returns a splitting of the motion of the massive bodies whose hierarchy is
+  // built from |kepler_splitting_positions_|.  The splitting is not
+  // thread-safe, so each instance must have its own.
+  not_null<std::unique_ptr<KeplerSplitting<Frame>>> MakeKeplerSplitting();
+
+  // Returns an instance of the |kepler_splitting_integrator_| of the
+  // |fixed_step_parameters_| for the given |splitting|, which must outlive it.
+  // The states are passed to |append_state| as those of the
+  // |NewtonianMotionEquation|.
+  not_null<std::unique_ptr<
+      typename Integrator<KeplerSplittingEquation>::Instance>>
+  NewKeplerSplittingInstance(
+      KeplerSplitting<Frame>& splitting,
+      typename KeplerSplittingEquation::SystemState const& initial_state,
+      typename Integrator<NewtonianMotionEquation>::AppendState const&
+          append_state) const;
+
+  // Solves whichever of |instance_| and |kepler_splitting_instance_| is not
+  // null up to |t_final|.
+  absl::Status SolveInstance(Instant const& t_final) REQUIRES(lock_);
+
   // Note the return by copy: the returned value is usable even if the
   // |instance_| is being integrated.
   Instant instance_time() const EXCLUDES(lock_);
+  Instant instance_time_locked() const REQUIRES_SHARED(lock_);
 
   virtual Instant t_min_locked() const REQUIRES_SHARED(lock_);
   virtual Instant t_max_locked() const REQUIRES_SHARED(lock_);
 
+  // Evaluates the positions of the bodies, in the order of |bodies_|, at time
+  // |t|.  If |use_positions_cache| is true, the positions are looked up in
+  // |massive_bodies_positions_cache_|, and added to it if they are not found:
+  // the fixed-step flows of many massless bodies, e.g., the histories on the
+  // threads of the plugin, evaluate the massive bodies at the same times.  A
+  // lookup that hits the cache doesn't lock and doesn't write to the cache.
+  // The adaptive-step flows almost never evaluate the massive bodies twice at
+  // the same time, so they must not use the cache: they would serialize on
+  // |massive_bodies_positions_cache_lock_|.
+  void EvaluateMassiveBodiesPositions(
+      Instant const& t,
+      bool use_positions_cache,
+      std::vector<Position<Frame>>& positions) const
+      EXCLUDES(massive_bodies_positions_cache_lock_);
+
+  // Evaluates at time |t| the positions (resp. degrees of freedom) of the
+  // bodies whose |trajectories| are given, sharing the polynomial lookup.  The
+  // output vectors are resized as needed.
+  void EvaluatePositions(
+      Instant const& t,
+      std::vector<not_null<ContinuousTrajectory<Frame>*>> const& trajectories,
+      std::vector<Position<Frame>>& positions) const;
+  void EvaluateDegreesOfFreedom(
+      Instant const& t,
+      std::vector<not_null<ContinuousTrajectory<Frame>*>> const& trajectories,
+      std::vector<DegreesOfFreedom<Frame>>& degrees_of_freedom) const;
+
   // Computes the accelerations between one body, |body1| (with index |b1| in
   // the |positions| and |accelerations| arrays) and the bodies |bodies2| (with
   // indices [b2_begin, b2_end[ in the |bodies2|, |positions| and
@@ -376,32 +693,94 @@ class Ephemeris {
       std::vector<Geopotential<Frame>> const& geopotentials);
 
   // Computes the accelerations due to one body, |body1| (with index |b1| in the
-  // |bodies_| and |trajectories_| arrays) on massless bodies at the given
-  // |positions|.  The template parameter specifies what we know about the
-  // massive body, and therefore what forces apply.  Returns an integer for
-  // efficiency.
+  // |bodies_| and |trajectories_| arrays and located at |position1|) on
+  // massless bodies at the given |positions|.  The template parameter specifies
+  // what we know about the massive body, and therefore what forces apply.
+  // Returns an integer for efficiency.
   template<bool body1_is_oblate>
   std::underlying_type_t<absl::StatusCode>
   ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies(
       Instant const& t,
       MassiveBody const& body1,
       std::size_t b1,
+      Position<Frame> const& position1,
       std::vector<Position<Frame>> const& positions,
-      std::vector<Vector<Acceleration, Frame>>& accelerations) const
-      REQUIRES_SHARED(lock_);
+      std::vector<Vector<Acceleration, Frame>>& accelerations) const;
+
+  // Same as above, but the accelerations are accumulated in a structure of
+  // arrays, which makes it possible to vectorize the computation of the
+  // central force across massless bodies.  The |positions| must be the ones
+  // that were gathered into |accelerations|.
+  template<bool body1_is_oblate>
+  std::underlying_type_t<absl::StatusCode>
+  ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies(
+      Instant const& t,
+      MassiveBody const& body1,
+      std::size_t b1,
+      Position<Frame> const& position1,
+      std::vector<Position<Frame>> const& positions,
+      MasslessBodiesAccelerations<Frame>& accelerations) const;
+
+  // Sets |spherical_harmonics_effects[b2]| to the effect of the spherical
+  // harmonics of the oblate body |b1| located at |position1| on a massless body
+  // at |positions[b2]|, which must be multiplied by the gravitational parameter
+  // of |b1| to obtain an acceleration.  The orientation of |b1| is only
+  // computed once for all the |positions|.  |displacements| is a buffer.
+  void ComputeSphericalHarmonicsEffects(
+      Instant const& t,
+      std::size_t b1,
+      Position<Frame> const& position1,
+      std::vector<Position<Frame>> const& positions,
+      std::vector<Displacement<Frame>>& displacements,
+      std::vector<Vector<Quotient<Acceleration, GravitationalParameter>,
+                         Frame>>& spherical_harmonics_effects) const;
 
   // Computes the potential resulting from one body, |body1| (with index |b1| in
-  // the |bodies_| and |trajectories_| arrays) at the given |positions|.  The
-  // template parameter specifies what we know about the massive body, and
-  // therefore what potential applies.
+  // the |bodies_| and |trajectories_| arrays and located at |position1|) at the
+  // given |positions|.  The template parameter specifies what we know about the
+  // massive body, and therefore what potential applies.
   template<bool body1_is_oblate>
   void ComputeGravitationalPotentialsOfMassiveBody(
       Instant const& t,
       MassiveBody const& body1,
       std::size_t b1,
+      Position<Frame> const& position1,
       std::vector<Position<Frame>> const& positions,
-      std::vector<SpecificEnergy>& potentials) const
-      REQUIRES_SHARED(lock_);
+      std::vector<SpecificEnergy>& potentials) const;
+
+  // A part of a row of the triangle of pairs of massive bodies: the pairs
+  // (b1, b2) for b2 in [b2_begin, b2_end[.
+  struct MassiveBodiesSegment {
+    std::size_t b1;
+    std::size_t b2_begin;
+    std::size_t b2_end;
+  };
+  // A set of contiguous segments forming one unit of parallel work.
+  using MassiveBodiesTile = std::vector<MassiveBodiesSegment>;
+
+  // Computes the accelerations between the pairs of bodies of the |segment|,
+  // accumulating them in |accelerations|.
+  void ComputeGravitationalAccelerationBetweenMassiveBodiesInSegment(
+      Instant const& t,
+      MassiveBodiesSegment const& segment,
+      std::vector<Position<Frame>> const& positions,
+      std::vector<Vector<Acceleration, Frame>>& accelerations) const;
+
+  // Computes the acceleration exerted by all the other massive bodies on the
+  // body with index |b| in |bodies_|, summing the contributions in the same
+  // order as |ComputeGravitationalAccelerationBetweenAllMassiveBodies| does
+  // serially.
+  Vector<Acceleration, Frame>
+  ComputeGravitationalAccelerationOnMassiveBodyInSerialOrder(
+      Instant const& t,
+      std::size_t b,
+      std::vector<Position<Frame>> const& positions) const;
+
+  // Runs |task(i)| for all i in [0, size[ on the |massive_bodies_pool_| and on
+  // the calling thread.  The assignment of indices to threads is dynamic.
+  void RunOnMassiveBodiesThreads(
+      int size,
+      std::function<void(int)> const& task) const;
 
   // Computes the accelerations between all the massive bodies in |bodies_|.
   absl::Status ComputeGravitationalAccelerationBetweenAllMassiveBodies(
@@ -412,13 +791,116 @@ class Ephemeris {
   // Computes the acceleration exerted by the massive bodies in |bodies_| on
   // massless bodies.  The massless bodies are at the given |positions|.
   // Returns an error iff a collision occurred, i.e., the massless body is
-  // inside one of the |bodies_|.
+  // inside one of the |bodies_|.  |use_positions_cache| is passed to
+  // |EvaluateMassiveBodiesPositions|.
   absl::StatusCode
   ComputeGravitationalAccelerationByAllMassiveBodiesOnMasslessBodies(
       Instant const& t,
       std::vector<Position<Frame>> const& positions,
-      std::vector<Vector<Acceleration, Frame>>& accelerations) const
-      EXCLUDES(lock_);
+      std::vector<Vector<Acceleration, Frame>>& accelerations,
+      bool use_positions_cache) const EXCLUDES(lock_);
+
+  // Same as above, but the massive bodies are at the given
+  // |massive_positions|.
+  absl::StatusCode
+  ComputeGravitationalAccelerationByAllMassiveBodiesOnMasslessBodies(
+      Instant const& t,
+      std::vector<Position<Frame>> const& massive_positions,
+      std::vector<Position<Frame>> const& positions,
+      std::vector<Vector<Acceleration, Frame>>& accelerations) const;
+
+  // The state of the culling of the perturbers for a massless body, see
+  // |SetPerturberCulling|.  It is carried from one computation of the
+  // accelerations to the next during a flow.
+  struct CulledPerturber {
+    // Increased to account for the harmonics of the perturber.
+    GravitationalParameter effective_gravitational_parameter;
+    // The distance and relative speed between the perturber and the primary at
+    // the time of the selection.
+    Length distance;
+    Speed relative_speed;
+  };
+  struct PerturberCulling {
+    std::size_t primary;
+    GravitationalParameter primary_gravitational_parameter;
+    // The bodies whose acceleration is computed exactly, including the primary,
+    // in the order of |bodies_|.  Empty before the first selection.
+    std::vector<std::size_t> exact_bodies;
+    std::vector<CulledPerturber> culled_perturbers;
+    Instant t_selection;
+    // The acceleration of the primary by the culled perturbers at
+    // |t_selection|.
+    Vector<Acceleration, Frame> culled_acceleration;
+    double max_relative_error_bound = 0;
+  };
+
+  // Same as above, but the perturbers are culled for each massless body.  The
+  // |cullings| are indexed like the |positions|, or empty, in which case no
+  // culling takes place.
+  absl::StatusCode
+  ComputeGravitationalAccelerationByAllMassiveBodiesOnMasslessBodies(
+      Instant const& t,
+      std::vector<Position<Frame>> const& positions,
+      std::vector<Vector<Acceleration, Frame>>& accelerations,
+      std::vector<PerturberCulling>& cullings) const EXCLUDES(lock_);
+
+  // Same as above, but the massive bodies are at the given
+  // |massive_positions|.
+  absl::StatusCode
+  ComputeGravitationalAccelerationByAllMassiveBodiesOnMasslessBodies(
+      Instant const& t,
+      std::vector<Position<Frame>> const& massive_positions,
+      std::vector<Position<Frame>> const& positions,
+      std::vector<Vector<Acceleration, Frame>>& accelerations,
+      std::vector<PerturberCulling>& cullings) const;
+
+  // Computes the accelerations of the massless bodies at |positions| when the
+  // massive bodies are at |massive_positions|.
+  using MasslessBodiesAccelerationComputation =
+      std::function<absl::Status(
+          Instant const& t,
+          std::vector<Position<Frame>> const& massive_positions,
+          std::vector<Position<Frame>> const& positions,
+          std::vector<Vector<Acceleration, Frame>>& accelerations)>;
+
+  // Same as above, but the massless bodies are split in ranges whose
+  // accelerations are computed on the |massive_bodies_pool_|, if any.  Sets
+  // |collided[i]| if the massless body at |positions[i]| is inside one of the
+  // |bodies_|.
+  void ComputeGravitationalAccelerationByAllMassiveBodiesOnMasslessBodies(
+      Instant const& t,
+      std::vector<Position<Frame>> const& positions,
+      std::vector<Vector<Acceleration, Frame>>& accelerations,
+      std::vector<bool>& collided,
+      bool use_positions_cache) const EXCLUDES(lock_);
+
+  // Returns the index of the body that exerts the largest acceleration on a
+  // massless body at |position|, ignoring the harmonics.  Sets
+  // |dominant_acceleration| to the magnitude of that acceleration.
+  std::size_t DominantBody(
+      Position<Frame> const& position,
+      std::vector<Position<Frame>> const& massive_positions,
+      Acceleration& dominant_acceleration) const;
+
+  // Selects the primary and the perturbers to cull for a massless body at
+  // |position|.
+  void SelectPerturbers(Instant const& t,
+                        Position<Frame> const& position,
+                        std::vector<Position<Frame>> const& massive_positions,
+                        PerturberCulling& culling) const;
+
+  // A bound on the error made at |t| on the acceleration of a massless body at
+  // |position| by approximating the culled perturbers, relative to the
+  // acceleration by the primary.  Infinite if the approximation is not valid.
+  double PerturberCullingRelativeErrorBound(
+      Instant const& t,
+      Position<Frame> const& position,
+      Position<Frame> const& primary_position,
+      PerturberCulling const& culling) const;
+
+  // Records the error bounds of the |cullings| at the end of a flow.
+  void RecordPerturberCullingErrorBounds(
+      std::vector<PerturberCulling> const& cullings) EXCLUDES(lock_);
 
   // Computes the potential resulting from the massive bodies in |bodies_|.  The
   // potentials are computed at the given |positions|.
@@ -428,13 +910,72 @@ class Ephemeris {
       std::vector<SpecificEnergy>& potentials) const
       EXCLUDES(lock_);
 
-  // Flows the given ODE with an adaptive step integrator.
+  // Creates an instance integrating the |trajectories| with a fixed-step
+  // integrator for the given |compute_acceleration|.  See
+  // |StoppableNewInstance| for the |event_detectors|.
+  absl::StatusOr<not_null<
+      std::unique_ptr<typename Integrator<NewtonianMotionEquation>::Instance>>>
+  NewInstanceForEquation(
+      std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
+      typename NewtonianMotionEquation::RightHandSideComputation
+          compute_acceleration,
+      std::vector<EventDetector<Frame>*> const& event_detectors,
+      FixedStepParameters const& parameters);
+
+  // Flows the given ODE with an adaptive step integrator.  The
+  // |event_detector| may be null.  The |compute_massless_accelerations| are
+  // used by Encke's method, they may be null for other ODEs.
   template<typename ODE>
   absl::Status FlowODEWithAdaptiveStep(
       typename ODE::RightHandSideComputation compute_acceleration,
+      MasslessBodiesAccelerationComputation compute_massless_accelerations,
       not_null<DiscreteTrajectory<Frame>*> trajectory,
       Instant const& t,
       ODEAdaptiveStepParameters<ODE> const& parameters,
+      std::int64_t max_ephemeris_steps,
+      EventDetector<Frame>* event_detector) EXCLUDES(lock_);
+
+  // Solves the |problem| of a single massless body with the adaptive step
+  // |integrator|.  For the Newtonian motion equation and an embedded explicit
+  // Runge-Kutta-Nyström integrator, this uses the fast path for a single
+  // degree of freedom, otherwise it solves an instance.
+  template<typename ODE>
+  static absl::Status SolveMasslessBody(
+      AdaptiveStepSizeIntegrator<ODE> const& integrator,
+      IntegrationProblem<ODE> const& problem,
+      typename AdaptiveStepSizeIntegrator<ODE>::AppendState const& append_state,
+      typename AdaptiveStepSizeIntegrator<ODE>::ToleranceToErrorRatio const&
+          tolerance_to_error_ratio,
+      typename AdaptiveStepSizeIntegrator<ODE>::Parameters const& parameters,
+      Instant const& t_final);
+
+  // Same as |SolveMasslessBody| for the Newtonian motion equation, but using
+  // Encke's method with the given |rectification_tolerance|, see
+  // |ODEAdaptiveStepParameters|.  The |integrator| solves the deviation from
+  // the reference conic, with the step size control of |parameters|.  The
+  // |compute_massless_accelerations| must agree with the |problem|.
+  absl::Status SolveMasslessBodyWithEncke(
+      AdaptiveStepSizeIntegrator<NewtonianMotionEquation> const& integrator,
+      IntegrationProblem<NewtonianMotionEquation> const& problem,
+      MasslessBodiesAccelerationComputation const&
+          compute_massless_accelerations,
+      typename AdaptiveStepSizeIntegrator<
+          NewtonianMotionEquation>::AppendState const& append_state,
+      typename AdaptiveStepSizeIntegrator<NewtonianMotionEquation>::
+          ToleranceToErrorRatio const& tolerance_to_error_ratio,
+      typename AdaptiveStepSizeIntegrator<
+          NewtonianMotionEquation>::Parameters const& parameters,
+      Instant const& t_final,
+      double rectification_tolerance) const EXCLUDES(lock_);
+
+  // The batched |FlowWithAdaptiveStep| with an embedded explicit
+  // Runge-Kutta-Nyström |integrator|.
+  template<typename EmbeddedExplicitRungeKuttaNyströmIntegrator>
+  std::vector<absl::Status> FlowBatchWithAdaptiveStep(
+      EmbeddedExplicitRungeKuttaNyströmIntegrator const& integrator,
+      std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
+      Instant const& t,
+      AdaptiveStepParameters const& parameters,
       std::int64_t max_ephemeris_steps) EXCLUDES(lock_);
 
   // Computes an estimate of the ratio |tolerance / error|.
@@ -450,6 +991,9 @@ class Ephemeris {
   // The indices of bodies in |unowned_bodies_|.
   std::map<not_null<MassiveBody const*>, int> unowned_bodies_indices_;
 
+  // The trajectories in the order of |unowned_bodies_|.
+  std::vector<not_null<ContinuousTrajectory<Frame>*>> unowned_trajectories_;
+
   // The oblate bodies precede the spherical bodies in this vector.  The system
   // state is indexed in the same order.
   std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies_;
@@ -473,28 +1017,108 @@ class Ephemeris {
   not_null<
       std::unique_ptr<Checkpointer<serialization::Ephemeris>>> checkpointer_;
 
+  // Parallel computation of the accelerations between the massive bodies, see
+  // |SetMassiveBodiesParallelism|.  The pool is null if the computation is
+  // serial.  The tiles are only used if |!massive_bodies_identical_to_serial_|.
+  // The pool is also used by |ComputeApsides|.
+  int massive_bodies_threads_ = 1;
+  bool massive_bodies_identical_to_serial_ = false;
+  std::unique_ptr<ThreadPool<void>> massive_bodies_pool_;
+  std::vector<MassiveBodiesTile> massive_bodies_tiles_;
+
+  // See |SetPerturberCulling|.  Culling is disabled if the tolerance is 0.
+  double perturber_culling_tolerance_ = 0;
+  double perturber_culling_error_bound_ GUARDED_BY(lock_) = 0;
+
   // This member must only be accessed by the |reanimator_| thread, or before
   // the |reanimator_| thread is started.  An ephemeris that is constructed de
   // novo won't ever need reanimation, so all the checkpoints are animate at
   // birth.
   Instant oldest_reanimated_checkpoint_ = InfinitePast;
 
+  // Null unless |SetReanimationCache| was called.  Only written by the
+  // |reanimator_| thread once it is started, but read by the threads of the
+  // |reanimation_pool_|.
+  std::unique_ptr<EphemerisCache<Frame>> reanimation_cache_;
+
+  // Concurrent reanimation of the segments, see |SetReanimationParallelism|.
+  // The pool is null if the reanimation is serial.
+  int reanimation_threads_ = 1;
+  std::unique_ptr<ThreadPool<absl::StatusOr<ReanimatedSegment>>>
+      reanimation_pool_;
+
   // The techniques and terminology follow [Lov22].
   RecurringThread<Instant> reanimator_;
 
+  // The look-ahead horizon, if |StartLookAheadProlongation| was called.  This
+  // member is not modified once the |prolongator_| is started.
+  std::optional<Time> look_ahead_horizon_;
+
+  // Keeps |t_max()| ahead of the times passed to |Prolong|.
+  RecurringThread<Instant> prolongator_;
+
   // The fields above this line are fixed at construction and therefore not
   // protected.  Note that |ContinuousTrajectory| is thread-safe.  |lock_| is
   // also used to protect sections where the trajectories are not mutually
-  // consistent (e.g., during Prolong).
+  // consistent (e.g., during Prolong).  It is not needed to evaluate the
+  // trajectories at times before |t_max()|, since they are only extended.
   mutable absl::Mutex lock_;
 
   // Parameter passed to the last call to |RequestReanimation|, if any.
   std::optional<Instant> last_desired_t_min_ GUARDED_BY(lock_);
 
+  // The progress of the current reanimation, see |reanimation_progress|.
+  std::int64_t segments_to_reanimate_ GUARDED_BY(lock_) = 0;
+  std::int64_t reanimated_segments_ GUARDED_BY(lock_) = 0;
+
+  // The positions from which the hierarchy of the Kepler splittings is built,
+  // in the order of |unowned_bodies_|.  Empty unless the
+  // |fixed_step_parameters_| have a |kepler_splitting_integrator_|.  Fixed at
+  // construction.
+  std::vector<Position<Frame>> kepler_splitting_positions_;
+
+  // Exactly one of |instance_| and |kepler_splitting_instance_| is not null,
+  // depending on whether the |fixed_step_parameters_| have a
+  // |kepler_splitting_integrator_|.  The latter solves the equation of
+  // |kepler_splitting_|.
   std::unique_ptr<typename Integrator<NewtonianMotionEquation>::Instance>
       instance_ GUARDED_BY(lock_);
+  std::unique_ptr<KeplerSplitting<Frame>> kepler_splitting_ GUARDED_BY(lock_);
+  std::unique_ptr<typename Integrator<KeplerSplittingEquation>::Instance>
+      kepler_splitting_instance_ GUARDED_BY(lock_);
 
   absl::Status last_severe_integration_status_ GUARDED_BY(lock_);
+
+  // A small cache of the positions of the massive bodies, indexed by time, see
+  // |EvaluateMassiveBodiesPositions|.  The positions of the bodies at a given
+  // time never change once they can be evaluated, so the cache is never
+  // invalidated.  Entries are replaced in round-robin order.  Each entry is a
+  // sequence lock: the writers, which hold
+  // |massive_bodies_positions_cache_lock_|, make |sequence| odd while they
+  // modify the entry, and the readers retry if |sequence| changed while they
+  // were reading.  The |time| is stored as the number of seconds since
+  // |Instant()|, NaN for an empty entry, and the |coordinates| are the
+  // coordinates in metres of the positions, in the order of |bodies_|.
+  struct MassiveBodiesPositionsCacheEntry {
+    std::atomic<std::uint64_t> sequence = 0;
+    std::atomic<double> time = std::numeric_limits<double>::quiet_NaN();
+    std::vector<std::atomic<double>> coordinates;
+  };
+  static constexpr int massive_bodies_positions_cache_size = 16;
+  mutable absl::Mutex massive_bodies_positions_cache_lock_;
+  mutable std::array<MassiveBodiesPositionsCacheEntry,
+                     massive_bodies_positions_cache_size>
+      massive_bodies_positions_cache_;
+  mutable int next_massive_bodies_positions_cache_entry_
+      GUARDED_BY(massive_bodies_positions_cache_lock_) = 0;
+  // Only updated with relaxed operations, they are not ordered with respect to
+  // the cache.
+  mutable std::atomic<std::int64_t> massive_bodies_positions_cache_hits_ = 0;
+  mutable std::atomic<std::int64_t> massive_bodies_positions_cache_misses_ = 0;
+  mutable std::atomic<std::int64_t>
+      massless_bodies_ranges_computed_concurrently_ = 0;
+
+  friend class physics::KustaanheimoStiefelFlow<Frame>;
 };
 
 }  // namespace internal_ephemeris
@@ -4,27 +4,42 @@
 #include "physics/ephemeris.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <deque>
 #include <functional>
+#include <future>
 #include <limits>
+#include <numeric>
 #include <optional>
+#include <string>
+#include <thread>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "absl/container/btree_set.h"
 #include "absl/strings/str_cat.h"
 #include "astronomy/epoch.hpp"
+#include "base/fingerprint2011.hpp"
 #include "base/jthread.hpp"
 #include "base/macros.hpp"
 #include "base/map_util.hpp"
 #include "base/not_null.hpp"
+#include "base/serialization.hpp"
+#include "base/status_utilities.hpp"
 #include "geometry/grassmann.hpp"
 #include "geometry/r3_element.hpp"
+#include "integrators/embedded_explicit_runge_kutta_nyström_integrator.hpp"
 #include "integrators/integrators.hpp"
+#include "integrators/methods.hpp"
 #include "integrators/ordinary_differential_equations.hpp"
 #include "numerics/hermite3.hpp"
 #include "physics/continuous_trajectory.hpp"
+#include "physics/kepler_orbit.hpp"
+#include "physics/massless_body.hpp"
 #include "quantities/elementary_functions.hpp"
 #include "quantities/named_quantities.hpp"
+#include "quantities/numbers.hpp"
 #include "quantities/quantities.hpp"
 #include "quantities/si.hpp"
 
@@ -35,32 +50,36 @@ namespace internal_ephemeris {
 using astronomy::J2000;
 using base::dynamic_cast_not_null;
 using base::FindOrDie;
+using base::Fingerprint2011;
+using base::FingerprintCat2011;
 using base::make_not_null_unique;
 using base::MakeStoppableThread;
+using base::SerializeAsBytes;
+using base::stop_token;
+using base::this_stoppable_thread;
 using geometry::Barycentre;
 using geometry::Displacement;
-using geometry::InnerProduct;
 using geometry::Position;
 using geometry::R3Element;
-using geometry::Sign;
 using geometry::Velocity;
 using integrators::EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegrator;
 using integrators::ExplicitSecondOrderOrdinaryDifferentialEquation;
 using integrators::IntegrationProblem;
 using integrators::Integrator;
 using integrators::methods::Fine1987RKNG34;
-using numerics::Brent;
 using numerics::DoublePrecision;
 using numerics::Hermite3;
 using quantities::Abs;
 using quantities::Exponentiation;
 using quantities::GravitationalParameter;
+using quantities::Infinity;
 using quantities::Inverse;
+using quantities::IsFinite;
+using quantities::Pow;
 using quantities::Quotient;
 using quantities::Sqrt;
 using quantities::Square;
 using quantities::Time;
-using quantities::Variation;
 using quantities::si::Day;
 using quantities::si::Metre;
 using quantities::si::Milli;
@@ -77,11 +96,36 @@ constexpr Time max_time_between_checkpoints = 180 * Day;
 // Below this threshold detect a collision to prevent the integrator and the
 // downsampling from going postal.
 constexpr double min_radius_tolerance = 0.99;
+// Below this number of massless bodies, the cost of converting the positions
+// to a structure of arrays exceeds the benefit of vectorization.
+constexpr int min_massless_bodies_for_vectorization = 4;
+// The number of tiles used for the parallel computation of the accelerations
+// between massive bodies.  It doesn't depend on the number of threads so that
+// the result doesn't either.  It is large enough for the dynamic assignment of
+// tiles to threads to balance the load even though the tiles involving oblate
+// bodies are more expensive.
+constexpr int massive_bodies_tiles = 64;
+// The number of massless bodies in a range of a batched instance, see
+// |NewBatchedInstance|.  Large enough for the vectorized computation to pay
+// off, small enough for the ranges to be balanced among the threads.
+constexpr int massless_bodies_per_range = 32;
 
 inline absl::Status CollisionDetected() {
   return absl::OutOfRangeError("Collision detected");
 }
 
+// A bound on the change of the acceleration μ q / |q|³ when q moves by at most
+// |δ| from a point at distance |distance|.  The norm of the Jacobian of that
+// function is 2 μ / |q|³.
+inline Acceleration TidalAccelerationBound(GravitationalParameter const& μ,
+                                           Length const& distance,
+                                           Length const& δ) {
+  if (δ >= distance) {
+    return Infinity<Acceleration>;
+  }
+  return 2 * μ * δ / Pow<3>(distance - δ);
+}
+
 template<typename Frame>
 template<typename ODE>
 Ephemeris<Frame>::ODEAdaptiveStepParameters<ODE>::ODEAdaptiveStepParameters(
@@ -148,6 +192,21 @@ set_speed_integration_tolerance(Speed const& speed_integration_tolerance) {
   speed_integration_tolerance_ = speed_integration_tolerance;
 }
 
+template<typename Frame>
+template<typename ODE>
+double Ephemeris<Frame>::ODEAdaptiveStepParameters<ODE>::
+encke_rectification_tolerance() const {
+  return encke_rectification_tolerance_;
+}
+
+template<typename Frame>
+template<typename ODE>
+void Ephemeris<Frame>::ODEAdaptiveStepParameters<ODE>::
+set_encke_rectification_tolerance(double const encke_rectification_tolerance) {
+  CHECK_LE(0, encke_rectification_tolerance);
+  encke_rectification_tolerance_ = encke_rectification_tolerance;
+}
+
 template<typename Frame>
 template<typename ODE>
 void Ephemeris<Frame>::ODEAdaptiveStepParameters<ODE>::WriteToMessage(
@@ -159,6 +218,9 @@ void Ephemeris<Frame>::ODEAdaptiveStepParameters<ODE>::WriteToMessage(
       message->mutable_length_integration_tolerance());
   speed_integration_tolerance_.WriteToMessage(
       message->mutable_speed_integration_tolerance());
+  if (encke_rectification_tolerance_ > 0) {
+    message->set_encke_rectification_tolerance(encke_rectification_tolerance_);
+  }
 }
 
 template<typename Frame>
@@ -166,11 +228,16 @@ template<typename ODE>
 typename Ephemeris<Frame>::template ODEAdaptiveStepParameters<ODE>
 Ephemeris<Frame>::ODEAdaptiveStepParameters<ODE>::ReadFromMessage(
     serialization::Ephemeris::AdaptiveStepParameters const& message) {
-  return ODEAdaptiveStepParameters(
+  ODEAdaptiveStepParameters parameters(
       AdaptiveStepSizeIntegrator<ODE>::ReadFromMessage(message.integrator()),
       message.max_steps(),
       Length::ReadFromMessage(message.length_integration_tolerance()),
       Speed::ReadFromMessage(message.speed_integration_tolerance()));
+  if (message.has_encke_rectification_tolerance()) {
+    parameters.set_encke_rectification_tolerance(
+        message.encke_rectification_tolerance());
+  }
+  return parameters;
 }
 
 template<typename Frame>
@@ -206,6 +273,16 @@ Ephemeris<Frame>::FixedStepParameters::FixedStepParameters(
   CHECK_LT(Time(), step);
 }
 
+template<typename Frame>
+Ephemeris<Frame>::FixedStepParameters::FixedStepParameters(
+    FixedStepSizeIntegrator<NewtonianMotionEquation> const& integrator,
+    FixedStepSizeIntegrator<KeplerSplittingEquation> const&
+        kepler_splitting_integrator,
+    Time const& step)
+    : FixedStepParameters(integrator, step) {
+  kepler_splitting_integrator_ = &kepler_splitting_integrator;
+}
+
 template<typename Frame>
 inline Time const& Ephemeris<Frame>::FixedStepParameters::step() const {
   return step_;
@@ -217,16 +294,29 @@ void Ephemeris<Frame>::FixedStepParameters::WriteToMessage(
     const {
   integrator_->WriteToMessage(message->mutable_integrator());
   step_.WriteToMessage(message->mutable_step());
+  if (kepler_splitting_integrator_ != nullptr) {
+    kepler_splitting_integrator_->WriteToMessage(
+        message->mutable_kepler_splitting_integrator());
+  }
 }
 
 template<typename Frame>
 typename Ephemeris<Frame>::FixedStepParameters
 Ephemeris<Frame>::FixedStepParameters::ReadFromMessage(
     serialization::Ephemeris::FixedStepParameters const& message) {
-  return FixedStepParameters(
+  auto const& integrator =
       FixedStepSizeIntegrator<NewtonianMotionEquation>::ReadFromMessage(
-          message.integrator()),
-      Time::ReadFromMessage(message.step()));
+          message.integrator());
+  Time const step = Time::ReadFromMessage(message.step());
+  if (message.has_kepler_splitting_integrator()) {
+    return FixedStepParameters(
+        integrator,
+        FixedStepSizeIntegrator<KeplerSplittingEquation>::ReadFromMessage(
+            message.kepler_splitting_integrator()),
+        step);
+  } else {
+    return FixedStepParameters(integrator, step);
+  }
 }
 
 template<typename Frame>
@@ -246,6 +336,11 @@ Ephemeris<Frame>::Ephemeris(
           [this](Instant const& desired_t_min) {
             return Reanimate(desired_t_min);
           },
+          20ms),  // 50 Hz.
+      prolongator_(
+          [this](Instant const& t) {
+            return ProlongAhead(t);
+          },
           20ms) {  // 50 Hz.
   CHECK(!bodies.empty());
   CHECK_EQ(bodies.size(), initial_state.size());
@@ -271,6 +366,7 @@ Ephemeris<Frame>::Ephemeris(
     CHECK(inserted);
     ContinuousTrajectory<Frame>* const trajectory = it->second.get();
     CHECK_OK(trajectory->Append(initial_time, degrees_of_freedom));
+    unowned_trajectories_.push_back(trajectory);
 
     if (body->is_oblate()) {
       geopotentials_.emplace(
@@ -294,17 +390,33 @@ Ephemeris<Frame>::Ephemeris(
       ++number_of_spherical_bodies_;
     }
   }
+  for (auto& entry : massive_bodies_positions_cache_) {
+    entry.coordinates = std::vector<std::atomic<double>>(3 * bodies_.size());
+  }
 
   absl::ReaderMutexLock l(&lock_);  // For locking checks.
-  instance_ = fixed_step_parameters_.integrator_->NewInstance(
-      problem,
-      /*append_state=*/std::bind(
-          &Ephemeris::AppendMassiveBodiesState, this, _1),
-      fixed_step_parameters_.step_);
+  auto const append_state =
+      std::bind(&Ephemeris::AppendMassiveBodiesState, this, _1);
+  if (fixed_step_parameters_.kepler_splitting_integrator_ == nullptr) {
+    instance_ = fixed_step_parameters_.integrator_->NewInstance(
+        problem, append_state, fixed_step_parameters_.step_);
+  } else {
+    for (auto const& degrees_of_freedom : initial_state) {
+      kepler_splitting_positions_.push_back(degrees_of_freedom.position());
+    }
+    typename KeplerSplittingEquation::SystemState kepler_splitting_state;
+    std::get<0>(kepler_splitting_state.y) = state.positions;
+    std::get<1>(kepler_splitting_state.y) = state.velocities;
+    kepler_splitting_state.time = state.time;
+    kepler_splitting_ = MakeKeplerSplitting();
+    kepler_splitting_instance_ = NewKeplerSplittingInstance(
+        *kepler_splitting_, kepler_splitting_state, append_state);
+  }
 }
 
 template<typename Frame>
 Ephemeris<Frame>::~Ephemeris() {
+  prolongator_.Stop();
   reanimator_.Stop();
 }
 
@@ -336,10 +448,31 @@ Instant Ephemeris<Frame>::t_min() const {
   return t_min_locked();
 }
 
+template<typename Frame>
+std::vector<Position<Frame>> Ephemeris<Frame>::EvaluateAllPositions(
+    Instant const& t) const {
+  std::vector<Position<Frame>> positions;
+  EvaluatePositions(t, unowned_trajectories_, positions);
+  return positions;
+}
+
+template<typename Frame>
+std::vector<DegreesOfFreedom<Frame>>
+Ephemeris<Frame>::EvaluateAllDegreesOfFreedom(Instant const& t) const {
+  std::vector<DegreesOfFreedom<Frame>> degrees_of_freedom;
+  EvaluateDegreesOfFreedom(t, unowned_trajectories_, degrees_of_freedom);
+  return degrees_of_freedom;
+}
+
 template<typename Frame>
 Instant Ephemeris<Frame>::t_max() const {
-  absl::ReaderMutexLock l(&lock_);
-  return t_max_locked();
+  // No locking: the trajectories are only extended, so the minimum of their
+  // |t_max|s is a time at which they can all be evaluated.
+  Instant t_max = trajectories_.front()->t_max();
+  for (auto const trajectory : trajectories_) {
+    t_max = std::min(t_max, trajectory->t_max());
+  }
+  return t_max;
 }
 
 template<typename Frame>
@@ -355,6 +488,15 @@ absl::Status Ephemeris<Frame>::last_severe_integration_status() const {
   return last_severe_integration_status_;
 }
 
+template<typename Frame>
+std::int64_t Ephemeris<Frame>::checkpoints_size_in_bytes() const {
+  std::int64_t result = checkpointer_->checkpoints_size_in_bytes();
+  for (auto const trajectory : unowned_trajectories_) {
+    result += trajectory->checkpoints_size_in_bytes();
+  }
+  return result;
+}
+
 template<typename Frame>
 void Ephemeris<Frame>::RequestReanimation(Instant const& desired_t_min) {
   reanimator_.Start();
@@ -384,6 +526,28 @@ void Ephemeris<Frame>::RequestReanimation(Instant const& desired_t_min) {
   reanimator_.Put(desired_t_min);
 }
 
+template<typename Frame>
+void Ephemeris<Frame>::SetReanimationParallelism(int const number_of_threads) {
+  CHECK_LE(1, number_of_threads);
+  reanimation_threads_ = number_of_threads;
+  if (number_of_threads == 1) {
+    reanimation_pool_.reset();
+  } else {
+    reanimation_pool_ =
+        std::make_unique<ThreadPool<absl::StatusOr<ReanimatedSegment>>>(
+            /*pool_size=*/number_of_threads);
+  }
+}
+
+template<typename Frame>
+double Ephemeris<Frame>::reanimation_progress() const {
+  absl::ReaderMutexLock l(&lock_);
+  if (segments_to_reanimate_ == 0) {
+    return 1;
+  }
+  return static_cast<double>(reanimated_segments_) / segments_to_reanimate_;
+}
+
 template<typename Frame>
 void Ephemeris<Frame>::WaitForReanimation(Instant const& desired_t_min) {
   auto desired_t_min_reached = [this, desired_t_min]() {
@@ -395,8 +559,113 @@ void Ephemeris<Frame>::WaitForReanimation(Instant const& desired_t_min) {
   lock_.Await(absl::Condition(&desired_t_min_reached));
 }
 
+template<typename Frame>
+template<typename, typename>
+void Ephemeris<Frame>::SetReanimationCache(std::filesystem::path const& path) {
+  // The key covers everything that affects the integration and the fitting,
+  // except for the state, which is covered by the fingerprints of the segments.
+  serialization::Ephemeris message;
+  for (auto const& body : bodies_) {
+    body->WriteToMessage(message.add_body());
+  }
+  fixed_step_parameters_.WriteToMessage(
+      message.mutable_fixed_step_parameters());
+  accuracy_parameters_.WriteToMessage(message.mutable_accuracy_parameters());
+  for (auto const& position : kepler_splitting_positions_) {
+    position.WriteToMessage(message.add_kepler_splitting_position());
+  }
+  reanimation_cache_ = std::make_unique<EphemerisCache<Frame>>(
+      path,
+      /*key=*/Fingerprint2011(SerializeAsBytes(message).get()),
+      trajectories_.size());
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::SetMassiveBodiesParallelism(
+    int const number_of_threads,
+    bool const identical_to_serial) {
+  CHECK_LE(1, number_of_threads);
+  massive_bodies_threads_ = number_of_threads;
+  massive_bodies_identical_to_serial_ = identical_to_serial;
+  massive_bodies_tiles_.clear();
+  if (number_of_threads == 1) {
+    massive_bodies_pool_.reset();
+    return;
+  }
+  massive_bodies_pool_ =
+      std::make_unique<ThreadPool<void>>(/*pool_size=*/number_of_threads - 1);
+
+  // Split the triangle of pairs, enumerated row by row, into tiles having
+  // (almost) the same number of pairs.
+  std::size_t const number_of_bodies = bodies_.size();
+  std::int64_t const number_of_pairs =
+      number_of_bodies * (number_of_bodies - 1) / 2;
+  std::int64_t const number_of_tiles =
+      std::min<std::int64_t>(number_of_pairs, massive_bodies_tiles);
+  std::int64_t pair = 0;
+  for (std::int64_t tile = 0; tile < number_of_tiles; ++tile) {
+    massive_bodies_tiles_.emplace_back();
+  }
+  for (std::size_t b1 = 0; b1 < number_of_bodies; ++b1) {
+    std::size_t b2 = b1 + 1;
+    while (b2 < number_of_bodies) {
+      // The tile to which |pair| belongs, and the first pair of the next tile.
+      std::int64_t const tile = pair * number_of_tiles / number_of_pairs;
+      std::int64_t const next_tile_first_pair =
+          ((tile + 1) * number_of_pairs + number_of_tiles - 1) /
+          number_of_tiles;
+      std::size_t const b2_end = std::min<std::size_t>(
+          number_of_bodies, b2 + (next_tile_first_pair - pair));
+      massive_bodies_tiles_[tile].push_back({b1, b2, b2_end});
+      pair += b2_end - b2;
+      b2 = b2_end;
+    }
+  }
+  CHECK_EQ(number_of_pairs, pair);
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::SetPerturberCulling(double const relative_tolerance) {
+  CHECK_LE(0, relative_tolerance);
+  perturber_culling_tolerance_ = relative_tolerance;
+}
+
+template<typename Frame>
+double Ephemeris<Frame>::perturber_culling_error_bound() const {
+  absl::ReaderMutexLock l(&lock_);
+  return perturber_culling_error_bound_;
+}
+
+template<typename Frame>
+std::int64_t Ephemeris<Frame>::massive_bodies_positions_cache_hits() const {
+  return massive_bodies_positions_cache_hits_.load(std::memory_order_relaxed);
+}
+
+template<typename Frame>
+std::int64_t Ephemeris<Frame>::massive_bodies_positions_cache_misses() const {
+  return massive_bodies_positions_cache_misses_.load(std::memory_order_relaxed);
+}
+
+template<typename Frame>
+std::int64_t
+Ephemeris<Frame>::massless_bodies_ranges_computed_concurrently() const {
+  return massless_bodies_ranges_computed_concurrently_.load(
+      std::memory_order_relaxed);
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::StartLookAheadProlongation(Time const& horizon) {
+  CHECK_LT(Time(), horizon);
+  look_ahead_horizon_ = horizon;
+  prolongator_.Start();
+}
+
 template<typename Frame>
 absl::Status Ephemeris<Frame>::Prolong(Instant const& t) {
+  if (look_ahead_horizon_.has_value()) {
+    prolongator_.Put(t + look_ahead_horizon_.value());
+  }
+
   // Short-circuit without locking.
   if (t <= t_max()) {
     return absl::OkStatus();
@@ -418,7 +687,7 @@ absl::Status Ephemeris<Frame>::Prolong(Instant const& t) {
   // after the first integration.
   absl::MutexLock l(&lock_);
   while (t_max_locked() < t) {
-    instance_->Solve(t_final).IgnoreError();
+    SolveInstance(t_final).IgnoreError();
     RETURN_IF_STOPPED;
     t_final += fixed_step_parameters_.step_;
   }
@@ -444,9 +713,21 @@ Ephemeris<Frame>::StoppableNewInstance(
     std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
     IntrinsicAccelerations const& intrinsic_accelerations,
     FixedStepParameters const& parameters) {
-  IntegrationProblem<NewtonianMotionEquation> problem;
+  return StoppableNewInstance(trajectories,
+                              intrinsic_accelerations,
+                              /*event_detectors=*/{},
+                              parameters);
+}
 
-  problem.equation.compute_acceleration =
+template<typename Frame>
+absl::StatusOr<not_null<std::unique_ptr<typename Integrator<
+    typename Ephemeris<Frame>::NewtonianMotionEquation>::Instance>>>
+Ephemeris<Frame>::StoppableNewInstance(
+    std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
+    IntrinsicAccelerations const& intrinsic_accelerations,
+    std::vector<EventDetector<Frame>*> const& event_detectors,
+    FixedStepParameters const& parameters) {
+  auto compute_acceleration =
       [this, intrinsic_accelerations](
           Instant const& t,
           std::vector<Position<Frame>> const& positions,
@@ -455,7 +736,8 @@ Ephemeris<Frame>::StoppableNewInstance(
         ComputeGravitationalAccelerationByAllMassiveBodiesOnMasslessBodies(
             t,
             positions,
-            accelerations);
+            accelerations,
+            /*use_positions_cache=*/true);
     // Add the intrinsic accelerations.
     for (int i = 0; i < intrinsic_accelerations.size(); ++i) {
       auto const intrinsic_acceleration = intrinsic_accelerations[i];
@@ -466,6 +748,52 @@ Ephemeris<Frame>::StoppableNewInstance(
     return error == absl::StatusCode::kOk ? absl::OkStatus() :
                     CollisionDetected();
   };
+  return NewInstanceForEquation(trajectories,
+                                std::move(compute_acceleration),
+                                event_detectors,
+                                parameters);
+}
+
+template<typename Frame>
+not_null<std::unique_ptr<typename Integrator<
+    typename Ephemeris<Frame>::NewtonianMotionEquation>::Instance>>
+Ephemeris<Frame>::NewBatchedInstance(
+    std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
+    FixedStepParameters const& parameters,
+    not_null<std::vector<bool>*> const collided) {
+  collided->assign(trajectories.size(), false);
+  auto compute_acceleration =
+      [this, collided](
+          Instant const& t,
+          std::vector<Position<Frame>> const& positions,
+          std::vector<Vector<Acceleration, Frame>>& accelerations) {
+    ComputeGravitationalAccelerationByAllMassiveBodiesOnMasslessBodies(
+        t,
+        positions,
+        accelerations,
+        *collided,
+        /*use_positions_cache=*/true);
+    return absl::OkStatus();
+  };
+  return NewInstanceForEquation(trajectories,
+                                std::move(compute_acceleration),
+                                /*event_detectors=*/{},
+                                parameters).value();
+}
+
+template<typename Frame>
+absl::StatusOr<not_null<std::unique_ptr<typename Integrator<
+    typename Ephemeris<Frame>::NewtonianMotionEquation>::Instance>>>
+Ephemeris<Frame>::NewInstanceForEquation(
+    std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
+    typename NewtonianMotionEquation::RightHandSideComputation
+        compute_acceleration,
+    std::vector<EventDetector<Frame>*> const& event_detectors,
+    FixedStepParameters const& parameters) {
+  CHECK(event_detectors.empty() ||
+        event_detectors.size() == trajectories.size());
+  IntegrationProblem<NewtonianMotionEquation> problem;
+  problem.equation.compute_acceleration = std::move(compute_acceleration);
 
   CHECK(!trajectories.empty());
   auto const trajectory_last_time = (*trajectories.begin())->back().time;
@@ -479,8 +807,20 @@ Ephemeris<Frame>::StoppableNewInstance(
         last_degrees_of_freedom.velocity());
   }
 
-  auto const append_state = std::bind(
-      &Ephemeris::AppendMasslessBodiesStateToTrajectories, _1, trajectories);
+  for (int i = 0; i < event_detectors.size(); ++i) {
+    if (event_detectors[i] != nullptr) {
+      auto const& [last_time, last_degrees_of_freedom] =
+          trajectories[i]->back();
+      event_detectors[i]->Append(last_time, last_degrees_of_freedom);
+    }
+  }
+
+  auto const append_state =
+      [trajectories, event_detectors](
+          typename NewtonianMotionEquation::SystemState const& state) {
+        AppendMasslessBodiesStateToTrajectories(state, trajectories);
+        AppendMasslessBodiesStateToEventDetectors(state, event_detectors);
+      };
 
   // The construction of the instance may evaluate the degrees of freedom of the
   // bodies.
@@ -502,39 +842,94 @@ absl::Status Ephemeris<Frame>::FlowWithAdaptiveStep(
     Instant const& t,
     AdaptiveStepParameters const& parameters,
     std::int64_t const max_ephemeris_steps) {
-  auto compute_acceleration = [this, &intrinsic_acceleration](
+  return FlowWithAdaptiveStep(trajectory,
+                              std::move(intrinsic_acceleration),
+                              t,
+                              parameters,
+                              max_ephemeris_steps,
+                              /*event_detector=*/nullptr);
+}
+
+template<typename Frame>
+absl::Status Ephemeris<Frame>::FlowWithAdaptiveStep(
+    not_null<DiscreteTrajectory<Frame>*> trajectory,
+    GeneralizedIntrinsicAcceleration intrinsic_acceleration,
+    Instant const& t,
+    GeneralizedAdaptiveStepParameters const& parameters,
+    std::int64_t max_ephemeris_steps) {
+  return FlowWithAdaptiveStep(trajectory,
+                              std::move(intrinsic_acceleration),
+                              t,
+                              parameters,
+                              max_ephemeris_steps,
+                              /*event_detector=*/nullptr);
+}
+
+template<typename Frame>
+absl::Status Ephemeris<Frame>::FlowWithAdaptiveStep(
+    not_null<DiscreteTrajectory<Frame>*> const trajectory,
+    IntrinsicAcceleration intrinsic_acceleration,
+    Instant const& t,
+    AdaptiveStepParameters const& parameters,
+    std::int64_t const max_ephemeris_steps,
+    EventDetector<Frame>* const event_detector) {
+  std::vector<PerturberCulling> cullings(
+      perturber_culling_tolerance_ > 0 ? 1 : 0);
+  MasslessBodiesAccelerationComputation compute_massless_accelerations =
+      [this, &cullings, &intrinsic_acceleration](
+          Instant const& t,
+          std::vector<Position<Frame>> const& massive_positions,
+          std::vector<Position<Frame>> const& positions,
+          std::vector<Vector<Acceleration, Frame>>& accelerations) {
+        auto const error =
+            ComputeGravitationalAccelerationByAllMassiveBodiesOnMasslessBodies(
+                t,
+                massive_positions,
+                positions,
+                accelerations,
+                cullings);
+        if (intrinsic_acceleration != nullptr) {
+          accelerations[0] += intrinsic_acceleration(t);
+        }
+        return error == absl::StatusCode::kOk ? absl::OkStatus() :
+                        CollisionDetected();
+      };
+  auto compute_acceleration = [this, &compute_massless_accelerations](
       Instant const& t,
       std::vector<Position<Frame>> const& positions,
       std::vector<Vector<Acceleration, Frame>>& accelerations) {
-    auto const error =
-        ComputeGravitationalAccelerationByAllMassiveBodiesOnMasslessBodies(
-            t,
-            positions,
-            accelerations);
-    if (intrinsic_acceleration != nullptr) {
-      accelerations[0] += intrinsic_acceleration(t);
-    }
-    return error == absl::StatusCode::kOk ? absl::OkStatus() :
-                    CollisionDetected();
+    // The buffer is reused across calls on the same thread.
+    thread_local std::vector<Position<Frame>> massive_positions;
+    EvaluateMassiveBodiesPositions(
+        t, /*use_positions_cache=*/false, massive_positions);
+    return compute_massless_accelerations(
+        t, massive_positions, positions, accelerations);
   };
 
-  return FlowODEWithAdaptiveStep<NewtonianMotionEquation>(
-             std::move(compute_acceleration),
-             trajectory,
-             t,
-             parameters,
-             max_ephemeris_steps);
+  auto const status = FlowODEWithAdaptiveStep<NewtonianMotionEquation>(
+                          std::move(compute_acceleration),
+                          compute_massless_accelerations,
+                          trajectory,
+                          t,
+                          parameters,
+                          max_ephemeris_steps,
+                          event_detector);
+  RecordPerturberCullingErrorBounds(cullings);
+  return status;
 }
 
 template<typename Frame>
 absl::Status Ephemeris<Frame>::FlowWithAdaptiveStep(
-    not_null<DiscreteTrajectory<Frame>*> trajectory,
+    not_null<DiscreteTrajectory<Frame>*> const trajectory,
     GeneralizedIntrinsicAcceleration intrinsic_acceleration,
     Instant const& t,
     GeneralizedAdaptiveStepParameters const& parameters,
-    std::int64_t max_ephemeris_steps) {
+    std::int64_t const max_ephemeris_steps,
+    EventDetector<Frame>* const event_detector) {
+  std::vector<PerturberCulling> cullings(
+      perturber_culling_tolerance_ > 0 ? 1 : 0);
   auto compute_acceleration =
-      [this, &intrinsic_acceleration](
+      [this, &cullings, &intrinsic_acceleration](
           Instant const& t,
           std::vector<Position<Frame>> const& positions,
           std::vector<Velocity<Frame>> const& velocities,
@@ -543,7 +938,8 @@ absl::Status Ephemeris<Frame>::FlowWithAdaptiveStep(
             ComputeGravitationalAccelerationByAllMassiveBodiesOnMasslessBodies(
                 t,
                 positions,
-                accelerations);
+                accelerations,
+                cullings);
         if (intrinsic_acceleration != nullptr) {
           accelerations[0] +=
               intrinsic_acceleration(t, {positions[0], velocities[0]});
@@ -552,12 +948,229 @@ absl::Status Ephemeris<Frame>::FlowWithAdaptiveStep(
                         CollisionDetected();
       };
 
-  return FlowODEWithAdaptiveStep<GeneralizedNewtonianMotionEquation>(
-             std::move(compute_acceleration),
-             trajectory,
-             t,
-             parameters,
-             max_ephemeris_steps);
+  auto const status =
+      FlowODEWithAdaptiveStep<GeneralizedNewtonianMotionEquation>(
+          std::move(compute_acceleration),
+          /*compute_massless_accelerations=*/nullptr,
+          trajectory,
+          t,
+          parameters,
+          max_ephemeris_steps,
+          event_detector);
+  RecordPerturberCullingErrorBounds(cullings);
+  return status;
+}
+
+template<typename Frame>
+std::vector<absl::Status> Ephemeris<Frame>::FlowWithAdaptiveStep(
+    std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
+    Instant const& t,
+    AdaptiveStepParameters const& parameters,
+    std::int64_t const max_ephemeris_steps) {
+  auto const flow_sequentially = [this,
+                                  &trajectories,
+                                  &t,
+                                  &parameters,
+                                  max_ephemeris_steps]() {
+    std::vector<absl::Status> statuses;
+    statuses.reserve(trajectories.size());
+    for (auto const trajectory : trajectories) {
+      statuses.push_back(FlowWithAdaptiveStep(trajectory,
+                                              NoIntrinsicAcceleration,
+                                              t,
+                                              parameters,
+                                              max_ephemeris_steps));
+    }
+    return statuses;
+  };
+
+  // The batched integration doesn't support Encke's method.
+  if (parameters.encke_rectification_tolerance_ > 0) {
+    return flow_sequentially();
+  }
+
+  // Only the embedded explicit Runge-Kutta-Nyström integrators support
+  // batching.
+  using RKN434FM = integrators::EmbeddedExplicitRungeKuttaNyströmIntegrator<
+      integrators::methods::DormandالمكاوىPrince1986RKN434FM,
+      Position<Frame>>;
+  if (auto const* const eerkn =
+          dynamic_cast<RKN434FM const*>(parameters.integrator_.get())) {
+    return FlowBatchWithAdaptiveStep(
+        *eerkn, trajectories, t, parameters, max_ephemeris_steps);
+  }
+  return flow_sequentially();
+}
+
+template<typename Frame>
+absl::StatusOr<typename Ephemeris<Frame>::PararealDefect>
+Ephemeris<Frame>::FlowWithAdaptiveStepParareal(
+    not_null<DiscreteTrajectory<Frame>*> const trajectory,
+    Instant const& t,
+    AdaptiveStepParameters const& parameters,
+    PararealParameters const& parareal_parameters,
+    std::int64_t const max_ephemeris_steps,
+    ThreadPool<void>* const pool) {
+  int const slices = parareal_parameters.slices;
+  CHECK_LE(1, slices);
+  CHECK_LE(1, parareal_parameters.max_iterations);
+  auto const& [trajectory_last_time,
+               trajectory_last_degrees_of_freedom] = trajectory->back();
+  if (trajectory_last_time == t) {
+    return PararealDefect{};
+  }
+  // See |FlowODEWithAdaptiveStep| for the |min| and the |max|.
+  Instant const t_final =
+      std::min(std::max(instance_time() +
+                            max_ephemeris_steps * fixed_step_parameters_.step(),
+                        trajectory_last_time + fixed_step_parameters_.step()),
+               t);
+  Prolong(t_final).IgnoreError();
+  RETURN_IF_STOPPED;
+
+  // The boundaries of the slices.
+  std::vector<Instant> times;
+  for (int n = 0; n < slices; ++n) {
+    times.push_back(trajectory_last_time +
+                    n * ((t_final - trajectory_last_time) / slices));
+  }
+  times.push_back(t_final);
+
+  // Integrates the slice |n| from the given |degrees_of_freedom|.
+  auto const flow = [this, &times](
+      int const n,
+      DegreesOfFreedom<Frame> const& degrees_of_freedom,
+      AdaptiveStepParameters const& parameters,
+      DiscreteTrajectory<Frame>& slice) {
+    slice = DiscreteTrajectory<Frame>();
+    slice.Append(times[n], degrees_of_freedom).IgnoreError();
+    return FlowWithAdaptiveStep(&slice,
+                                NoIntrinsicAcceleration,
+                                times[n + 1],
+                                parameters,
+                                unlimited_max_ephemeris_steps);
+  };
+
+  // The parareal iterates: the predicted states at the beginning of the
+  // slices, the coarse and fine solutions at their end, and the states from
+  // which these solutions were computed.
+  std::vector<DegreesOfFreedom<Frame>> initial_states;
+  std::vector<std::optional<DegreesOfFreedom<Frame>>> coarse_initial_states(
+      slices);
+  std::vector<std::optional<DegreesOfFreedom<Frame>>> coarse_final_states(
+      slices);
+  std::vector<std::optional<DegreesOfFreedom<Frame>>> fine_initial_states(
+      slices);
+  std::vector<DiscreteTrajectory<Frame>> fine_slices(slices);
+  std::vector<absl::Status> fine_statuses(slices);
+
+  // Recomputes the coarse solution of slice |n| if its initial state changed.
+  DiscreteTrajectory<Frame> coarse_slice;
+  auto const coarse = [&coarse_final_states,
+                       &coarse_initial_states,
+                       &coarse_slice,
+                       &flow,
+                       &initial_states,
+                       &parareal_parameters](int const n) {
+    if (coarse_initial_states[n] != initial_states[n]) {
+      RETURN_IF_ERROR(flow(n,
+                           initial_states[n],
+                           parareal_parameters.coarse_parameters,
+                           coarse_slice));
+      coarse_initial_states[n] = initial_states[n];
+      coarse_final_states[n] = coarse_slice.back().degrees_of_freedom;
+    }
+    return absl::OkStatus();
+  };
+
+  // The initial prediction.
+  initial_states.push_back(trajectory_last_degrees_of_freedom);
+  for (int n = 0; n < slices - 1; ++n) {
+    RETURN_IF_ERROR(coarse(n));
+    initial_states.push_back(*coarse_final_states[n]);
+  }
+
+  PararealDefect defect;
+  for (;;) {
+    ++defect.iterations;
+
+    // Integrate the slices whose initial state changed.
+    std::vector<std::future<void>> futures;
+    for (int n = 0; n < slices; ++n) {
+      if (fine_initial_states[n] == initial_states[n]) {
+        continue;
+      }
+      fine_initial_states[n] = initial_states[n];
+      auto task = [&fine_slices, &fine_statuses, &flow, &initial_states,
+                   &parameters, n]() {
+        fine_statuses[n] =
+            flow(n, initial_states[n], parameters, fine_slices[n]);
+      };
+      if (pool == nullptr) {
+        task();
+      } else {
+        futures.push_back(pool->Add(std::move(task)));
+      }
+    }
+    for (auto& future : futures) {
+      future.wait();
+    }
+    for (auto const& status : fine_statuses) {
+      RETURN_IF_ERROR(status);
+    }
+    RETURN_IF_STOPPED;
+
+    defect.position = Length();
+    defect.velocity = Speed();
+    for (int n = 1; n < slices; ++n) {
+      DegreesOfFreedom<Frame> const& fine_final_state =
+          fine_slices[n - 1].back().degrees_of_freedom;
+      defect.position = std::max(
+          defect.position,
+          (fine_final_state.position() - initial_states[n].position()).Norm());
+      defect.velocity = std::max(
+          defect.velocity,
+          (fine_final_state.velocity() - initial_states[n].velocity()).Norm());
+    }
+    if ((defect.position <= parameters.length_integration_tolerance_ &&
+         defect.velocity <= parameters.speed_integration_tolerance_) ||
+        defect.iterations == parareal_parameters.max_iterations) {
+      break;
+    }
+
+    // Correct the predictions with the difference between the fine and coarse
+    // solutions of the previous iteration.  The first slice is exact, and so is
+    // the beginning of the next one.
+    for (int n = 0; n < slices - 1; ++n) {
+      DegreesOfFreedom<Frame> const previous_coarse_final_state =
+          *coarse_final_states[n];
+      RETURN_IF_ERROR(coarse(n));
+      DegreesOfFreedom<Frame> const& fine_final_state =
+          fine_slices[n].back().degrees_of_freedom;
+      initial_states[n + 1] = DegreesOfFreedom<Frame>(
+          coarse_final_states[n]->position() +
+              (fine_final_state.position() -
+               previous_coarse_final_state.position()),
+          coarse_final_states[n]->velocity() +
+              (fine_final_state.velocity() -
+               previous_coarse_final_state.velocity()));
+    }
+  }
+
+  for (auto const& fine_slice : fine_slices) {
+    for (auto it = std::next(fine_slice.begin()); it != fine_slice.end();
+         ++it) {
+      trajectory->Append(it->time, it->degrees_of_freedom).IgnoreError();
+    }
+  }
+
+  // See |FlowODEWithAdaptiveStep| for the limit on the ephemeris steps.
+  if (t_final == t) {
+    return defect;
+  } else {
+    return absl::DeadlineExceededError("Couldn't reach " + DebugString(t) +
+                                       ", stopping at " + DebugString(t_final));
+  }
 }
 
 template<typename Frame>
@@ -584,7 +1197,8 @@ Ephemeris<Frame>::ComputeGravitationalAccelerationOnMasslessBody(
   ComputeGravitationalAccelerationByAllMassiveBodiesOnMasslessBodies(
       t,
       {position},
-      accelerations);
+      accelerations,
+      /*use_positions_cache=*/false);
 
   return accelerations[0];
 }
@@ -610,23 +1224,16 @@ Ephemeris<Frame>::ComputeGravitationalAccelerationOnMassiveBody(
   std::vector<Position<Frame>> positions;
   std::vector<Vector<Acceleration, Frame>> accelerations(bodies_.size());
   int b1 = -1;
-
-  // Evaluate the |positions|.  Locking is necessary to be able to call the
-  // "locked" method of each trajectory.
-  {
-    absl::ReaderMutexLock l(&lock_);
-    positions.reserve(bodies_.size());
-    for (int b = 0; b < bodies_.size(); ++b) {
-      auto const& current_body = bodies_[b];
-      auto const& current_body_trajectory = trajectories_[b];
-      if (current_body.get() == body) {
-        CHECK_EQ(-1, b1);
-        b1 = b;
-      }
-      positions.push_back(current_body_trajectory->EvaluatePositionLocked(t));
+  for (int b = 0; b < bodies_.size(); ++b) {
+    if (bodies_[b].get() == body) {
+      CHECK_EQ(-1, b1);
+      b1 = b;
     }
-    CHECK_LE(0, b1);
   }
+  CHECK_LE(0, b1);
+
+  // Evaluate the |positions|.
+  EvaluatePositions(t, trajectories_, positions);
 
   if (body_is_oblate) {
     ComputeGravitationalAccelerationByMassiveBodyOnMassiveBodies<
@@ -703,63 +1310,32 @@ void Ephemeris<Frame>::ComputeApsides(not_null<MassiveBody const*> const body1,
                                       DiscreteTrajectory<Frame>& periapsides1,
                                       DiscreteTrajectory<Frame>& apoapsides2,
                                       DiscreteTrajectory<Frame>& periapsides2) {
-  absl::ReaderMutexLock l(&lock_);
-
   not_null<ContinuousTrajectory<Frame> const*> const body1_trajectory =
       trajectory(body1);
   not_null<ContinuousTrajectory<Frame> const*> const body2_trajectory =
       trajectory(body2);
 
-  // Computes the derivative of the squared distance between |body1| and |body2|
-  // at time |t|.
-  auto const evaluate_square_distance_derivative =
-      [body1_trajectory, body2_trajectory](
-          Instant const& t) -> Variation<Square<Length>> {
-    DegreesOfFreedom<Frame> const body1_degrees_of_freedom =
-        body1_trajectory->EvaluateDegreesOfFreedomLocked(t);
-    DegreesOfFreedom<Frame> const body2_degrees_of_freedom =
-        body2_trajectory->EvaluateDegreesOfFreedomLocked(t);
-    RelativeDegreesOfFreedom<Frame> const relative =
-        body1_degrees_of_freedom - body2_degrees_of_freedom;
-    return 2.0 * InnerProduct(relative.displacement(), relative.velocity());
-  };
-
-  std::optional<Instant> previous_time;
-  std::optional<Variation<Square<Length>>> previous_squared_distance_derivative;
-
-  for (Instant time = t_min_locked();
-       time <= t_max_locked();
-       time += fixed_step_parameters_.step()) {
-    Variation<Square<Length>> const squared_distance_derivative =
-        evaluate_square_distance_derivative(time);
-    if (previous_squared_distance_derivative &&
-        Sign(squared_distance_derivative) !=
-            Sign(*previous_squared_distance_derivative)) {
-      CHECK(previous_time);
-
-      // The derivative of |squared_distance| changed sign.  Find its zero by
-      // Brent's method, this is the time of the apsis.  Then compute the apsis
-      // and append it to one of the output trajectories.
-      Instant const apsis_time = Brent(evaluate_square_distance_derivative,
-                                       *previous_time,
-                                       time);
-      DegreesOfFreedom<Frame> const apsis1_degrees_of_freedom =
-          body1_trajectory->EvaluateDegreesOfFreedomLocked(apsis_time);
-      DegreesOfFreedom<Frame> const apsis2_degrees_of_freedom =
-          body2_trajectory->EvaluateDegreesOfFreedomLocked(apsis_time);
-      if (Sign(squared_distance_derivative).is_negative()) {
-        apoapsides1.Append(apsis_time, apsis1_degrees_of_freedom).IgnoreError();
-        apoapsides2.Append(apsis_time, apsis2_degrees_of_freedom).IgnoreError();
-      } else {
-        periapsides1.Append(apsis_time,
-                            apsis1_degrees_of_freedom).IgnoreError();
-        periapsides2.Append(apsis_time,
-                            apsis2_degrees_of_freedom).IgnoreError();
-      }
+  // The bounds are computed once, the trajectories may be prolonged
+  // concurrently.  The apsides are the zeros of the derivative of the squared
+  // distance, which are found directly on the polynomials of the trajectories.
+  Instant const t_initial = t_min();
+  Instant const t_final = t_max();
+  for (auto const& apsis :
+       body1_trajectory->ComputeApsides(*body2_trajectory,
+                                        t_initial,
+                                        t_final,
+                                        massive_bodies_pool_.get())) {
+    DegreesOfFreedom<Frame> const apsis1_degrees_of_freedom =
+        body1_trajectory->EvaluateDegreesOfFreedom(apsis.time);
+    DegreesOfFreedom<Frame> const apsis2_degrees_of_freedom =
+        body2_trajectory->EvaluateDegreesOfFreedom(apsis.time);
+    if (apsis.increasing) {
+      periapsides1.Append(apsis.time, apsis1_degrees_of_freedom).IgnoreError();
+      periapsides2.Append(apsis.time, apsis2_degrees_of_freedom).IgnoreError();
+    } else {
+      apoapsides1.Append(apsis.time, apsis1_degrees_of_freedom).IgnoreError();
+      apoapsides2.Append(apsis.time, apsis2_degrees_of_freedom).IgnoreError();
     }
-
-    previous_time = time;
-    previous_squared_distance_derivative = squared_distance_derivative;
   }
 }
 
@@ -783,7 +1359,7 @@ void Ephemeris<Frame>::WriteToMessage(
 
   // Make sure that a checkpoint exists, otherwise we would not serialize some
   // parts of the state.
-  WriteToCheckpointIfNeeded(instance_->time().value);
+  WriteToCheckpointIfNeeded(instance_time_locked());
   checkpointer_->WriteToMessage(message->mutable_checkpoint());
 
   // The bodies are serialized in the order in which they were given at
@@ -800,6 +1376,9 @@ void Ephemeris<Frame>::WriteToMessage(
       message->mutable_fixed_step_parameters());
   accuracy_parameters_.WriteToMessage(
       message->mutable_accuracy_parameters());
+  for (auto const& position : kepler_splitting_positions_) {
+    position.WriteToMessage(message->add_kepler_splitting_position());
+  }
   LOG(INFO) << NAMED(message->SpaceUsed());
   LOG(INFO) << NAMED(message->ByteSize());
 }
@@ -833,10 +1412,22 @@ not_null<std::unique_ptr<Ephemeris<Frame>>> Ephemeris<Frame>::ReadFromMessage(
   FixedStepParameters const fixed_step_parameters =
       FixedStepParameters::ReadFromMessage(message.fixed_step_parameters());
 
-  // Dummy initial state and time.  We'll overwrite them later.
-  std::vector<DegreesOfFreedom<Frame>> const initial_state(
+  // Dummy initial state and time.  We'll overwrite them later.  The positions
+  // from which the hierarchy of the Kepler splitting was built are restored
+  // here, since the constructor builds the splitting from them; like the
+  // bodies, they are in the order given at construction.
+  std::vector<DegreesOfFreedom<Frame>> initial_state(
       bodies.size(),
       DegreesOfFreedom<Frame>(Frame::origin, Frame::unmoving));
+  if (message.kepler_splitting_position_size() > 0) {
+    CHECK_EQ(bodies.size(), message.kepler_splitting_position_size());
+    for (int i = 0; i < bodies.size(); ++i) {
+      initial_state[i] = DegreesOfFreedom<Frame>(
+          Position<Frame>::ReadFromMessage(
+              message.kepler_splitting_position(i)),
+          Frame::unmoving);
+    }
+  }
   Instant const initial_time;
   auto ephemeris = make_not_null_unique<Ephemeris<Frame>>(
                        std::move(bodies),
@@ -916,7 +1507,8 @@ Ephemeris<Frame>::Ephemeris(
       checkpointer_(
           make_not_null_unique<Checkpointer<serialization::Ephemeris>>(
               /*reader=*/nullptr, /*writer=*/nullptr)),
-      reanimator_(/*action=*/nullptr, 0ms) {}
+      reanimator_(/*action=*/nullptr, 0ms),
+      prolongator_(/*action=*/nullptr, 0ms) {}
 
 template<typename Frame>
 void Ephemeris<Frame>::WriteToCheckpointIfNeeded(Instant const& time) const {
@@ -938,7 +1530,12 @@ Ephemeris<Frame>::MakeCheckpointerWriter() {
     return [this](
                not_null<serialization::Ephemeris::Checkpoint*> const message) {
       lock_.AssertReaderHeld();
-      instance_->WriteToMessage(message->mutable_instance());
+      if (instance_ != nullptr) {
+        instance_->WriteToMessage(message->mutable_instance());
+      } else {
+        kepler_splitting_instance_->WriteToMessage(
+            message->mutable_instance());
+      }
     };
   } else {
     return nullptr;
@@ -951,12 +1548,22 @@ Ephemeris<Frame>::MakeCheckpointerReader() {
   if constexpr (base::is_serializable_v<Frame>) {
     return [this](serialization::Ephemeris::Checkpoint const& message) {
       absl::MutexLock l(&lock_);
-      instance_ = FixedStepSizeIntegrator<NewtonianMotionEquation>::Instance::
-          ReadFromMessage(
-              message.instance(),
-              MakeMassiveBodiesNewtonianMotionEquation(),
-              /*append_state=*/
-              std::bind(&Ephemeris::AppendMassiveBodiesState, this, _1));
+      auto const append_state =
+          std::bind(&Ephemeris::AppendMassiveBodiesState, this, _1);
+      if (fixed_step_parameters_.kepler_splitting_integrator_ == nullptr) {
+        instance_ = FixedStepSizeIntegrator<NewtonianMotionEquation>::
+            Instance::ReadFromMessage(
+                message.instance(),
+                MakeMassiveBodiesNewtonianMotionEquation(),
+                append_state);
+      } else {
+        kepler_splitting_ = MakeKeplerSplitting();
+        kepler_splitting_instance_ = NewKeplerSplittingInstance(
+            *kepler_splitting_,
+            KeplerSplittingEquation::SystemState::ReadFromMessage(
+                message.instance().current_state()),
+            append_state);
+      }
       return absl::OkStatus();
     };
   } else {
@@ -965,11 +1572,24 @@ Ephemeris<Frame>::MakeCheckpointerReader() {
 }
 
 template<typename Frame>
-absl::Status Ephemeris<Frame>::Reanimate(Instant const desired_t_min) {
-  absl::btree_set<Instant> checkpoints;
-  {
-    absl::ReaderMutexLock l(&lock_);
-
+absl::Status Ephemeris<Frame>::ProlongAhead(Instant const& t) {
+  while (t_max() < t) {
+    {
+      absl::MutexLock l(&lock_);
+      SolveInstance(instance_time_locked() + fixed_step_parameters_.step_)
+          .IgnoreError();
+    }
+    RETURN_IF_STOPPED;
+  }
+  return absl::OkStatus();
+}
+
+template<typename Frame>
+absl::Status Ephemeris<Frame>::Reanimate(Instant const desired_t_min) {
+  absl::btree_set<Instant> checkpoints;
+  {
+    absl::ReaderMutexLock l(&lock_);
+
     // It is very important that |oldest_reanimated_checkpoint_| be only read by
     // the |reanimator_| thread.  If the caller was trying to determine the set
     // of checkpoints to reanimate it might race with a reanimation already in
@@ -981,83 +1601,206 @@ absl::Status Ephemeris<Frame>::Reanimate(Instant const desired_t_min) {
         oldest_checkpoint_to_reanimate, oldest_reanimated_checkpoint_);
   }
 
-  // This loop integrates all the segments defined by the checkpoints, going
-  // backwards in time.  The last checkpoint is not restored, it just serves as
-  // a limit.
+  // The segments defined by the checkpoints, going backwards in time, as pairs
+  // (t_initial, t_final).  The last checkpoint is not restored, it just serves
+  // as a limit.
+  std::vector<std::pair<Instant, Instant>> segments;
   std::optional<Instant> following_checkpoint;
   for (auto it = checkpoints.crbegin(); it != checkpoints.crend(); ++it) {
     Instant const& checkpoint = *it;
     if (following_checkpoint.has_value()) {
-      RETURN_IF_ERROR(checkpointer_->ReadFromCheckpointAt(
-          checkpoint,
-          [this,
-           t_final = following_checkpoint.value(),
-           t_initial = checkpoint](
-              serialization::Ephemeris::Checkpoint const& message) {
-            if constexpr (base::is_serializable_v<Frame>) {
-              return ReanimateOneCheckpoint(message, t_initial, t_final);
-            } else {
-              return absl::UnknownError(
-                  "No reanimation for non-serializable frames");
-            }
-          }));
+      segments.emplace_back(checkpoint, following_checkpoint.value());
     }
     following_checkpoint = checkpoint;
   }
-  return absl::OkStatus();
+  {
+    absl::MutexLock l(&lock_);
+    segments_to_reanimate_ = segments.size();
+    reanimated_segments_ = 0;
+  }
+
+  // Integrates the segment between |t_initial| and |t_final| without
+  // stitching it.
+  auto const reanimate_segment =
+      [this](Instant const& t_initial,
+             Instant const& t_final) -> absl::StatusOr<ReanimatedSegment> {
+    std::optional<ReanimatedSegment> segment;
+    RETURN_IF_ERROR(checkpointer_->ReadFromCheckpointAt(
+        t_initial,
+        [this, &segment, &t_final, &t_initial](
+            serialization::Ephemeris::Checkpoint const& message)
+            -> absl::Status {
+          if constexpr (base::is_serializable_v<Frame>) {
+            auto reanimated_segment =
+                ReanimateSegment(message, t_initial, t_final);
+            RETURN_IF_ERROR(reanimated_segment.status());
+            segment.emplace(std::move(reanimated_segment).value());
+            return absl::OkStatus();
+          } else {
+            return absl::UnknownError(
+                "No reanimation for non-serializable frames");
+          }
+        }));
+    return std::move(segment).value();
+  };
+
+  if (reanimation_pool_ == nullptr) {
+    for (auto const& [t_initial, t_final] : segments) {
+      auto segment = reanimate_segment(t_initial, t_final);
+      RETURN_IF_ERROR(segment.status());
+      StitchReanimatedSegment(std::move(segment).value());
+    }
+    return absl::OkStatus();
+  }
+
+  // The segments are integrated concurrently on the |reanimation_pool_|, but
+  // they are stitched in order.  At most |reanimation_threads_| segments are in
+  // flight, which bounds the memory used by the segments that are waiting to be
+  // stitched.  The tasks honour the stop requests made to this thread, and they
+  // are all waited for before returning since they refer to |this|.
+  stop_token const st = this_stoppable_thread::get_stop_token();
+  std::deque<std::future<absl::StatusOr<ReanimatedSegment>>> futures;
+  std::size_t next_segment = 0;
+  absl::Status status;
+  for (;;) {
+    while (status.ok() &&
+           next_segment < segments.size() &&
+           futures.size() < static_cast<std::size_t>(reanimation_threads_)) {
+      auto const& [t_initial, t_final] = segments[next_segment];
+      futures.push_back(reanimation_pool_->Add(
+          [&reanimate_segment, st, t_initial = t_initial, t_final = t_final]() {
+            this_stoppable_thread::Scope const scope(st);
+            return reanimate_segment(t_initial, t_final);
+          }));
+      ++next_segment;
+    }
+    if (futures.empty()) {
+      break;
+    }
+    auto segment = futures.front().get();
+    futures.pop_front();
+    if (status.ok()) {
+      if (segment.ok()) {
+        StitchReanimatedSegment(std::move(segment).value());
+      } else {
+        status = segment.status();
+      }
+    }
+  }
+  return status;
 }
 
 template<typename Frame>
-absl::Status Ephemeris<Frame>::ReanimateOneCheckpoint(
+auto Ephemeris<Frame>::ReanimateSegment(
     serialization::Ephemeris::Checkpoint const& message,
     Instant const& t_initial,
-    Instant const& t_final) {
+    Instant const& t_final) -> absl::StatusOr<ReanimatedSegment> {
   LOG(INFO) << "Reanimating segment from " << t_initial << " to " << t_final;
 
-  // Create new trajectories and initialize them from the checkpoint at
-  // t_initial.
-  std::vector<not_null<std::unique_ptr<ContinuousTrajectory<Frame>>>>
-      trajectories;
+  ReanimatedSegment segment;
+  segment.t_initial = t_initial;
+  auto& trajectories = segment.trajectories;
   for (int i = 0; i < trajectories_.size(); ++i) {
     trajectories.emplace_back(std::make_unique<ContinuousTrajectory<Frame>>(
         fixed_step_parameters_.step_,
         accuracy_parameters_.fitting_tolerance_));
+  }
+
+  std::uint64_t fingerprint = 0;
+  if (reanimation_cache_ != nullptr) {
+    fingerprint = ReanimationCacheFingerprint(message, t_initial, t_final);
+  }
+  if (reanimation_cache_ != nullptr &&
+      reanimation_cache_->ReadSegment(fingerprint, trajectories)) {
+    LOG(INFO) << "Segment read from the reanimation cache";
+    // The cache only holds the polynomials.  Restore the other members of the
+    // new trajectories from the checkpoint at t_final, which is the state in
+    // which the integration would have left them.
+    for (int i = 0; i < trajectories_.size(); ++i) {
+      CHECK_OK(trajectories_[i]->ReadFromCheckpointAt(
+          t_final, trajectories[i]->MakeCheckpointerReader()));
+    }
+  } else {
+    // Initialize the new trajectories from the checkpoint at t_initial.
+    for (int i = 0; i < trajectories_.size(); ++i) {
+      // This statement is subtle: it restores the checkpoints of the
+      // trajectories of this ephemeris, but thanks to the newly-created reader,
+      // it restores them into the local trajectories.
+      CHECK_OK(trajectories_[i]->ReadFromCheckpointAt(
+          t_initial, trajectories[i]->MakeCheckpointerReader()));
+    }
 
-    // This statement is subtle: it restores the checkpoints of the trajectories
-    // of this ephemeris, but thanks to the newly-created reader, it restores
-    // them into the local trajectories.
-    CHECK_OK(trajectories_[i]->ReadFromCheckpointAt(
-        t_initial, trajectories[i]->MakeCheckpointerReader()));
+    // Reconstruct the integrator instance from the current checkpoint.
+    auto append_massive_bodies_state =
+        [this, &trajectories](
+            typename NewtonianMotionEquation::SystemState const& state) {
+          AppendMassiveBodiesStateToTrajectories(state, trajectories);
+        };
+    // Do the integration.  After this step the t_max() of the trajectories may
+    // be before t_final because there may be last_points_ that haven't been
+    // put in a series.  Don't proceed in case of error, we would run into a gap
+    // when trying to stitch the trajectories.
+    if (fixed_step_parameters_.kepler_splitting_integrator_ == nullptr) {
+      auto const instance = FixedStepSizeIntegrator<NewtonianMotionEquation>::
+          Instance::ReadFromMessage(message.instance(),
+                                    MakeMassiveBodiesNewtonianMotionEquation(),
+                                    append_massive_bodies_state);
+      RETURN_IF_ERROR(instance->Solve(t_final));
+    } else {
+      auto const splitting = MakeKeplerSplitting();
+      auto const instance = NewKeplerSplittingInstance(
+          *splitting,
+          KeplerSplittingEquation::SystemState::ReadFromMessage(
+              message.instance().current_state()),
+          append_massive_bodies_state);
+      RETURN_IF_ERROR(instance->Solve(t_final));
+    }
+
+    if (reanimation_cache_ != nullptr) {
+      segment.cache_fingerprint = fingerprint;
+    }
   }
 
-  // Reconstruct the integrator instance from the current checkpoint.
-  auto append_massive_bodies_state =
-      [&trajectories](
-          typename NewtonianMotionEquation::SystemState const& state) {
-        AppendMassiveBodiesStateToTrajectories(state, trajectories);
-      };
-  auto const instance = FixedStepSizeIntegrator<NewtonianMotionEquation>::
-      Instance::ReadFromMessage(message.instance(),
-                                MakeMassiveBodiesNewtonianMotionEquation(),
-                                append_massive_bodies_state);
+  return segment;
+}
 
-  // Do the integration.  After this step the t_max() of the trajectories may
-  // be before t_final because there may be last_points_ that haven't been put
-  // in a series.  Don't proceed in case of error, we would run into a gap when
-  // trying to stitch the trajectories.
-  RETURN_IF_ERROR(instance->Solve(t_final));
+template<typename Frame>
+void Ephemeris<Frame>::StitchReanimatedSegment(ReanimatedSegment segment) {
+  if (segment.cache_fingerprint.has_value()) {
+    reanimation_cache_->WriteSegment(segment.cache_fingerprint.value(),
+                                     segment.trajectories);
+  }
 
   // Stitch the local trajectories to the ones in this ephemeris and record that
   // we will not reanimate this checkpoint again.
-  {
-    absl::MutexLock l(&lock_);
-    for (int i = 0; i < trajectories_.size(); ++i) {
-      trajectories_[i]->Prepend(std::move(*trajectories[i]));
-    }
-    oldest_reanimated_checkpoint_ = t_initial;
+  absl::MutexLock l(&lock_);
+  for (int i = 0; i < trajectories_.size(); ++i) {
+    trajectories_[i]->Prepend(std::move(*segment.trajectories[i]));
   }
+  oldest_reanimated_checkpoint_ = segment.t_initial;
+  ++reanimated_segments_;
+}
 
-  return absl::OkStatus();
+template<typename Frame>
+std::uint64_t Ephemeris<Frame>::ReanimationCacheFingerprint(
+    serialization::Ephemeris::Checkpoint const& message,
+    Instant const& t_initial,
+    Instant const& t_final) const {
+  std::uint64_t fingerprint = Fingerprint2011(SerializeAsBytes(message).get());
+  for (auto const& trajectory : trajectories_) {
+    CHECK_OK(trajectory->ReadFromCheckpointAt(
+        t_initial,
+        [&fingerprint](
+            serialization::ContinuousTrajectory::Checkpoint const& checkpoint) {
+          fingerprint = FingerprintCat2011(
+              fingerprint, Fingerprint2011(SerializeAsBytes(checkpoint).get()));
+          return absl::OkStatus();
+        }));
+  }
+  serialization::Point t_final_message;
+  t_final.WriteToMessage(&t_final_message);
+  return FingerprintCat2011(
+      fingerprint, Fingerprint2011(SerializeAsBytes(t_final_message).get()));
 }
 
 template<typename Frame>
@@ -1092,17 +1835,25 @@ template<typename ContinuousTrajectoryPtr>
 std::vector<absl::Status>
 Ephemeris<Frame>::AppendMassiveBodiesStateToTrajectories(
     typename NewtonianMotionEquation::SystemState const& state,
-    std::vector<not_null<ContinuousTrajectoryPtr>> const& trajectories) {
-  std::vector<absl::Status> statuses;
-  statuses.reserve(trajectories.size());
+    std::vector<not_null<ContinuousTrajectoryPtr>> const& trajectories)
+    const {
+  std::vector<absl::Status> statuses(trajectories.size());
   Instant const time = state.time.value;
-  int index = 0;
-  for (auto& trajectory : trajectories) {
-    statuses.push_back(trajectory->Append(
+  auto const append = [&state, &statuses, &time, &trajectories](
+                          int const index) {
+    statuses[index] = trajectories[index]->Append(
         time,
         DegreesOfFreedom<Frame>(state.positions[index].value,
-                                state.velocities[index].value)));
-    ++index;
+                                state.velocities[index].value));
+  };
+  // The trajectories are independent, and an |Append| that fits a polynomial
+  // is expensive, so the bodies are distributed over the threads if possible.
+  if (massive_bodies_pool_ != nullptr) {
+    RunOnMassiveBodiesThreads(trajectories.size(), append);
+  } else {
+    for (int index = 0; index < trajectories.size(); ++index) {
+      append(index);
+    }
   }
   return statuses;
 }
@@ -1122,6 +1873,21 @@ void Ephemeris<Frame>::AppendMasslessBodiesStateToTrajectories(
   }
 }
 
+template<typename Frame>
+void Ephemeris<Frame>::AppendMasslessBodiesStateToEventDetectors(
+    typename NewtonianMotionEquation::SystemState const& state,
+    std::vector<EventDetector<Frame>*> const& event_detectors) {
+  Instant const time = state.time.value;
+  for (int index = 0; index < event_detectors.size(); ++index) {
+    if (event_detectors[index] != nullptr) {
+      event_detectors[index]->Append(
+          time,
+          DegreesOfFreedom<Frame>(state.positions[index].value,
+                                  state.velocities[index].value));
+    }
+  }
+}
+
 template<typename Frame>
 typename Ephemeris<Frame>::NewtonianMotionEquation
 Ephemeris<Frame>::MakeMassiveBodiesNewtonianMotionEquation() {
@@ -1138,10 +1904,75 @@ Ephemeris<Frame>::MakeMassiveBodiesNewtonianMotionEquation() {
   return equation;
 }
 
+template<typename Frame>
+not_null<std::unique_ptr<KeplerSplitting<Frame>>>
+Ephemeris<Frame>::MakeKeplerSplitting() {
+  // The splitting uses the order of the system state.
+  std::vector<not_null<MassiveBody const*>> bodies;
+  std::vector<Position<Frame>> positions;
+  for (auto const& body : bodies_) {
+    bodies.push_back(body.get());
+    positions.push_back(
+        kepler_splitting_positions_[FindOrDie(unowned_bodies_indices_,
+                                              body.get())]);
+  }
+  return make_not_null_unique<KeplerSplitting<Frame>>(
+      std::move(bodies),
+      positions,
+      MakeMassiveBodiesNewtonianMotionEquation().compute_acceleration);
+}
+
+template<typename Frame>
+not_null<std::unique_ptr<typename Integrator<
+    typename Ephemeris<Frame>::KeplerSplittingEquation>::Instance>>
+Ephemeris<Frame>::NewKeplerSplittingInstance(
+    KeplerSplitting<Frame>& splitting,
+    typename KeplerSplittingEquation::SystemState const& initial_state,
+    typename Integrator<NewtonianMotionEquation>::AppendState const&
+        append_state) const {
+  IntegrationProblem<KeplerSplittingEquation> problem;
+  problem.equation = splitting.equation();
+  problem.initial_state = initial_state;
+  // The vectors of |state| are reused across steps.
+  auto append_kepler_splitting_state =
+      [append_state,
+       state = typename NewtonianMotionEquation::SystemState()](
+          typename KeplerSplittingEquation::SystemState const&
+              kepler_splitting_state) mutable {
+        auto const& [positions, velocities] = kepler_splitting_state.y;
+        state.positions.assign(positions.begin(), positions.end());
+        state.velocities.assign(velocities.begin(), velocities.end());
+        state.time = kepler_splitting_state.time;
+        append_state(state);
+      };
+  return fixed_step_parameters_.kepler_splitting_integrator_->NewInstance(
+      problem,
+      std::move(append_kepler_splitting_state),
+      fixed_step_parameters_.step_);
+}
+
+template<typename Frame>
+absl::Status Ephemeris<Frame>::SolveInstance(Instant const& t_final) {
+  if (instance_ != nullptr) {
+    return instance_->Solve(t_final);
+  } else {
+    return kepler_splitting_instance_->Solve(t_final);
+  }
+}
+
 template<typename Frame>
 Instant Ephemeris<Frame>::instance_time() const {
   absl::ReaderMutexLock l(&lock_);
-  return instance_->time().value;
+  return instance_time_locked();
+}
+
+template<typename Frame>
+Instant Ephemeris<Frame>::instance_time_locked() const {
+  if (instance_ != nullptr) {
+    return instance_->time().value;
+  } else {
+    return kepler_splitting_instance_->time().value;
+  }
 }
 
 template<typename Frame>
@@ -1149,7 +1980,7 @@ Instant Ephemeris<Frame>::t_min_locked() const {
   lock_.AssertReaderHeld();
   Instant t_min = bodies_to_trajectories_.begin()->second->t_min();
   for (auto const& [_, trajectory] : bodies_to_trajectories_) {
-    t_min = std::max(t_min, trajectory->t_min_locked());
+    t_min = std::max(t_min, trajectory->t_min());
   }
   return t_min;
 }
@@ -1159,11 +1990,119 @@ Instant Ephemeris<Frame>::t_max_locked() const {
   lock_.AssertReaderHeld();
   Instant t_max = bodies_to_trajectories_.begin()->second->t_max();
   for (auto const& [_, trajectory] : bodies_to_trajectories_) {
-    t_max = std::min(t_max, trajectory->t_max_locked());
+    t_max = std::min(t_max, trajectory->t_max());
   }
   return t_max;
 }
 
+template<typename Frame>
+void Ephemeris<Frame>::EvaluateMassiveBodiesPositions(
+    Instant const& t,
+    bool const use_positions_cache,
+    std::vector<Position<Frame>>& positions) const {
+  if (!use_positions_cache) {
+    EvaluatePositions(t, trajectories_, positions);
+    return;
+  }
+
+  double const time = (t - Instant()) / Second;
+  positions.resize(bodies_.size());
+
+  // Returns true iff |entry| is for |time|, in which case |positions| has been
+  // filled from it.
+  auto const read_entry =
+      [&positions, time](MassiveBodiesPositionsCacheEntry const& entry) {
+    std::uint64_t const sequence =
+        entry.sequence.load(std::memory_order_acquire);
+    if (sequence % 2 != 0 ||
+        entry.time.load(std::memory_order_relaxed) != time) {
+      return false;
+    }
+    auto const& coordinates = entry.coordinates;
+    for (int i = 0; i < positions.size(); ++i) {
+      positions[i] =
+          Frame::origin +
+          Displacement<Frame>(
+              {coordinates[3 * i].load(std::memory_order_relaxed) * Metre,
+               coordinates[3 * i + 1].load(std::memory_order_relaxed) * Metre,
+               coordinates[3 * i + 2].load(std::memory_order_relaxed) * Metre});
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return entry.sequence.load(std::memory_order_relaxed) == sequence;
+  };
+
+  for (auto const& entry : massive_bodies_positions_cache_) {
+    if (read_entry(entry)) {
+      massive_bodies_positions_cache_hits_.fetch_add(1,
+                                                     std::memory_order_relaxed);
+      return;
+    }
+  }
+
+  // Check again after taking the lock, as another thread may have computed the
+  // positions in the meantime.  The first thread to get here computes the
+  // positions and the others reuse them.
+  absl::MutexLock l(&massive_bodies_positions_cache_lock_);
+  for (auto const& entry : massive_bodies_positions_cache_) {
+    if (read_entry(entry)) {
+      massive_bodies_positions_cache_hits_.fetch_add(1,
+                                                     std::memory_order_relaxed);
+      return;
+    }
+  }
+  massive_bodies_positions_cache_misses_.fetch_add(1,
+                                                   std::memory_order_relaxed);
+  EvaluatePositions(t, trajectories_, positions);
+
+  int& next_entry = next_massive_bodies_positions_cache_entry_;
+  auto& entry = massive_bodies_positions_cache_[next_entry];
+  next_entry = (next_entry + 1) % massive_bodies_positions_cache_size;
+  std::uint64_t const sequence = entry.sequence.load(std::memory_order_relaxed);
+  entry.sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  entry.time.store(time, std::memory_order_relaxed);
+  for (int i = 0; i < positions.size(); ++i) {
+    auto const coordinates = (positions[i] - Frame::origin).coordinates();
+    entry.coordinates[3 * i].store(coordinates.x / Metre,
+                                   std::memory_order_relaxed);
+    entry.coordinates[3 * i + 1].store(coordinates.y / Metre,
+                                       std::memory_order_relaxed);
+    entry.coordinates[3 * i + 2].store(coordinates.z / Metre,
+                                       std::memory_order_relaxed);
+  }
+  entry.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::EvaluatePositions(
+    Instant const& t,
+    std::vector<not_null<ContinuousTrajectory<Frame>*>> const& trajectories,
+    std::vector<Position<Frame>>& positions) const {
+  positions.resize(trajectories.size());
+  // The trajectories are appended to in lockstep, so their polynomials have the
+  // same boundaries, except after a |Prepend| of a trajectory whose boundaries
+  // differ.  The lookup for the first trajectory is most often reused by the
+  // others.
+  std::int64_t hint = 0;
+  for (int i = 0; i < trajectories.size(); ++i) {
+    positions[i] = trajectories[i]->EvaluatePosition(t, hint);
+  }
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::EvaluateDegreesOfFreedom(
+    Instant const& t,
+    std::vector<not_null<ContinuousTrajectory<Frame>*>> const& trajectories,
+    std::vector<DegreesOfFreedom<Frame>>& degrees_of_freedom) const {
+  degrees_of_freedom.clear();
+  degrees_of_freedom.reserve(trajectories.size());
+  std::int64_t hint = 0;
+  for (auto const trajectory : trajectories) {
+    degrees_of_freedom.push_back(
+        trajectory->EvaluateDegreesOfFreedom(t, hint));
+  }
+}
+
 template<typename Frame>
 template<bool body1_is_oblate,
          bool body2_is_oblate,
@@ -1241,18 +2180,30 @@ Ephemeris<Frame>::ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies(
     Instant const& t,
     MassiveBody const& body1,
     std::size_t const b1,
+    Position<Frame> const& position1,
     std::vector<Position<Frame>> const& positions,
     std::vector<Vector<Acceleration, Frame>>& accelerations) const {
-  lock_.AssertReaderHeld();
   GravitationalParameter const& μ1 = body1.gravitational_parameter();
-  auto const& trajectory1 = *trajectories_[b1];
-  Position<Frame> const position1 = trajectory1.EvaluatePositionLocked(t);
   Length const body1_collision_radius =
       min_radius_tolerance * body1.min_radius();
   // TODO(phl): Use std::to_underlying when we have C++23.
   auto error = static_cast<std::underlying_type_t<absl::StatusCode>>(
       absl::StatusCode::kOk);
 
+  // The buffers are reused across calls on the same thread.
+  thread_local std::vector<Displacement<Frame>> displacements;
+  thread_local std::vector<
+      Vector<Quotient<Acceleration, GravitationalParameter>, Frame>>
+      spherical_harmonics_effects;
+  if (body1_is_oblate) {
+    ComputeSphericalHarmonicsEffects(t,
+                                     b1,
+                                     position1,
+                                     positions,
+                                     displacements,
+                                     spherical_harmonics_effects);
+  }
+
   for (std::size_t b2 = 0; b2 < positions.size(); ++b2) {
     // A vector from the center of |b2| to the center of |b1|.
     Displacement<Frame> const Δq = position1 - positions[b2];
@@ -1271,33 +2222,81 @@ Ephemeris<Frame>::ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies(
     accelerations[b2] += Δq * μ1_over_Δq³;
 
     if (body1_is_oblate) {
-      Vector<Quotient<Acceleration,
-                      GravitationalParameter>, Frame> const
-          spherical_harmonics_effect =
-              geopotentials_[b1].GeneralSphericalHarmonicsAcceleration(
-                  t,
-                  -Δq,
-                  Δq_norm,
-                  Δq²,
-                  one_over_Δq³);
-      accelerations[b2] += μ1 * spherical_harmonics_effect;
+      accelerations[b2] += μ1 * spherical_harmonics_effects[b2];
     }
   }
   return error;
 }
 
+template<typename Frame>
+template<bool body1_is_oblate>
+std::underlying_type_t<absl::StatusCode>
+Ephemeris<Frame>::ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies(
+    Instant const& t,
+    MassiveBody const& body1,
+    std::size_t const b1,
+    Position<Frame> const& position1,
+    std::vector<Position<Frame>> const& positions,
+    MasslessBodiesAccelerations<Frame>& accelerations) const {
+  GravitationalParameter const& μ1 = body1.gravitational_parameter();
+  Length const body1_collision_radius =
+      min_radius_tolerance * body1.min_radius();
+
+  bool const collided = accelerations.AddPointMassAccelerations(
+      position1, μ1, body1_collision_radius);
+
+  if (body1_is_oblate) {
+    // The spherical harmonics are added after the central force for each
+    // massless body, so the order of the sums is the same as in the scalar
+    // code.
+    // The buffers are reused across calls on the same thread.
+    thread_local std::vector<Displacement<Frame>> displacements;
+    thread_local std::vector<
+        Vector<Quotient<Acceleration, GravitationalParameter>, Frame>>
+        spherical_harmonics_effects;
+    ComputeSphericalHarmonicsEffects(t,
+                                     b1,
+                                     position1,
+                                     positions,
+                                     displacements,
+                                     spherical_harmonics_effects);
+    for (std::size_t b2 = 0; b2 < positions.size(); ++b2) {
+      accelerations.Add(b2, μ1 * spherical_harmonics_effects[b2]);
+    }
+  }
+  return static_cast<std::underlying_type_t<absl::StatusCode>>(
+      collided ? absl::StatusCode::kOutOfRange : absl::StatusCode::kOk);
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::ComputeSphericalHarmonicsEffects(
+    Instant const& t,
+    std::size_t const b1,
+    Position<Frame> const& position1,
+    std::vector<Position<Frame>> const& positions,
+    std::vector<Displacement<Frame>>& displacements,
+    std::vector<Vector<Quotient<Acceleration, GravitationalParameter>, Frame>>&
+        spherical_harmonics_effects) const {
+  displacements.resize(positions.size());
+  for (std::size_t b2 = 0; b2 < positions.size(); ++b2) {
+    // A vector from the center of |b1| to the center of |b2|.  This is exactly
+    // the opposite of the vector used for the central force.
+    displacements[b2] = positions[b2] - position1;
+  }
+  geopotentials_[b1].GeneralSphericalHarmonicsAccelerations(
+      t, displacements, spherical_harmonics_effects);
+}
+
 template<typename Frame>
 template<bool body1_is_oblate>
 void Ephemeris<Frame>::ComputeGravitationalPotentialsOfMassiveBody(
     Instant const& t,
     MassiveBody const& body1,
-    std::size_t b1,
+    std::size_t const b1,
+    Position<Frame> const& position1,
     std::vector<Position<Frame>> const& positions,
     std::vector<SpecificEnergy>& potentials) const {
-  lock_.AssertReaderHeld();
   GravitationalParameter const& μ1 = body1.gravitational_parameter();
-  auto const& trajectory1 = *trajectories_[b1];
-  Position<Frame> const position1 = trajectory1.EvaluatePositionLocked(t);
 
   for (std::size_t b2 = 0; b2 < positions.size(); ++b2) {
     // A vector from the center of |b2| to the center of |b1|.
@@ -1326,6 +2325,140 @@ void Ephemeris<Frame>::ComputeGravitationalPotentialsOfMassiveBody(
   }
 }
 
+template<typename Frame>
+void Ephemeris<Frame>::
+ComputeGravitationalAccelerationBetweenMassiveBodiesInSegment(
+    Instant const& t,
+    MassiveBodiesSegment const& segment,
+    std::vector<Position<Frame>> const& positions,
+    std::vector<Vector<Acceleration, Frame>>& accelerations) const {
+  std::size_t const b1 = segment.b1;
+  MassiveBody const& body1 = *bodies_[b1];
+  std::size_t const number_of_oblate_bodies = number_of_oblate_bodies_;
+  if (b1 < number_of_oblate_bodies) {
+    ComputeGravitationalAccelerationByMassiveBodyOnMassiveBodies<
+        /*body1_is_oblate=*/true,
+        /*body2_is_oblate=*/true>(
+        t,
+        body1, b1,
+        /*bodies2=*/bodies_,
+        /*b2_begin=*/segment.b2_begin,
+        /*b2_end=*/std::min(segment.b2_end, number_of_oblate_bodies),
+        positions, accelerations, geopotentials_);
+    ComputeGravitationalAccelerationByMassiveBodyOnMassiveBodies<
+        /*body1_is_oblate=*/true,
+        /*body2_is_oblate=*/false>(
+        t,
+        body1, b1,
+        /*bodies2=*/bodies_,
+        /*b2_begin=*/std::max(segment.b2_begin, number_of_oblate_bodies),
+        /*b2_end=*/segment.b2_end,
+        positions, accelerations, geopotentials_);
+  } else {
+    ComputeGravitationalAccelerationByMassiveBodyOnMassiveBodies<
+        /*body1_is_oblate=*/false,
+        /*body2_is_oblate=*/false>(
+        t,
+        body1, b1,
+        /*bodies2=*/bodies_,
+        /*b2_begin=*/segment.b2_begin,
+        /*b2_end=*/segment.b2_end,
+        positions, accelerations, geopotentials_);
+  }
+}
+
+template<typename Frame>
+Vector<Acceleration, Frame> Ephemeris<Frame>::
+ComputeGravitationalAccelerationOnMassiveBodyInSerialOrder(
+    Instant const& t,
+    std::size_t const b,
+    std::vector<Position<Frame>> const& positions) const {
+  // The serial computation goes through the pairs (b1, b2), b1 < b2, row by
+  // row, and for each pair adds to the accelerations of both bodies the central
+  // force, then the effect of the geopotential of b1, then that of b2.  The
+  // displacement is always from b2 to b1.  We reproduce the operations that
+  // affect the acceleration of |b| exactly.
+  std::size_t const number_of_bodies = bodies_.size();
+  std::size_t const number_of_oblate_bodies = number_of_oblate_bodies_;
+  Vector<Acceleration, Frame> acceleration;
+  for (std::size_t other = 0; other < number_of_bodies; ++other) {
+    if (other == b) {
+      continue;
+    }
+    bool const b_is_b1 = b < other;
+    std::size_t const b1 = b_is_b1 ? b : other;
+    std::size_t const b2 = b_is_b1 ? other : b;
+    GravitationalParameter const& μ_other =
+        bodies_[other]->gravitational_parameter();
+
+    Displacement<Frame> const Δq = positions[b1] - positions[b2];
+    Square<Length> const Δq² = Δq.Norm²();
+    Length const Δq_norm = Sqrt(Δq²);
+    Exponentiation<Length, -3> const one_over_Δq³ = Δq_norm / (Δq² * Δq²);
+
+    auto const μ_other_over_Δq³ = μ_other * one_over_Δq³;
+    if (b_is_b1) {
+      acceleration -= Δq * μ_other_over_Δq³;
+    } else {
+      acceleration += Δq * μ_other_over_Δq³;
+    }
+
+    if (b1 < number_of_oblate_bodies) {
+      Vector<Quotient<Acceleration,
+                      GravitationalParameter>, Frame> const
+          spherical_harmonics_effect =
+              geopotentials_[b1].GeneralSphericalHarmonicsAcceleration(
+                  t,
+                  -Δq,
+                  Δq_norm,
+                  Δq²,
+                  one_over_Δq³);
+      if (b_is_b1) {
+        acceleration -= μ_other * spherical_harmonics_effect;
+      } else {
+        acceleration += μ_other * spherical_harmonics_effect;
+      }
+    }
+    if (b2 < number_of_oblate_bodies) {
+      Vector<Quotient<Acceleration,
+                      GravitationalParameter>, Frame> const
+          degree_2_zonal_effect2 =
+              geopotentials_[b2].GeneralSphericalHarmonicsAcceleration(
+                  t,
+                  Δq,
+                  Δq_norm,
+                  Δq²,
+                  one_over_Δq³);
+      if (b_is_b1) {
+        acceleration += μ_other * degree_2_zonal_effect2;
+      } else {
+        acceleration -= μ_other * degree_2_zonal_effect2;
+      }
+    }
+  }
+  return acceleration;
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::RunOnMassiveBodiesThreads(
+    int const size,
+    std::function<void(int)> const& task) const {
+  std::atomic<int> next_index = 0;
+  auto const run = [&next_index, size, &task]() {
+    for (int i = next_index++; i < size; i = next_index++) {
+      task(i);
+    }
+  };
+  std::vector<std::future<void>> futures;
+  for (int i = 1; i < massive_bodies_threads_; ++i) {
+    futures.push_back(massive_bodies_pool_->Add(run));
+  }
+  run();
+  for (auto const& future : futures) {
+    future.wait();
+  }
+}
+
 template<typename Frame>
 absl::Status
 Ephemeris<Frame>::ComputeGravitationalAccelerationBetweenAllMassiveBodies(
@@ -1336,6 +2469,39 @@ Ephemeris<Frame>::ComputeGravitationalAccelerationBetweenAllMassiveBodies(
 
   accelerations.assign(accelerations.size(), Vector<Acceleration, Frame>());
 
+  if (massive_bodies_pool_ != nullptr) {
+    if (massive_bodies_identical_to_serial_) {
+      RunOnMassiveBodiesThreads(
+          accelerations.size(),
+          [this, &t, &positions, &accelerations](int const b) {
+            accelerations[b] =
+                ComputeGravitationalAccelerationOnMassiveBodyInSerialOrder(
+                    t, b, positions);
+          });
+    } else {
+      std::vector<std::vector<Vector<Acceleration, Frame>>>
+          tile_accelerations(massive_bodies_tiles_.size());
+      RunOnMassiveBodiesThreads(
+          massive_bodies_tiles_.size(),
+          [this, &t, &positions, &accelerations, &tile_accelerations](
+              int const tile) {
+            tile_accelerations[tile].resize(accelerations.size());
+            for (auto const& segment : massive_bodies_tiles_[tile]) {
+              ComputeGravitationalAccelerationBetweenMassiveBodiesInSegment(
+                  t, segment, positions, tile_accelerations[tile]);
+            }
+          });
+      // The reduction is done in the order of the tiles, which makes the
+      // result deterministic.
+      for (auto const& accelerations_of_tile : tile_accelerations) {
+        for (std::size_t b = 0; b < accelerations.size(); ++b) {
+          accelerations[b] += accelerations_of_tile[b];
+        }
+      }
+    }
+    return absl::OkStatus();
+  }
+
   for (std::size_t b1 = 0; b1 < number_of_oblate_bodies_; ++b1) {
     MassiveBody const& body1 = *bodies_[b1];
     ComputeGravitationalAccelerationByMassiveBodyOnMassiveBodies<
@@ -1382,6 +2548,24 @@ Ephemeris<Frame>::
 ComputeGravitationalAccelerationByAllMassiveBodiesOnMasslessBodies(
     Instant const& t,
     std::vector<Position<Frame>> const& positions,
+    std::vector<Vector<Acceleration, Frame>>& accelerations,
+    bool const use_positions_cache) const {
+  // No locking: the trajectories are only extended, and the positions at a
+  // given time never change once they can be evaluated.
+  // The buffer is reused across calls on the same thread.
+  thread_local std::vector<Position<Frame>> massive_positions;
+  EvaluateMassiveBodiesPositions(t, use_positions_cache, massive_positions);
+  return ComputeGravitationalAccelerationByAllMassiveBodiesOnMasslessBodies(
+      t, massive_positions, positions, accelerations);
+}
+
+template<typename Frame>
+absl::StatusCode
+Ephemeris<Frame>::
+ComputeGravitationalAccelerationByAllMassiveBodiesOnMasslessBodies(
+    Instant const& t,
+    std::vector<Position<Frame>> const& massive_positions,
+    std::vector<Position<Frame>> const& positions,
     std::vector<Vector<Acceleration, Frame>>& accelerations) const {
   CHECK_EQ(positions.size(), accelerations.size());
   accelerations.assign(accelerations.size(), Vector<Acceleration, Frame>());
@@ -1389,14 +2573,41 @@ ComputeGravitationalAccelerationByAllMassiveBodiesOnMasslessBodies(
   auto error = static_cast<std::underlying_type_t<absl::StatusCode>>(
       absl::StatusCode::kOk);
 
-  // Locking ensures that we see a consistent state of all the trajectories.
-  absl::ReaderMutexLock l(&lock_);
+  if (positions.size() >= min_massless_bodies_for_vectorization) {
+    // The buffers are reused across calls on the same thread.
+    thread_local MasslessBodiesAccelerations<Frame> soa_accelerations;
+    soa_accelerations.Gather(positions);
+    for (std::size_t b1 = 0; b1 < number_of_oblate_bodies_; ++b1) {
+      MassiveBody const& body1 = *bodies_[b1];
+      error |= ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies<
+                   /*body1_is_oblate=*/true>(
+                   t,
+                   body1, b1, massive_positions[b1],
+                   positions,
+                   soa_accelerations);
+    }
+    for (std::size_t b1 = number_of_oblate_bodies_;
+         b1 < number_of_oblate_bodies_ +
+              number_of_spherical_bodies_;
+         ++b1) {
+      MassiveBody const& body1 = *bodies_[b1];
+      error |= ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies<
+                   /*body1_is_oblate=*/false>(
+                   t,
+                   body1, b1, massive_positions[b1],
+                   positions,
+                   soa_accelerations);
+    }
+    soa_accelerations.Scatter(accelerations);
+    return static_cast<absl::StatusCode>(error);
+  }
+
   for (std::size_t b1 = 0; b1 < number_of_oblate_bodies_; ++b1) {
     MassiveBody const& body1 = *bodies_[b1];
     error |= ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies<
                  /*body1_is_oblate=*/true>(
                  t,
-                 body1, b1,
+                 body1, b1, massive_positions[b1],
                  positions,
                  accelerations);
   }
@@ -1408,13 +2619,310 @@ ComputeGravitationalAccelerationByAllMassiveBodiesOnMasslessBodies(
     error |= ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies<
                  /*body1_is_oblate=*/false>(
                  t,
-                 body1, b1,
+                 body1, b1, massive_positions[b1],
                  positions,
                  accelerations);
   }
   return static_cast<absl::StatusCode>(error);
 }
 
+template<typename Frame>
+void Ephemeris<Frame>::
+ComputeGravitationalAccelerationByAllMassiveBodiesOnMasslessBodies(
+    Instant const& t,
+    std::vector<Position<Frame>> const& positions,
+    std::vector<Vector<Acceleration, Frame>>& accelerations,
+    std::vector<bool>& collided,
+    bool const use_positions_cache) const {
+  CHECK_EQ(positions.size(), accelerations.size());
+  CHECK_EQ(positions.size(), collided.size());
+  int const size = positions.size();
+  int const number_of_ranges =
+      (size + massless_bodies_per_range - 1) / massless_bodies_per_range;
+  std::vector<absl::StatusCode> errors(number_of_ranges);
+  std::thread::id const calling_thread = std::this_thread::get_id();
+  auto const compute_range = [this, &accelerations, calling_thread, &errors,
+                              &positions, size, &t, use_positions_cache](
+                                 int const range) {
+    int const begin = range * massless_bodies_per_range;
+    int const end = std::min(begin + massless_bodies_per_range, size);
+    if (std::this_thread::get_id() != calling_thread) {
+      massless_bodies_ranges_computed_concurrently_.fetch_add(
+          1, std::memory_order_relaxed);
+    }
+    // The buffers are reused across calls on the same thread.
+    thread_local std::vector<Position<Frame>> range_positions;
+    thread_local std::vector<Vector<Acceleration, Frame>> range_accelerations;
+    range_positions.assign(positions.begin() + begin, positions.begin() + end);
+    range_accelerations.resize(end - begin);
+    errors[range] =
+        ComputeGravitationalAccelerationByAllMassiveBodiesOnMasslessBodies(
+            t, range_positions, range_accelerations, use_positions_cache);
+    std::copy(range_accelerations.begin(),
+              range_accelerations.end(),
+              accelerations.begin() + begin);
+  };
+  if (massive_bodies_pool_ != nullptr) {
+    RunOnMassiveBodiesThreads(number_of_ranges, compute_range);
+  } else {
+    for (int range = 0; range < number_of_ranges; ++range) {
+      compute_range(range);
+    }
+  }
+
+  // Collisions are rare, so it is cheaper to look for the massless bodies that
+  // collided than to keep track of them in the vectorized computation.
+  std::vector<Position<Frame>> position(1);
+  std::vector<Vector<Acceleration, Frame>> acceleration(1);
+  for (int range = 0; range < number_of_ranges; ++range) {
+    if (errors[range] == absl::StatusCode::kOk) {
+      continue;
+    }
+    int const begin = range * massless_bodies_per_range;
+    int const end = std::min(begin + massless_bodies_per_range, size);
+    for (int i = begin; i < end; ++i) {
+      position[0] = positions[i];
+      if (ComputeGravitationalAccelerationByAllMassiveBodiesOnMasslessBodies(
+              t, position, acceleration, use_positions_cache) !=
+          absl::StatusCode::kOk) {
+        collided[i] = true;
+      }
+    }
+  }
+}
+
+template<typename Frame>
+absl::StatusCode
+Ephemeris<Frame>::
+ComputeGravitationalAccelerationByAllMassiveBodiesOnMasslessBodies(
+    Instant const& t,
+    std::vector<Position<Frame>> const& positions,
+    std::vector<Vector<Acceleration, Frame>>& accelerations,
+    std::vector<PerturberCulling>& cullings) const {
+  // The buffer is reused across calls on the same thread.
+  thread_local std::vector<Position<Frame>> massive_positions;
+  EvaluateMassiveBodiesPositions(
+      t, /*use_positions_cache=*/false, massive_positions);
+  return ComputeGravitationalAccelerationByAllMassiveBodiesOnMasslessBodies(
+      t, massive_positions, positions, accelerations, cullings);
+}
+
+template<typename Frame>
+absl::StatusCode
+Ephemeris<Frame>::
+ComputeGravitationalAccelerationByAllMassiveBodiesOnMasslessBodies(
+    Instant const& t,
+    std::vector<Position<Frame>> const& massive_positions,
+    std::vector<Position<Frame>> const& positions,
+    std::vector<Vector<Acceleration, Frame>>& accelerations,
+    std::vector<PerturberCulling>& cullings) const {
+  if (cullings.empty()) {
+    return ComputeGravitationalAccelerationByAllMassiveBodiesOnMasslessBodies(
+        t, massive_positions, positions, accelerations);
+  }
+  CHECK_EQ(positions.size(), accelerations.size());
+  CHECK_EQ(positions.size(), cullings.size());
+  // TODO(phl): Use std::to_underlying when we have C++23.
+  auto error = static_cast<std::underlying_type_t<absl::StatusCode>>(
+      absl::StatusCode::kOk);
+
+  // The buffers are reused across calls on the same thread.
+  thread_local std::vector<Position<Frame>> position(1);
+  thread_local std::vector<Vector<Acceleration, Frame>> acceleration(1);
+
+  for (std::size_t i = 0; i < positions.size(); ++i) {
+    PerturberCulling& culling = cullings[i];
+    double relative_error_bound = std::numeric_limits<double>::infinity();
+    if (!culling.exact_bodies.empty()) {
+      relative_error_bound = PerturberCullingRelativeErrorBound(
+          t, positions[i], massive_positions[culling.primary], culling);
+    }
+    if (relative_error_bound > perturber_culling_tolerance_) {
+      SelectPerturbers(t, positions[i], massive_positions, culling);
+      relative_error_bound = PerturberCullingRelativeErrorBound(
+          t, positions[i], massive_positions[culling.primary], culling);
+    }
+    culling.max_relative_error_bound =
+        std::max(culling.max_relative_error_bound, relative_error_bound);
+
+    position[0] = positions[i];
+    acceleration[0] = culling.culled_acceleration;
+    for (std::size_t const b1 : culling.exact_bodies) {
+      MassiveBody const& body1 = *bodies_[b1];
+      if (b1 < number_of_oblate_bodies_) {
+        error |= ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies<
+                     /*body1_is_oblate=*/true>(
+                     t,
+                     body1, b1, massive_positions[b1],
+                     position,
+                     acceleration);
+      } else {
+        error |= ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies<
+                     /*body1_is_oblate=*/false>(
+                     t,
+                     body1, b1, massive_positions[b1],
+                     position,
+                     acceleration);
+      }
+    }
+    accelerations[i] = acceleration[0];
+  }
+  return static_cast<absl::StatusCode>(error);
+}
+
+template<typename Frame>
+std::size_t Ephemeris<Frame>::DominantBody(
+    Position<Frame> const& position,
+    std::vector<Position<Frame>> const& massive_positions,
+    Acceleration& dominant_acceleration) const {
+  std::size_t dominant_body = 0;
+  dominant_acceleration = Acceleration();
+  for (std::size_t b = 0; b < bodies_.size(); ++b) {
+    Acceleration const acceleration =
+        bodies_[b]->gravitational_parameter() /
+        (position - massive_positions[b]).Norm²();
+    if (acceleration > dominant_acceleration) {
+      dominant_body = b;
+      dominant_acceleration = acceleration;
+    }
+  }
+  return dominant_body;
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::SelectPerturbers(
+    Instant const& t,
+    Position<Frame> const& position,
+    std::vector<Position<Frame>> const& massive_positions,
+    PerturberCulling& culling) const {
+  Acceleration primary_acceleration;
+  culling.primary =
+      DominantBody(position, massive_positions, primary_acceleration);
+  Position<Frame> const& primary_position = massive_positions[culling.primary];
+  Length const r = (position - primary_position).Norm();
+  DegreesOfFreedom<Frame> const primary_degrees_of_freedom =
+      trajectories_[culling.primary]->EvaluateDegreesOfFreedom(t);
+
+  struct Candidate {
+    std::size_t body;
+    CulledPerturber perturber;
+    // The acceleration of the primary by the perturber.
+    Vector<Acceleration, Frame> acceleration;
+    Acceleration tidal_bound;
+  };
+  std::vector<Candidate> candidates;
+  culling.exact_bodies.clear();
+  culling.exact_bodies.push_back(culling.primary);
+
+  // The buffers are reused across calls on the same thread.
+  thread_local std::vector<Position<Frame>> positions(1);
+  thread_local std::vector<Vector<Acceleration, Frame>> accelerations(1);
+  positions[0] = primary_position;
+  for (std::size_t b = 0; b < bodies_.size(); ++b) {
+    if (b == culling.primary) {
+      continue;
+    }
+    RelativeDegreesOfFreedom<Frame> const relative =
+        trajectories_[b]->EvaluateDegreesOfFreedom(t) -
+        primary_degrees_of_freedom;
+    Length const distance = relative.displacement().Norm();
+    GravitationalParameter const& μ = bodies_[b]->gravitational_parameter();
+    Acceleration const tidal_bound = TidalAccelerationBound(μ, distance, r);
+    if (!IsFinite(tidal_bound)) {
+      culling.exact_bodies.push_back(b);
+      continue;
+    }
+
+    // The collisions of the primary are not our concern here.
+    accelerations[0] = Vector<Acceleration, Frame>();
+    if (b < number_of_oblate_bodies_) {
+      ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies<
+          /*body1_is_oblate=*/true>(
+          t, *bodies_[b], b, massive_positions[b], positions, accelerations);
+    } else {
+      ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies<
+          /*body1_is_oblate=*/false>(
+          t, *bodies_[b], b, massive_positions[b], positions, accelerations);
+    }
+    // The harmonics decrease at least as fast as the degree 2 term, whose
+    // Jacobian is, relative to its value, twice that of the central term.  To
+    // first order, their effect is bounded by increasing μ.
+    Vector<Acceleration, Frame> const central_acceleration =
+        μ * relative.displacement() / Pow<3>(distance);
+    double const harmonics_factor =
+        1 + 2 * (accelerations[0] - central_acceleration).Norm() /
+                central_acceleration.Norm();
+    candidates.push_back(
+        {b,
+         CulledPerturber{μ * harmonics_factor,
+                         distance,
+                         relative.velocity().Norm()},
+         accelerations[0],
+         harmonics_factor * tidal_bound});
+  }
+
+  // Cull the perturbers with the smallest tidal effects while the sum of their
+  // bounds is below half the tolerance, so that the selection remains valid
+  // for some time.
+  std::sort(candidates.begin(),
+            candidates.end(),
+            [](Candidate const& left, Candidate const& right) {
+              return left.tidal_bound < right.tidal_bound;
+            });
+  Acceleration const budget =
+      0.5 * perturber_culling_tolerance_ * primary_acceleration;
+  Acceleration sum_of_tidal_bounds;
+  culling.culled_perturbers.clear();
+  culling.culled_acceleration = Vector<Acceleration, Frame>();
+  for (auto const& candidate : candidates) {
+    sum_of_tidal_bounds += candidate.tidal_bound;
+    if (sum_of_tidal_bounds <= budget) {
+      culling.culled_perturbers.push_back(candidate.perturber);
+      culling.culled_acceleration += candidate.acceleration;
+    } else {
+      culling.exact_bodies.push_back(candidate.body);
+    }
+  }
+  std::sort(culling.exact_bodies.begin(), culling.exact_bodies.end());
+  culling.primary_gravitational_parameter =
+      bodies_[culling.primary]->gravitational_parameter();
+  culling.t_selection = t;
+}
+
+template<typename Frame>
+double Ephemeris<Frame>::PerturberCullingRelativeErrorBound(
+    Instant const& t,
+    Position<Frame> const& position,
+    Position<Frame> const& primary_position,
+    PerturberCulling const& culling) const {
+  Square<Length> const r² = (position - primary_position).Norm²();
+  Length const r = Sqrt(r²);
+  Time const Δt = Abs(t - culling.t_selection);
+  Acceleration bound;
+  for (auto const& perturber : culling.culled_perturbers) {
+    // The point where the acceleration was evaluated is the position of the
+    // primary at |t_selection|.  To first order in |Δt|, the massless body is
+    // now within this distance of that point, relative to the perturber.
+    Length const δ = r + perturber.relative_speed * Δt;
+    bound += TidalAccelerationBound(
+        perturber.effective_gravitational_parameter, perturber.distance, δ);
+  }
+  return bound * r² / culling.primary_gravitational_parameter;
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::RecordPerturberCullingErrorBounds(
+    std::vector<PerturberCulling> const& cullings) {
+  if (cullings.empty()) {
+    return;
+  }
+  absl::MutexLock l(&lock_);
+  for (auto const& culling : cullings) {
+    perturber_culling_error_bound_ = std::max(perturber_culling_error_bound_,
+                                              culling.max_relative_error_bound);
+  }
+}
+
 template<typename Frame>
 void Ephemeris<Frame>::ComputeGravitationalPotentialsOfAllMassiveBodies(
     Instant const& t,
@@ -1423,13 +2931,14 @@ void Ephemeris<Frame>::ComputeGravitationalPotentialsOfAllMassiveBodies(
   CHECK_EQ(positions.size(), potentials.size());
   potentials.assign(potentials.size(), SpecificEnergy());
 
-  // Locking ensures that we see a consistent state of all the trajectories.
-  absl::ReaderMutexLock l(&lock_);
+  std::vector<Position<Frame>> massive_positions;
+  EvaluatePositions(t, trajectories_, massive_positions);
+
   for (std::size_t b1 = 0; b1 < number_of_oblate_bodies_; ++b1) {
     MassiveBody const& body1 = *bodies_[b1];
     ComputeGravitationalPotentialsOfMassiveBody</*body1_is_oblate=*/true>(
         t,
-        body1, b1,
+        body1, b1, massive_positions[b1],
         positions,
         potentials);
   }
@@ -1440,7 +2949,7 @@ void Ephemeris<Frame>::ComputeGravitationalPotentialsOfAllMassiveBodies(
     MassiveBody const& body1 = *bodies_[b1];
     ComputeGravitationalPotentialsOfMassiveBody</*body1_is_oblate=*/false>(
         t,
-        body1, b1,
+        body1, b1, massive_positions[b1],
         positions,
         potentials);
   }
@@ -1451,15 +2960,23 @@ template<typename Frame>
 template<typename ODE>
 absl::Status Ephemeris<Frame>::FlowODEWithAdaptiveStep(
     typename ODE::RightHandSideComputation compute_acceleration,
+    MasslessBodiesAccelerationComputation compute_massless_accelerations,
     not_null<DiscreteTrajectory<Frame>*> trajectory,
     Instant const& t,
     ODEAdaptiveStepParameters<ODE> const& parameters,
-    std::int64_t max_ephemeris_steps) {
+    std::int64_t max_ephemeris_steps,
+    EventDetector<Frame>* const event_detector) {
   auto const& [trajectory_last_time,
                trajectory_last_degrees_of_freedom] = trajectory->back();
   if (trajectory_last_time == t) {
     return absl::OkStatus();
   }
+  std::vector<EventDetector<Frame>*> event_detectors;
+  if (event_detector != nullptr) {
+    event_detector->Append(trajectory_last_time,
+                           trajectory_last_degrees_of_freedom);
+    event_detectors.push_back(event_detector);
+  }
 
   std::vector<not_null<DiscreteTrajectory<Frame>*>> const trajectories =
       {trajectory};
@@ -1498,15 +3015,33 @@ absl::Status Ephemeris<Frame>::FlowODEWithAdaptiveStep(
                 _1, _2);
 
   typename AdaptiveStepSizeIntegrator<ODE>::AppendState append_state =
-      std::bind(&Ephemeris::AppendMasslessBodiesStateToTrajectories,
-                _1,
-                std::cref(trajectories));
-  auto const instance =
-      parameters.integrator_->NewInstance(problem,
-                                          append_state,
-                                          tolerance_to_error_ratio,
-                                          integrator_parameters);
-  auto status = instance->Solve(t_final);
+      [&trajectories, &event_detectors](
+          typename NewtonianMotionEquation::SystemState const& state) {
+        AppendMasslessBodiesStateToTrajectories(state, trajectories);
+        AppendMasslessBodiesStateToEventDetectors(state, event_detectors);
+      };
+  auto const solve = [&]() {
+    if constexpr (std::is_same_v<ODE, NewtonianMotionEquation>) {
+      if (parameters.encke_rectification_tolerance_ > 0) {
+        return SolveMasslessBodyWithEncke(
+            *parameters.integrator_,
+            problem,
+            compute_massless_accelerations,
+            append_state,
+            tolerance_to_error_ratio,
+            integrator_parameters,
+            t_final,
+            parameters.encke_rectification_tolerance_);
+      }
+    }
+    return SolveMasslessBody(*parameters.integrator_,
+                             problem,
+                             append_state,
+                             tolerance_to_error_ratio,
+                             integrator_parameters,
+                             t_final);
+  };
+  auto status = solve();
 
   // We probably don't care if the vessel gets too close to the singularity, as
   // we only use this integrator for the future.  So we swallow the error.  Note
@@ -1529,6 +3064,372 @@ absl::Status Ephemeris<Frame>::FlowODEWithAdaptiveStep(
   }
 }
 
+template<typename Frame>
+template<typename ODE>
+absl::Status Ephemeris<Frame>::SolveMasslessBody(
+    AdaptiveStepSizeIntegrator<ODE> const& integrator,
+    IntegrationProblem<ODE> const& problem,
+    typename AdaptiveStepSizeIntegrator<ODE>::AppendState const& append_state,
+    typename AdaptiveStepSizeIntegrator<ODE>::ToleranceToErrorRatio const&
+        tolerance_to_error_ratio,
+    typename AdaptiveStepSizeIntegrator<ODE>::Parameters const& parameters,
+    Instant const& t_final) {
+  auto const solve_instance = [&]() {
+    auto const instance = integrator.NewInstance(
+        problem, append_state, tolerance_to_error_ratio, parameters);
+    return instance->Solve(t_final);
+  };
+  if constexpr (std::is_same_v<ODE, NewtonianMotionEquation>) {
+    // The right-hand side of the ephemeris operates on vectors of massless
+    // bodies; the buffers are reused across calls on the same thread.
+    auto const compute_acceleration =
+        [&problem](Instant const& t,
+                   Position<Frame> const& position,
+                   Vector<Acceleration, Frame>& acceleration) {
+          thread_local std::vector<Position<Frame>> positions(1);
+          thread_local std::vector<Vector<Acceleration, Frame>> accelerations(
+              1);
+          positions[0] = position;
+          auto const status = problem.equation.compute_acceleration(
+              t, positions, accelerations);
+          acceleration = accelerations[0];
+          return status;
+        };
+
+    using RKN434FM = integrators::EmbeddedExplicitRungeKuttaNyströmIntegrator<
+        integrators::methods::DormandالمكاوىPrince1986RKN434FM,
+        Position<Frame>>;
+    if (auto const* const eerkn =
+            dynamic_cast<RKN434FM const*>(&integrator)) {
+      return eerkn->SolveSingle({.initial_state = problem.initial_state,
+                                 .t_final = t_final,
+                                 .append_state = append_state,
+                                 .tolerance_to_error_ratio =
+                                     tolerance_to_error_ratio,
+                                 .parameters = parameters},
+                                compute_acceleration);
+    }
+  }
+  return solve_instance();
+}
+
+template<typename Frame>
+absl::Status Ephemeris<Frame>::SolveMasslessBodyWithEncke(
+    AdaptiveStepSizeIntegrator<NewtonianMotionEquation> const& integrator,
+    IntegrationProblem<NewtonianMotionEquation> const& problem,
+    MasslessBodiesAccelerationComputation const&
+        compute_massless_accelerations,
+    typename AdaptiveStepSizeIntegrator<
+        NewtonianMotionEquation>::AppendState const& append_state,
+    typename AdaptiveStepSizeIntegrator<NewtonianMotionEquation>::
+        ToleranceToErrorRatio const& tolerance_to_error_ratio,
+    typename AdaptiveStepSizeIntegrator<
+        NewtonianMotionEquation>::Parameters const& parameters,
+    Instant const& t_final,
+    double const rectification_tolerance) const {
+  using ODE = NewtonianMotionEquation;
+
+  // The buffers are reused across calls on the same thread.
+  thread_local std::vector<Position<Frame>> massive_positions;
+  thread_local std::vector<Position<Frame>> positions(1);
+  thread_local std::vector<Vector<Acceleration, Frame>> accelerations(1);
+
+  // The current state of the massless body, and its deviation from the
+  // reference conic around the primary.
+  Instant t = problem.initial_state.time.value;
+  Position<Frame> q = problem.initial_state.positions[0].value;
+  Velocity<Frame> v = problem.initial_state.velocities[0].value;
+  Displacement<Frame> δq;
+  Velocity<Frame> δv;
+  std::size_t primary = 0;
+  std::optional<KeplerOrbit<Frame>> reference;
+
+  // The last step that was not truncated at the end of a revolution, used as
+  // the first step of the next one.
+  Time step = parameters.first_step;
+  std::int64_t steps = 0;
+  absl::Status status;
+  for (;;) {
+    if (!reference.has_value() ||
+        δq.Norm() > rectification_tolerance *
+                        reference->StateVectors(t).displacement().Norm()) {
+      EvaluateMassiveBodiesPositions(
+          t, /*use_positions_cache=*/false, massive_positions);
+      Acceleration primary_acceleration;
+      primary = DominantBody(q, massive_positions, primary_acceleration);
+      reference.emplace(*bodies_[primary],
+                        MasslessBody{},
+                        DegreesOfFreedom<Frame>(q, v) -
+                            trajectories_[primary]->EvaluateDegreesOfFreedom(t),
+                        t);
+      δq = Displacement<Frame>();
+      δv = Velocity<Frame>();
+    }
+
+    not_null<MassiveBody const*> const primary_body = bodies_[primary].get();
+    ContinuousTrajectory<Frame> const& primary_trajectory =
+        *trajectories_[primary];
+    KeplerOrbit<Frame> const& conic = *reference;
+    GravitationalParameter const& μ = primary_body->gravitational_parameter();
+
+    // The deviation is integrated over the period of a circular orbit at the
+    // current distance, after which the conic may be rectified.
+    Length const r = (q - primary_trajectory.EvaluatePosition(t)).Norm();
+    Instant const t_revolution =
+        std::min(t + 2 * π * Sqrt(Pow<3>(r) / μ), t_final);
+
+    // The state vectors of the conic are memoized for the last time at which
+    // they were evaluated: the right-hand side is evaluated at the end of each
+    // step, where the state is then appended.
+    std::optional<std::pair<Instant, RelativeDegreesOfFreedom<Frame>>>
+        conic_state;
+    auto const conic_state_vectors =
+        [&conic, &conic_state](Instant const& τ) {
+          if (!conic_state.has_value() || conic_state->first != τ) {
+            conic_state.emplace(τ, conic.StateVectors(τ));
+          }
+          return conic_state->second;
+        };
+
+    // The acceleration of the deviation is that of the massless body, minus
+    // that of the primary, minus that on the conic.  It is small and smooth,
+    // so the integrator takes large steps.  The central attraction of the
+    // primary cancels with that on the conic.
+    IntegrationProblem<ODE> deviation_problem;
+    deviation_problem.equation.compute_acceleration =
+        [this, &compute_massless_accelerations, &conic_state_vectors, primary,
+         μ](Instant const& τ,
+            std::vector<Position<Frame>> const& deviations,
+            std::vector<Vector<Acceleration, Frame>>& deviation_accelerations) {
+          EvaluateMassiveBodiesPositions(
+              τ, /*use_positions_cache=*/false, massive_positions);
+          Displacement<Frame> const ρ = conic_state_vectors(τ).displacement();
+          positions[0] = massive_positions[primary] + ρ +
+                         (deviations[0] - Frame::origin);
+          auto const status = compute_massless_accelerations(
+              τ, massive_positions, positions, accelerations);
+          deviation_accelerations[0] =
+              accelerations[0] -
+              ComputeGravitationalAccelerationOnMassiveBodyInSerialOrder(
+                  τ, primary, massive_positions) +
+              μ * ρ / Pow<3>(ρ.Norm());
+          return status;
+        };
+    deviation_problem.initial_state =
+        ODE::SystemState({Frame::origin + δq}, {δv}, t);
+
+    auto const append_deviation_state =
+        [&append_state, &conic_state_vectors, &primary_trajectory, &q, &v,
+         &δq, &δv, &step, &steps, &t, &t_revolution](
+            ODE::SystemState const& state) {
+          Instant const& τ = state.time.value;
+          if (τ != t_revolution) {
+            step = τ - t;
+          }
+          δq = state.positions[0].value - Frame::origin;
+          δv = state.velocities[0].value;
+          RelativeDegreesOfFreedom<Frame> const ρ = conic_state_vectors(τ);
+          DegreesOfFreedom<Frame> const primary_degrees_of_freedom =
+              primary_trajectory.EvaluateDegreesOfFreedom(τ);
+          q = primary_degrees_of_freedom.position() + ρ.displacement() + δq;
+          v = primary_degrees_of_freedom.velocity() + ρ.velocity() + δv;
+          t = τ;
+          ++steps;
+          append_state(ODE::SystemState({q}, {v}, τ));
+        };
+
+    typename AdaptiveStepSizeIntegrator<ODE>::Parameters const
+        revolution_parameters(
+            /*first_step=*/std::min(step, t_revolution - t),
+            parameters.safety_factor,
+            /*max_steps=*/parameters.max_steps - steps,
+            /*last_step_is_exact=*/true);
+    absl::Status const revolution_status =
+        SolveMasslessBody(integrator,
+                          deviation_problem,
+                          append_deviation_state,
+                          tolerance_to_error_ratio,
+                          revolution_parameters,
+                          t_revolution);
+    // Collisions are reported at the end, as for the integration of the full
+    // motion.
+    if (!revolution_status.ok() && !absl::IsOutOfRange(revolution_status)) {
+      return revolution_status;
+    }
+    status.Update(revolution_status);
+    if (t == t_final) {
+      return status;
+    }
+    if (steps == parameters.max_steps) {
+      return absl::Status(termination_condition::ReachedMaximalStepCount,
+                          "Reached maximum step count " +
+                              std::to_string(parameters.max_steps) +
+                              " at time " + DebugString(t) +
+                              "; requested t_final is " + DebugString(t_final) +
+                              ".");
+    }
+  }
+}
+
+template<typename Frame>
+template<typename EmbeddedExplicitRungeKuttaNyströmIntegrator>
+std::vector<absl::Status> Ephemeris<Frame>::FlowBatchWithAdaptiveStep(
+    EmbeddedExplicitRungeKuttaNyströmIntegrator const& integrator,
+    std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
+    Instant const& t,
+    AdaptiveStepParameters const& parameters,
+    std::int64_t const max_ephemeris_steps) {
+  using BatchedProblem =
+      typename EmbeddedExplicitRungeKuttaNyströmIntegrator::BatchedProblem;
+  std::vector<absl::Status> statuses(trajectories.size());
+
+  auto const tolerance_to_error_ratio =
+      std::bind(&Ephemeris<Frame>::ToleranceToErrorRatio,
+                std::cref(parameters.length_integration_tolerance_),
+                std::cref(parameters.speed_integration_tolerance_),
+                _1, _2);
+
+  // The indices of the |trajectories| that don't already end at |t|, and their
+  // problems.
+  std::vector<int> flowed_trajectories;
+  std::vector<BatchedProblem> problems;
+  Instant latest_t_final = InfinitePast;
+  for (int i = 0; i < trajectories.size(); ++i) {
+    not_null<DiscreteTrajectory<Frame>*> const trajectory = trajectories[i];
+    auto const& [trajectory_last_time,
+                 trajectory_last_degrees_of_freedom] = trajectory->back();
+    if (trajectory_last_time == t) {
+      continue;
+    }
+    // See |FlowODEWithAdaptiveStep| for the |min| and the |max|.
+    Instant const t_final =
+        std::min(std::max(instance_time() + max_ephemeris_steps *
+                                                fixed_step_parameters_.step(),
+                          trajectory_last_time + fixed_step_parameters_.step()),
+                 t);
+    latest_t_final = std::max(latest_t_final, t_final);
+    flowed_trajectories.push_back(i);
+    problems.push_back(BatchedProblem{
+        .initial_state = {{trajectory_last_degrees_of_freedom.position()},
+                          {trajectory_last_degrees_of_freedom.velocity()},
+                          trajectory_last_time},
+        .t_final = t_final,
+        .append_state =
+            [trajectory](
+                typename NewtonianMotionEquation::SystemState const& state) {
+              trajectory->Append(
+                  state.time.value,
+                  DegreesOfFreedom<Frame>(
+                      state.positions[0].value,
+                      state.velocities[0].value)).IgnoreError();
+            },
+        .tolerance_to_error_ratio = tolerance_to_error_ratio,
+        .parameters = typename AdaptiveStepSizeIntegrator<
+            NewtonianMotionEquation>::Parameters(
+            /*first_time_step=*/t_final - trajectory_last_time,
+            /*safety_factor=*/0.9,
+            parameters.max_steps_,
+            /*last_step_is_exact=*/true)});
+  }
+  if (problems.empty()) {
+    return statuses;
+  }
+  Prolong(latest_t_final).IgnoreError();
+  if (this_stoppable_thread::get_stop_token().stop_requested()) {
+    for (int const i : flowed_trajectories) {
+      statuses[i] = absl::CancelledError("Cancelled by stop token");
+    }
+    return statuses;
+  }
+
+  std::vector<PerturberCulling> cullings(
+      perturber_culling_tolerance_ > 0 ? problems.size() : 0);
+  // The problems that are at the same time have their accelerations computed
+  // together.
+  auto const compute_accelerations = [this, &cullings](
+      std::vector<int> const& indices,
+      std::vector<Instant> const& times,
+      std::vector<Position<Frame>> const& positions,
+      std::vector<Vector<Acceleration, Frame>>& accelerations,
+      std::vector<absl::Status>& statuses) {
+    // The buffers are reused across calls on the same thread.
+    thread_local std::vector<int> order;
+    thread_local std::vector<Position<Frame>> group_positions;
+    thread_local std::vector<Vector<Acceleration, Frame>> group_accelerations;
+    thread_local std::vector<PerturberCulling> group_cullings;
+    thread_local std::vector<bool> group_collided;
+    order.resize(times.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(),
+                     order.end(),
+                     [&times](int const left, int const right) {
+                       return times[left] < times[right];
+                     });
+    for (int begin = 0; begin < order.size();) {
+      Instant const& time = times[order[begin]];
+      int end = begin;
+      group_positions.clear();
+      group_cullings.clear();
+      for (; end < order.size() && times[order[end]] == time; ++end) {
+        group_positions.push_back(positions[order[end]]);
+        if (!cullings.empty()) {
+          group_cullings.push_back(
+              std::move(cullings[indices[order[end]]]));
+        }
+      }
+      group_accelerations.resize(group_positions.size());
+      auto const error =
+          ComputeGravitationalAccelerationByAllMassiveBodiesOnMasslessBodies(
+              time,
+              group_positions,
+              group_accelerations,
+              group_cullings);
+      for (int k = begin; k < end; ++k) {
+        accelerations[order[k]] = group_accelerations[k - begin];
+        if (!cullings.empty()) {
+          cullings[indices[order[k]]] =
+              std::move(group_cullings[k - begin]);
+        }
+      }
+      if (error != absl::StatusCode::kOk) {
+        group_collided.assign(group_positions.size(), false);
+        ComputeGravitationalAccelerationByAllMassiveBodiesOnMasslessBodies(
+            time,
+            group_positions,
+            group_accelerations,
+            group_collided,
+            /*use_positions_cache=*/false);
+        for (int k = begin; k < end; ++k) {
+          if (group_collided[k - begin]) {
+            statuses[order[k]] = CollisionDetected();
+          }
+        }
+      }
+      begin = end;
+    }
+  };
+
+  auto const problem_statuses =
+      integrator.SolveBatch(problems, compute_accelerations);
+  RecordPerturberCullingErrorBounds(cullings);
+
+  for (int p = 0; p < problems.size(); ++p) {
+    auto status = problem_statuses[p];
+    // See |FlowODEWithAdaptiveStep| for the handling of collisions and of the
+    // limit on the ephemeris steps.
+    if (absl::IsOutOfRange(status)) {
+      status = absl::OkStatus();
+    }
+    if (status.ok() && problems[p].t_final != t) {
+      status = absl::DeadlineExceededError(
+          "Couldn't reach " + DebugString(t) + ", stopping at " +
+          DebugString(problems[p].t_final));
+    }
+    statuses[flowed_trajectories[p]] = std::move(status);
+  }
+  return statuses;
+}
+
 template<typename Frame>
 double Ephemeris<Frame>::ToleranceToErrorRatio(
     Length const& length_integration_tolerance,
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "base/mapped_file.hpp"
+#include "base/not_null.hpp"
+#include "geometry/named_quantities.hpp"
+#include "physics/continuous_trajectory.hpp"
+
+namespace principia {
+namespace physics {
+namespace internal_ephemeris_cache {
+
+using base::MappedFile;
+using base::not_null;
+using geometry::Instant;
+
+// A persistent cache of the polynomials of the trajectories of an |Ephemeris|,
+// which makes it possible to reanimate the ephemeris without integrating and
+// fitting again the segments between checkpoints.  A segment is identified by
+// a fingerprint computed by the client, which must depend on everything that
+// affects the polynomials of the segment.  The file as a whole is identified
+// by a |key|, and a file which is not a well-formed cache for that key is
+// discarded.
+//
+// The file is mapped read-only at construction, at which point the structure
+// of its segments is validated: the sizes must be consistent with the size of
+// the file and the degrees must be within the range supported by
+// |ContinuousTrajectory|, otherwise the file is discarded.  The coefficients of
+// the polynomials of a segment are only accessed if the segment is read.  The
+// segments written after construction are appended to the file, and are only
+// visible to the caches constructed afterwards.
+//
+// The file is a sequence of 64-bit words in native byte order: the header
+//   magic, version, key, number of trajectories,
+// followed by segments, each made of
+//   fingerprint, number of words in the rest of the segment,
+// and, for each trajectory, the number of its polynomials followed by
+//   t_min, t_max, degree, flat representation (see |PolynomialArena|)
+// for each polynomial.  Times are in seconds since |Instant()|.
+//
+// |ReadSegment| may be called concurrently with itself and with
+// |WriteSegment|, but the calls to |WriteSegment| must be synchronized.
+template<typename Frame>
+class EphemerisCache {
+ public:
+  using Trajectories =
+      std::vector<not_null<std::unique_ptr<ContinuousTrajectory<Frame>>>>;
+
+  EphemerisCache(std::filesystem::path path,
+                 std::uint64_t key,
+                 int number_of_trajectories);
+
+  // If the segment with the given |fingerprint| is in the cache, appends its
+  // polynomials to the |trajectories|, which must be empty, and returns true.
+  // Otherwise returns false.
+  bool ReadSegment(std::uint64_t fingerprint,
+                   Trajectories const& trajectories) const;
+
+  // Appends to the file a segment with the given |fingerprint| consisting of
+  // the polynomials of the |trajectories|.
+  void WriteSegment(std::uint64_t fingerprint,
+                    Trajectories const& trajectories);
+
+ private:
+  static constexpr std::uint64_t magic = 0x68637045'61706943;  // "CipaEpch".
+  static constexpr std::uint64_t version = 1;
+  static constexpr std::int64_t header_words = 4;
+
+  // Returns true iff the mapped file is a well-formed cache for |key_|, in
+  // which case |segments_| is filled.
+  bool IndexSegments();
+
+  // Returns true iff the |segment_words| words starting at |words| are a
+  // well-formed segment (excluding its fingerprint and size).
+  bool IsWellFormedSegment(std::uint64_t const* words,
+                           std::int64_t segment_words) const;
+
+  std::filesystem::path const path_;
+  std::uint64_t const key_;
+  int const number_of_trajectories_;
+
+  // Null if the file was discarded.
+  std::unique_ptr<MappedFile> mapped_file_;
+  // The offset (in words) of the first trajectory of each segment in the
+  // mapped file, indexed by fingerprint.
+  std::map<std::uint64_t, std::int64_t> segments_;
+  // True if the file must be rewritten with a header before a segment may be
+  // appended to it.
+  bool must_write_header_;
+};
+
+}  // namespace internal_ephemeris_cache
+
+using internal_ephemeris_cache::EphemerisCache;
+
+}  // namespace physics
+}  // namespace principia
+
+#include "physics/ephemeris_cache_body.hpp"
@@ -0,0 +1,201 @@
+#pragma once
+
+#include "physics/ephemeris_cache.hpp"
+
+#include <bit>
+#include <fstream>
+#include <utility>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "glog/logging.h"
+#include "quantities/si.hpp"
+
+namespace principia {
+namespace physics {
+namespace internal_ephemeris_cache {
+
+using internal_continuous_trajectory::max_degree;
+using quantities::si::Second;
+
+template<typename Frame>
+EphemerisCache<Frame>::EphemerisCache(std::filesystem::path path,
+                                      std::uint64_t const key,
+                                      int const number_of_trajectories)
+    : path_(std::move(path)),
+      key_(key),
+      number_of_trajectories_(number_of_trajectories),
+      mapped_file_(std::make_unique<MappedFile>(path_)) {
+  must_write_header_ = !IndexSegments();
+  if (must_write_header_) {
+    LOG_IF(WARNING, mapped_file_->bytes().size > 0)
+        << "Discarding ephemeris cache " << path_;
+    // Release the file so that it may be overwritten.
+    segments_.clear();
+    mapped_file_.reset();
+  }
+  LOG(INFO) << "Ephemeris cache " << path_ << " has " << segments_.size()
+            << " segments";
+}
+
+template<typename Frame>
+bool EphemerisCache<Frame>::ReadSegment(
+    std::uint64_t const fingerprint,
+    Trajectories const& trajectories) const {
+  CHECK_EQ(number_of_trajectories_, trajectories.size());
+  auto const it = segments_.find(fingerprint);
+  if (it == segments_.end()) {
+    return false;
+  }
+
+  // The structure of the segment was validated by |IndexSegments|.
+  auto const bytes = mapped_file_->bytes();
+  auto const* const words = reinterpret_cast<std::uint64_t const*>(bytes.data);
+  auto const* const doubles = reinterpret_cast<double const*>(bytes.data);
+  std::int64_t offset = it->second;
+  for (auto const& trajectory : trajectories) {
+    using Polynomials = typename ContinuousTrajectory<Frame>::Polynomials;
+    using InstantPolynomialPair =
+        typename ContinuousTrajectory<Frame>::InstantPolynomialPair;
+    absl::MutexLock l(&trajectory->lock_);
+    CHECK(trajectory->polynomials_.view().empty());
+    std::int64_t const number_of_polynomials = words[offset++];
+    for (std::int64_t i = 0; i < number_of_polynomials; ++i) {
+      Instant const t_min = Instant() + doubles[offset] * Second;
+      Instant const t_max = Instant() + doubles[offset + 1] * Second;
+      int const degree = words[offset + 2];
+      offset += 3;
+      trajectory->polynomials_.push_back(InstantPolynomialPair(
+          t_min,
+          t_max,
+          trajectory->polynomial_arena_.push_back(degree, &doubles[offset])));
+      offset += Polynomials::FlatSize(degree);
+    }
+    if (number_of_polynomials > 0) {
+      trajectory->first_time_ = trajectory->polynomials_.view().front().t_min;
+    }
+  }
+  return true;
+}
+
+template<typename Frame>
+void EphemerisCache<Frame>::WriteSegment(std::uint64_t const fingerprint,
+                                         Trajectories const& trajectories) {
+  CHECK_EQ(number_of_trajectories_, trajectories.size());
+  std::vector<std::uint64_t> words;
+  if (must_write_header_) {
+    words = {magic,
+             version,
+             key_,
+             static_cast<std::uint64_t>(number_of_trajectories_)};
+  }
+  words.push_back(fingerprint);
+  std::int64_t const size_index = words.size();
+  words.push_back(0);
+  std::vector<double> flat;
+  for (auto const& trajectory : trajectories) {
+    using Polynomials = typename ContinuousTrajectory<Frame>::Polynomials;
+    auto const polynomials = trajectory->polynomials_.view();
+    words.push_back(polynomials.size());
+    for (std::int64_t i = polynomials.begin(); i < polynomials.end(); ++i) {
+      auto const& pair = polynomials[i];
+      int const degree = pair.polynomial.degree();
+      words.push_back(std::bit_cast<std::uint64_t>((pair.t_min - Instant()) /
+                                                   Second));
+      words.push_back(std::bit_cast<std::uint64_t>((pair.t_max - Instant()) /
+                                                   Second));
+      words.push_back(degree);
+      flat.resize(Polynomials::FlatSize(degree));
+      pair.polynomial.WriteFlat(flat.data());
+      for (double const d : flat) {
+        words.push_back(std::bit_cast<std::uint64_t>(d));
+      }
+    }
+  }
+  words[size_index] = words.size() - size_index - 1;
+
+  auto const mode = must_write_header_ ? std::ios::trunc : std::ios::app;
+  std::ofstream file(path_, std::ios::binary | mode);
+  file.write(reinterpret_cast<char const*>(words.data()),
+             words.size() * sizeof(std::uint64_t));
+  file.close();
+  if (file.good()) {
+    must_write_header_ = false;
+  } else {
+    LOG(WARNING) << "Unable to write to ephemeris cache " << path_;
+  }
+}
+
+template<typename Frame>
+bool EphemerisCache<Frame>::IndexSegments() {
+  auto const bytes = mapped_file_->bytes();
+  if (bytes.size % sizeof(std::uint64_t) != 0) {
+    return false;
+  }
+  auto const* const words = reinterpret_cast<std::uint64_t const*>(bytes.data);
+  std::int64_t const size = bytes.size / sizeof(std::uint64_t);
+  if (size < header_words ||
+      words[0] != magic ||
+      words[1] != version ||
+      words[2] != key_ ||
+      words[3] != static_cast<std::uint64_t>(number_of_trajectories_)) {
+    return false;
+  }
+  // This detects an incomplete segment at the end of the file, as well as a
+  // file whose contents don't have the expected structure.
+  std::int64_t offset = header_words;
+  while (offset < size) {
+    if (size - offset < 2) {
+      return false;
+    }
+    std::uint64_t const fingerprint = words[offset];
+    std::uint64_t const segment_words = words[offset + 1];
+    offset += 2;
+    if (segment_words > static_cast<std::uint64_t>(size - offset) ||
+        !IsWellFormedSegment(&words[offset], segment_words)) {
+      return false;
+    }
+    segments_.emplace(fingerprint, offset);
+    offset += segment_words;
+  }
+  return true;
+}
+
+template<typename Frame>
+bool EphemerisCache<Frame>::IsWellFormedSegment(
+    std::uint64_t const* const words,
+    std::int64_t const segment_words) const {
+  using Polynomials = typename ContinuousTrajectory<Frame>::Polynomials;
+  auto const* const doubles = reinterpret_cast<double const*>(words);
+  std::int64_t offset = 0;
+  for (int i = 0; i < number_of_trajectories_; ++i) {
+    if (offset == segment_words) {
+      return false;
+    }
+    std::uint64_t const number_of_polynomials = words[offset++];
+    for (std::uint64_t j = 0; j < number_of_polynomials; ++j) {
+      if (segment_words - offset < 3) {
+        return false;
+      }
+      double const t_min = doubles[offset];
+      double const t_max = doubles[offset + 1];
+      std::uint64_t const degree = words[offset + 2];
+      offset += 3;
+      if (!(t_min < t_max) ||
+          degree < 1 ||
+          degree > static_cast<std::uint64_t>(max_degree)) {
+        return false;
+      }
+      std::int64_t const flat_size = Polynomials::FlatSize(degree);
+      if (segment_words - offset < flat_size) {
+        return false;
+      }
+      offset += flat_size;
+    }
+  }
+  return offset == segment_words;
+}
+
+}  // namespace internal_ephemeris_cache
+}  // namespace physics
+}  // namespace principia
@@ -0,0 +1,204 @@
+#include "physics/ephemeris_cache.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "geometry/frame.hpp"
+#include "geometry/grassmann.hpp"
+#include "geometry/named_quantities.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "physics/continuous_trajectory.hpp"
+#include "physics/degrees_of_freedom.hpp"
+#include "quantities/elementary_functions.hpp"
+#include "quantities/numbers.hpp"
+#include "quantities/quantities.hpp"
+#include "quantities/si.hpp"
+#include "serialization/geometry.pb.h"
+#include "testing_utilities/matchers.hpp"
+
+namespace principia {
+namespace physics {
+
+using geometry::Displacement;
+using geometry::Frame;
+using geometry::Handedness;
+using geometry::Inertial;
+using geometry::Instant;
+using geometry::Position;
+using geometry::Velocity;
+using quantities::Angle;
+using quantities::AngularFrequency;
+using quantities::Cos;
+using quantities::Length;
+using quantities::Sin;
+using quantities::Time;
+using quantities::si::Kilo;
+using quantities::si::Metre;
+using quantities::si::Milli;
+using quantities::si::Radian;
+using quantities::si::Second;
+using ::testing::Eq;
+
+class EphemerisCacheTest : public ::testing::Test {
+ protected:
+  using World = Frame<serialization::Frame::TestTag,
+                      Inertial,
+                      Handedness::Right,
+                      serialization::Frame::TEST>;
+  using Trajectories = EphemerisCache<World>::Trajectories;
+
+  EphemerisCacheTest()
+      : path_(std::string(::testing::UnitTest::GetInstance()
+                              ->current_test_info()
+                              ->name()) +
+              ".ephemeris_cache") {
+    std::filesystem::remove(path_);
+  }
+
+  ~EphemerisCacheTest() override {
+    std::filesystem::remove(path_);
+  }
+
+  // Returns |number_of_trajectories| empty trajectories.
+  Trajectories MakeTrajectories(int const number_of_trajectories) const {
+    Trajectories trajectories;
+    for (int i = 0; i < number_of_trajectories; ++i) {
+      trajectories.emplace_back(std::make_unique<ContinuousTrajectory<World>>(
+          step_, /*tolerance=*/1 * Milli(Metre)));
+    }
+    return trajectories;
+  }
+
+  // Returns trajectories on circular orbits with different radii.
+  Trajectories MakeCircularTrajectories(int const number_of_trajectories) {
+    Trajectories trajectories = MakeTrajectories(number_of_trajectories);
+    AngularFrequency const ω = 2 * π * Radian / (100 * Second);
+    for (int i = 0; i < number_of_trajectories; ++i) {
+      Length const r = (i + 1) * Kilo(Metre);
+      for (int j = 0; j <= 1000; ++j) {
+        Instant const t = t0_ + j * step_;
+        Angle const angle = ω * (t - t0_);
+        EXPECT_OK(trajectories[i]->Append(
+            t,
+            DegreesOfFreedom<World>(
+                World::origin + Displacement<World>({r * Cos(angle),
+                                                     r * Sin(angle),
+                                                     0 * Metre}),
+                Velocity<World>({-ω * r * Sin(angle) / Radian,
+                                 ω * r * Cos(angle) / Radian,
+                                 0 * Metre / Second}))));
+      }
+    }
+    return trajectories;
+  }
+
+  std::filesystem::path const path_;
+  Time const step_ = 10 * Milli(Second);
+  Instant const t0_;
+};
+
+TEST_F(EphemerisCacheTest, RoundTrip) {
+  auto const trajectories = MakeCircularTrajectories(3);
+  {
+    EphemerisCache<World> cache(
+        path_, /*key=*/42, /*number_of_trajectories=*/3);
+    EXPECT_FALSE(cache.ReadSegment(/*fingerprint=*/1, MakeTrajectories(3)));
+    cache.WriteSegment(/*fingerprint=*/1, trajectories);
+    cache.WriteSegment(/*fingerprint=*/2, MakeTrajectories(3));
+    // The segments written are not visible to this cache.
+    EXPECT_FALSE(cache.ReadSegment(/*fingerprint=*/1, MakeTrajectories(3)));
+  }
+
+  EphemerisCache<World> const cache(path_, /*key=*/42, 3);
+  auto const read_trajectories = MakeTrajectories(3);
+  EXPECT_TRUE(cache.ReadSegment(/*fingerprint=*/1, read_trajectories));
+  for (int i = 0; i < 3; ++i) {
+    auto const& expected = *trajectories[i];
+    auto const& actual = *read_trajectories[i];
+    EXPECT_THAT(actual.t_min(), Eq(expected.t_min()));
+    EXPECT_THAT(actual.t_max(), Eq(expected.t_max()));
+    for (Instant t = expected.t_min();
+         t <= expected.t_max();
+         t += step_ / 3) {
+      EXPECT_THAT(actual.EvaluateDegreesOfFreedom(t),
+                  Eq(expected.EvaluateDegreesOfFreedom(t)));
+    }
+  }
+  auto const empty_trajectories = MakeTrajectories(3);
+  EXPECT_TRUE(cache.ReadSegment(/*fingerprint=*/2, empty_trajectories));
+  EXPECT_TRUE(empty_trajectories[0]->empty());
+  EXPECT_FALSE(cache.ReadSegment(/*fingerprint=*/3, MakeTrajectories(3)));
+}
+
+TEST_F(EphemerisCacheTest, Discarded) {
+  {
+    EphemerisCache<World> cache(
+        path_, /*key=*/42, /*number_of_trajectories=*/2);
+    cache.WriteSegment(/*fingerprint=*/1, MakeCircularTrajectories(2));
+  }
+  {
+    // A different key discards the file.
+    EphemerisCache<World> cache(
+        path_, /*key=*/43, /*number_of_trajectories=*/2);
+    EXPECT_FALSE(cache.ReadSegment(/*fingerprint=*/1, MakeTrajectories(2)));
+    cache.WriteSegment(/*fingerprint=*/1, MakeCircularTrajectories(2));
+  }
+  {
+    EphemerisCache<World> const cache(path_, /*key=*/43, 2);
+    EXPECT_TRUE(cache.ReadSegment(/*fingerprint=*/1, MakeTrajectories(2)));
+  }
+
+  // An incomplete segment discards the file.
+  std::filesystem::resize_file(path_,
+                               std::filesystem::file_size(path_) -
+                                   sizeof(std::uint64_t));
+  EphemerisCache<World> const cache(path_, /*key=*/43, 2);
+  EXPECT_FALSE(cache.ReadSegment(/*fingerprint=*/1, MakeTrajectories(2)));
+}
+
+TEST_F(EphemerisCacheTest, Corrupted) {
+  // Overwrites the word at |index| in the file.
+  auto const overwrite = [this](std::int64_t const index,
+                                std::uint64_t const word) {
+    std::fstream file(path_, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(index * sizeof(std::uint64_t));
+    file.write(reinterpret_cast<char const*>(&word), sizeof(word));
+  };
+  // The header has 4 words, and the segment starts with its fingerprint and
+  // size, followed by the number of polynomials of the first trajectory and by
+  // the t_min, t_max and degree of its first polynomial.
+  std::int64_t const number_of_polynomials_index = 6;
+  std::int64_t const degree_index = 9;
+
+  {
+    EphemerisCache<World> cache(
+        path_, /*key=*/42, /*number_of_trajectories=*/2);
+    cache.WriteSegment(/*fingerprint=*/1, MakeCircularTrajectories(2));
+  }
+  {
+    EphemerisCache<World> cache(path_, /*key=*/42, 2);
+    EXPECT_TRUE(cache.ReadSegment(/*fingerprint=*/1, MakeTrajectories(2)));
+  }
+
+  // A degree out of range discards the file.
+  overwrite(degree_index, 1000);
+  {
+    EphemerisCache<World> cache(path_, /*key=*/42, 2);
+    EXPECT_FALSE(cache.ReadSegment(/*fingerprint=*/1, MakeTrajectories(2)));
+    cache.WriteSegment(/*fingerprint=*/1, MakeCircularTrajectories(2));
+  }
+
+  // A number of polynomials inconsistent with the size of the segment discards
+  // the file.
+  overwrite(number_of_polynomials_index, 1'000'000);
+  EphemerisCache<World> const cache(path_, /*key=*/42, 2);
+  EXPECT_FALSE(cache.ReadSegment(/*fingerprint=*/1, MakeTrajectories(2)));
+}
+
+}  // namespace physics
+}  // namespace principia
@@ -1,6 +1,7 @@
 ﻿
 #include "physics/ephemeris.hpp"
 
+#include <chrono>
 #include <limits>
 #include <map>
 #include <optional>
@@ -12,6 +13,7 @@
 
 #include "astronomy/frames.hpp"
 #include "base/macros.hpp"
+#include "base/thread_pool.hpp"
 #include "geometry/barycentre_calculator.hpp"
 #include "geometry/frame.hpp"
 #include "geometry/named_quantities.hpp"
@@ -22,8 +24,11 @@
 #include "integrators/embedded_explicit_runge_kutta_nyström_integrator.hpp"
 #include "integrators/methods.hpp"
 #include "integrators/symmetric_linear_multistep_integrator.hpp"
+#include "integrators/symplectic_partitioned_runge_kutta_integrator.hpp"
 #include "integrators/symplectic_runge_kutta_nyström_integrator.hpp"
 #include "mathematica/mathematica.hpp"
+#include "physics/apsides.hpp"
+#include "physics/event_detector.hpp"
 #include "physics/kepler_orbit.hpp"
 #include "physics/massive_body.hpp"
 #include "physics/oblate_body.hpp"
@@ -51,18 +56,22 @@ namespace internal_ephemeris {
 
 using astronomy::ICRS;
 using base::not_null;
+using base::ThreadPool;
 using geometry::Barycentre;
 using geometry::AngularVelocity;
 using geometry::Displacement;
 using geometry::Frame;
 using geometry::InfiniteFuture;
 using geometry::InfinitePast;
+using geometry::InnerProduct;
 using geometry::Rotation;
 using geometry::Velocity;
 using integrators::EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegrator;
 using integrators::EmbeddedExplicitRungeKuttaNyströmIntegrator;
 using integrators::SymmetricLinearMultistepIntegrator;
+using integrators::SymplecticPartitionedRungeKuttaIntegrator;
 using integrators::SymplecticRungeKuttaNyströmIntegrator;
+using integrators::methods::BlanesMoan2002S6;
 using integrators::methods::DormandالمكاوىPrince1986RKN434FM;
 using integrators::methods::Fine1987RKNG34;
 using integrators::methods::McLachlanAtela1992Order4Optimal;
@@ -80,6 +89,7 @@ using quantities::astronomy::JulianYear;
 using quantities::astronomy::SolarGravitationalParameter;
 using quantities::astronomy::TerrestrialEquatorialRadius;
 using quantities::astronomy::TerrestrialPolarRadius;
+using quantities::si::Day;
 using quantities::si::Hour;
 using quantities::si::Kilo;
 using quantities::si::Kilogram;
@@ -102,9 +112,12 @@ using testing_utilities::operator""_;
 using ::testing::AllOf;
 using ::testing::AnyOf;
 using ::testing::Eq;
+using ::testing::Ge;
 using ::testing::Gt;
+using ::testing::Le;
 using ::testing::Lt;
 using ::testing::Ref;
+using ::testing::SizeIs;
 using namespace std::chrono_literals;
 namespace si = quantities::si;
 
@@ -317,6 +330,71 @@ TEST_P(EphemerisTest, EarthMoon) {
   EXPECT_THAT(Abs(moon_positions[100].coordinates().x), Lt(2 * Metre));
 }
 
+TEST_P(EphemerisTest, EvaluateAll) {
+  auto const ephemeris = solar_system_.MakeEphemeris(
+      /*accuracy_parameters=*/{/*fitting_tolerance=*/1 * Milli(Metre),
+                               /*geopotential_tolerance=*/0x1p-24},
+      Ephemeris<ICRS>::FixedStepParameters(integrator(), 10 * Minute));
+  EXPECT_OK(ephemeris->Prolong(t0_ + 1 * Day));
+
+  auto const& bodies = ephemeris->bodies();
+  for (Instant t = t0_; t <= t0_ + 1 * Day; t += 37 * Minute) {
+    auto const positions = ephemeris->EvaluateAllPositions(t);
+    auto const degrees_of_freedom = ephemeris->EvaluateAllDegreesOfFreedom(t);
+    ASSERT_THAT(positions.size(), Eq(bodies.size()));
+    ASSERT_THAT(degrees_of_freedom.size(), Eq(bodies.size()));
+    for (int i = 0; i < bodies.size(); ++i) {
+      auto const& trajectory = *ephemeris->trajectory(bodies[i]);
+      EXPECT_THAT(positions[i], Eq(trajectory.EvaluatePosition(t)));
+      EXPECT_THAT(degrees_of_freedom[i],
+                  Eq(trajectory.EvaluateDegreesOfFreedom(t)));
+    }
+  }
+}
+
+// Two probes flowed with a fixed step by separate instances.  The second
+// instance to reach a time reads the positions of the massive bodies from the
+// cache, and the probes have identical trajectories.
+TEST_P(EphemerisTest, MassiveBodiesPositionsCache) {
+  auto const ephemeris = solar_system_.MakeEphemeris(
+      /*accuracy_parameters=*/{/*fitting_tolerance=*/1 * Milli(Metre),
+                               /*geopotential_tolerance=*/0x1p-24},
+      Ephemeris<ICRS>::FixedStepParameters(integrator(), 10 * Minute));
+  EXPECT_OK(ephemeris->Prolong(t0_ + 1 * Day));
+  DegreesOfFreedom<ICRS> const degrees_of_freedom(
+      ICRS::origin + Displacement<ICRS>({1 * AstronomicalUnit,
+                                         1 * AstronomicalUnit,
+                                         1 * AstronomicalUnit}),
+      ICRS::unmoving);
+
+  DiscreteTrajectory<ICRS> trajectory1;
+  DiscreteTrajectory<ICRS> trajectory2;
+  EXPECT_OK(trajectory1.Append(t0_, degrees_of_freedom));
+  EXPECT_OK(trajectory2.Append(t0_, degrees_of_freedom));
+  auto const instance1 = ephemeris->NewInstance(
+      {&trajectory1},
+      Ephemeris<ICRS>::NoIntrinsicAccelerations,
+      Ephemeris<ICRS>::FixedStepParameters(integrator(), 1 * Minute));
+  auto const instance2 = ephemeris->NewInstance(
+      {&trajectory2},
+      Ephemeris<ICRS>::NoIntrinsicAccelerations,
+      Ephemeris<ICRS>::FixedStepParameters(integrator(), 1 * Minute));
+  // The flows alternate at each step, so that the times evaluated by the first
+  // instance are still in the cache when the second one needs them.
+  for (int i = 1; i <= 600; ++i) {
+    Instant const t = t0_ + i * Minute;
+    EXPECT_OK(ephemeris->FlowWithFixedStep(t, *instance1));
+    EXPECT_OK(ephemeris->FlowWithFixedStep(t, *instance2));
+  }
+  EXPECT_THAT(ephemeris->massive_bodies_positions_cache_hits(), Gt(0));
+  EXPECT_THAT(ephemeris->massive_bodies_positions_cache_misses(), Gt(0));
+
+  EXPECT_THAT(trajectory2.size(), Eq(trajectory1.size()));
+  EXPECT_THAT(trajectory2.back().time, Eq(trajectory1.back().time));
+  EXPECT_THAT(trajectory2.back().degrees_of_freedom,
+              Eq(trajectory1.back().degrees_of_freedom));
+}
+
 // The Moon alone.  It moves in straight line.
 TEST_P(EphemerisTest, Moon) {
   std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
@@ -617,6 +695,261 @@ TEST_P(EphemerisTest, EarthTwoProbes) {
               Eq(q_probe2));
 }
 
+// A probe on an elliptic orbit around the Earth.  The apsides detected during
+// the integration are those found afterwards by walking the trajectory.
+TEST_P(EphemerisTest, EventDetection) {
+  std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+  std::vector<DegreesOfFreedom<ICRS>> initial_state;
+  Position<ICRS> centre_of_mass;
+  Time period;
+  SetUpEarthMoonSystem(bodies, initial_state, centre_of_mass, period);
+
+  bodies.erase(bodies.begin() + 1);
+  initial_state.erase(initial_state.begin() + 1);
+
+  MassiveBody const* const earth = bodies[0].get();
+  Position<ICRS> const earth_position = initial_state[0].position();
+  Velocity<ICRS> const earth_velocity = initial_state[0].velocity();
+
+  Ephemeris<ICRS> ephemeris(
+      std::move(bodies),
+      initial_state,
+      t0_,
+      /*accuracy_parameters=*/{/*fitting_tolerance=*/5 * Milli(Metre),
+                               /*geopotential_tolerance=*/0x1p-24},
+      Ephemeris<ICRS>::FixedStepParameters(integrator(), period / 100));
+  ContinuousTrajectory<ICRS> const& earth_trajectory =
+      *ephemeris.trajectory(earth);
+
+  // The probe starts just after its apoapsis, with 90% of the circular speed.
+  Length const distance = 1e7 * Metre;
+  Speed const speed =
+      0.9 * Sqrt(earth->gravitational_parameter() / distance);
+  DiscreteTrajectory<ICRS> trajectory;
+  EXPECT_OK(trajectory.Append(
+      t0_,
+      DegreesOfFreedom<ICRS>(
+          earth_position +
+              Vector<Length, ICRS>({0 * Metre, distance, 0 * Metre}),
+          earth_velocity +
+              Velocity<ICRS>({speed,
+                              -10 * Metre / Second,
+                              0 * Metre / Second}))));
+
+  using Event = EventDetector<ICRS>::Event;
+  std::vector<Event> events;
+  EventDetector<ICRS> event_detector(
+      {[&earth_trajectory](Instant const& t,
+                           DegreesOfFreedom<ICRS> const& degrees_of_freedom) {
+        RelativeDegreesOfFreedom<ICRS> const relative =
+            degrees_of_freedom - earth_trajectory.EvaluateDegreesOfFreedom(t);
+        return InnerProduct(relative.displacement(), relative.velocity()) /
+               (Metre * Metre / Second);
+      }},
+      [&events](Event const& event) { events.push_back(event); });
+
+  EXPECT_OK(ephemeris.FlowWithAdaptiveStep(
+      &trajectory,
+      Ephemeris<ICRS>::NoIntrinsicAcceleration,
+      t0_ + 4 * Hour,
+      Ephemeris<ICRS>::AdaptiveStepParameters(
+          EmbeddedExplicitRungeKuttaNyströmIntegrator<
+              DormandالمكاوىPrince1986RKN434FM,
+              Position<ICRS>>(),
+          max_steps,
+          1 * Milli(Metre),
+          1 * Milli(Metre) / Second),
+      Ephemeris<ICRS>::unlimited_max_ephemeris_steps,
+      &event_detector));
+
+  DiscreteTrajectory<ICRS> apoapsides;
+  DiscreteTrajectory<ICRS> periapsides;
+  ComputeApsides(earth_trajectory,
+                 trajectory,
+                 trajectory.begin(),
+                 trajectory.end(),
+                 /*max_points=*/100,
+                 apoapsides,
+                 periapsides);
+
+  // Periapsis, apoapsis, periapsis.
+  ASSERT_THAT(events, SizeIs(3));
+  ASSERT_THAT(periapsides, SizeIs(2));
+  ASSERT_THAT(apoapsides, SizeIs(1));
+  EXPECT_TRUE(events[0].increasing);
+  EXPECT_FALSE(events[1].increasing);
+  EXPECT_TRUE(events[2].increasing);
+  EXPECT_THAT(AbsoluteError(periapsides.begin()->time, events[0].time),
+              Lt(1 * Second));
+  EXPECT_THAT(AbsoluteError(apoapsides.begin()->time, events[1].time),
+              Lt(1 * Second));
+  EXPECT_THAT(AbsoluteError(periapsides.rbegin()->time, events[2].time),
+              Lt(1 * Second));
+}
+
+// Probes on elliptic orbits around the Earth, flowed together or separately.
+TEST_P(EphemerisTest, BatchedFlowWithAdaptiveStep) {
+  std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+  std::vector<DegreesOfFreedom<ICRS>> initial_state;
+  Position<ICRS> centre_of_mass;
+  Time period;
+  SetUpEarthMoonSystem(bodies, initial_state, centre_of_mass, period);
+
+  bodies.erase(bodies.begin() + 1);
+  initial_state.erase(initial_state.begin() + 1);
+
+  MassiveBody const* const earth = bodies[0].get();
+  Position<ICRS> const earth_position = initial_state[0].position();
+  Velocity<ICRS> const earth_velocity = initial_state[0].velocity();
+
+  Ephemeris<ICRS> ephemeris(
+      std::move(bodies),
+      initial_state,
+      t0_,
+      /*accuracy_parameters=*/{/*fitting_tolerance=*/5 * Milli(Metre),
+                               /*geopotential_tolerance=*/0x1p-24},
+      Ephemeris<ICRS>::FixedStepParameters(integrator(), period / 100));
+  Ephemeris<ICRS>::AdaptiveStepParameters const parameters(
+      EmbeddedExplicitRungeKuttaNyströmIntegrator<
+          DormandالمكاوىPrince1986RKN434FM,
+          Position<ICRS>>(),
+      max_steps,
+      1 * Milli(Metre),
+      1 * Milli(Metre) / Second);
+
+  // The last probe already ends at the final time.
+  std::vector<Length> const distances = {1e7 * Metre, 2e7 * Metre, 4e7 * Metre};
+  Instant const t_final = t0_ + 4 * Hour;
+  std::vector<DiscreteTrajectory<ICRS>> separate_trajectories(
+      distances.size());
+  std::vector<DiscreteTrajectory<ICRS>> batched_trajectories(
+      distances.size() + 1);
+  std::vector<not_null<DiscreteTrajectory<ICRS>*>> batch;
+  for (int i = 0; i < distances.size(); ++i) {
+    Speed const speed =
+        0.9 * Sqrt(earth->gravitational_parameter() / distances[i]);
+    DegreesOfFreedom<ICRS> const degrees_of_freedom(
+        earth_position +
+            Vector<Length, ICRS>({0 * Metre, distances[i], 0 * Metre}),
+        earth_velocity +
+            Velocity<ICRS>({speed, 0 * Metre / Second, 0 * Metre / Second}));
+    EXPECT_OK(separate_trajectories[i].Append(t0_, degrees_of_freedom));
+    EXPECT_OK(batched_trajectories[i].Append(t0_, degrees_of_freedom));
+    EXPECT_OK(ephemeris.FlowWithAdaptiveStep(
+        &separate_trajectories[i],
+        Ephemeris<ICRS>::NoIntrinsicAcceleration,
+        t_final,
+        parameters,
+        Ephemeris<ICRS>::unlimited_max_ephemeris_steps));
+    batch.push_back(&batched_trajectories[i]);
+  }
+  EXPECT_OK(batched_trajectories.back().Append(
+      t_final, separate_trajectories.front().back().degrees_of_freedom));
+  batch.push_back(&batched_trajectories.back());
+
+  auto const statuses = ephemeris.FlowWithAdaptiveStep(
+      batch,
+      t_final,
+      parameters,
+      Ephemeris<ICRS>::unlimited_max_ephemeris_steps);
+  ASSERT_THAT(statuses, SizeIs(batch.size()));
+  for (auto const& status : statuses) {
+    EXPECT_OK(status);
+  }
+  EXPECT_THAT(batched_trajectories.back(), SizeIs(1));
+  for (int i = 0; i < distances.size(); ++i) {
+    EXPECT_THAT(batched_trajectories[i],
+                SizeIs(separate_trajectories[i].size()));
+    EXPECT_EQ(t_final, batched_trajectories[i].back().time);
+    EXPECT_THAT(
+        AbsoluteError(
+            separate_trajectories[i].back().degrees_of_freedom.position(),
+            batched_trajectories[i].back().degrees_of_freedom.position()),
+        Lt(1 * Milli(Metre)));
+  }
+}
+
+// A probe on an elliptic orbit around the Earth, flowed serially and in
+// parallel in time.
+TEST_P(EphemerisTest, Parareal) {
+  std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+  std::vector<DegreesOfFreedom<ICRS>> initial_state;
+  Position<ICRS> centre_of_mass;
+  Time period;
+  SetUpEarthMoonSystem(bodies, initial_state, centre_of_mass, period);
+
+  bodies.erase(bodies.begin() + 1);
+  initial_state.erase(initial_state.begin() + 1);
+
+  MassiveBody const* const earth = bodies[0].get();
+  Position<ICRS> const earth_position = initial_state[0].position();
+  Velocity<ICRS> const earth_velocity = initial_state[0].velocity();
+
+  Ephemeris<ICRS> ephemeris(
+      std::move(bodies),
+      initial_state,
+      t0_,
+      /*accuracy_parameters=*/{/*fitting_tolerance=*/5 * Milli(Metre),
+                               /*geopotential_tolerance=*/0x1p-24},
+      Ephemeris<ICRS>::FixedStepParameters(integrator(), period / 100));
+  auto const& adaptive_integrator = EmbeddedExplicitRungeKuttaNyströmIntegrator<
+      DormandالمكاوىPrince1986RKN434FM,
+      Position<ICRS>>();
+  Ephemeris<ICRS>::AdaptiveStepParameters const parameters(
+      adaptive_integrator,
+      max_steps,
+      1 * Milli(Metre),
+      1 * Milli(Metre) / Second);
+  Ephemeris<ICRS>::PararealParameters const parareal_parameters{
+      .slices = 8,
+      .coarse_parameters = Ephemeris<ICRS>::AdaptiveStepParameters(
+          adaptive_integrator,
+          max_steps,
+          1 * Kilo(Metre),
+          1 * Metre / Second),
+      .max_iterations = 8};
+
+  Length const distance = 1e7 * Metre;
+  Speed const speed = 0.9 * Sqrt(earth->gravitational_parameter() / distance);
+  DegreesOfFreedom<ICRS> const degrees_of_freedom(
+      earth_position + Vector<Length, ICRS>({0 * Metre, distance, 0 * Metre}),
+      earth_velocity +
+          Velocity<ICRS>({speed, 0 * Metre / Second, 0 * Metre / Second}));
+  Instant const t_final = t0_ + 1 * Day;
+
+  DiscreteTrajectory<ICRS> serial_trajectory;
+  EXPECT_OK(serial_trajectory.Append(t0_, degrees_of_freedom));
+  EXPECT_OK(ephemeris.FlowWithAdaptiveStep(
+      &serial_trajectory,
+      Ephemeris<ICRS>::NoIntrinsicAcceleration,
+      t_final,
+      parameters,
+      Ephemeris<ICRS>::unlimited_max_ephemeris_steps));
+
+  ThreadPool<void> pool(/*pool_size=*/4);
+  DiscreteTrajectory<ICRS> parareal_trajectory;
+  EXPECT_OK(parareal_trajectory.Append(t0_, degrees_of_freedom));
+  auto const defect = ephemeris.FlowWithAdaptiveStepParareal(
+      &parareal_trajectory,
+      t_final,
+      parameters,
+      parareal_parameters,
+      Ephemeris<ICRS>::unlimited_max_ephemeris_steps,
+      &pool);
+  ASSERT_TRUE(defect.ok()) << defect.status();
+
+  // The coarse prediction is not good enough, so at least one correction is
+  // needed.
+  EXPECT_THAT(defect->iterations, AllOf(Ge(2), Le(8)));
+  EXPECT_THAT(defect->position, Le(1 * Milli(Metre)));
+  EXPECT_THAT(defect->velocity, Le(1 * Milli(Metre) / Second));
+  EXPECT_EQ(t_final, parareal_trajectory.back().time);
+  EXPECT_THAT(
+      AbsoluteError(serial_trajectory.back().degrees_of_freedom.position(),
+                    parareal_trajectory.back().degrees_of_freedom.position()),
+      Lt(1 * Metre));
+}
+
 TEST_P(EphemerisTest, Serialization) {
   std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
   std::vector<DegreesOfFreedom<ICRS>> initial_state;
@@ -1239,6 +1572,342 @@ TEST(EphemerisTestNoFixture, Reanimator) {
     }
   }
 }
+
+TEST(EphemerisTestNoFixture, ConcurrentReanimator) {
+  Instant const t_initial;
+  Instant const t_final = t_initial + 2 * JulianYear;
+
+  SolarSystem<ICRS> solar_system(
+      SOLUTION_DIR / "astronomy" / "sol_gravity_model.proto.txt",
+      SOLUTION_DIR / "astronomy" /
+          "sol_initial_state_jd_2451545_000000000.proto.txt");
+
+  auto ephemeris1 = solar_system.MakeEphemeris(
+      /*accuracy_parameters=*/{/*fitting_tolerance=*/1 * Milli(Metre),
+                               /*geopotential_tolerance=*/0x1p-24},
+      /*fixed_step_parameters=*/{
+          SymmetricLinearMultistepIntegrator<QuinlanTremaine1990Order12,
+                                             Position<ICRS>>(),
+          /*step=*/10 * Minute});
+  EXPECT_OK(ephemeris1->Prolong(t_final));
+
+  serialization::Ephemeris message;
+  ephemeris1->WriteToMessage(&message);
+  auto const ephemeris2 = Ephemeris<ICRS>::ReadFromMessage(
+      /*desired_t_min=*/InfiniteFuture,
+      message);
+  EXPECT_EQ(1, ephemeris2->reanimation_progress());
+
+  // Reanimate the segments on multiple threads.
+  ephemeris2->SetReanimationParallelism(4);
+  ephemeris2->RequestReanimation(t_initial);
+  ephemeris2->WaitForReanimation(t_initial);
+  EXPECT_EQ(1, ephemeris2->reanimation_progress());
+  EXPECT_OK(ephemeris2->Prolong(t_final));
+
+  // The segments are stitched in the right order, and they are identical to
+  // the ones computed serially.
+  EXPECT_EQ(ephemeris1->t_min(), ephemeris2->t_min());
+  EXPECT_EQ(ephemeris1->t_max(), ephemeris2->t_max());
+  for (int i = 0; i < ephemeris1->bodies().size(); ++i) {
+    auto trajectory1 = ephemeris1->trajectory(ephemeris1->bodies()[i]);
+    auto trajectory2 = ephemeris2->trajectory(ephemeris2->bodies()[i]);
+    for (Instant t = t_initial;
+         t <= t_final;
+         t += (t_final - t_initial) / 100) {
+      EXPECT_EQ(trajectory1->EvaluateDegreesOfFreedom(t),
+                trajectory2->EvaluateDegreesOfFreedom(t));
+    }
+  }
+}
+
+TEST(EphemerisTestNoFixture, MassiveBodiesParallelism) {
+  Instant const t_initial;
+  Instant const t_final = t_initial + 10 * Day;
+
+  SolarSystem<ICRS> solar_system(
+      SOLUTION_DIR / "astronomy" / "sol_gravity_model.proto.txt",
+      SOLUTION_DIR / "astronomy" /
+          "sol_initial_state_jd_2451545_000000000.proto.txt");
+  auto const make_ephemeris = [&solar_system](int const number_of_threads,
+                                              bool const identical_to_serial) {
+    auto ephemeris = solar_system.MakeEphemeris(
+        /*accuracy_parameters=*/{/*fitting_tolerance=*/1 * Milli(Metre),
+                                 /*geopotential_tolerance=*/0x1p-24},
+        /*fixed_step_parameters=*/{
+            SymmetricLinearMultistepIntegrator<QuinlanTremaine1990Order12,
+                                               Position<ICRS>>(),
+            /*step=*/10 * Minute});
+    ephemeris->SetMassiveBodiesParallelism(number_of_threads,
+                                           identical_to_serial);
+    EXPECT_OK(ephemeris->Prolong(t_final));
+    return ephemeris;
+  };
+
+  auto const serial = make_ephemeris(1, /*identical_to_serial=*/false);
+  auto const identical = make_ephemeris(4, /*identical_to_serial=*/true);
+  auto const tiled2 = make_ephemeris(2, /*identical_to_serial=*/false);
+  auto const tiled4 = make_ephemeris(4, /*identical_to_serial=*/false);
+
+  for (int i = 0; i < serial->bodies().size(); ++i) {
+    auto const serial_trajectory = serial->trajectory(serial->bodies()[i]);
+    auto const identical_trajectory =
+        identical->trajectory(identical->bodies()[i]);
+    auto const tiled2_trajectory = tiled2->trajectory(tiled2->bodies()[i]);
+    auto const tiled4_trajectory = tiled4->trajectory(tiled4->bodies()[i]);
+    for (Instant t = t_initial;
+         t <= t_final;
+         t += (t_final - t_initial) / 10) {
+      // The order of the sums is the same as the serial computation, and the
+      // fitting of each trajectory doesn't depend on the thread that does it.
+      EXPECT_EQ(serial_trajectory->EvaluateDegreesOfFreedom(t),
+                identical_trajectory->EvaluateDegreesOfFreedom(t));
+      // The tiling doesn't depend on the number of threads.
+      EXPECT_EQ(tiled2_trajectory->EvaluateDegreesOfFreedom(t),
+                tiled4_trajectory->EvaluateDegreesOfFreedom(t));
+      EXPECT_THAT((serial_trajectory->EvaluatePosition(t) -
+                   tiled4_trajectory->EvaluatePosition(t)).Norm(),
+                  Lt(1 * Metre));
+    }
+  }
+}
+
+TEST(EphemerisTestNoFixture, LookAheadProlongation) {
+  Instant const t_initial;
+  Time const horizon = 30 * Day;
+
+  SolarSystem<ICRS> solar_system(
+      SOLUTION_DIR / "astronomy" / "sol_gravity_model.proto.txt",
+      SOLUTION_DIR / "astronomy" /
+          "sol_initial_state_jd_2451545_000000000.proto.txt");
+  auto const ephemeris = solar_system.MakeEphemeris(
+      /*accuracy_parameters=*/{/*fitting_tolerance=*/1 * Milli(Metre),
+                               /*geopotential_tolerance=*/0x1p-24},
+      /*fixed_step_parameters=*/{
+          SymmetricLinearMultistepIntegrator<QuinlanTremaine1990Order12,
+                                             Position<ICRS>>(),
+          /*step=*/10 * Minute});
+  ephemeris->StartLookAheadProlongation(horizon);
+
+  // Returns false if |t_max()| doesn't reach |t| within a minute, so that a
+  // broken look-ahead fails the test instead of hanging it.
+  auto const wait_for_t_max = [&ephemeris](Instant const& t) {
+    auto const deadline = std::chrono::steady_clock::now() + 60s;
+    while (ephemeris->t_max() < t) {
+      if (std::chrono::steady_clock::now() > deadline) {
+        return false;
+      }
+      std::this_thread::sleep_for(10ms);
+    }
+    return true;
+  };
+
+  EXPECT_OK(ephemeris->Prolong(t_initial + 1 * Day));
+  EXPECT_LE(t_initial + 1 * Day, ephemeris->t_max());
+  ASSERT_TRUE(wait_for_t_max(t_initial + 1 * Day + horizon));
+
+  // The look-ahead covers this call, which doesn't integrate anything: the
+  // look-ahead thread is idle and only wakes up periodically, so |t_max()| is
+  // unchanged when the call returns.
+  Instant const t_max = ephemeris->t_max();
+  ASSERT_LE(t_initial + 20 * Day, t_max);
+  EXPECT_OK(ephemeris->Prolong(t_initial + 20 * Day));
+  EXPECT_EQ(t_max, ephemeris->t_max());
+  ASSERT_TRUE(wait_for_t_max(t_initial + 20 * Day + horizon));
+}
+
+// A probe in low lunar orbit, with and without culling of the perturbers.
+TEST(EphemerisTestNoFixture, PerturberCulling) {
+  Instant const t_initial;
+  Instant const t_final = t_initial + 1 * Day;
+  double const relative_tolerance = 1e-10;
+
+  SolarSystem<ICRS> solar_system(
+      SOLUTION_DIR / "astronomy" / "sol_gravity_model.proto.txt",
+      SOLUTION_DIR / "astronomy" /
+          "sol_initial_state_jd_2451545_000000000.proto.txt");
+  auto const ephemeris = solar_system.MakeEphemeris(
+      /*accuracy_parameters=*/{/*fitting_tolerance=*/1 * Milli(Metre),
+                               /*geopotential_tolerance=*/0x1p-24},
+      /*fixed_step_parameters=*/{
+          SymmetricLinearMultistepIntegrator<QuinlanTremaine1990Order12,
+                                             Position<ICRS>>(),
+          /*step=*/10 * Minute});
+
+  DegreesOfFreedom<ICRS> const moon = solar_system.degrees_of_freedom("Moon");
+  Length const radius = 1'838 * Kilo(Metre);
+  Speed const speed =
+      Sqrt(solar_system.gravitational_parameter("Moon") / radius);
+  DegreesOfFreedom<ICRS> const initial_degrees_of_freedom(
+      moon.position() + Displacement<ICRS>({radius, 0 * Metre, 0 * Metre}),
+      moon.velocity() +
+          Velocity<ICRS>({0 * Metre / Second, speed, 0 * Metre / Second}));
+  Ephemeris<ICRS>::AdaptiveStepParameters const parameters(
+      EmbeddedExplicitRungeKuttaNyströmIntegrator<
+          DormandالمكاوىPrince1986RKN434FM,
+          Position<ICRS>>(),
+      max_steps,
+      /*length_integration_tolerance=*/1 * Milli(Metre),
+      /*speed_integration_tolerance=*/1 * Milli(Metre) / Second);
+
+  DiscreteTrajectory<ICRS> exact_trajectory;
+  EXPECT_OK(exact_trajectory.Append(t_initial, initial_degrees_of_freedom));
+  EXPECT_OK(ephemeris->FlowWithAdaptiveStep(
+      &exact_trajectory,
+      Ephemeris<ICRS>::NoIntrinsicAcceleration,
+      t_final,
+      parameters,
+      Ephemeris<ICRS>::unlimited_max_ephemeris_steps));
+  EXPECT_EQ(0, ephemeris->perturber_culling_error_bound());
+
+  ephemeris->SetPerturberCulling(relative_tolerance);
+  DiscreteTrajectory<ICRS> culled_trajectory;
+  EXPECT_OK(culled_trajectory.Append(t_initial, initial_degrees_of_freedom));
+  EXPECT_OK(ephemeris->FlowWithAdaptiveStep(
+      &culled_trajectory,
+      Ephemeris<ICRS>::NoIntrinsicAcceleration,
+      t_final,
+      parameters,
+      Ephemeris<ICRS>::unlimited_max_ephemeris_steps));
+  EXPECT_LT(0, ephemeris->perturber_culling_error_bound());
+  EXPECT_GE(relative_tolerance, ephemeris->perturber_culling_error_bound());
+
+  EXPECT_EQ(exact_trajectory.back().time, culled_trajectory.back().time);
+  EXPECT_THAT((exact_trajectory.back().degrees_of_freedom.position() -
+               culled_trajectory.back().degrees_of_freedom.position()).Norm(),
+              Lt(10 * Metre));
+}
+
+// A probe in low Earth orbit, integrated with and without Encke's method.  The
+// deviation from the Keplerian orbit is smooth, so Encke's method takes much
+// larger steps for a similar result.
+TEST(EphemerisTestNoFixture, Encke) {
+  Instant const t_initial;
+  Instant const t_final = t_initial + 1 * Day;
+
+  SolarSystem<ICRS> solar_system(
+      SOLUTION_DIR / "astronomy" / "sol_gravity_model.proto.txt",
+      SOLUTION_DIR / "astronomy" /
+          "sol_initial_state_jd_2451545_000000000.proto.txt");
+  auto const ephemeris = solar_system.MakeEphemeris(
+      /*accuracy_parameters=*/{/*fitting_tolerance=*/1 * Milli(Metre),
+                               /*geopotential_tolerance=*/0x1p-24},
+      /*fixed_step_parameters=*/{
+          SymmetricLinearMultistepIntegrator<QuinlanTremaine1990Order12,
+                                             Position<ICRS>>(),
+          /*step=*/10 * Minute});
+
+  DegreesOfFreedom<ICRS> const earth = solar_system.degrees_of_freedom("Earth");
+  Length const radius = 6'778 * Kilo(Metre);
+  Speed const speed =
+      Sqrt(solar_system.gravitational_parameter("Earth") / radius);
+  DegreesOfFreedom<ICRS> const initial_degrees_of_freedom(
+      earth.position() + Displacement<ICRS>({radius, 0 * Metre, 0 * Metre}),
+      earth.velocity() +
+          Velocity<ICRS>({0 * Metre / Second, speed, 0 * Metre / Second}));
+  Ephemeris<ICRS>::AdaptiveStepParameters parameters(
+      EmbeddedExplicitRungeKuttaNyströmIntegrator<
+          DormandالمكاوىPrince1986RKN434FM,
+          Position<ICRS>>(),
+      max_steps,
+      /*length_integration_tolerance=*/1 * Milli(Metre),
+      /*speed_integration_tolerance=*/1 * Milli(Metre) / Second);
+
+  DiscreteTrajectory<ICRS> cowell_trajectory;
+  EXPECT_OK(cowell_trajectory.Append(t_initial, initial_degrees_of_freedom));
+  EXPECT_OK(ephemeris->FlowWithAdaptiveStep(
+      &cowell_trajectory,
+      Ephemeris<ICRS>::NoIntrinsicAcceleration,
+      t_final,
+      parameters,
+      Ephemeris<ICRS>::unlimited_max_ephemeris_steps));
+
+  parameters.set_encke_rectification_tolerance(1e-3);
+  DiscreteTrajectory<ICRS> encke_trajectory;
+  EXPECT_OK(encke_trajectory.Append(t_initial, initial_degrees_of_freedom));
+  EXPECT_OK(ephemeris->FlowWithAdaptiveStep(
+      &encke_trajectory,
+      Ephemeris<ICRS>::NoIntrinsicAcceleration,
+      t_final,
+      parameters,
+      Ephemeris<ICRS>::unlimited_max_ephemeris_steps));
+
+  EXPECT_EQ(cowell_trajectory.back().time, encke_trajectory.back().time);
+  EXPECT_THAT((cowell_trajectory.back().degrees_of_freedom.position() -
+               encke_trajectory.back().degrees_of_freedom.position()).Norm(),
+              Lt(100 * Metre));
+  EXPECT_THAT(encke_trajectory.size(), Lt(cowell_trajectory.size() / 2));
+
+  // The parameters survive serialization.
+  serialization::Ephemeris::AdaptiveStepParameters message;
+  parameters.WriteToMessage(&message);
+  EXPECT_EQ(1e-3,
+            Ephemeris<ICRS>::AdaptiveStepParameters::ReadFromMessage(message)
+                .encke_rectification_tolerance());
+}
+
+TEST(EphemerisTestNoFixture, KeplerSplitting) {
+  Instant const t_initial;
+  Instant const t_final = t_initial + 1 * JulianYear;
+
+  SolarSystem<ICRS> solar_system(
+      SOLUTION_DIR / "astronomy" / "sol_gravity_model.proto.txt",
+      SOLUTION_DIR / "astronomy" /
+          "sol_initial_state_jd_2451545_000000000.proto.txt");
+  Ephemeris<ICRS>::AccuracyParameters const accuracy_parameters(
+      /*fitting_tolerance=*/1 * Milli(Metre),
+      /*geopotential_tolerance=*/0x1p-24);
+  auto const newtonian_ephemeris = solar_system.MakeEphemeris(
+      accuracy_parameters,
+      /*fixed_step_parameters=*/{
+          SymmetricLinearMultistepIntegrator<QuinlanTremaine1990Order12,
+                                             Position<ICRS>>(),
+          /*step=*/10 * Minute});
+  auto const splitting_ephemeris = solar_system.MakeEphemeris(
+      accuracy_parameters,
+      /*fixed_step_parameters=*/{
+          SymmetricLinearMultistepIntegrator<QuinlanTremaine1990Order12,
+                                             Position<ICRS>>(),
+          SymplecticPartitionedRungeKuttaIntegrator<BlanesMoan2002S6,
+                                                    Position<ICRS>>(),
+          /*step=*/1 * Hour});
+  EXPECT_OK(newtonian_ephemeris->Prolong(t_final));
+  EXPECT_OK(splitting_ephemeris->Prolong(t_final));
+  EXPECT_LE(t_final, splitting_ephemeris->t_max());
+
+  for (int i = 0; i < newtonian_ephemeris->bodies().size(); ++i) {
+    auto const newtonian_trajectory =
+        newtonian_ephemeris->trajectory(newtonian_ephemeris->bodies()[i]);
+    auto const splitting_trajectory =
+        splitting_ephemeris->trajectory(splitting_ephemeris->bodies()[i]);
+    EXPECT_THAT((newtonian_trajectory->EvaluatePosition(t_final) -
+                 splitting_trajectory->EvaluatePosition(t_final)).Norm(),
+                Lt(100 * Kilo(Metre)))
+        << newtonian_ephemeris->bodies()[i]->name();
+  }
+
+  // The splitting integrator and the hierarchy survive serialization, and the
+  // ephemeris read from the message prolongs exactly as the original one.
+  serialization::Ephemeris message;
+  splitting_ephemeris->WriteToMessage(&message);
+  EXPECT_TRUE(
+      message.fixed_step_parameters().has_kepler_splitting_integrator());
+  EXPECT_EQ(splitting_ephemeris->bodies().size(),
+            message.kepler_splitting_position_size());
+  auto const splitting_ephemeris_read = Ephemeris<ICRS>::ReadFromMessage(
+      /*desired_t_min=*/InfiniteFuture,
+      message);
+  Instant const t_prolonged = t_final + 10 * Day;
+  EXPECT_OK(splitting_ephemeris->Prolong(t_prolonged));
+  EXPECT_OK(splitting_ephemeris_read->Prolong(t_prolonged));
+  for (int i = 0; i < splitting_ephemeris->bodies().size(); ++i) {
+    EXPECT_EQ(splitting_ephemeris->trajectory(splitting_ephemeris->bodies()[i])
+                  ->EvaluateDegreesOfFreedom(t_prolonged),
+              splitting_ephemeris_read
+                  ->trajectory(splitting_ephemeris_read->bodies()[i])
+                  ->EvaluateDegreesOfFreedom(t_prolonged));
+  }
+}
 #endif
 
 INSTANTIATE_TEST_SUITE_P(
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <functional>
+#include <optional>
+#include <vector>
+
+#include "geometry/named_quantities.hpp"
+#include "physics/degrees_of_freedom.hpp"
+
+namespace principia {
+namespace physics {
+namespace internal_event_detector {
+
+using geometry::Instant;
+
+// Detects the zeros of event functions along the trajectory of a massless body
+// while it is being integrated, so that apsides, nodes, impacts, etc. may be
+// found without walking the trajectory again.  The detector is given the
+// successive states of the body; when the sign of an event function changes
+// between two states, its zero is found by Brent's method on the Hermite
+// interpolant of these states, which is also what the trajectory uses.
+// This class is not thread-safe.
+template<typename Frame>
+class EventDetector {
+ public:
+  // A function of the state of the body whose zeros are the events.  Only its
+  // sign matters, so quantities may be divided by any unit.
+  using EventFunction = std::function<double(
+      Instant const& time,
+      DegreesOfFreedom<Frame> const& degrees_of_freedom)>;
+
+  struct Event {
+    // The index of the event function in the argument of the constructor.
+    int index;
+    Instant time;
+    DegreesOfFreedom<Frame> degrees_of_freedom;
+    // True if the event function goes from negative to positive.
+    bool increasing;
+  };
+
+  // Called for each event, in increasing time order.
+  using EventHandler = std::function<void(Event const& event)>;
+
+  EventDetector(std::vector<EventFunction> event_functions,
+                EventHandler event_handler);
+
+  // Processes the state of the body at |time|.  The states must be given in
+  // increasing time order; a state at or before the last one is ignored, so
+  // the first state of an integration may safely be given again.  No event is
+  // reported at the time of the first state.
+  void Append(Instant const& time,
+              DegreesOfFreedom<Frame> const& degrees_of_freedom);
+
+ private:
+  struct State {
+    Instant time;
+    DegreesOfFreedom<Frame> degrees_of_freedom;
+    std::vector<double> values;
+  };
+
+  std::vector<EventFunction> const event_functions_;
+  EventHandler const event_handler_;
+  std::optional<State> last_state_;
+  // Reused across calls to avoid allocations.
+  std::vector<Event> events_;
+};
+
+}  // namespace internal_event_detector
+
+using internal_event_detector::EventDetector;
+
+}  // namespace physics
+}  // namespace principia
+
+#include "physics/event_detector_body.hpp"
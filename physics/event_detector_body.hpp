@@ -0,0 +1,108 @@
+#pragma once
+
+#include "physics/event_detector.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "geometry/named_quantities.hpp"
+#include "numerics/hermite3.hpp"
+#include "numerics/root_finders.hpp"
+
+namespace principia {
+namespace physics {
+namespace internal_event_detector {
+
+using geometry::Position;
+using numerics::Brent;
+using numerics::Hermite3;
+
+template<typename Frame>
+EventDetector<Frame>::EventDetector(std::vector<EventFunction> event_functions,
+                                    EventHandler event_handler)
+    : event_functions_(std::move(event_functions)),
+      event_handler_(std::move(event_handler)) {}
+
+template<typename Frame>
+void EventDetector<Frame>::Append(
+    Instant const& time,
+    DegreesOfFreedom<Frame> const& degrees_of_freedom) {
+  if (last_state_.has_value() && time <= last_state_->time) {
+    return;
+  }
+  State state{.time = time,
+              .degrees_of_freedom = degrees_of_freedom,
+              .values = {}};
+  state.values.reserve(event_functions_.size());
+  for (auto const& event_function : event_functions_) {
+    state.values.push_back(event_function(time, degrees_of_freedom));
+  }
+  if (!last_state_.has_value()) {
+    last_state_ = std::move(state);
+    return;
+  }
+
+  State const& last = *last_state_;
+  std::optional<Hermite3<Instant, Position<Frame>>> interpolant;
+  auto const evaluate = [&interpolant](Instant const& t) {
+    return DegreesOfFreedom<Frame>(interpolant->Evaluate(t),
+                                   interpolant->EvaluateDerivative(t));
+  };
+
+  events_.clear();
+  for (int i = 0; i < static_cast<int>(event_functions_.size()); ++i) {
+    double const last_value = last.values[i];
+    double const value = state.values[i];
+    if (value == 0 && last_value != 0) {
+      // The event is exactly at the end of the step.  An event exactly at the
+      // beginning of the step has already been reported.
+      events_.push_back({.index = i,
+                         .time = time,
+                         .degrees_of_freedom = degrees_of_freedom,
+                         .increasing = last_value < 0});
+    } else if ((last_value < 0 && value > 0) ||
+               (last_value > 0 && value < 0)) {
+      if (!interpolant.has_value()) {
+        interpolant.emplace(
+            std::pair{last.time, time},
+            std::pair{last.degrees_of_freedom.position(),
+                      degrees_of_freedom.position()},
+            std::pair{last.degrees_of_freedom.velocity(),
+                      degrees_of_freedom.velocity()});
+      }
+      auto const& event_function = event_functions_[i];
+      auto const f = [&evaluate, &event_function](Instant const& t) {
+        return event_function(t, evaluate(t));
+      };
+      // The interpolant may not reproduce the sign of the event function at
+      // the ends of the step if it is nearly zero there.
+      double const f_lower = f(last.time);
+      double const f_upper = f(time);
+      Instant event_time;
+      if ((f_lower < 0 && f_upper > 0) || (f_lower > 0 && f_upper < 0)) {
+        event_time = Brent(f, last.time, time);
+      } else {
+        event_time = std::abs(f_lower) < std::abs(f_upper) ? last.time : time;
+      }
+      events_.push_back({.index = i,
+                         .time = event_time,
+                         .degrees_of_freedom = evaluate(event_time),
+                         .increasing = value > 0});
+    }
+  }
+
+  std::stable_sort(events_.begin(),
+                   events_.end(),
+                   [](Event const& left, Event const& right) {
+                     return left.time < right.time;
+                   });
+  for (auto const& event : events_) {
+    event_handler_(event);
+  }
+  last_state_ = std::move(state);
+}
+
+}  // namespace internal_event_detector
+}  // namespace physics
+}  // namespace principia
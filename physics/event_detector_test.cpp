@@ -0,0 +1,96 @@
+#include "physics/event_detector.hpp"
+
+#include <vector>
+
+#include "geometry/frame.hpp"
+#include "geometry/grassmann.hpp"
+#include "geometry/named_quantities.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "physics/degrees_of_freedom.hpp"
+#include "quantities/elementary_functions.hpp"
+#include "quantities/numbers.hpp"
+#include "quantities/quantities.hpp"
+#include "quantities/si.hpp"
+#include "serialization/geometry.pb.h"
+#include "testing_utilities/numerics.hpp"
+
+namespace principia {
+namespace physics {
+
+using geometry::Displacement;
+using geometry::Frame;
+using geometry::Handedness;
+using geometry::Inertial;
+using geometry::Instant;
+using geometry::Velocity;
+using quantities::Angle;
+using quantities::AngularFrequency;
+using quantities::Cos;
+using quantities::Sin;
+using quantities::Time;
+using quantities::si::Metre;
+using quantities::si::Micro;
+using quantities::si::Radian;
+using quantities::si::Second;
+using testing_utilities::AbsoluteError;
+using ::testing::Lt;
+using ::testing::SizeIs;
+
+class EventDetectorTest : public ::testing::Test {
+ protected:
+  using World = Frame<serialization::Frame::TestTag,
+                      Inertial,
+                      Handedness::Right,
+                      serialization::Frame::TEST>;
+
+  // A circular motion of radius 1 m and period 2π s.
+  DegreesOfFreedom<World> MakeDegreesOfFreedom(Instant const& t) const {
+    AngularFrequency const ω = 1 * Radian / Second;
+    Angle const θ = ω * (t - t0_);
+    return DegreesOfFreedom<World>(
+        World::origin + Displacement<World>({Cos(θ) * Metre,
+                                             Sin(θ) * Metre,
+                                             0 * Metre}),
+        Velocity<World>({-Sin(θ) * Metre / Second,
+                         Cos(θ) * Metre / Second,
+                         0 * Metre / Second}));
+  }
+
+  Instant const t0_;
+};
+
+TEST_F(EventDetectorTest, Nodes) {
+  using Event = EventDetector<World>::Event;
+  std::vector<Event> events;
+  // The crossings of the x-z plane, and those of the y-z plane.
+  EventDetector<World> detector(
+      {[](Instant const& t, DegreesOfFreedom<World> const& dof) {
+         return (dof.position() - World::origin).coordinates().y / Metre;
+       },
+       [](Instant const& t, DegreesOfFreedom<World> const& dof) {
+         return (dof.position() - World::origin).coordinates().x / Metre;
+       }},
+      [&events](Event const& event) { events.push_back(event); });
+
+  Time const step = 0.1 * Second;
+  for (int i = 0; i <= 70; ++i) {
+    Instant const t = t0_ + i * step;
+    detector.Append(t, MakeDegreesOfFreedom(t));
+    // A state that was already given is ignored.
+    detector.Append(t, MakeDegreesOfFreedom(t));
+  }
+
+  // The zeros are at multiples of π / 2 s, alternately for each function, and
+  // the first one is decreasing.
+  ASSERT_THAT(events, SizeIs(4));
+  for (int i = 0; i < events.size(); ++i) {
+    EXPECT_EQ((i + 1) % 2, events[i].index);
+    EXPECT_THAT(AbsoluteError(t0_ + (i + 1) * π / 2 * Second, events[i].time),
+                Lt(1 * Micro(Second)));
+    EXPECT_EQ(i == 2 || i == 3, events[i].increasing);
+  }
+}
+
+}  // namespace physics
+}  // namespace principia
@@ -50,6 +50,18 @@ class Geopotential {
       Square<Length> const& r²,
       Exponentiation<Length, -3> const& one_over_r³) const;
 
+  // Sets |accelerations[i]| to the result of
+  // |GeneralSphericalHarmonicsAcceleration| for the displacement |r[i]|.  The
+  // orientation of the body at |t| is only computed once, which makes this
+  // function much faster than repeated calls to the scalar one when there are
+  // many displacements.  The results are identical to those of the scalar
+  // function.
+  void GeneralSphericalHarmonicsAccelerations(
+      Instant const& t,
+      std::vector<Displacement<Frame>> const& r,
+      std::vector<Vector<Quotient<Acceleration, GravitationalParameter>,
+                         Frame>>& accelerations) const;
+
   Quotient<SpecificEnergy, GravitationalParameter>
   GeneralSphericalHarmonicsPotential(
       Instant const& t,
@@ -80,6 +92,13 @@ class Geopotential {
 
   using UnitVector = Vector<double, Frame>;
 
+  // The axes with respect to which the longitude and latitude are computed.
+  struct Axes {
+    UnitVector x̂;
+    UnitVector ŷ;
+    UnitVector ẑ;
+  };
+
   // Holds precomputed data for one evaluation of the acceleration.
   struct Precomputations;
 
@@ -98,6 +117,25 @@ class Geopotential {
   // |degree_damping_[1].outer_threshold()| are infinite, |limiting_degree > 1|.
   int LimitingDegree(Length const& r_norm) const;
 
+  // True if the sectoral and tesseral harmonics are not evaluated at |r_norm|.
+  bool IsZonal(Length const& r_norm) const;
+
+  // In the zonal case the rotation of the body is of no importance, so any pair
+  // of equatorial vectors will do.  Otherwise the axes are those of the surface
+  // frame at |t|, which are expensive to compute.
+  Axes ZonalAxes() const;
+  Axes SurfaceAxes(Instant const& t) const;
+
+  // The implementation of |GeneralSphericalHarmonicsAcceleration| once the
+  // |axes| are known.
+  Vector<ReducedAcceleration, Frame> SphericalHarmonicsAcceleration(
+      Axes const& axes,
+      bool is_zonal,
+      Displacement<Frame> const& r,
+      Length const& r_norm,
+      Square<Length> const& r²,
+      Exponentiation<Length, -3> const& one_over_r³) const;
+
   not_null<OblateBody<Frame> const*> body_;
 
   // The contribution from the harmonics of degree n is damped by
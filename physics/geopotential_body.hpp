@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <optional>
 #include <queue>
 #include <vector>
 
@@ -114,7 +115,8 @@ template<int... degrees>
 class Geopotential<Frame>::AllDegrees<std::integer_sequence<int, degrees...>> {
  public:
   static auto Acceleration(Geopotential<Frame> const& geopotential,
-                           Instant const& t,
+                           Axes const& axes,
+                           bool is_zonal,
                            Displacement<Frame> const& r,
                            Length const& r_norm,
                            Square<Length> const& r²,
@@ -122,7 +124,8 @@ class Geopotential<Frame>::AllDegrees<std::integer_sequence<int, degrees...>> {
       -> Vector<ReducedAcceleration, Frame>;
 
   static auto Potential(Geopotential<Frame> const& geopotential,
-                        Instant const& t,
+                        Axes const& axes,
+                        bool is_zonal,
                         Displacement<Frame> const& r,
                         Length const& r_norm,
                         Square<Length> const& r²,
@@ -132,7 +135,7 @@ class Geopotential<Frame>::AllDegrees<std::integer_sequence<int, degrees...>> {
  private:
   static void InitializePrecomputations(
       Geopotential<Frame> const& geopotential,
-      Instant const& t,
+      Axes const& axes,
       Displacement<Frame> const& r,
       Length const& r_norm,
       Square<Length> const& r²,
@@ -515,21 +518,18 @@ template<typename Frame>
 template<int... degrees>
 auto Geopotential<Frame>::AllDegrees<std::integer_sequence<int, degrees...>>::
 Acceleration(Geopotential<Frame> const& geopotential,
-             Instant const& t,
+             Axes const& axes,
+             bool const is_zonal,
              Displacement<Frame> const& r,
              Length const& r_norm,
              Square<Length> const& r²,
              Exponentiation<Length, -3> const& one_over_r³)
     -> Vector<ReducedAcceleration, Frame> {
   constexpr int size = sizeof...(degrees);
-  OblateBody<Frame> const& body = *geopotential.body_;
-  const bool is_zonal =
-      body.is_zonal() ||
-      r_norm > geopotential.sectoral_damping_.outer_threshold();
 
   Precomputations precomputations;
   InitializePrecomputations(
-      geopotential, t, r, r_norm, r², one_over_r³, precomputations);
+      geopotential, axes, r, r_norm, r², one_over_r³, precomputations);
 
   // Force the evaluation by increasing degree using an initializer list.  In
   // the zonal case, no point in going beyond order 0.
@@ -552,21 +552,18 @@ template<typename Frame>
 template<int... degrees>
 auto Geopotential<Frame>::AllDegrees<std::integer_sequence<int, degrees...>>::
 Potential(Geopotential<Frame> const& geopotential,
-          Instant const& t,
+          Axes const& axes,
+          bool const is_zonal,
           Displacement<Frame> const& r,
           Length const& r_norm,
           Square<Length> const& r²,
           Exponentiation<Length, -3> const& one_over_r³)
     -> ReducedPotential {
   constexpr int size = sizeof...(degrees);
-  OblateBody<Frame> const& body = *geopotential.body_;
-  const bool is_zonal =
-      body.is_zonal() ||
-      r_norm > geopotential.sectoral_damping_.outer_threshold();
 
   Precomputations precomputations;
   InitializePrecomputations(
-      geopotential, t, r, r_norm, r², one_over_r³, precomputations);
+      geopotential, axes, r, r_norm, r², one_over_r³, precomputations);
 
   // Force the evaluation by increasing degree using an initializer list.  In
   // the zonal case, no point in going beyond order 0.
@@ -589,16 +586,13 @@ template<typename Frame>
 template<int... degrees>
 void Geopotential<Frame>::AllDegrees<std::integer_sequence<int, degrees...>>::
 InitializePrecomputations(Geopotential<Frame> const& geopotential,
-                          Instant const& t,
+                          Axes const& axes,
                           Displacement<Frame> const& r,
                           Length const& r_norm,
                           Square<Length> const& r²,
                           Exponentiation<Length, -3> const& one_over_r³,
                           Precomputations& precomputations) {
   OblateBody<Frame> const& body = *geopotential.body_;
-  const bool is_zonal =
-      body.is_zonal() ||
-      r_norm > geopotential.sectoral_damping_.outer_threshold();
 
   precomputations.r_norm = r_norm;
   precomputations.r² = r²;
@@ -622,20 +616,9 @@ InitializePrecomputations(Geopotential<Frame> const& geopotential,
 
   auto& DmPn_of_sin_β = precomputations.DmPn_of_sin_β;
 
-  // In the zonal case the rotation of the body is of no importance, so any pair
-  // of equatorial vectors will do.
-  UnitVector x̂;
-  UnitVector ŷ;
-  UnitVector const ẑ = body.polar_axis();
-  if (is_zonal) {
-    x̂ = body.equatorial();
-    ŷ = body.biequatorial();
-  } else {
-    auto const from_surface_frame =
-      body.template FromSurfaceFrame<SurfaceFrame>(t);
-    x̂ = from_surface_frame(x_);
-    ŷ = from_surface_frame(y_);
-  }
+  UnitVector const& x̂ = axes.x̂;
+  UnitVector const& ŷ = axes.ŷ;
+  UnitVector const& ẑ = axes.ẑ;
 
   Length const x = InnerProduct(r, x̂);
   Length const y = InnerProduct(r, ŷ);
@@ -748,7 +731,7 @@ Geopotential<Frame>::Geopotential(not_null<OblateBody<Frame> const*> body,
 #define PRINCIPIA_CASE_SPHERICAL_HARMONICS_ACCELERATION(d)                     \
   case (d):                                                                    \
     return AllDegrees<std::make_integer_sequence<int, (d) + 1>>::Acceleration( \
-        *this, t, r, r_norm, r², one_over_r³)
+        *this, axes, is_zonal, r, r_norm, r², one_over_r³)
 
 template<typename Frame>
 Vector<Quotient<Acceleration, GravitationalParameter>, Frame>
@@ -758,6 +741,47 @@ Geopotential<Frame>::GeneralSphericalHarmonicsAcceleration(
     Length const& r_norm,
     Square<Length> const& r²,
     Exponentiation<Length, -3> const& one_over_r³) const {
+  bool const is_zonal = IsZonal(r_norm);
+  return SphericalHarmonicsAcceleration(
+      is_zonal ? ZonalAxes() : SurfaceAxes(t),
+      is_zonal,
+      r, r_norm, r², one_over_r³);
+}
+
+template<typename Frame>
+void Geopotential<Frame>::GeneralSphericalHarmonicsAccelerations(
+    Instant const& t,
+    std::vector<Displacement<Frame>> const& r,
+    std::vector<Vector<Quotient<Acceleration, GravitationalParameter>,
+                       Frame>>& accelerations) const {
+  accelerations.resize(r.size());
+  Axes const zonal_axes = ZonalAxes();
+  // Only computed if at least one displacement needs it.
+  std::optional<Axes> surface_axes;
+  for (std::size_t i = 0; i < r.size(); ++i) {
+    Square<Length> const r² = r[i].Norm²();
+    Length const r_norm = Sqrt(r²);
+    Exponentiation<Length, -3> const one_over_r³ = r_norm / (r² * r²);
+    bool const is_zonal = IsZonal(r_norm);
+    if (!is_zonal && !surface_axes.has_value()) {
+      surface_axes = SurfaceAxes(t);
+    }
+    accelerations[i] = SphericalHarmonicsAcceleration(
+        is_zonal ? zonal_axes : *surface_axes,
+        is_zonal,
+        r[i], r_norm, r², one_over_r³);
+  }
+}
+
+template<typename Frame>
+auto Geopotential<Frame>::SphericalHarmonicsAcceleration(
+    Axes const& axes,
+    bool const is_zonal,
+    Displacement<Frame> const& r,
+    Length const& r_norm,
+    Square<Length> const& r²,
+    Exponentiation<Length, -3> const& one_over_r³) const
+    -> Vector<ReducedAcceleration, Frame> {
   if (r_norm != r_norm) {
     // Short-circuit NaN, to avoid having to deal with an unordered
     // |r_norm| when finding the partition point below.
@@ -830,7 +854,7 @@ Geopotential<Frame>::GeneralSphericalHarmonicsAcceleration(
 #define PRINCIPIA_CASE_SPHERICAL_HARMONICS_POTENTIAL(d)                     \
   case (d):                                                                 \
     return AllDegrees<std::make_integer_sequence<int, (d) + 1>>::Potential( \
-        *this, t, r, r_norm, r², one_over_r³)
+        *this, axes, is_zonal, r, r_norm, r², one_over_r³)
 
 template<typename Frame>
 Quotient<SpecificEnergy, GravitationalParameter>
@@ -845,6 +869,8 @@ Geopotential<Frame>::GeneralSphericalHarmonicsPotential(
     // |r_norm| when finding the partition point below.
     return NaN<ReducedPotential>;
   }
+  bool const is_zonal = IsZonal(r_norm);
+  Axes const axes = is_zonal ? ZonalAxes() : SurfaceAxes(t);
   // We have |max_degree > 0|.
   int const max_degree = LimitingDegree(r_norm) - 1;
   switch (max_degree) {
@@ -931,6 +957,23 @@ int Geopotential<Frame>::LimitingDegree(Length const& r_norm) const {
          degree_damping_.begin();
 }
 
+template<typename Frame>
+bool Geopotential<Frame>::IsZonal(Length const& r_norm) const {
+  return body_->is_zonal() || r_norm > sectoral_damping_.outer_threshold();
+}
+
+template<typename Frame>
+auto Geopotential<Frame>::ZonalAxes() const -> Axes {
+  return {body_->equatorial(), body_->biequatorial(), body_->polar_axis()};
+}
+
+template<typename Frame>
+auto Geopotential<Frame>::SurfaceAxes(Instant const& t) const -> Axes {
+  auto const from_surface_frame =
+      body_->template FromSurfaceFrame<SurfaceFrame>(t);
+  return {from_surface_frame(x_), from_surface_frame(y_), body_->polar_axis()};
+}
+
 template<typename Frame>
 const Vector<double, typename Geopotential<Frame>::SurfaceFrame>
     Geopotential<Frame>::x_({1, 0, 0});
@@ -1,6 +1,7 @@
 ﻿
 #include "physics/geopotential.hpp"
 
+#include <cmath>
 #include <random>
 #include <vector>
 
@@ -850,6 +851,43 @@ TEST_F(GeopotentialTest, Potential) {
   }
 }
 
+// Check that the batch evaluation gives the same results as the scalar one,
+// both in the zonal and in the non-zonal regime.
+TEST_F(GeopotentialTest, Batch) {
+  SolarSystem<ICRS> solar_system_2000(
+            SOLUTION_DIR / "astronomy" / "sol_gravity_model.proto.txt",
+            SOLUTION_DIR / "astronomy" /
+                "sol_initial_state_jd_2451545_000000000.proto.txt");
+  solar_system_2000.LimitOblatenessToDegree("Earth", /*max_degree=*/9);
+  auto earth_message = solar_system_2000.gravity_model_message("Earth");
+  auto const earth = solar_system_2000.MakeOblateBody(earth_message);
+  Geopotential<ICRS> const geopotential(earth.get(), /*tolerance=*/0x1.0p-24);
+  Instant const t = Instant() + 1234 * Second;
+
+  std::mt19937_64 random(42);
+  std::uniform_real_distribution<double> direction_distribution(-1, 1);
+  std::uniform_real_distribution<double> log_radius_distribution(6.5, 9);
+  std::vector<Displacement<ICRS>> displacements;
+  for (int i = 0; i < 1000; ++i) {
+    Vector<double, ICRS> const direction({direction_distribution(random),
+                                          direction_distribution(random),
+                                          direction_distribution(random)});
+    displacements.push_back(std::pow(10, log_radius_distribution(random)) *
+                            Metre * direction / direction.Norm());
+  }
+
+  std::vector<Vector<Quotient<Acceleration, GravitationalParameter>, ICRS>>
+      accelerations;
+  geopotential.GeneralSphericalHarmonicsAccelerations(
+      t, displacements, accelerations);
+  ASSERT_THAT(accelerations.size(), Eq(displacements.size()));
+  for (int i = 0; i < displacements.size(); ++i) {
+    EXPECT_THAT(accelerations[i],
+                Eq(GeneralSphericalHarmonicsAcceleration(
+                    geopotential, t, displacements[i])));
+  }
+}
+
 }  // namespace internal_geopotential
 }  // namespace physics
 }  // namespace principia
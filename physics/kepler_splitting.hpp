@@ -0,0 +1,128 @@
+#pragma once
+
+#include <vector>
+
+#include "absl/status/status.h"
+#include "base/not_null.hpp"
+#include "geometry/grassmann.hpp"
+#include "geometry/named_quantities.hpp"
+#include "integrators/ordinary_differential_equations.hpp"
+#include "physics/massive_body.hpp"
+#include "physics/massless_body.hpp"
+#include "quantities/named_quantities.hpp"
+
+namespace principia {
+namespace physics {
+namespace internal_kepler_splitting {
+
+using base::not_null;
+using geometry::Instant;
+using geometry::Position;
+using geometry::Vector;
+using geometry::Velocity;
+using integrators::DecomposableFirstOrderDifferentialEquation;
+using integrators::SpecialSecondOrderDifferentialEquation;
+using quantities::Acceleration;
+using quantities::GravitationalParameter;
+
+// The splitting of the motion of a system of massive bodies into Keplerian
+// drifts and interaction kicks, in hierarchical Jacobi coordinates, as in
+// [WH91] and [Beu03].  The resulting |DecomposableEquation| may be solved by a
+// |SymplecticPartitionedRungeKuttaIntegrator|, whose error is then
+// proportional to the interactions, not to the central forces, so that much
+// larger steps may be taken than with the full Newtonian equation.
+//
+// The hierarchy is built once from the given positions: the bodies are taken
+// by decreasing gravitational parameter, and each body is a satellite of the
+// deepest body in whose Hill sphere it lies.  Each body and its satellites,
+// taken by increasing distance, form a subsystem; a subsystem and the next
+// satellite are merged, and their Jacobi coordinates are the position and
+// velocity of the barycentre of the latter with respect to that of the former.
+// The Keplerian drift propagates each of these coordinates in the field of the
+// merged subsystem, and the kick applies the accelerations given by
+// |compute_acceleration| minus those of these Keplerian problems.
+//
+// |Frame| must not rotate, and the hierarchy must remain valid for the duration
+// of the integration.  This class is not thread-safe.  It is used by the
+// |Ephemeris| when its |FixedStepParameters| specify a splitting integrator.
+template<typename Frame>
+class KeplerSplitting {
+ public:
+  using NewtonianMotionEquation =
+      SpecialSecondOrderDifferentialEquation<Position<Frame>>;
+  using DecomposableEquation =
+      DecomposableFirstOrderDifferentialEquation<Position<Frame>,
+                                                 Velocity<Frame>>;
+
+  // |positions| are those of the |bodies|, in the same order, and are used to
+  // build the hierarchy.  |compute_acceleration| must compute the full
+  // accelerations of the |bodies|.
+  KeplerSplitting(
+      std::vector<not_null<MassiveBody const*>> bodies,
+      std::vector<Position<Frame>> const& positions,
+      typename NewtonianMotionEquation::RightHandSideComputation
+          compute_acceleration);
+
+  // The left flow is the kick and the right flow the drift.  The result refers
+  // to |*this|, which must outlive it.
+  DecomposableEquation equation();
+
+  // The index of the primary of each body in the hierarchy, or -1 for the root.
+  std::vector<int> const& parents() const;
+
+ private:
+  // Two subsystems merged into the one with index |n + k|, where |n| is the
+  // number of bodies and |k| the index of the merger.  The subsystems with an
+  // index below |n| are the bodies.
+  struct Merger {
+    int inner;
+    int outer;
+    // A body with the total gravitational parameter of the merged subsystem.
+    MassiveBody system;
+  };
+
+  // Adds the mergers of the subsystem rooted at |primary|, after those of its
+  // satellites, and returns the index of that subsystem.
+  int AddSubsystem(int primary,
+                   std::vector<std::vector<int>> const& satellites);
+
+  // Sets |barycentre_positions_| and |barycentre_velocities_| for all the
+  // subsystems.
+  void ComputeBarycentres(std::vector<Position<Frame>> const& positions,
+                          std::vector<Velocity<Frame>> const& velocities);
+
+  absl::Status Kick(Instant const& t_initial,
+                    Instant const& t_final,
+                    typename DecomposableEquation::State const& initial_state,
+                    typename DecomposableEquation::State& final_state);
+
+  absl::Status Drift(Instant const& t_initial,
+                     Instant const& t_final,
+                     typename DecomposableEquation::State const& initial_state,
+                     typename DecomposableEquation::State& final_state);
+
+  std::vector<not_null<MassiveBody const*>> const bodies_;
+  typename NewtonianMotionEquation::RightHandSideComputation const
+      compute_acceleration_;
+  std::vector<int> parents_;
+  std::vector<Merger> mergers_;
+  // Indexed by subsystem.
+  std::vector<GravitationalParameter> gravitational_parameters_;
+  int root_;
+  MasslessBody const massless_body_;
+
+  // Reused across calls to avoid allocations.
+  std::vector<Position<Frame>> barycentre_positions_;
+  std::vector<Velocity<Frame>> barycentre_velocities_;
+  std::vector<Vector<Acceleration, Frame>> accelerations_;
+  std::vector<Vector<Acceleration, Frame>> kepler_accelerations_;
+};
+
+}  // namespace internal_kepler_splitting
+
+using internal_kepler_splitting::KeplerSplitting;
+
+}  // namespace physics
+}  // namespace principia
+
+#include "physics/kepler_splitting_body.hpp"
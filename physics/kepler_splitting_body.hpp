@@ -0,0 +1,247 @@
+#pragma once
+
+#include "physics/kepler_splitting.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <numeric>
+#include <utility>
+
+#include "physics/degrees_of_freedom.hpp"
+#include "physics/kepler_orbit.hpp"
+#include "quantities/elementary_functions.hpp"
+#include "quantities/quantities.hpp"
+
+namespace principia {
+namespace physics {
+namespace internal_kepler_splitting {
+
+using geometry::Displacement;
+using quantities::Length;
+using quantities::Pow;
+using quantities::Time;
+using ::std::placeholders::_1;
+using ::std::placeholders::_2;
+using ::std::placeholders::_3;
+using ::std::placeholders::_4;
+
+template<typename Frame>
+KeplerSplitting<Frame>::KeplerSplitting(
+    std::vector<not_null<MassiveBody const*>> bodies,
+    std::vector<Position<Frame>> const& positions,
+    typename NewtonianMotionEquation::RightHandSideComputation
+        compute_acceleration)
+    : bodies_(std::move(bodies)),
+      compute_acceleration_(std::move(compute_acceleration)) {
+  int const n = bodies_.size();
+  CHECK_EQ(n, positions.size());
+  CHECK_LT(0, n);
+  for (auto const body : bodies_) {
+    gravitational_parameters_.push_back(body->gravitational_parameter());
+  }
+
+  // The bodies by decreasing gravitational parameter, the first one being the
+  // root of the hierarchy.
+  std::vector<int> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(),
+                   order.end(),
+                   [this](int const left, int const right) {
+                     return gravitational_parameters_[left] >
+                            gravitational_parameters_[right];
+                   });
+
+  parents_.assign(n, -1);
+  std::vector<std::vector<int>> satellites(n);
+  for (int k = 1; k < n; ++k) {
+    int const body = order[k];
+    // Descend the hierarchy as long as |body| is in the Hill sphere of a
+    // satellite.
+    int primary = order[0];
+    for (bool descended = true; descended;) {
+      descended = false;
+      for (int const satellite : satellites[primary]) {
+        Length const hill_radius =
+            (positions[satellite] - positions[primary]).Norm() *
+            std::cbrt(gravitational_parameters_[satellite] /
+                      (3 * gravitational_parameters_[primary]));
+        if ((positions[body] - positions[satellite]).Norm() < hill_radius) {
+          primary = satellite;
+          descended = true;
+          break;
+        }
+      }
+    }
+    parents_[body] = primary;
+    satellites[primary].push_back(body);
+  }
+
+  // The satellites are merged by increasing distance to their primary.
+  for (int primary = 0; primary < n; ++primary) {
+    auto const distance = [&positions, primary](int const satellite) {
+      return (positions[satellite] - positions[primary]).Norm();
+    };
+    std::sort(satellites[primary].begin(),
+              satellites[primary].end(),
+              [&distance](int const left, int const right) {
+                return distance(left) < distance(right);
+              });
+  }
+  root_ = AddSubsystem(order[0], satellites);
+
+  int const subsystems = gravitational_parameters_.size();
+  barycentre_positions_.resize(subsystems);
+  barycentre_velocities_.resize(subsystems);
+  accelerations_.resize(n);
+  kepler_accelerations_.resize(subsystems);
+}
+
+template<typename Frame>
+typename KeplerSplitting<Frame>::DecomposableEquation
+KeplerSplitting<Frame>::equation() {
+  DecomposableEquation equation;
+  equation.left_flow = std::bind(&KeplerSplitting::Kick, this, _1, _2, _3, _4);
+  equation.right_flow =
+      std::bind(&KeplerSplitting::Drift, this, _1, _2, _3, _4);
+  return equation;
+}
+
+template<typename Frame>
+std::vector<int> const& KeplerSplitting<Frame>::parents() const {
+  return parents_;
+}
+
+template<typename Frame>
+int KeplerSplitting<Frame>::AddSubsystem(
+    int const primary,
+    std::vector<std::vector<int>> const& satellites) {
+  int subsystem = primary;
+  for (int const satellite : satellites[primary]) {
+    int const satellite_subsystem = AddSubsystem(satellite, satellites);
+    GravitationalParameter const μ =
+        gravitational_parameters_[subsystem] +
+        gravitational_parameters_[satellite_subsystem];
+    mergers_.push_back({.inner = subsystem,
+                        .outer = satellite_subsystem,
+                        .system = MassiveBody(μ)});
+    gravitational_parameters_.push_back(μ);
+    subsystem = gravitational_parameters_.size() - 1;
+  }
+  return subsystem;
+}
+
+template<typename Frame>
+void KeplerSplitting<Frame>::ComputeBarycentres(
+    std::vector<Position<Frame>> const& positions,
+    std::vector<Velocity<Frame>> const& velocities) {
+  int const n = bodies_.size();
+  std::copy(positions.begin(), positions.end(), barycentre_positions_.begin());
+  std::copy(
+      velocities.begin(), velocities.end(), barycentre_velocities_.begin());
+  // The mergers are in post-order, so the subsystems that they merge have
+  // already been computed.
+  for (int k = 0; k < mergers_.size(); ++k) {
+    Merger const& merger = mergers_[k];
+    int const merged = n + k;
+    double const outer_fraction = gravitational_parameters_[merger.outer] /
+                                  gravitational_parameters_[merged];
+    auto& q = barycentre_positions_;
+    auto& v = barycentre_velocities_;
+    q[merged] = q[merger.inner] + outer_fraction * (q[merger.outer] -
+                                                    q[merger.inner]);
+    v[merged] = v[merger.inner] + outer_fraction * (v[merger.outer] -
+                                                    v[merger.inner]);
+  }
+}
+
+template<typename Frame>
+absl::Status KeplerSplitting<Frame>::Kick(
+    Instant const& t_initial,
+    Instant const& t_final,
+    typename DecomposableEquation::State const& initial_state,
+    typename DecomposableEquation::State& final_state) {
+  int const n = bodies_.size();
+  Time const τ = t_final - t_initial;
+  auto const& [q₀, v₀] = initial_state;
+  auto& [q₁, v₁] = final_state;
+
+  absl::Status const status =
+      compute_acceleration_(t_initial, q₀, accelerations_);
+
+  // The accelerations of the Keplerian problems, first on the subsystems that
+  // they involve, then pushed down to the bodies from the root.
+  ComputeBarycentres(q₀, v₀);
+  auto& q = barycentre_positions_;
+  auto& a = kepler_accelerations_;
+  std::fill(a.begin(), a.end(), Vector<Acceleration, Frame>());
+  for (auto const& merger : mergers_) {
+    Displacement<Frame> const r = q[merger.outer] - q[merger.inner];
+    auto const r_over_r³ = r / Pow<3>(r.Norm());
+    a[merger.outer] -= gravitational_parameters_[merger.inner] * r_over_r³;
+    a[merger.inner] += gravitational_parameters_[merger.outer] * r_over_r³;
+  }
+  for (int k = mergers_.size() - 1; k >= 0; --k) {
+    Merger const& merger = mergers_[k];
+    int const merged = n + k;
+    a[merger.inner] += a[merged];
+    a[merger.outer] += a[merged];
+  }
+
+  for (int i = 0; i < n; ++i) {
+    q₁[i] = q₀[i];
+    v₁[i] = v₀[i] + τ * (accelerations_[i] - a[i]);
+  }
+  return status;
+}
+
+template<typename Frame>
+absl::Status KeplerSplitting<Frame>::Drift(
+    Instant const& t_initial,
+    Instant const& t_final,
+    typename DecomposableEquation::State const& initial_state,
+    typename DecomposableEquation::State& final_state) {
+  int const n = bodies_.size();
+  Time const τ = t_final - t_initial;
+  auto const& [q₀, v₀] = initial_state;
+  auto& [q₁, v₁] = final_state;
+
+  ComputeBarycentres(q₀, v₀);
+  auto& q = barycentre_positions_;
+  auto& v = barycentre_velocities_;
+  // The barycentre of the system moves uniformly.
+  q[root_] += v[root_] * τ;
+  // From the root down, the Jacobi coordinates of each merger are propagated
+  // and the barycentres of its subsystems are recovered from the propagated
+  // barycentre of the merged one.  The barycentres of the subsystems of a
+  // merger are only overwritten after its Jacobi coordinates are computed.
+  for (int k = mergers_.size() - 1; k >= 0; --k) {
+    Merger const& merger = mergers_[k];
+    int const merged = n + k;
+    RelativeDegreesOfFreedom<Frame> const jacobi_coordinates(
+        q[merger.outer] - q[merger.inner], v[merger.outer] - v[merger.inner]);
+    RelativeDegreesOfFreedom<Frame> const propagated =
+        KeplerOrbit<Frame>(merger.system,
+                           massless_body_,
+                           jacobi_coordinates,
+                           t_initial).StateVectors(t_final);
+    double const inner_fraction = gravitational_parameters_[merger.inner] /
+                                  gravitational_parameters_[merged];
+    double const outer_fraction = gravitational_parameters_[merger.outer] /
+                                  gravitational_parameters_[merged];
+    q[merger.inner] = q[merged] - outer_fraction * propagated.displacement();
+    q[merger.outer] = q[merged] + inner_fraction * propagated.displacement();
+    v[merger.inner] = v[merged] - outer_fraction * propagated.velocity();
+    v[merger.outer] = v[merged] + inner_fraction * propagated.velocity();
+  }
+
+  for (int i = 0; i < n; ++i) {
+    q₁[i] = q[i];
+    v₁[i] = v[i];
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace internal_kepler_splitting
+}  // namespace physics
+}  // namespace principia
@@ -0,0 +1,266 @@
+#include "physics/kepler_splitting.hpp"
+
+#include <vector>
+
+#include "absl/status/status.h"
+#include "base/not_null.hpp"
+#include "geometry/frame.hpp"
+#include "geometry/grassmann.hpp"
+#include "geometry/named_quantities.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "integrators/methods.hpp"
+#include "integrators/symplectic_partitioned_runge_kutta_integrator.hpp"
+#include "integrators/symplectic_runge_kutta_nyström_integrator.hpp"
+#include "physics/degrees_of_freedom.hpp"
+#include "physics/kepler_orbit.hpp"
+#include "physics/massive_body.hpp"
+#include "physics/massless_body.hpp"
+#include "quantities/elementary_functions.hpp"
+#include "quantities/named_quantities.hpp"
+#include "quantities/quantities.hpp"
+#include "quantities/si.hpp"
+#include "serialization/geometry.pb.h"
+#include "testing_utilities/matchers.hpp"
+
+namespace principia {
+namespace physics {
+
+using base::not_null;
+using geometry::Displacement;
+using geometry::Frame;
+using geometry::Handedness;
+using geometry::Inertial;
+using geometry::Instant;
+using geometry::Position;
+using geometry::Vector;
+using geometry::Velocity;
+using integrators::IntegrationProblem;
+using integrators::SymplecticPartitionedRungeKuttaIntegrator;
+using integrators::SymplecticRungeKuttaNyströmIntegrator;
+using quantities::Acceleration;
+using quantities::Angle;
+using quantities::Cos;
+using quantities::GravitationalParameter;
+using quantities::Length;
+using quantities::Pow;
+using quantities::Sin;
+using quantities::Speed;
+using quantities::Sqrt;
+using quantities::Time;
+using quantities::si::Day;
+using quantities::si::Kilo;
+using quantities::si::Metre;
+using quantities::si::Minute;
+using quantities::si::Radian;
+using ::testing::ElementsAre;
+using ::testing::Lt;
+namespace si = quantities::si;
+
+class KeplerSplittingTest : public ::testing::Test {
+ protected:
+  using World = Frame<serialization::Frame::TestTag,
+                      Inertial,
+                      Handedness::Right,
+                      serialization::Frame::TEST>;
+  using NewtonianMotionEquation =
+      KeplerSplitting<World>::NewtonianMotionEquation;
+  using DecomposableEquation = KeplerSplitting<World>::DecomposableEquation;
+
+  KeplerSplittingTest()
+      : sun_(1.32712440018e20 * si::Unit<GravitationalParameter>),
+        earth_(3.986004418e14 * si::Unit<GravitationalParameter>),
+        moon_(4.9048695e12 * si::Unit<GravitationalParameter>),
+        jupiter_(1.26686534e17 * si::Unit<GravitationalParameter>) {}
+
+  // The degrees of freedom of a circular orbit of radius |r| around a primary,
+  // in a plane inclined by |i| on the x-y plane, at the given |phase|.
+  static RelativeDegreesOfFreedom<World> Circular(
+      GravitationalParameter const& μ,
+      Length const& r,
+      Angle const& phase,
+      Angle const& i) {
+    Speed const v = Sqrt(μ / r);
+    return RelativeDegreesOfFreedom<World>(
+        Displacement<World>({r * Cos(phase),
+                             r * Sin(phase) * Cos(i),
+                             r * Sin(phase) * Sin(i)}),
+        Velocity<World>({-v * Sin(phase),
+                         v * Cos(phase) * Cos(i),
+                         v * Cos(phase) * Sin(i)}));
+  }
+
+  // The point-mass gravitation of the given |bodies|.
+  static NewtonianMotionEquation::RightHandSideComputation Gravitation(
+      std::vector<not_null<MassiveBody const*>> const& bodies) {
+    return [bodies](Instant const& t,
+                    std::vector<Position<World>> const& positions,
+                    std::vector<Vector<Acceleration, World>>& accelerations) {
+      for (auto& acceleration : accelerations) {
+        acceleration = Vector<Acceleration, World>();
+      }
+      for (int i = 0; i < bodies.size(); ++i) {
+        for (int j = i + 1; j < bodies.size(); ++j) {
+          Displacement<World> const r = positions[j] - positions[i];
+          auto const r_over_r³ = r / Pow<3>(r.Norm());
+          accelerations[i] += bodies[j]->gravitational_parameter() * r_over_r³;
+          accelerations[j] -= bodies[i]->gravitational_parameter() * r_over_r³;
+        }
+      }
+      return absl::OkStatus();
+    };
+  }
+
+  // The Sun at rest at the origin, and the Earth, the Moon and Jupiter on
+  // nearly circular orbits.
+  void SolarSystem(std::vector<not_null<MassiveBody const*>>& bodies,
+                   std::vector<Position<World>>& positions,
+                   std::vector<Velocity<World>>& velocities) const {
+    auto const earth = Circular(sun_.gravitational_parameter() +
+                                    earth_.gravitational_parameter(),
+                                1.496e11 * Metre,
+                                0 * Radian,
+                                0 * Radian);
+    auto const moon = Circular(earth_.gravitational_parameter() +
+                                   moon_.gravitational_parameter(),
+                               3.844e8 * Metre,
+                               1 * Radian,
+                               0.09 * Radian);
+    auto const jupiter = Circular(sun_.gravitational_parameter() +
+                                      jupiter_.gravitational_parameter(),
+                                  7.785e11 * Metre,
+                                  2 * Radian,
+                                  0.02 * Radian);
+    bodies = {&sun_, &earth_, &moon_, &jupiter_};
+    positions = {World::origin,
+                 World::origin + earth.displacement(),
+                 World::origin + earth.displacement() + moon.displacement(),
+                 World::origin + jupiter.displacement()};
+    velocities = {World::unmoving,
+                  earth.velocity(),
+                  earth.velocity() + moon.velocity(),
+                  jupiter.velocity()};
+  }
+
+  MassiveBody const sun_;
+  MassiveBody const earth_;
+  MassiveBody const moon_;
+  MassiveBody const jupiter_;
+  Instant const t0_;
+};
+
+TEST_F(KeplerSplittingTest, Hierarchy) {
+  std::vector<not_null<MassiveBody const*>> bodies;
+  std::vector<Position<World>> positions;
+  std::vector<Velocity<World>> velocities;
+  SolarSystem(bodies, positions, velocities);
+  KeplerSplitting<World> const splitting(
+      bodies, positions, Gravitation(bodies));
+  // The Moon is in the Hill sphere of the Earth.
+  EXPECT_THAT(splitting.parents(), ElementsAre(-1, 0, 1, 0));
+}
+
+// For two bodies the kicks vanish, so the drifts are exact whatever the step.
+TEST_F(KeplerSplittingTest, TwoBodies) {
+  std::vector<not_null<MassiveBody const*>> const bodies = {&sun_, &earth_};
+  GravitationalParameter const μ =
+      sun_.gravitational_parameter() + earth_.gravitational_parameter();
+  // An eccentric orbit.
+  auto const circular = Circular(μ, 1.496e11 * Metre, 0 * Radian, 0 * Radian);
+  RelativeDegreesOfFreedom<World> const earth(circular.displacement(),
+                                              1.1 * circular.velocity());
+  std::vector<Position<World>> const positions = {
+      World::origin, World::origin + earth.displacement()};
+
+  KeplerSplitting<World> splitting(bodies, positions, Gravitation(bodies));
+  IntegrationProblem<DecomposableEquation> problem;
+  problem.equation = splitting.equation();
+  problem.initial_state = DecomposableEquation::SystemState(
+      {positions, {World::unmoving, earth.velocity()}}, t0_);
+  DecomposableEquation::SystemState final_state;
+  auto const instance =
+      SymplecticPartitionedRungeKuttaIntegrator<
+          integrators::methods::NewtonDelambreStørmerVerletLeapfrog,
+          Position<World>>()
+          .NewInstance(problem,
+                       [&final_state](auto const& state) {
+                         final_state = state;
+                       },
+                       /*step=*/10 * Day);
+  Instant const t_final = t0_ + 360 * Day;
+  EXPECT_OK(instance->Solve(t_final));
+
+  auto const& [q, v] = final_state.y;
+  RelativeDegreesOfFreedom<World> const expected =
+      KeplerOrbit<World>(MassiveBody(μ), MasslessBody{}, earth, t0_)
+          .StateVectors(t_final);
+  EXPECT_THAT((q[1].value - q[0].value - expected.displacement()).Norm(),
+              Lt(100 * Metre));
+}
+
+// The splitting is much more accurate than a leapfrog on the full equation
+// with the same step, because the motion of the Moon around the Earth is
+// integrated exactly.
+TEST_F(KeplerSplittingTest, Accuracy) {
+  std::vector<not_null<MassiveBody const*>> bodies;
+  std::vector<Position<World>> positions;
+  std::vector<Velocity<World>> velocities;
+  SolarSystem(bodies, positions, velocities);
+  Instant const t_final = t0_ + 60 * Day;
+  Time const step = 1 * Day;
+
+  IntegrationProblem<NewtonianMotionEquation> newtonian_problem;
+  newtonian_problem.equation.compute_acceleration = Gravitation(bodies);
+  newtonian_problem.initial_state =
+      NewtonianMotionEquation::SystemState(positions, velocities, t0_);
+  NewtonianMotionEquation::SystemState newtonian_state;
+  auto const append_newtonian_state =
+      [&newtonian_state](NewtonianMotionEquation::SystemState const& state) {
+        newtonian_state = state;
+      };
+
+  auto const reference_instance =
+      SymplecticRungeKuttaNyströmIntegrator<
+          integrators::methods::BlanesMoan2002SRKN14A,
+          Position<World>>()
+          .NewInstance(newtonian_problem,
+                       append_newtonian_state,
+                       /*step=*/10 * Minute);
+  EXPECT_OK(reference_instance->Solve(t_final));
+  Position<World> const reference_moon = newtonian_state.positions[2].value;
+
+  auto const leapfrog_instance =
+      SymplecticRungeKuttaNyströmIntegrator<
+          integrators::methods::NewtonDelambreStørmerVerletLeapfrog,
+          serialization::FixedStepSizeIntegrator::ABA,
+          Position<World>>()
+          .NewInstance(newtonian_problem, append_newtonian_state, step);
+  EXPECT_OK(leapfrog_instance->Solve(t_final));
+  Length const leapfrog_error =
+      (newtonian_state.positions[2].value - reference_moon).Norm();
+
+  KeplerSplitting<World> splitting(bodies, positions, Gravitation(bodies));
+  IntegrationProblem<DecomposableEquation> problem;
+  problem.equation = splitting.equation();
+  problem.initial_state =
+      DecomposableEquation::SystemState({positions, velocities}, t0_);
+  DecomposableEquation::SystemState final_state;
+  auto const splitting_instance =
+      SymplecticPartitionedRungeKuttaIntegrator<
+          integrators::methods::NewtonDelambreStørmerVerletLeapfrog,
+          Position<World>>()
+          .NewInstance(problem,
+                       [&final_state](auto const& state) {
+                         final_state = state;
+                       },
+                       step);
+  EXPECT_OK(splitting_instance->Solve(t_final));
+  Length const splitting_error =
+      (std::get<0>(final_state.y)[2].value - reference_moon).Norm();
+
+  EXPECT_THAT(splitting_error, Lt(500 * Kilo(Metre)));
+  EXPECT_THAT(splitting_error, Lt(leapfrog_error / 100));
+}
+
+}  // namespace physics
+}  // namespace principia
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "base/not_null.hpp"
+#include "geometry/named_quantities.hpp"
+#include "integrators/integrators.hpp"
+#include "integrators/ordinary_differential_equations.hpp"
+#include "physics/continuous_trajectory.hpp"
+#include "physics/degrees_of_freedom.hpp"
+#include "physics/discrete_trajectory.hpp"
+#include "physics/ephemeris.hpp"
+#include "physics/massive_body.hpp"
+#include "quantities/named_quantities.hpp"
+#include "quantities/quantities.hpp"
+
+namespace principia {
+namespace physics {
+namespace internal_kustaanheimo_stiefel_flow {
+
+using base::not_null;
+using geometry::Instant;
+using integrators::AdaptiveStepSizeIntegrator;
+using integrators::ExplicitFirstOrderOrdinaryDifferentialEquation;
+using quantities::Length;
+using quantities::Speed;
+using quantities::Time;
+
+// Flows a massless body in the gravitational field of an |Ephemeris| using the
+// regularization of Kustaanheimo and Stiefel, see [SS71], chapters 2 and 3.
+// The position of the body with respect to a |primary| is L(u) u, where u is a
+// four-dimensional vector and L(u) is the Kustaanheimo-Stiefel matrix, and the
+// motion is integrated in a fictitious time s such that dt = r ds, where r is
+// the distance to the primary.  The Keplerian motion around the primary then
+// becomes a harmonic oscillator in s, so that an adaptive integrator takes
+// steps of nearly constant size in the eccentric anomaly, instead of tiny steps
+// around the periapsis and needlessly many around the apoapsis of eccentric
+// orbits.  The perturbations, i.e., the gravitation of the other bodies, the
+// geopotential of the primary and the acceleration of the primary itself,
+// enter the equations of motion and that of the Keplerian energy, which is part
+// of the state.
+//
+// The equations are made dimensionless using the initial distance to the
+// primary and the corresponding circular orbit.  The integration proceeds in s
+// until the time, which is part of the state, passes the final time, and the
+// last step is then recomputed to end at that time.
+//
+// Intrinsic accelerations and collisions are not supported.  This class is not
+// thread-safe.
+template<typename Frame>
+class KustaanheimoStiefelFlow {
+ public:
+  // The fictitious time.
+  using IndependentVariable = double;
+
+  // The state variables are u and u′ (4 elements each), the opposite of the
+  // Keplerian energy and the time (1 element each).
+  using ODE =
+      ExplicitFirstOrderOrdinaryDifferentialEquation<IndependentVariable,
+                                                     double,
+                                                     double,
+                                                     double,
+                                                     Instant>;
+
+  class AdaptiveParameters final {
+   public:
+    AdaptiveParameters(AdaptiveStepSizeIntegrator<ODE> const& integrator,
+                       std::int64_t max_steps,
+                       Length const& length_integration_tolerance,
+                       Speed const& speed_integration_tolerance);
+
+    AdaptiveStepSizeIntegrator<ODE> const& integrator() const;
+    std::int64_t max_steps() const;
+    Length length_integration_tolerance() const;
+    Speed speed_integration_tolerance() const;
+
+   private:
+    // This will refer to a static object returned by a factory.
+    not_null<AdaptiveStepSizeIntegrator<ODE> const*> integrator_;
+    std::int64_t max_steps_;
+    Length length_integration_tolerance_;
+    Speed speed_integration_tolerance_;
+  };
+
+  // |primary| must be one of the bodies of the |ephemeris|.
+  KustaanheimoStiefelFlow(AdaptiveParameters const& parameters,
+                          not_null<Ephemeris<Frame>*> ephemeris,
+                          not_null<MassiveBody const*> primary);
+
+  // Integrates the motion of a massless body from the last point of
+  // |trajectory| until |t_final|, appending a point to |trajectory| after each
+  // step.  Unless an error is returned, the last point is at |t_final|.  The
+  // |ephemeris| is prolonged as needed.
+  absl::Status FlowWithAdaptiveStep(
+      not_null<DiscreteTrajectory<Frame>*> trajectory,
+      Instant const& t_final);
+
+ private:
+  using IndependentVariableDifference =
+      typename ODE::IndependentVariableDifference;
+  using State = typename ODE::State;
+  using StateVariation = typename ODE::StateVariation;
+  using SystemState = typename ODE::SystemState;
+  using SystemStateError = typename ODE::SystemStateError;
+
+  static constexpr IndependentVariableDifference first_s_step_ = 1e-2;
+  // The number of iterations of Newton's method used to find the last step.
+  static constexpr int max_last_step_iterations_ = 4;
+
+  // The regularized state corresponding to the given degrees of freedom
+  // with respect to the primary, at s = 0.
+  SystemState ToRegularized(
+      RelativeDegreesOfFreedom<Frame> const& relative_degrees_of_freedom,
+      Instant const& t) const;
+  DegreesOfFreedom<Frame> FromRegularized(SystemState const& state) const;
+
+  // The time and the derivative of the time with respect to s in |state|.
+  static Instant const& TimeOf(SystemState const& state);
+  Time TimeDerivativeOf(SystemState const& state) const;
+
+  // Returns the index of |primary| in the bodies of |ephemeris|.
+  static std::size_t IndexOfPrimary(Ephemeris<Frame> const& ephemeris,
+                                    not_null<MassiveBody const*> primary);
+
+  // Sets |u_| and |uʹ_| from |state|.
+  void SetErrorReference(SystemState const& state);
+
+  absl::Status RightHandSide(IndependentVariable s,
+                             State const& state,
+                             StateVariation& variation);
+
+  double ToleranceToErrorRatio(IndependentVariableDifference current_s_step,
+                               SystemStateError const& error) const;
+
+  AdaptiveParameters const parameters_;
+  not_null<Ephemeris<Frame>*> const ephemeris_;
+  not_null<MassiveBody const*> const primary_;
+  not_null<ContinuousTrajectory<Frame> const*> const primary_trajectory_;
+  // The index of the |primary_| in the bodies of the |ephemeris_|, used to
+  // look up its position among those of the massive bodies.
+  std::size_t const primary_index_;
+
+  // Set at the beginning of each flow.
+  Length characteristic_length_;
+  Time characteristic_time_;
+  Instant t_final_;
+  // If true, |RightHandSide| aborts the integration once the time passes
+  // |t_final_|.
+  bool stop_after_t_final_ = false;
+
+  // The values of u and u′ at the beginning of the current step, used to
+  // convert the errors on the state into errors on the degrees of freedom.
+  std::vector<double> u_;
+  std::vector<double> uʹ_;
+};
+
+}  // namespace internal_kustaanheimo_stiefel_flow
+
+using internal_kustaanheimo_stiefel_flow::KustaanheimoStiefelFlow;
+
+}  // namespace physics
+}  // namespace principia
+
+#include "physics/kustaanheimo_stiefel_flow_body.hpp"
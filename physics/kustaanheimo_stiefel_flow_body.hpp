@@ -0,0 +1,427 @@
+#pragma once
+
+#include "physics/kustaanheimo_stiefel_flow.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+#include "base/macros.hpp"
+#include "base/status_utilities.hpp"
+#include "geometry/grassmann.hpp"
+#include "quantities/elementary_functions.hpp"
+
+namespace principia {
+namespace physics {
+namespace internal_kustaanheimo_stiefel_flow {
+
+using geometry::Displacement;
+using geometry::Position;
+using geometry::Vector;
+using geometry::Velocity;
+using integrators::IntegrationProblem;
+using quantities::Abs;
+using quantities::Acceleration;
+using quantities::Infinity;
+using quantities::Pow;
+using quantities::Sqrt;
+using ::std::placeholders::_1;
+using ::std::placeholders::_2;
+using ::std::placeholders::_3;
+
+// L(u) x, where L(u) is the Kustaanheimo-Stiefel matrix of u, see [SS71],
+// section 9.
+inline std::array<double, 4> KustaanheimoStiefelProduct(
+    std::array<double, 4> const& u,
+    std::array<double, 4> const& x) {
+  auto const& [u₁, u₂, u₃, u₄] = u;
+  auto const& [x₁, x₂, x₃, x₄] = x;
+  return {u₁ * x₁ - u₂ * x₂ - u₃ * x₃ + u₄ * x₄,
+          u₂ * x₁ + u₁ * x₂ - u₄ * x₃ - u₃ * x₄,
+          u₃ * x₁ + u₄ * x₂ + u₁ * x₃ + u₂ * x₄,
+          u₄ * x₁ - u₃ * x₂ + u₂ * x₃ - u₁ * x₄};
+}
+
+// L(u)ᵀ x.
+inline std::array<double, 4> KustaanheimoStiefelTransposedProduct(
+    std::array<double, 4> const& u,
+    std::array<double, 4> const& x) {
+  auto const& [u₁, u₂, u₃, u₄] = u;
+  auto const& [x₁, x₂, x₃, x₄] = x;
+  return {u₁ * x₁ + u₂ * x₂ + u₃ * x₃ + u₄ * x₄,
+          -u₂ * x₁ + u₁ * x₂ + u₄ * x₃ - u₃ * x₄,
+          -u₃ * x₁ - u₄ * x₂ + u₁ * x₃ + u₂ * x₄,
+          u₄ * x₁ - u₃ * x₂ - u₂ * x₃ - u₁ * x₄};
+}
+
+inline double SquaredNorm(std::array<double, 4> const& x) {
+  return x[0] * x[0] + x[1] * x[1] + x[2] * x[2] + x[3] * x[3];
+}
+
+template<typename T>
+std::array<double, 4> ToArray(std::vector<T> const& v) {
+  if constexpr (std::is_same_v<T, double>) {
+    return {v[0], v[1], v[2], v[3]};
+  } else {
+    return {v[0].value, v[1].value, v[2].value, v[3].value};
+  }
+}
+
+template<typename Frame>
+KustaanheimoStiefelFlow<Frame>::AdaptiveParameters::AdaptiveParameters(
+    AdaptiveStepSizeIntegrator<ODE> const& integrator,
+    std::int64_t const max_steps,
+    Length const& length_integration_tolerance,
+    Speed const& speed_integration_tolerance)
+    : integrator_(&integrator),
+      max_steps_(max_steps),
+      length_integration_tolerance_(length_integration_tolerance),
+      speed_integration_tolerance_(speed_integration_tolerance) {}
+
+template<typename Frame>
+auto KustaanheimoStiefelFlow<Frame>::AdaptiveParameters::integrator() const
+    -> AdaptiveStepSizeIntegrator<ODE> const& {
+  return *integrator_;
+}
+
+template<typename Frame>
+std::int64_t
+KustaanheimoStiefelFlow<Frame>::AdaptiveParameters::max_steps() const {
+  return max_steps_;
+}
+
+template<typename Frame>
+Length KustaanheimoStiefelFlow<Frame>::AdaptiveParameters::
+length_integration_tolerance() const {
+  return length_integration_tolerance_;
+}
+
+template<typename Frame>
+Speed KustaanheimoStiefelFlow<Frame>::AdaptiveParameters::
+speed_integration_tolerance() const {
+  return speed_integration_tolerance_;
+}
+
+template<typename Frame>
+KustaanheimoStiefelFlow<Frame>::KustaanheimoStiefelFlow(
+    AdaptiveParameters const& parameters,
+    not_null<Ephemeris<Frame>*> const ephemeris,
+    not_null<MassiveBody const*> const primary)
+    : parameters_(parameters),
+      ephemeris_(ephemeris),
+      primary_(primary),
+      primary_trajectory_(ephemeris->trajectory(primary)),
+      primary_index_(IndexOfPrimary(*ephemeris, primary)) {}
+
+template<typename Frame>
+absl::Status KustaanheimoStiefelFlow<Frame>::FlowWithAdaptiveStep(
+    not_null<DiscreteTrajectory<Frame>*> const trajectory,
+    Instant const& t_final) {
+  auto const& [t_initial, degrees_of_freedom] = trajectory->back();
+  if (t_initial == t_final) {
+    return absl::OkStatus();
+  }
+  CHECK_LT(t_initial, t_final) << "Flow back to the future";
+  RETURN_IF_ERROR(ephemeris_->Prolong(t_final));
+
+  RelativeDegreesOfFreedom<Frame> const relative_degrees_of_freedom =
+      degrees_of_freedom -
+      primary_trajectory_->EvaluateDegreesOfFreedom(t_initial);
+  characteristic_length_ = relative_degrees_of_freedom.displacement().Norm();
+  characteristic_time_ = Sqrt(Pow<3>(characteristic_length_) /
+                              primary_->gravitational_parameter());
+  t_final_ = t_final;
+
+  IntegrationProblem<ODE> problem;
+  problem.equation.compute_derivative =
+      std::bind(&KustaanheimoStiefelFlow::RightHandSide, this, _1, _2, _3);
+  problem.initial_state =
+      ToRegularized(relative_degrees_of_freedom, t_initial);
+  auto const tolerance_to_error_ratio =
+      std::bind(&KustaanheimoStiefelFlow::ToleranceToErrorRatio, this, _1, _2);
+  SetErrorReference(problem.initial_state);
+
+  // The last state before |t_final|, from which the last step is recomputed.
+  SystemState last_state = problem.initial_state;
+  std::int64_t steps = 0;
+  typename AdaptiveStepSizeIntegrator<ODE>::AppendState const append_state =
+      [this, &last_state, &steps, t_final, trajectory](
+          SystemState const& state) {
+        ++steps;
+        if (TimeOf(state) < t_final) {
+          last_state = state;
+          SetErrorReference(state);
+          trajectory->Append(TimeOf(state),
+                             FromRegularized(state)).IgnoreError();
+        }
+      };
+
+  // Integrate in s until |RightHandSide| sees a time past |t_final|.
+  stop_after_t_final_ = true;
+  auto const instance = parameters_.integrator().NewInstance(
+      problem,
+      append_state,
+      tolerance_to_error_ratio,
+      typename AdaptiveStepSizeIntegrator<ODE>::Parameters(
+          /*first_step=*/first_s_step_,
+          /*safety_factor=*/0.9,
+          parameters_.max_steps(),
+          /*last_step_is_exact=*/false));
+  absl::Status const status =
+      instance->Solve(Infinity<IndependentVariable>);
+  stop_after_t_final_ = false;
+  if (!absl::IsAborted(status) || steps == parameters_.max_steps()) {
+    return status;
+  }
+
+  // Recompute the last step, finding with Newton's method the step in s that
+  // ends at |t_final|.
+  problem.initial_state = last_state;
+  IndependentVariable const s_last = last_state.s.value;
+  IndependentVariableDifference Δs =
+      (t_final - TimeOf(last_state)) / TimeDerivativeOf(last_state);
+  SystemState final_state = last_state;
+  for (int i = 0; i < max_last_step_iterations_; ++i) {
+    if (s_last + Δs == s_last) {
+      break;
+    }
+    SetErrorReference(last_state);
+    auto const last_step_instance = parameters_.integrator().NewInstance(
+        problem,
+        [this, &final_state](SystemState const& state) {
+          final_state = state;
+          SetErrorReference(state);
+        },
+        tolerance_to_error_ratio,
+        typename AdaptiveStepSizeIntegrator<ODE>::Parameters(
+            /*first_step=*/Δs,
+            /*safety_factor=*/0.9,
+            parameters_.max_steps(),
+            /*last_step_is_exact=*/true));
+    RETURN_IF_ERROR(last_step_instance->Solve(s_last + Δs));
+    Time const δt = t_final - TimeOf(final_state);
+    // The speed relative to the primary is 2 |u′| / |u|.
+    Speed const relative_speed =
+        2 * std::sqrt(SquaredNorm(ToArray(std::get<1>(final_state.y))) /
+                      SquaredNorm(ToArray(std::get<0>(final_state.y)))) *
+        (characteristic_length_ / characteristic_time_);
+    if (Abs(δt) * relative_speed <=
+        parameters_.length_integration_tolerance()) {
+      break;
+    }
+    Δs += δt / TimeDerivativeOf(final_state);
+  }
+
+  // The difference in time left by Newton's method is small, so a first-order
+  // correction is enough.
+  Instant const& t_end = TimeOf(final_state);
+  RETURN_IF_ERROR(ephemeris_->Prolong(t_end));
+  DegreesOfFreedom<Frame> const end = FromRegularized(final_state);
+  Time const δt = t_final - t_end;
+  trajectory->Append(
+      t_final,
+      DegreesOfFreedom<Frame>(
+          end.position() + end.velocity() * δt,
+          end.velocity() +
+              ephemeris_->ComputeGravitationalAccelerationOnMasslessBody(
+                  end.position(), t_end) * δt)).IgnoreError();
+  return absl::OkStatus();
+}
+
+template<typename Frame>
+auto KustaanheimoStiefelFlow<Frame>::ToRegularized(
+    RelativeDegreesOfFreedom<Frame> const& relative_degrees_of_freedom,
+    Instant const& t) const -> SystemState {
+  Length const& L = characteristic_length_;
+  Time const& T = characteristic_time_;
+  auto const x =
+      relative_degrees_of_freedom.displacement().coordinates() / L;
+  auto const v =
+      relative_degrees_of_freedom.velocity().coordinates() * (T / L);
+  double const r = x.Norm();
+
+  // Among the vectors u such that L(u) u = x, pick the one that is
+  // numerically well-conditioned, see [SS71], section 9.
+  std::array<double, 4> u;
+  if (x.x >= 0) {
+    u[0] = std::sqrt((r + x.x) / 2);
+    u[1] = x.y / (2 * u[0]);
+    u[2] = x.z / (2 * u[0]);
+    u[3] = 0;
+  } else {
+    u[1] = std::sqrt((r - x.x) / 2);
+    u[0] = x.y / (2 * u[1]);
+    u[2] = 0;
+    u[3] = x.z / (2 * u[1]);
+  }
+  std::array<double, 4> uʹ =
+      KustaanheimoStiefelTransposedProduct(u, {v.x, v.y, v.z, 0});
+  for (auto& uʹᵢ : uʹ) {
+    uʹᵢ /= 2;
+  }
+  double const η = 1 / r - v.Norm²() / 2;
+
+  State const state(std::vector<double>(u.begin(), u.end()),
+                    std::vector<double>(uʹ.begin(), uʹ.end()),
+                    std::vector<double>{η},
+                    std::vector<Instant>{t});
+  return SystemState(/*s=*/0, state);
+}
+
+template<typename Frame>
+DegreesOfFreedom<Frame> KustaanheimoStiefelFlow<Frame>::FromRegularized(
+    SystemState const& state) const {
+  Length const& L = characteristic_length_;
+  Time const& T = characteristic_time_;
+  auto const u = ToArray(std::get<0>(state.y));
+  auto const uʹ = ToArray(std::get<1>(state.y));
+  double const ρ = SquaredNorm(u);
+  auto const x = KustaanheimoStiefelProduct(u, u);
+  auto const L_uʹ = KustaanheimoStiefelProduct(u, uʹ);
+  RelativeDegreesOfFreedom<Frame> const relative_degrees_of_freedom(
+      Displacement<Frame>({x[0] * L, x[1] * L, x[2] * L}),
+      Velocity<Frame>({2 * L_uʹ[0] / ρ * (L / T),
+                       2 * L_uʹ[1] / ρ * (L / T),
+                       2 * L_uʹ[2] / ρ * (L / T)}));
+  return primary_trajectory_->EvaluateDegreesOfFreedom(TimeOf(state)) +
+         relative_degrees_of_freedom;
+}
+
+template<typename Frame>
+Instant const& KustaanheimoStiefelFlow<Frame>::TimeOf(
+    SystemState const& state) {
+  return std::get<3>(state.y).front().value;
+}
+
+template<typename Frame>
+Time KustaanheimoStiefelFlow<Frame>::TimeDerivativeOf(
+    SystemState const& state) const {
+  return characteristic_time_ * SquaredNorm(ToArray(std::get<0>(state.y)));
+}
+
+template<typename Frame>
+std::size_t KustaanheimoStiefelFlow<Frame>::IndexOfPrimary(
+    Ephemeris<Frame> const& ephemeris,
+    not_null<MassiveBody const*> const primary) {
+  for (std::size_t b = 0; b < ephemeris.bodies_.size(); ++b) {
+    if (ephemeris.bodies_[b].get() == primary) {
+      return b;
+    }
+  }
+  LOG(FATAL) << primary->name() << " is not in the ephemeris";
+  base::noreturn();
+}
+
+template<typename Frame>
+void KustaanheimoStiefelFlow<Frame>::SetErrorReference(
+    SystemState const& state) {
+  auto const u = ToArray(std::get<0>(state.y));
+  auto const uʹ = ToArray(std::get<1>(state.y));
+  u_.assign(u.begin(), u.end());
+  uʹ_.assign(uʹ.begin(), uʹ.end());
+}
+
+template<typename Frame>
+absl::Status KustaanheimoStiefelFlow<Frame>::RightHandSide(
+    IndependentVariable const s,
+    State const& state,
+    StateVariation& variation) {
+  Length const& L = characteristic_length_;
+  Time const& T = characteristic_time_;
+  auto const& [u, uʹ, η, t] = state;
+  auto& [u_derivative, uʹ_derivative, η_derivative, t_derivative] =
+      variation;
+  Instant const& tₛ = t.front();
+
+  // The stages of the last step may go beyond |t_final_|.
+  if (tₛ > ephemeris_->t_max()) {
+    RETURN_IF_ERROR(ephemeris_->Prolong(tₛ));
+  }
+
+  auto const u_array = ToArray(u);
+  double const ρ = SquaredNorm(u_array);
+  auto const x = KustaanheimoStiefelProduct(u_array, u_array);
+  Displacement<Frame> const displacement({x[0] * L, x[1] * L, x[2] * L});
+
+  // The massive bodies are evaluated once for the accelerations of the
+  // massless body and of the primary.  The buffers are reused across calls on
+  // the same thread.
+  thread_local std::vector<Position<Frame>> massive_positions;
+  thread_local std::vector<Position<Frame>> positions(1);
+  thread_local std::vector<Vector<Acceleration, Frame>> accelerations(1);
+  ephemeris_->EvaluateMassiveBodiesPositions(
+      tₛ, /*use_positions_cache=*/false, massive_positions);
+  positions[0] = massive_positions[primary_index_] + displacement;
+  // Collisions are not supported, so the status is ignored.
+  ephemeris_->
+      ComputeGravitationalAccelerationByAllMassiveBodiesOnMasslessBodies(
+          tₛ, massive_positions, positions, accelerations);
+
+  // The perturbing acceleration, i.e., the acceleration relative to the
+  // primary minus the Keplerian one.
+  Vector<Acceleration, Frame> const perturbation =
+      accelerations[0] -
+      ephemeris_->ComputeGravitationalAccelerationOnMassiveBodyInSerialOrder(
+          tₛ, primary_index_, massive_positions) +
+      primary_->gravitational_parameter() * displacement /
+          Pow<3>(ρ * L);
+  auto const P = (perturbation * (Pow<2>(T) / L)).coordinates();
+  auto const Lᵀ_P = KustaanheimoStiefelTransposedProduct(u_array,
+                                                          {P.x, P.y, P.z, 0});
+
+  // [SS71], section 9, equations (53) and (54).
+  double ηʹ = 0;
+  for (int i = 0; i < 4; ++i) {
+    u_derivative[i] = uʹ[i];
+    uʹ_derivative[i] = -η.front() / 2 * u[i] + ρ / 2 * Lᵀ_P[i];
+    ηʹ -= 2 * uʹ[i] * Lᵀ_P[i];
+  }
+  η_derivative.front() = ηʹ;
+  t_derivative.front() = T * ρ;
+
+  if (stop_after_t_final_ && tₛ >= t_final_) {
+    return absl::AbortedError("Reached the final time");
+  }
+  return absl::OkStatus();
+}
+
+template<typename Frame>
+double KustaanheimoStiefelFlow<Frame>::ToleranceToErrorRatio(
+    IndependentVariableDifference const current_s_step,
+    SystemStateError const& error) const {
+  Length const& L = characteristic_length_;
+  Time const& T = characteristic_time_;
+  auto const& [δu, δuʹ, δη, δt] = error;
+  double const u = std::sqrt(SquaredNorm(ToArray(u_)));
+  double const uʹ = std::sqrt(SquaredNorm(ToArray(uʹ_)));
+  double const δu_norm = std::sqrt(SquaredNorm(ToArray(δu)));
+  double const δuʹ_norm = std::sqrt(SquaredNorm(ToArray(δuʹ)));
+  // The dimensionless speed relative to the primary.
+  double const v = 2 * uʹ / u;
+
+  // First-order bounds of the errors on the position and velocity from the
+  // errors on u and u′, obtained by differentiating x = L(u) u and
+  // v = 2 L(u) u′ / |u|².
+  Length const length_error = 2 * u * δu_norm * L;
+  Speed const speed_error = (2 * δuʹ_norm + 3 * v * δu_norm) / u * (L / T);
+  // An error on the energy is an error on the speed, and an error on the time
+  // is an error on the position along the orbit.
+  double const δη_abs = std::abs(δη.front());
+  Speed const energy_speed_error =
+      std::min(δη_abs / v, std::sqrt(2 * δη_abs)) * (L / T);
+  Length const time_length_error = Abs(δt.front()) * v * (L / T);
+
+  return std::min({parameters_.length_integration_tolerance() / length_error,
+                   parameters_.length_integration_tolerance() /
+                       time_length_error,
+                   parameters_.speed_integration_tolerance() / speed_error,
+                   parameters_.speed_integration_tolerance() /
+                       energy_speed_error});
+}
+
+}  // namespace internal_kustaanheimo_stiefel_flow
+}  // namespace physics
+}  // namespace principia
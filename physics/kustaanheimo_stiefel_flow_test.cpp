@@ -0,0 +1,185 @@
+#include "physics/kustaanheimo_stiefel_flow.hpp"
+
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "base/not_null.hpp"
+#include "geometry/frame.hpp"
+#include "geometry/grassmann.hpp"
+#include "geometry/named_quantities.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "integrators/embedded_explicit_runge_kutta_integrator.hpp"
+#include "integrators/embedded_explicit_runge_kutta_nyström_integrator.hpp"
+#include "integrators/methods.hpp"
+#include "integrators/symmetric_linear_multistep_integrator.hpp"
+#include "physics/degrees_of_freedom.hpp"
+#include "physics/discrete_trajectory.hpp"
+#include "physics/ephemeris.hpp"
+#include "physics/kepler_orbit.hpp"
+#include "physics/massive_body.hpp"
+#include "physics/massless_body.hpp"
+#include "quantities/elementary_functions.hpp"
+#include "quantities/named_quantities.hpp"
+#include "quantities/quantities.hpp"
+#include "quantities/si.hpp"
+#include "testing_utilities/matchers.hpp"
+#include "testing_utilities/numerics.hpp"
+
+namespace principia {
+namespace physics {
+
+using base::make_not_null_unique;
+using base::not_null;
+using geometry::Displacement;
+using geometry::Frame;
+using geometry::Inertial;
+using geometry::Instant;
+using geometry::Position;
+using geometry::Velocity;
+using integrators::EmbeddedExplicitRungeKuttaIntegrator;
+using integrators::EmbeddedExplicitRungeKuttaNyströmIntegrator;
+using integrators::SymmetricLinearMultistepIntegrator;
+using integrators::methods::DormandPrince1986RK547FC;
+using integrators::methods::DormandالمكاوىPrince1986RKN434FM;
+using integrators::methods::QuinlanTremaine1990Order12;
+using quantities::GravitationalParameter;
+using quantities::Length;
+using quantities::Speed;
+using quantities::Sqrt;
+using quantities::si::Day;
+using quantities::si::Kilo;
+using quantities::si::Metre;
+using quantities::si::Milli;
+using quantities::si::Minute;
+using quantities::si::Second;
+using testing_utilities::RelativeError;
+using ::testing::Eq;
+using ::testing::Lt;
+namespace si = quantities::si;
+
+class KustaanheimoStiefelFlowTest : public ::testing::Test {
+ protected:
+  using World = Frame<enum class WorldTag, Inertial>;
+
+  KustaanheimoStiefelFlowTest()
+      : earth_(new MassiveBody(3.986004418e14 *
+                               si::Unit<GravitationalParameter>)),
+        ephemeris_(MakeEphemeris(earth_)),
+        parameters_(
+            EmbeddedExplicitRungeKuttaIntegrator<
+                DormandPrince1986RK547FC,
+                KustaanheimoStiefelFlow<World>::IndependentVariable,
+                double,
+                double,
+                double,
+                Instant>(),
+            /*max_steps=*/std::numeric_limits<std::int64_t>::max(),
+            /*length_integration_tolerance=*/1 * Milli(Metre),
+            /*speed_integration_tolerance=*/1 * Milli(Metre) / Second) {}
+
+  static not_null<std::unique_ptr<Ephemeris<World>>> MakeEphemeris(
+      MassiveBody const* const earth) {
+    std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+    bodies.emplace_back(std::unique_ptr<MassiveBody const>(earth));
+    return make_not_null_unique<Ephemeris<World>>(
+        std::move(bodies),
+        std::vector<DegreesOfFreedom<World>>{{World::origin, World::unmoving}},
+        Instant(),
+        Ephemeris<World>::AccuracyParameters(
+            /*fitting_tolerance=*/1 * Milli(Metre),
+            /*geopotential_tolerance=*/0x1p-24),
+        Ephemeris<World>::FixedStepParameters(
+            SymmetricLinearMultistepIntegrator<QuinlanTremaine1990Order12,
+                                               Position<World>>(),
+            /*step=*/10 * Minute));
+  }
+
+  MassiveBody const* const earth_;
+  not_null<std::unique_ptr<Ephemeris<World>>> const ephemeris_;
+  KustaanheimoStiefelFlow<World>::AdaptiveParameters const parameters_;
+  Instant const t0_;
+};
+
+#if !defined(_DEBUG)
+
+// An orbit with an eccentricity of 0.9 and a periapsis 300 km above the surface
+// of the Earth, integrated for about 5 revolutions.  The result agrees with the
+// Keplerian orbit, and is obtained in far fewer steps than the integration of
+// the Newtonian equation.
+TEST_F(KustaanheimoStiefelFlowTest, EccentricKeplerOrbit) {
+  double const e = 0.9;
+  Length const periapsis = 6678 * Kilo(Metre);
+  Speed const periapsis_speed =
+      Sqrt(earth_->gravitational_parameter() * (1 + e) / periapsis);
+  DegreesOfFreedom<World> const initial_degrees_of_freedom(
+      World::origin + Displacement<World>({periapsis, 0 * Metre, 0 * Metre}),
+      Velocity<World>({0 * Metre / Second,
+                       0.8 * periapsis_speed,
+                       0.6 * periapsis_speed}));
+  Instant const t_final = t0_ + 10 * Day;
+
+  DiscreteTrajectory<World> trajectory;
+  EXPECT_OK(trajectory.Append(t0_, initial_degrees_of_freedom));
+  KustaanheimoStiefelFlow<World> flow(parameters_, ephemeris_.get(), earth_);
+  EXPECT_OK(flow.FlowWithAdaptiveStep(&trajectory, t_final));
+  EXPECT_THAT(trajectory.back().time, Eq(t_final));
+
+  KeplerOrbit<World> const orbit(
+      *earth_,
+      MasslessBody{},
+      initial_degrees_of_freedom - DegreesOfFreedom<World>(World::origin,
+                                                           World::unmoving),
+      t0_);
+  RelativeDegreesOfFreedom<World> const expected = orbit.StateVectors(t_final);
+  EXPECT_THAT((trajectory.back().degrees_of_freedom.position() -
+               (World::origin + expected.displacement())).Norm(),
+              Lt(1 * Metre));
+  EXPECT_THAT((trajectory.back().degrees_of_freedom.velocity() -
+               expected.velocity()).Norm(),
+              Lt(1 * Milli(Metre) / Second));
+
+  DiscreteTrajectory<World> cowell_trajectory;
+  EXPECT_OK(cowell_trajectory.Append(t0_, initial_degrees_of_freedom));
+  EXPECT_OK(ephemeris_->FlowWithAdaptiveStep(
+      &cowell_trajectory,
+      Ephemeris<World>::NoIntrinsicAcceleration,
+      t_final,
+      Ephemeris<World>::AdaptiveStepParameters(
+          EmbeddedExplicitRungeKuttaNyströmIntegrator<
+              DormandالمكاوىPrince1986RKN434FM,
+              Position<World>>(),
+          std::numeric_limits<std::int64_t>::max(),
+          parameters_.length_integration_tolerance(),
+          parameters_.speed_integration_tolerance()),
+      Ephemeris<World>::unlimited_max_ephemeris_steps));
+  EXPECT_THAT(trajectory.size(), Lt(cowell_trajectory.size() / 2));
+}
+
+// Flowing in several calls yields points at each of the requested times.
+TEST_F(KustaanheimoStiefelFlowTest, Restart) {
+  Length const r = 7000 * Kilo(Metre);
+  Speed const v = Sqrt(earth_->gravitational_parameter() / r);
+  DiscreteTrajectory<World> trajectory;
+  EXPECT_OK(trajectory.Append(
+      t0_,
+      DegreesOfFreedom<World>(
+          World::origin + Displacement<World>({r, 0 * Metre, 0 * Metre}),
+          Velocity<World>({0 * Metre / Second, v, 0 * Metre / Second}))));
+  KustaanheimoStiefelFlow<World> flow(parameters_, ephemeris_.get(), earth_);
+  for (int i = 1; i <= 10; ++i) {
+    Instant const t = t0_ + i * 17 * Minute;
+    EXPECT_OK(flow.FlowWithAdaptiveStep(&trajectory, t));
+    EXPECT_THAT(trajectory.back().time, Eq(t));
+    EXPECT_THAT(
+        RelativeError(r, (trajectory.back().degrees_of_freedom.position() -
+                          World::origin).Norm()),
+        Lt(1e-7));
+  }
+}
+
+#endif
+
+}  // namespace physics
+}  // namespace principia
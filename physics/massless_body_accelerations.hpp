@@ -0,0 +1,74 @@
+﻿#pragma once
+
+#include <vector>
+
+#include "geometry/grassmann.hpp"
+#include "geometry/named_quantities.hpp"
+#include "quantities/named_quantities.hpp"
+#include "quantities/quantities.hpp"
+
+namespace principia {
+namespace physics {
+namespace internal_massless_body_accelerations {
+
+using geometry::Position;
+using geometry::Vector;
+using quantities::Acceleration;
+using quantities::GravitationalParameter;
+using quantities::Length;
+
+// The positions of, and the accelerations on, a set of massless bodies, stored
+// as a structure of arrays in SI units.  This layout makes it possible to
+// compute the accelerations exerted by a massive body on |lanes| massless
+// bodies at a time, instead of evaluating one |R3Element| at a time and leaving
+// the |zt| half of its registers mostly idle.
+// We use 128-bit vectors because clang cannot emit VEX-encoded instructions
+// without VEX-encoding everything (see #3019 and numerics/fma.hpp).  The
+// results are bitwise identical to those of the scalar computation in
+// |Ephemeris|, because the operations are performed in the same order.
+template<typename Frame>
+class MasslessBodiesAccelerations final {
+ public:
+  // The number of massless bodies processed by one iteration of the vectorized
+  // loop.
+  static constexpr int lanes = 2;
+
+  // Loads the |positions| and clears the accelerations.  The storage is reused
+  // from one call to the next, so that a long-lived object doesn't allocate in
+  // steady state.
+  void Gather(std::vector<Position<Frame>> const& positions);
+
+  // Adds to the accelerations the Newtonian acceleration exerted by a point
+  // mass with gravitational parameter |μ1| located at |position1|.  Returns
+  // true iff at least one of the massless bodies is within |collision_radius|
+  // of |position1| (or if the distance is NaN).
+  bool AddPointMassAccelerations(Position<Frame> const& position1,
+                                 GravitationalParameter const& μ1,
+                                 Length const& collision_radius);
+
+  // Adds |acceleration| to the acceleration of the massless body at |index|.
+  void Add(int index, Vector<Acceleration, Frame> const& acceleration);
+
+  // Stores the accelerations into |accelerations|, which must have |size()|
+  // elements.
+  void Scatter(std::vector<Vector<Acceleration, Frame>>& accelerations) const;
+
+  int size() const;
+
+ private:
+  std::vector<double> qx_;
+  std::vector<double> qy_;
+  std::vector<double> qz_;
+  std::vector<double> ax_;
+  std::vector<double> ay_;
+  std::vector<double> az_;
+};
+
+}  // namespace internal_massless_body_accelerations
+
+using internal_massless_body_accelerations::MasslessBodiesAccelerations;
+
+}  // namespace physics
+}  // namespace principia
+
+#include "physics/massless_body_accelerations_body.hpp"
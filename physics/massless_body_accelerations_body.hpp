@@ -0,0 +1,141 @@
+﻿#pragma once
+
+#include "physics/massless_body_accelerations.hpp"
+
+#include <pmmintrin.h>
+
+#include "base/macros.hpp"
+#include "geometry/r3_element.hpp"
+#include "glog/logging.h"
+#include "quantities/elementary_functions.hpp"
+#include "quantities/si.hpp"
+
+namespace principia {
+namespace physics {
+namespace internal_massless_body_accelerations {
+
+using geometry::R3Element;
+using quantities::Sqrt;
+using quantities::si::Metre;
+using quantities::si::Unit;
+
+template<typename Frame>
+void MasslessBodiesAccelerations<Frame>::Gather(
+    std::vector<Position<Frame>> const& positions) {
+  int const size = positions.size();
+  qx_.resize(size);
+  qy_.resize(size);
+  qz_.resize(size);
+  ax_.assign(size, 0);
+  ay_.assign(size, 0);
+  az_.assign(size, 0);
+  for (int i = 0; i < size; ++i) {
+    R3Element<Length> const& q = (positions[i] - Frame::origin).coordinates();
+    qx_[i] = q.x / Metre;
+    qy_[i] = q.y / Metre;
+    qz_[i] = q.z / Metre;
+  }
+}
+
+template<typename Frame>
+bool MasslessBodiesAccelerations<Frame>::AddPointMassAccelerations(
+    Position<Frame> const& position1,
+    GravitationalParameter const& μ1,
+    Length const& collision_radius) {
+  R3Element<Length> const& q1 = (position1 - Frame::origin).coordinates();
+  double const x1 = q1.x / Metre;
+  double const y1 = q1.y / Metre;
+  double const z1 = q1.z / Metre;
+  double const μ = μ1 / Unit<GravitationalParameter>;
+  double const r = collision_radius / Metre;
+  int const size = qx_.size();
+
+  int i = 0;
+  bool collided = false;
+#if PRINCIPIA_USE_SSE3_INTRINSICS
+  __m128d const x1_128d = _mm_set1_pd(x1);
+  __m128d const y1_128d = _mm_set1_pd(y1);
+  __m128d const z1_128d = _mm_set1_pd(z1);
+  __m128d const μ_128d = _mm_set1_pd(μ);
+  __m128d const r_128d = _mm_set1_pd(r);
+  // All bits set in a lane as long as no collision was detected in that lane.
+  __m128d no_collision_128d = _mm_cmpeq_pd(r_128d, r_128d);
+  for (; i + lanes <= size; i += lanes) {
+    // Vectors from the massless bodies to the massive body.
+    __m128d const Δx = _mm_sub_pd(x1_128d, _mm_loadu_pd(&qx_[i]));
+    __m128d const Δy = _mm_sub_pd(y1_128d, _mm_loadu_pd(&qy_[i]));
+    __m128d const Δz = _mm_sub_pd(z1_128d, _mm_loadu_pd(&qz_[i]));
+
+    // Same order of operations as |R3Element::Norm²|.
+    __m128d const Δq² = _mm_add_pd(
+        _mm_add_pd(_mm_mul_pd(Δx, Δx), _mm_mul_pd(Δy, Δy)),
+        _mm_mul_pd(Δz, Δz));
+    __m128d const Δq_norm = _mm_sqrt_pd(Δq²);
+    // The comparison is false for NaNs, which are therefore reported as
+    // collisions, like in the scalar code.
+    no_collision_128d =
+        _mm_and_pd(no_collision_128d, _mm_cmpgt_pd(Δq_norm, r_128d));
+
+    __m128d const one_over_Δq³ = _mm_div_pd(Δq_norm, _mm_mul_pd(Δq², Δq²));
+    __m128d const μ_over_Δq³ = _mm_mul_pd(μ_128d, one_over_Δq³);
+
+    _mm_storeu_pd(&ax_[i],
+                  _mm_add_pd(_mm_loadu_pd(&ax_[i]),
+                             _mm_mul_pd(Δx, μ_over_Δq³)));
+    _mm_storeu_pd(&ay_[i],
+                  _mm_add_pd(_mm_loadu_pd(&ay_[i]),
+                             _mm_mul_pd(Δy, μ_over_Δq³)));
+    _mm_storeu_pd(&az_[i],
+                  _mm_add_pd(_mm_loadu_pd(&az_[i]),
+                             _mm_mul_pd(Δz, μ_over_Δq³)));
+  }
+  collided = _mm_movemask_pd(no_collision_128d) != (1 << lanes) - 1;
+#endif
+
+  // The remainder, or everything if intrinsics are not used.
+  for (; i < size; ++i) {
+    double const Δx = x1 - qx_[i];
+    double const Δy = y1 - qy_[i];
+    double const Δz = z1 - qz_[i];
+    double const Δq² = Δx * Δx + Δy * Δy + Δz * Δz;
+    double const Δq_norm = Sqrt(Δq²);
+    collided |= !(Δq_norm > r);
+    double const one_over_Δq³ = Δq_norm / (Δq² * Δq²);
+    double const μ_over_Δq³ = μ * one_over_Δq³;
+    ax_[i] += Δx * μ_over_Δq³;
+    ay_[i] += Δy * μ_over_Δq³;
+    az_[i] += Δz * μ_over_Δq³;
+  }
+  return collided;
+}
+
+template<typename Frame>
+void MasslessBodiesAccelerations<Frame>::Add(
+    int const index,
+    Vector<Acceleration, Frame> const& acceleration) {
+  R3Element<Acceleration> const& a = acceleration.coordinates();
+  ax_[index] += a.x / Unit<Acceleration>;
+  ay_[index] += a.y / Unit<Acceleration>;
+  az_[index] += a.z / Unit<Acceleration>;
+}
+
+template<typename Frame>
+void MasslessBodiesAccelerations<Frame>::Scatter(
+    std::vector<Vector<Acceleration, Frame>>& accelerations) const {
+  CHECK_EQ(accelerations.size(), ax_.size());
+  for (int i = 0; i < accelerations.size(); ++i) {
+    accelerations[i] = Vector<Acceleration, Frame>(
+        {ax_[i] * Unit<Acceleration>,
+         ay_[i] * Unit<Acceleration>,
+         az_[i] * Unit<Acceleration>});
+  }
+}
+
+template<typename Frame>
+int MasslessBodiesAccelerations<Frame>::size() const {
+  return qx_.size();
+}
+
+}  // namespace internal_massless_body_accelerations
+}  // namespace physics
+}  // namespace principia
@@ -0,0 +1,145 @@
+﻿#include "physics/massless_body_accelerations.hpp"
+
+#include <random>
+#include <vector>
+
+#include "geometry/frame.hpp"
+#include "geometry/grassmann.hpp"
+#include "geometry/named_quantities.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "quantities/elementary_functions.hpp"
+#include "quantities/named_quantities.hpp"
+#include "quantities/quantities.hpp"
+#include "quantities/si.hpp"
+
+namespace principia {
+namespace physics {
+
+using geometry::Displacement;
+using geometry::Frame;
+using geometry::Handedness;
+using geometry::Inertial;
+using geometry::Position;
+using geometry::Vector;
+using quantities::Acceleration;
+using quantities::Exponentiation;
+using quantities::GravitationalParameter;
+using quantities::Length;
+using quantities::Pow;
+using quantities::Sqrt;
+using quantities::Square;
+using quantities::si::Kilo;
+using quantities::si::Metre;
+using quantities::si::Second;
+using ::testing::ElementsAreArray;
+using ::testing::Eq;
+
+class MasslessBodiesAccelerationsTest : public ::testing::Test {
+ protected:
+  using World = Frame<serialization::Frame::TestTag,
+                      Inertial,
+                      Handedness::Right,
+                      serialization::Frame::TEST>;
+
+  // The computation performed by |Ephemeris| one |R3Element| at a time.
+  static Vector<Acceleration, World> ScalarAcceleration(
+      Position<World> const& position1,
+      GravitationalParameter const& μ1,
+      Position<World> const& position) {
+    Displacement<World> const Δq = position1 - position;
+    Square<Length> const Δq² = Δq.Norm²();
+    Length const Δq_norm = Sqrt(Δq²);
+    Exponentiation<Length, -3> const one_over_Δq³ = Δq_norm / (Δq² * Δq²);
+    auto const μ1_over_Δq³ = μ1 * one_over_Δq³;
+    return Δq * μ1_over_Δq³;
+  }
+
+  std::vector<Position<World>> RandomPositions(int const size) {
+    std::uniform_real_distribution<double> distribution(-1e7, 1e7);
+    std::vector<Position<World>> positions;
+    for (int i = 0; i < size; ++i) {
+      positions.push_back(
+          World::origin +
+          Displacement<World>({distribution(random_) * Metre,
+                               distribution(random_) * Metre,
+                               distribution(random_) * Metre}));
+    }
+    return positions;
+  }
+
+  std::mt19937_64 random_{42};
+};
+
+TEST_F(MasslessBodiesAccelerationsTest, BitwiseIdenticalToScalar) {
+  GravitationalParameter const μ1 = 3.986e14 * Pow<3>(Metre) / Pow<2>(Second);
+  GravitationalParameter const μ2 = 4.903e12 * Pow<3>(Metre) / Pow<2>(Second);
+  Position<World> const position1 =
+      World::origin + Displacement<World>({1 * Metre, 2 * Metre, 3 * Metre});
+  Position<World> const position2 =
+      World::origin +
+      Displacement<World>({3.8e8 * Metre, -1e6 * Metre, 2e5 * Metre});
+
+  // Odd and even sizes to exercise the remainder loop.
+  for (int const size : {1, 2, 7, 64}) {
+    auto const positions = RandomPositions(size);
+    MasslessBodiesAccelerations<World> soa_accelerations;
+    soa_accelerations.Gather(positions);
+    EXPECT_FALSE(soa_accelerations.AddPointMassAccelerations(
+        position1, μ1, /*collision_radius=*/1 * Metre));
+    EXPECT_FALSE(soa_accelerations.AddPointMassAccelerations(
+        position2, μ2, /*collision_radius=*/1 * Metre));
+    std::vector<Vector<Acceleration, World>> actual(size);
+    soa_accelerations.Scatter(actual);
+
+    std::vector<Vector<Acceleration, World>> expected(size);
+    for (int i = 0; i < size; ++i) {
+      expected[i] += ScalarAcceleration(position1, μ1, positions[i]);
+      expected[i] += ScalarAcceleration(position2, μ2, positions[i]);
+    }
+    EXPECT_THAT(actual, ElementsAreArray(expected)) << size;
+  }
+}
+
+TEST_F(MasslessBodiesAccelerationsTest, Collision) {
+  GravitationalParameter const μ1 = 3.986e14 * Pow<3>(Metre) / Pow<2>(Second);
+  auto positions = RandomPositions(5);
+  MasslessBodiesAccelerations<World> soa_accelerations;
+
+  // A collision in the vectorized part.
+  soa_accelerations.Gather(positions);
+  EXPECT_TRUE(soa_accelerations.AddPointMassAccelerations(
+      positions[1], μ1, /*collision_radius=*/6371 * Kilo(Metre)));
+
+  // A collision in the remainder.
+  soa_accelerations.Gather(positions);
+  EXPECT_TRUE(soa_accelerations.AddPointMassAccelerations(
+      positions[4], μ1, /*collision_radius=*/6371 * Kilo(Metre)));
+
+  // No collision.
+  soa_accelerations.Gather(positions);
+  EXPECT_FALSE(soa_accelerations.AddPointMassAccelerations(
+      World::origin + Displacement<World>({1e9 * Metre, 0 * Metre, 0 * Metre}),
+      μ1,
+      /*collision_radius=*/6371 * Kilo(Metre)));
+}
+
+TEST_F(MasslessBodiesAccelerationsTest, Add) {
+  auto const positions = RandomPositions(3);
+  MasslessBodiesAccelerations<World> soa_accelerations;
+  soa_accelerations.Gather(positions);
+  EXPECT_THAT(soa_accelerations.size(), Eq(3));
+  Vector<Acceleration, World> const a(
+      {1 * Metre / Pow<2>(Second),
+       2 * Metre / Pow<2>(Second),
+       3 * Metre / Pow<2>(Second)});
+  soa_accelerations.Add(1, a);
+  std::vector<Vector<Acceleration, World>> accelerations(3);
+  soa_accelerations.Scatter(accelerations);
+  EXPECT_THAT(accelerations[0], Eq(Vector<Acceleration, World>()));
+  EXPECT_THAT(accelerations[1], Eq(a));
+  EXPECT_THAT(accelerations[2], Eq(Vector<Acceleration, World>()));
+}
+
+}  // namespace physics
+}  // namespace principia
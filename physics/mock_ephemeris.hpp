@@ -22,6 +22,8 @@ class MockEphemeris : public Ephemeris<Frame> {
   using typename Ephemeris<Frame>::IntrinsicAcceleration;
   using typename Ephemeris<Frame>::IntrinsicAccelerations;
   using typename Ephemeris<Frame>::NewtonianMotionEquation;
+  using typename Ephemeris<Frame>::PararealDefect;
+  using typename Ephemeris<Frame>::PararealParameters;
 
   MockEphemeris()
       : Ephemeris<Frame>(
@@ -35,6 +37,14 @@ class MockEphemeris : public Ephemeris<Frame> {
               trajectory,
               (not_null<MassiveBody const*> body),
               (const, override));
+  MOCK_METHOD(std::vector<Position<Frame>>,
+              EvaluateAllPositions,
+              (Instant const& t),
+              (const, override));
+  MOCK_METHOD(std::vector<DegreesOfFreedom<Frame>>,
+              EvaluateAllDegreesOfFreedom,
+              (Instant const& t),
+              (const, override));
   MOCK_METHOD(bool, empty, (), (const, override));
   MOCK_METHOD(Instant, t_min, (), (const, override));
   MOCK_METHOD(Instant, t_max, (), (const, override));
@@ -52,6 +62,14 @@ class MockEphemeris : public Ephemeris<Frame> {
        IntrinsicAccelerations const& intrinsic_accelerations,
        FixedStepParameters const& parameters),
       (override));
+  MOCK_METHOD(
+      not_null<std::unique_ptr<
+          typename Integrator<NewtonianMotionEquation>::Instance>>,
+      NewBatchedInstance,
+      (std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
+       FixedStepParameters const& parameters,
+       not_null<std::vector<bool>*> collided),
+      (override));
   MOCK_METHOD(absl::Status,
               FlowWithAdaptiveStep,
               (not_null<DiscreteTrajectory<Frame>*> trajectory,
@@ -60,6 +78,23 @@ class MockEphemeris : public Ephemeris<Frame> {
                AdaptiveStepParameters const& parameters,
                std::int64_t max_ephemeris_steps),
               (override));
+  MOCK_METHOD(
+      std::vector<absl::Status>,
+      FlowWithAdaptiveStep,
+      (std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
+       Instant const& t,
+       AdaptiveStepParameters const& parameters,
+       std::int64_t max_ephemeris_steps),
+      (override));
+  MOCK_METHOD(absl::StatusOr<PararealDefect>,
+              FlowWithAdaptiveStepParareal,
+              (not_null<DiscreteTrajectory<Frame>*> trajectory,
+               Instant const& t,
+               AdaptiveStepParameters const& parameters,
+               PararealParameters const& parareal_parameters,
+               std::int64_t max_ephemeris_steps,
+               ThreadPool<void>* pool),
+              (override));
   MOCK_METHOD(
       absl::Status,
       FlowWithFixedStep,